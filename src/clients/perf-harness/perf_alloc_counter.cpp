@@ -0,0 +1,204 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "perf_alloc_counter.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "infrastructure/realtime_safety.h"
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+namespace scxt::perf
+{
+namespace
+{
+std::atomic<bool> countingEnabled{false};
+std::atomic<int64_t> allocCount{0}, freeCount{0}, allocBytes{0};
+
+inline void noteAlloc(std::size_t sz)
+{
+    if (countingEnabled.load(std::memory_order_relaxed))
+    {
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+        allocBytes.fetch_add((int64_t)sz, std::memory_order_relaxed);
+    }
+}
+inline void noteFree(void *p)
+{
+    if (p && countingEnabled.load(std::memory_order_relaxed))
+        freeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace rt = scxt::infrastructure::realtime;
+
+void *countedAlloc(std::size_t sz)
+{
+    noteAlloc(sz);
+#if SCXT_REALTIME_SAFETY_TRACKING
+    rt::note(rt::Violation::ALLOCATION, "operator new");
+    if (auto *p = rt::rawAlloc(sz))
+        return p;
+#else
+    if (auto *p = std::malloc(sz ? sz : 1))
+        return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void *countedAlignedAlloc(std::size_t sz, std::size_t al)
+{
+    noteAlloc(sz);
+#if SCXT_REALTIME_SAFETY_TRACKING
+    rt::note(rt::Violation::ALLOCATION, "operator new (aligned)");
+#endif
+    void *p{nullptr};
+    if (al < sizeof(void *))
+        al = sizeof(void *);
+    if (posix_memalign(&p, al, sz ? sz : 1) != 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void countedFree(void *p)
+{
+    noteFree(p);
+#if SCXT_REALTIME_SAFETY_TRACKING
+    if (p)
+        rt::note(rt::Violation::DEALLOCATION, "operator delete");
+    rt::rawFree(p);
+#else
+    std::free(p);
+#endif
+}
+} // namespace
+
+void setAllocCountingEnabled(bool b) { countingEnabled.store(b, std::memory_order_relaxed); }
+
+void resetAllocCounts()
+{
+    allocCount = 0;
+    freeCount = 0;
+    allocBytes = 0;
+}
+
+AllocCounts getAllocCounts() { return {allocCount.load(), freeCount.load(), allocBytes.load()}; }
+
+int64_t currentRSSBytes()
+{
+#if defined(__linux__)
+    long pages{0}, resident{0};
+    auto *f = std::fopen("/proc/self/statm", "r");
+    if (!f)
+        return 0;
+    auto n = std::fscanf(f, "%ld %ld", &pages, &resident);
+    std::fclose(f);
+    return n == 2 ? (int64_t)resident * sysconf(_SC_PAGESIZE) : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) !=
+        KERN_SUCCESS)
+        return 0;
+    return (int64_t)info.resident_size;
+#else
+    return 0;
+#endif
+}
+
+int64_t peakRSSBytes()
+{
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return (int64_t)ru.ru_maxrss; // bytes on macOS
+#else
+    return (int64_t)ru.ru_maxrss * 1024; // kilobytes on Linux
+#endif
+}
+
+} // namespace scxt::perf
+
+// The replacements have to live at global scope. The sized and nothrow forms are
+// spelled out so nothing falls through to a libstdc++/libc++ default which would
+// pair a counted new with an uncounted delete.
+void *operator new(std::size_t sz) { return scxt::perf::countedAlloc(sz); }
+void *operator new[](std::size_t sz) { return scxt::perf::countedAlloc(sz); }
+void *operator new(std::size_t sz, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return scxt::perf::countedAlloc(sz);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t sz, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return scxt::perf::countedAlloc(sz);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void *operator new(std::size_t sz, std::align_val_t al)
+{
+    return scxt::perf::countedAlignedAlloc(sz, (std::size_t)al);
+}
+void *operator new[](std::size_t sz, std::align_val_t al)
+{
+    return scxt::perf::countedAlignedAlloc(sz, (std::size_t)al);
+}
+void operator delete(void *p) noexcept { scxt::perf::countedFree(p); }
+void operator delete[](void *p) noexcept { scxt::perf::countedFree(p); }
+void operator delete(void *p, std::size_t) noexcept { scxt::perf::countedFree(p); }
+void operator delete[](void *p, std::size_t) noexcept { scxt::perf::countedFree(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { scxt::perf::countedFree(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { scxt::perf::countedFree(p); }
+void operator delete(void *p, std::align_val_t) noexcept { scxt::perf::countedFree(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { scxt::perf::countedFree(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    scxt::perf::countedFree(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+    scxt::perf::countedFree(p);
+}
@@ -0,0 +1,58 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_ALLOC_COUNTER_H
+#define SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_ALLOC_COUNTER_H
+
+#include <cstdint>
+
+namespace scxt::perf
+{
+
+// scxt-perf replaces the global operator new/delete family with malloc-backed
+// versions which count calls and requested bytes while counting is enabled. Off
+// by default so render timing never pays for it; load mode turns it on around each
+// load. malloc/free called directly (libgig, miniz, the sample buffers) are not
+// seen — this counts C++ allocations only.
+struct AllocCounts
+{
+    int64_t allocations{0};
+    int64_t frees{0};
+    int64_t bytes{0};
+};
+
+void setAllocCountingEnabled(bool);
+void resetAllocCounts();
+AllocCounts getAllocCounts();
+
+// Process memory. Current RSS is 0 where the platform gives us no cheap way to
+// read it; peak is the process high-water mark, so it only ever grows.
+int64_t currentRSSBytes();
+int64_t peakRSSBytes();
+
+} // namespace scxt::perf
+#endif
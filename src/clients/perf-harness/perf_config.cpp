@@ -106,18 +106,74 @@ SequenceSpec::Preset parsePreset(const std::string &s)
         return SequenceSpec::ChromaticBlast;
     if (s == "custom")
         return SequenceSpec::Custom;
+    if (s == "midi_file")
+        return SequenceSpec::MidiFile;
     throw std::runtime_error("Unknown sequence preset: " + s);
 }
 
+CustomEvent::Type parseEventType(const std::string &s)
+{
+    if (s == "note_on")
+        return CustomEvent::NoteOn;
+    if (s == "note_off")
+        return CustomEvent::NoteOff;
+    if (s == "cc")
+        return CustomEvent::ControlChange;
+    if (s == "pitch_bend")
+        return CustomEvent::PitchBend;
+    if (s == "channel_pressure")
+        return CustomEvent::ChannelPressure;
+    if (s == "poly_pressure")
+        return CustomEvent::PolyPressure;
+    if (s == "program_change")
+        return CustomEvent::ProgramChange;
+    throw std::runtime_error("Unknown sequence event type: " + s);
+}
+
+const char *eventTypeName(CustomEvent::Type t)
+{
+    switch (t)
+    {
+    case CustomEvent::NoteOn:
+        return "note_on";
+    case CustomEvent::NoteOff:
+        return "note_off";
+    case CustomEvent::ControlChange:
+        return "cc";
+    case CustomEvent::PitchBend:
+        return "pitch_bend";
+    case CustomEvent::ChannelPressure:
+        return "channel_pressure";
+    case CustomEvent::PolyPressure:
+        return "poly_pressure";
+    case CustomEvent::ProgramChange:
+        return "program_change";
+    }
+    return "note_on";
+}
+
 RunConfig::Mode parseMode(const std::string &s)
 {
     if (s == "measure")
         return RunConfig::Measure;
     if (s == "profile")
         return RunConfig::Profile;
+    if (s == "load")
+        return RunConfig::Load;
+    if (s == "multi_instance")
+        return RunConfig::MultiInstance;
     throw std::runtime_error("Unknown run mode: " + s);
 }
 
+RunConfig::FileCache parseFileCache(const std::string &s)
+{
+    if (s == "warm")
+        return RunConfig::WarmCache;
+    if (s == "cold")
+        return RunConfig::ColdCache;
+    throw std::runtime_error("Unknown file_cache: " + s);
+}
+
 RunConfig::AudioThreadPriority parsePriority(const std::string &s)
 {
     if (s == "default")
@@ -140,8 +196,15 @@ Config loadFromFile(const std::filesystem::path &p)
 
     if (auto *eng = find(v, "engine"); eng)
     {
-        warnUnknownKeys(*eng, "engine", {"sample_rate"});
+        warnUnknownKeys(*eng, "engine", {"sample_rate", "host_block_size", "omni_flavor"});
         readInto(*eng, "sample_rate", c.engine.sampleRate);
+        readInto(*eng, "host_block_size", c.engine.hostBlockSize);
+        if (c.engine.hostBlockSize < 0)
+            throw std::runtime_error("engine.host_block_size must be >= 0");
+        readInto(*eng, "omni_flavor", c.engine.omniFlavor);
+        if (!c.engine.omniFlavor.empty() && c.engine.omniFlavor != "omni" &&
+            c.engine.omniFlavor != "mpe" && c.engine.omniFlavor != "choct")
+            throw std::runtime_error("Unknown engine.omni_flavor: " + c.engine.omniFlavor);
     }
 
     if (auto *loads = find(v, "load"); loads && loads->is_array())
@@ -182,10 +245,15 @@ Config loadFromFile(const std::filesystem::path &p)
 
     if (auto *seq = find(v, "sequence"); seq)
     {
-        warnUnknownKeys(*seq, "sequence", {"preset", "params", "events"});
+        warnUnknownKeys(*seq, "sequence", {"preset", "params", "events", "midi_file"});
         std::string preset;
         if (readInto(*seq, "preset", preset))
             c.sequence.preset = parsePreset(preset);
+        std::string midiFile;
+        if (readInto(*seq, "midi_file", midiFile))
+            c.sequence.midiFile = std::filesystem::u8path(midiFile);
+        if (c.sequence.preset == SequenceSpec::MidiFile && c.sequence.midiFile.empty())
+            throw std::runtime_error("sequence: preset 'midi_file' requires 'midi_file' path");
 
         if (auto *params = find(*seq, "params"); params)
         {
@@ -212,15 +280,18 @@ Config loadFromFile(const std::filesystem::path &p)
         {
             for (const auto &ev : events->get_array())
             {
-                warnUnknownKeys(ev, "sequence.events[]", {"t", "type", "channel", "key", "vel"});
+                warnUnknownKeys(ev, "sequence.events[]",
+                                {"t", "type", "channel", "key", "vel", "cc", "value"});
                 CustomEvent e;
                 readInto(ev, "t", e.t);
                 std::string type;
                 if (readInto(ev, "type", type))
-                    e.noteOn = (type == "note_on");
+                    e.type = parseEventType(type);
                 readInto(ev, "channel", e.channel);
                 readInto(ev, "key", e.key);
                 readInto(ev, "vel", e.velocity);
+                readInto(ev, "cc", e.cc);
+                readInto(ev, "value", e.value);
                 c.sequence.custom.push_back(e);
             }
         }
@@ -231,7 +302,8 @@ Config loadFromFile(const std::filesystem::path &p)
         warnUnknownKeys(*run, "run",
                         {"mode", "warmup_iterations", "measure_iterations", "tail_silence_s",
                          "profile_iterations", "wait_for_key", "audio_thread_priority",
-                         "report_path", "wav_output_path"});
+                         "report_path", "wav_output_path", "file_cache", "instances",
+                         "threads"});
         auto &r = c.run;
         std::string mode;
         if (readInto(*run, "mode", mode))
@@ -244,6 +316,13 @@ Config loadFromFile(const std::filesystem::path &p)
         std::string prio;
         if (readInto(*run, "audio_thread_priority", prio))
             r.audioThreadPriority = parsePriority(prio);
+        readInto(*run, "instances", r.instances);
+        readInto(*run, "threads", r.threads);
+        if (r.instances < 1 || r.threads < 1)
+            throw std::runtime_error("run: 'instances' and 'threads' must be >= 1");
+        std::string fileCache;
+        if (readInto(*run, "file_cache", fileCache))
+            r.fileCache = parseFileCache(fileCache);
         readInto(*run, "report_path", r.reportPath);
         if (auto *x = find(*run, "wav_output_path"); x && !x->is_null())
             r.wavOutputPath = x->get_string();
@@ -258,6 +337,11 @@ std::string canonicalJson(const Config &c)
     v["name"] = c.name;
     v["description"] = c.description;
     v["engine"] = tao::json::value{{"sample_rate", c.engine.sampleRate}};
+    // Only emitted when non-default so scenarios which predate them keep their hash
+    if (c.engine.hostBlockSize != 0)
+        v["engine"]["host_block_size"] = c.engine.hostBlockSize;
+    if (!c.engine.omniFlavor.empty())
+        v["engine"]["omni_flavor"] = c.engine.omniFlavor;
 
     tao::json::value loads(tao::json::empty_array);
     for (const auto &s : c.load)
@@ -277,6 +361,7 @@ std::string canonicalJson(const Config &c)
     const char *presetName = c.sequence.preset == SequenceSpec::SingleNote       ? "single_note"
                              : c.sequence.preset == SequenceSpec::CMajorChord    ? "c_major_chord"
                              : c.sequence.preset == SequenceSpec::ChromaticBlast ? "chromatic_blast"
+                             : c.sequence.preset == SequenceSpec::MidiFile       ? "midi_file"
                                                                                  : "custom";
     tao::json::value seq(tao::json::empty_object);
     seq["preset"] = presetName;
@@ -296,6 +381,25 @@ std::string canonicalJson(const Config &c)
         params["chord_keys"] = std::move(ck);
         seq["params"] = std::move(params);
     }
+    if (c.sequence.preset == SequenceSpec::Custom)
+    {
+        tao::json::value evs(tao::json::empty_array);
+        for (const auto &e : c.sequence.custom)
+        {
+            tao::json::value ev{{"t", e.t},
+                                {"type", eventTypeName(e.type)},
+                                {"channel", e.channel},
+                                {"key", e.key},
+                                {"vel", e.velocity},
+                                {"cc", e.cc},
+                                {"value", e.value}};
+            evs.push_back(std::move(ev));
+        }
+        seq["events"] = std::move(evs);
+    }
+    // Like load paths, the MIDI file is identified by path rather than contents
+    if (c.sequence.preset == SequenceSpec::MidiFile)
+        seq["midi_file"] = c.sequence.midiFile.u8string();
     v["sequence"] = std::move(seq);
 
     // The canonical form deliberately omits output destinations (report_path,
@@ -303,7 +407,17 @@ std::string canonicalJson(const Config &c)
     // so the hash identifies the SCENARIO — same hash ⇒ same audio expected.
     // CLI overrides like --out / --wav don't perturb the hash.
     tao::json::value run(tao::json::empty_object);
-    run["mode"] = c.run.mode == RunConfig::Profile ? "profile" : "measure";
+    run["mode"] = c.run.mode == RunConfig::Profile         ? "profile"
+                  : c.run.mode == RunConfig::Load          ? "load"
+                  : c.run.mode == RunConfig::MultiInstance ? "multi_instance"
+                                                           : "measure";
+    if (c.run.mode == RunConfig::Load)
+        run["file_cache"] = c.run.fileCache == RunConfig::ColdCache ? "cold" : "warm";
+    if (c.run.mode == RunConfig::MultiInstance)
+    {
+        run["instances"] = c.run.instances;
+        run["threads"] = c.run.threads;
+    }
     run["warmup_iterations"] = c.run.warmupIterations;
     run["measure_iterations"] = c.run.measureIterations;
     run["tail_silence_s"] = c.run.tailSilenceS;
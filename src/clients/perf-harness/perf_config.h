@@ -40,6 +40,13 @@ namespace scxt::perf
 struct EngineConfig
 {
     double sampleRate{48000.0};
+    // 0 drives Engine::processAudio directly once per scxt::blockSize. Anything else
+    // runs the scenario through host buffers of this many frames, splitting them into
+    // engine blocks and dispatching events exactly as SCXTPlugin::process does.
+    int hostBlockSize{0};
+    // Engine::OmniFlavor as streamed ("omni", "mpe", "choct"); "mpe" switches the voice
+    // manager to the MPE MIDI 1 dialect. Empty leaves whatever the load set up.
+    std::string omniFlavor;
 };
 
 struct LoadStep
@@ -72,11 +79,23 @@ struct SequenceParams
 
 struct CustomEvent
 {
-    double t;
-    bool noteOn;
+    enum Type
+    {
+        NoteOn,
+        NoteOff,
+        ControlChange,
+        PitchBend,
+        ChannelPressure,
+        PolyPressure,
+        ProgramChange
+    } type{NoteOn};
+    double t{0};
     int channel{0};
     int key{60};
     float velocity{100.f};
+    int cc{64};
+    // CC / pressure / program are 0..127; pitch bend is the 14 bit value 0..16383
+    int value{0};
 };
 
 struct SequenceSpec
@@ -86,10 +105,12 @@ struct SequenceSpec
         SingleNote,
         CMajorChord,
         ChromaticBlast,
-        Custom
+        Custom,
+        MidiFile
     } preset{SingleNote};
     SequenceParams params;
     std::vector<CustomEvent> custom;
+    std::filesystem::path midiFile; // MidiFile: a Standard MIDI File, format 0 or 1
 };
 
 struct RunConfig
@@ -97,9 +118,24 @@ struct RunConfig
     enum Mode
     {
         Measure,
-        Profile
+        Profile,
+        Load,         // time the load steps themselves; no audio is rendered
+        MultiInstance // `instances` engines in one process driven from `threads` threads
     } mode{Measure};
 
+    // MultiInstance only. Engines are dealt round-robin to threads; threads beyond
+    // instances would idle, so the effective count is min(threads, instances).
+    int instances{4};
+    int threads{1};
+
+    // Load mode: Cold asks the OS to drop the loaded files (and every sample file
+    // the previous iteration pulled in) from its page cache before each iteration.
+    enum FileCache
+    {
+        WarmCache,
+        ColdCache
+    } fileCache{WarmCache};
+
     enum AudioThreadPriority
     {
         DefaultPriority,
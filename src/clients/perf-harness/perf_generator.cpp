@@ -30,6 +30,8 @@
 #include <algorithm>
 #include <cmath>
 
+#include "perf_midifile.h"
+
 namespace scxt::perf
 {
 
@@ -40,14 +42,52 @@ int64_t blockAt(double tSec, double sampleRate, int blockSize)
     return (int64_t)std::floor(tSec * sampleRate / blockSize);
 }
 
+int64_t sampleAt(double tSec, double sampleRate) { return (int64_t)std::floor(tSec * sampleRate); }
+
 void emitNote(std::vector<std::pair<int64_t, MidiEvent>> &out, double onT, double offT, int channel,
-              int key, float vel, double sampleRate, int blockSize)
+              int key, float vel, double sampleRate)
 {
-    out.emplace_back(blockAt(onT, sampleRate, blockSize),
+    out.emplace_back(sampleAt(onT, sampleRate),
                      MidiEvent{MidiEvent::NoteOn, (int16_t)channel, (int16_t)key, vel});
-    out.emplace_back(blockAt(offT, sampleRate, blockSize),
+    out.emplace_back(sampleAt(offT, sampleRate),
                      MidiEvent{MidiEvent::NoteOff, (int16_t)channel, (int16_t)key, vel});
 }
+
+MidiEvent midi1Event(uint8_t d0, uint8_t d1, uint8_t d2)
+{
+    MidiEvent m{MidiEvent::Midi1, (int16_t)(d0 & 0x0f), (int16_t)d1, 0.f};
+    m.midi1[0] = d0;
+    m.midi1[1] = d1;
+    m.midi1[2] = d2;
+    return m;
+}
+
+MidiEvent customToMidiEvent(const CustomEvent &e)
+{
+    auto ch = (uint8_t)(e.channel & 0x0f);
+    auto d7 = [](int v) { return (uint8_t)std::clamp(v, 0, 127); };
+    switch (e.type)
+    {
+    case CustomEvent::NoteOn:
+    case CustomEvent::NoteOff:
+        break;
+    case CustomEvent::ControlChange:
+        return midi1Event(0xb0 | ch, d7(e.cc), d7(e.value));
+    case CustomEvent::PitchBend:
+    {
+        auto v = std::clamp(e.value, 0, 16383);
+        return midi1Event(0xe0 | ch, v & 0x7f, (v >> 7) & 0x7f);
+    }
+    case CustomEvent::ChannelPressure:
+        return midi1Event(0xd0 | ch, d7(e.value), 0);
+    case CustomEvent::PolyPressure:
+        return midi1Event(0xa0 | ch, d7(e.key), d7(e.value));
+    case CustomEvent::ProgramChange:
+        return midi1Event(0xc0 | ch, d7(e.value), 0);
+    }
+    return MidiEvent{e.type == CustomEvent::NoteOn ? MidiEvent::NoteOn : MidiEvent::NoteOff,
+                     (int16_t)e.channel, (int16_t)e.key, e.velocity / 127.f};
+}
 } // namespace
 
 BakedSequence bake(const SequenceSpec &spec, double sampleRate, int blockSize, double tailSilenceS)
@@ -69,7 +109,7 @@ BakedSequence bake(const SequenceSpec &spec, double sampleRate, int blockSize, d
         {
             double on = i * (p.noteLenS + p.gapS);
             double off = on + p.noteLenS;
-            emitNote(b.events, on, off, p.channel, key, vel, sampleRate, blockSize);
+            emitNote(b.events, on, off, p.channel, key, vel, sampleRate);
             lastEdge = off;
         }
         break;
@@ -81,7 +121,7 @@ BakedSequence bake(const SequenceSpec &spec, double sampleRate, int blockSize, d
             double on = i * (p.noteLenS + p.gapS);
             double off = on + p.noteLenS;
             for (int k : p.chordKeys)
-                emitNote(b.events, on, off, p.channel, k, vel, sampleRate, blockSize);
+                emitNote(b.events, on, off, p.channel, k, vel, sampleRate);
             lastEdge = off;
         }
         break;
@@ -93,7 +133,7 @@ BakedSequence bake(const SequenceSpec &spec, double sampleRate, int blockSize, d
         {
             double on = i * (p.noteLenS + p.gapS);
             double off = on + p.noteLenS;
-            emitNote(b.events, on, off, p.channel, key, vel, sampleRate, blockSize);
+            emitNote(b.events, on, off, p.channel, key, vel, sampleRate);
             lastEdge = off;
         }
         break;
@@ -102,14 +142,24 @@ BakedSequence bake(const SequenceSpec &spec, double sampleRate, int blockSize, d
     {
         for (const auto &e : spec.custom)
         {
-            b.events.emplace_back(blockAt(e.t, sampleRate, blockSize),
-                                  MidiEvent{e.noteOn ? MidiEvent::NoteOn : MidiEvent::NoteOff,
-                                            (int16_t)e.channel, (int16_t)e.key,
-                                            e.velocity / 127.f});
+            b.events.emplace_back(sampleAt(e.t, sampleRate), customToMidiEvent(e));
             lastEdge = std::max(lastEdge, e.t);
         }
         break;
     }
+    case SequenceSpec::MidiFile:
+    {
+        // Every channel message, notes included, goes through processMIDI1Event so a
+        // file replays down the same path a MIDI 1 host's events take (MPE included,
+        // when the engine is in the MPE dialect).
+        for (const auto &m : readStandardMidiFile(spec.midiFile))
+        {
+            b.events.emplace_back(sampleAt(m.t, sampleRate),
+                                  midi1Event(m.data[0], m.data[1], m.data[2]));
+            lastEdge = std::max(lastEdge, m.t);
+        }
+        break;
+    }
     }
 
     std::stable_sort(b.events.begin(), b.events.end(),
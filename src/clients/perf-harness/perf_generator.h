@@ -42,21 +42,27 @@ struct MidiEvent
     enum Type
     {
         NoteOn,
-        NoteOff
+        NoteOff,
+        Midi1 // raw bytes in midi1, routed through Engine::processMIDI1Event
     } type;
     int16_t channel;
     int16_t key;
     float velocity;
+    uint8_t midi1[3]{0, 0, 0};
 };
 
 // blockSize is intentionally absent — the engine's block size is a compile-time
 // constant (scxt::blockSize). Don't store a runtime copy that pretends to be a
 // degree of freedom we can't actually honour.
+//
+// Events are positioned in samples, not blocks, so the runner can quantize them the
+// way the chosen host buffer size would. Driving the engine directly puts an event
+// in block sample_pos / blockSize.
 struct BakedSequence
 {
     double sampleRate{0};
     int64_t totalBlocks{0};
-    std::vector<std::pair<int64_t, MidiEvent>> events; // sorted by block_idx
+    std::vector<std::pair<int64_t, MidiEvent>> events; // sorted by sample_pos
 };
 
 BakedSequence bake(const SequenceSpec &, double sampleRate, int blockSize, double tailSilenceS);
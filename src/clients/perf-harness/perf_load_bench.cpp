@@ -0,0 +1,151 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "perf_load_bench.h"
+
+#include <iostream>
+#include <memory>
+#include <set>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "engine/engine.h"
+#include "messaging/messaging.h"
+
+#include "perf_alloc_counter.h"
+
+namespace scxt::perf
+{
+
+namespace
+{
+// Best-effort, like requestRealtimePriority: POSIX_FADV_DONTNEED drops clean pages
+// without privileges on Linux. Elsewhere there's no unprivileged equivalent so we
+// say so once and carry on warm.
+bool evictFromFileCache(const std::filesystem::path &p)
+{
+#if defined(__linux__)
+    int fd = ::open(p.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    auto rc = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    return rc == 0;
+#else
+    static bool warned{false};
+    if (!warned)
+        std::cerr << "scxt-perf: file_cache=cold is not implemented on this platform; "
+                     "iterations will run with a warm cache\n";
+    warned = true;
+    return false;
+#endif
+}
+} // namespace
+
+LoadBenchResult runLoadBenchmark(const Config &cfg)
+{
+    LoadBenchResult res;
+    infrastructure::LoadTimings timings;
+
+    // Sample files a multi references aren't in cfg.load, so the set to evict grows
+    // with whatever the previous iteration actually opened.
+    std::set<std::filesystem::path> touched;
+    for (const auto &s : cfg.load)
+        touched.insert(s.path);
+
+    auto runOne = [&](LoadIterationStats &st) -> bool {
+        auto engine = std::make_unique<scxt::engine::Engine>();
+        prepareEngine(*engine, cfg.engine);
+
+        if (cfg.run.fileCache == RunConfig::ColdCache)
+            for (const auto &p : touched)
+                st.evictedFiles += evictFromFileCache(p) ? 1 : 0;
+
+        timings.reset();
+        resetAllocCounts();
+        st.rssBeforeBytes = currentRSSBytes();
+
+        infrastructure::setLoadTimingSink(&timings);
+        setAllocCountingEnabled(true);
+        st.load = applyLoad(*engine, cfg.load);
+        setAllocCountingEnabled(false);
+        infrastructure::setLoadTimingSink(nullptr);
+
+        st.rssAfterBytes = currentRSSBytes();
+        st.peakRSSBytes = peakRSSBytes();
+        st.sampleMemoryBytes = engine->getSampleManager()->sampleMemoryInBytes;
+        auto ac = getAllocCounts();
+        st.allocations = ac.allocations;
+        st.allocatedBytes = ac.bytes;
+        for (int i = 0; i < infrastructure::LoadTimings::numPhases; ++i)
+        {
+            st.phaseMs[i] = timings.ns[i].load() * 1e-6;
+            st.phaseEntries[i] = timings.entries[i].load();
+        }
+
+        if (!st.load.ok)
+        {
+            res.error = st.load.error;
+            return false;
+        }
+
+        auto bypass = engine->getMessageController()->threadingChecker.bypassChecksInScope();
+        for (const auto &[id, addr] : engine->getSampleManager()->getSampleAddressesAndIDs())
+            if (!addr.path.empty())
+                touched.insert(addr.path);
+        return true;
+    };
+
+    std::cout << "scxt-perf: load mode, " << cfg.run.warmupIterations << " warmup + "
+              << cfg.run.measureIterations << " measure iteration(s), "
+              << (cfg.run.fileCache == RunConfig::ColdCache ? "cold" : "warm") << " file cache"
+              << std::endl;
+
+    for (int i = 0; i < cfg.run.warmupIterations; ++i)
+    {
+        LoadIterationStats st;
+        if (!runOne(st))
+            return res;
+        std::cout << "  warmup  " << (i + 1) << "/" << cfg.run.warmupIterations
+                  << ": wall=" << st.load.wallMs << "ms" << std::endl;
+        res.warmupIterations.push_back(std::move(st));
+    }
+    for (int i = 0; i < cfg.run.measureIterations; ++i)
+    {
+        LoadIterationStats st;
+        if (!runOne(st))
+            return res;
+        std::cout << "  measure " << (i + 1) << "/" << cfg.run.measureIterations
+                  << ": wall=" << st.load.wallMs << "ms" << std::endl;
+        res.measureIterations.push_back(std::move(st));
+    }
+    res.ok = true;
+    return res;
+}
+
+} // namespace scxt::perf
@@ -0,0 +1,70 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_LOAD_BENCH_H
+#define SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_LOAD_BENCH_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "infrastructure/load_timing.h"
+
+#include "perf_config.h"
+#include "perf_loader.h"
+
+namespace scxt::perf
+{
+
+struct LoadIterationStats
+{
+    LoadResult load; // wallMs and stepMs live here
+    std::array<double, infrastructure::LoadTimings::numPhases> phaseMs{};
+    std::array<int64_t, infrastructure::LoadTimings::numPhases> phaseEntries{};
+    int64_t allocations{0};
+    int64_t allocatedBytes{0};
+    int64_t rssBeforeBytes{0};
+    int64_t rssAfterBytes{0};
+    int64_t peakRSSBytes{0}; // process high-water mark after this iteration
+    uint64_t sampleMemoryBytes{0};
+    int evictedFiles{0}; // cold cache only
+};
+
+struct LoadBenchResult
+{
+    bool ok{false};
+    std::string error;
+    std::vector<LoadIterationStats> warmupIterations;
+    std::vector<LoadIterationStats> measureIterations;
+};
+
+// Each iteration builds a fresh engine (untimed), then times cfg.load into it with
+// the per-phase sink installed and C++ allocation counting on.
+LoadBenchResult runLoadBenchmark(const Config &cfg);
+
+} // namespace scxt::perf
+#endif
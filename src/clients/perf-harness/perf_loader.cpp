@@ -118,14 +118,24 @@ void countStructure(scxt::engine::Engine &e, LoadResult &r)
 }
 } // namespace
 
+void prepareEngine(scxt::engine::Engine &engine, const EngineConfig &cfg)
+{
+    engine.prepareToPlay(cfg.sampleRate);
+    engine.runtimeConfig.tuningMode = scxt::engine::Engine::TuningMode::TWELVE_TET;
+    engine.resetTuningFromRuntimeConfig();
+}
+
+void applyPostLoadEngineConfig(scxt::engine::Engine &engine, const EngineConfig &cfg)
+{
+    if (!cfg.omniFlavor.empty())
+        engine.setOmniFlavor(scxt::engine::Engine::fromStringOmniFlavor(cfg.omniFlavor));
+}
+
 LoadResult applyLoad(scxt::engine::Engine &engine, const std::vector<LoadStep> &steps)
 {
     LoadResult r;
     auto bypass = engine.getMessageController()->threadingChecker.bypassChecksInScope();
 
-    auto t0 = std::chrono::steady_clock::now();
-    uint64_t composite = 0xcbf29ce484222325ULL;
-
     for (const auto &s : steps)
     {
         if (!std::filesystem::exists(s.path))
@@ -133,14 +143,11 @@ LoadResult applyLoad(scxt::engine::Engine &engine, const std::vector<LoadStep> &
             r.error = "File not found: " + s.path.u8string();
             return r;
         }
-        size_t bytes = 0;
-        auto h = fnv1aFile(s.path, bytes);
-        r.totalFileBytes += bytes;
-        // fold per-file hash into composite (path|hash) so order-of-load matters
-        auto pathStr = s.path.u8string();
-        fnv1a(composite, pathStr.data(), pathStr.size());
-        fnv1a(composite, &h, sizeof(h));
+    }
 
+    for (const auto &s : steps)
+    {
+        auto t0 = std::chrono::steady_clock::now();
         switch (s.kind)
         {
         case LoadStep::LoadMulti:
@@ -176,9 +183,24 @@ LoadResult applyLoad(scxt::engine::Engine &engine, const std::vector<LoadStep> &
             }
             break;
         }
+        auto t1 = std::chrono::steady_clock::now();
+        r.stepMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        r.wallMs += r.stepMs.back();
+    }
+
+    // Hash after loading, not before, so reading the files here can't warm the
+    // cache for a cold-cache load run.
+    uint64_t composite = kFnvOffsetBasis;
+    for (const auto &s : steps)
+    {
+        size_t bytes = 0;
+        auto h = fnv1aFile(s.path, bytes);
+        r.totalFileBytes += bytes;
+        // fold per-file hash into composite (path|hash) so order-of-load matters
+        auto pathStr = s.path.u8string();
+        fnv1a(composite, pathStr.data(), pathStr.size());
+        fnv1a(composite, &h, sizeof(h));
     }
-    auto t1 = std::chrono::steady_clock::now();
-    r.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
     r.fileHash = composite;
     r.ok = true;
     countStructure(engine, r);
@@ -46,12 +46,19 @@ struct LoadResult
 {
     bool ok{false};
     std::string error;
-    double wallMs{0};
+    double wallMs{0};            // sum of stepMs; the harness's own file hashing is excluded
+    std::vector<double> stepMs; // one per LoadStep, in order
     int numParts{0}, numGroups{0}, numZones{0}, numSamples{0};
     uint64_t fileHash{0};     // FNV-1a over the union of loaded files' bytes
     size_t totalFileBytes{0}; // sum of loaded source-file sizes (proxy for instrument size)
 };
 
+// Sample rate, and 12-TET so MTS-ESP retuning doesn't show up in the perf profile.
+// Call before applyLoad.
+void prepareEngine(scxt::engine::Engine &, const EngineConfig &);
+// Settings a loaded multi would otherwise overwrite. Call after applyLoad.
+void applyPostLoadEngineConfig(scxt::engine::Engine &, const EngineConfig &);
+
 LoadResult applyLoad(scxt::engine::Engine &, const std::vector<LoadStep> &);
 
 } // namespace scxt::perf
@@ -25,6 +25,7 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
 #include <cstring>
 #include <exception>
 #include <filesystem>
@@ -34,10 +35,13 @@
 
 #include "configuration.h"
 #include "engine/engine.h"
+#include "infrastructure/realtime_safety.h"
 
 #include "perf_config.h"
 #include "perf_generator.h"
+#include "perf_load_bench.h"
 #include "perf_loader.h"
+#include "perf_multi.h"
 #include "perf_report.h"
 #include "perf_runner.h"
 
@@ -45,18 +49,50 @@ namespace
 {
 void printUsage(const char *argv0)
 {
-    fmt::print("Usage: {} <config.json> [--mode measure|profile] [--iters N] [--out path]\n",
+    fmt::print("Usage: {} <config.json> [--mode measure|profile|load|multi_instance] [--iters N]\n",
                argv0);
+    fmt::print("             [--out path] [--instances N] [--threads M]\n");
     fmt::print("             [--wav path] [--wait-for-key] [--profile-iters N] [--realtime]\n");
+    fmt::print("             [--host-block N] [--file-cache warm|cold]\n");
     fmt::print("\n");
-    fmt::print("Runs a scxt-core scenario described by <config.json>. Two modes:\n");
+    fmt::print("Runs a scxt-core scenario described by <config.json>. Modes:\n");
     fmt::print("  measure  warmup + N iterations, per-block timing, JSON report + fingerprint\n");
     fmt::print("  profile  loop the scenario for profiler attach; --wait-for-key prompts\n");
     fmt::print("           before entering the loop and prints PID for attaching;\n");
     fmt::print("           --profile-iters caps the loop (0/default = forever)\n");
+    fmt::print("  load     warmup + N timed loads into fresh engines; per-phase times, RSS,\n");
+    fmt::print("           sample memory and allocation counts. --file-cache cold evicts the\n");
+    fmt::print("           files from the OS cache before each iteration (Linux only)\n");
+    fmt::print("  multi_instance  --instances engines in one process on --threads threads;\n");
+    fmt::print("           aggregate realtime ratio, per-instance tails and scaling\n");
+    fmt::print("           efficiency against a lone engine\n");
     fmt::print("\n");
     fmt::print("  --realtime  request realtime thread priority (USER_INTERACTIVE qos on macOS,\n");
     fmt::print("              SCHED_FIFO on Linux — needs CAP_SYS_NICE or root)\n");
+    fmt::print("  --host-block  feed the engine through host buffers of N frames, split into\n");
+    fmt::print("                engine blocks as the plugin does (0 = drive blocks directly)\n");
+}
+
+// In a realtime safety tracking build a successful run still fails if the audio
+// thread allocated, locked or touched a file along the way.
+int checkRealtimeSafety(int result)
+{
+    namespace rt = scxt::infrastructure::realtime;
+    if constexpr (!rt::trackingEnabled)
+        return result;
+
+    auto n = rt::violationCount();
+    if (n == 0)
+    {
+        fmt::print("  realtime safety: clean\n");
+        return result;
+    }
+    fmt::print(stderr, "REALTIME SAFETY: {} violation(s) on the audio thread\n", n);
+    for (const auto &r : rt::recordedViolations())
+        fmt::print(stderr, "    {}\n", rt::describe(r));
+    if (n > rt::maxRecorded)
+        fmt::print(stderr, "    ... and {} more\n", n - rt::maxRecorded);
+    return result == 0 ? 3 : result;
 }
 } // namespace
 
@@ -108,8 +144,10 @@ int main(int argc, char **argv)
         if (a == "--mode")
         {
             std::string m = next();
-            cfg.run.mode =
-                (m == "profile") ? scxt::perf::RunConfig::Profile : scxt::perf::RunConfig::Measure;
+            cfg.run.mode = (m == "profile") ? scxt::perf::RunConfig::Profile
+                           : (m == "load")  ? scxt::perf::RunConfig::Load
+                           : (m == "multi_instance") ? scxt::perf::RunConfig::MultiInstance
+                                                     : scxt::perf::RunConfig::Measure;
         }
         else if (a == "--iters")
         {
@@ -135,6 +173,24 @@ int main(int argc, char **argv)
         {
             cfg.run.audioThreadPriority = scxt::perf::RunConfig::RealtimePriority;
         }
+        else if (a == "--file-cache")
+        {
+            std::string fc = next();
+            cfg.run.fileCache = (fc == "cold") ? scxt::perf::RunConfig::ColdCache
+                                               : scxt::perf::RunConfig::WarmCache;
+        }
+        else if (a == "--instances")
+        {
+            cfg.run.instances = std::max(1, std::atoi(next()));
+        }
+        else if (a == "--threads")
+        {
+            cfg.run.threads = std::max(1, std::atoi(next()));
+        }
+        else if (a == "--host-block")
+        {
+            cfg.engine.hostBlockSize = std::max(0, std::atoi(next()));
+        }
         else
         {
             fmt::print(stderr, "Unknown arg: {}\n", a);
@@ -142,12 +198,48 @@ int main(int argc, char **argv)
         }
     }
 
-    scxt::engine::Engine engine;
-    engine.prepareToPlay(cfg.engine.sampleRate);
+    if (cfg.run.mode == scxt::perf::RunConfig::Load)
+    {
+        auto bench = scxt::perf::runLoadBenchmark(cfg);
+        if (!bench.ok)
+        {
+            fmt::print(stderr, "Load failed: {}\n", bench.error);
+            return 2;
+        }
+        scxt::perf::printLoadConsoleSummary(cfg, bench);
+        scxt::perf::writeLoadReport(cfg.run.reportPath, cfg, bench);
+        fmt::print("  report         : {}\n", cfg.run.reportPath);
+        return checkRealtimeSafety(0);
+    }
+
+    scxt::perf::BakedSequence seq;
+    try
+    {
+        seq = scxt::perf::bake(cfg.sequence, cfg.engine.sampleRate, scxt::blockSize,
+                               cfg.run.tailSilenceS);
+    }
+    catch (const std::exception &e)
+    {
+        fmt::print(stderr, "Failed to build sequence: {}\n", e.what());
+        return 1;
+    }
+
+    if (cfg.run.mode == scxt::perf::RunConfig::MultiInstance)
+    {
+        auto multi = scxt::perf::runMultiInstance(cfg, seq);
+        if (!multi.ok)
+        {
+            fmt::print(stderr, "Load failed: {}\n", multi.error);
+            return 2;
+        }
+        scxt::perf::printMultiConsoleSummary(cfg, multi);
+        scxt::perf::writeMultiReport(cfg.run.reportPath, cfg, multi);
+        fmt::print("  report         : {}\n", cfg.run.reportPath);
+        return checkRealtimeSafety(0);
+    }
 
-    // Force 12-TET so MTS-ESP retuning doesn't show up in the perf profile.
-    engine.runtimeConfig.tuningMode = scxt::engine::Engine::TuningMode::TWELVE_TET;
-    engine.resetTuningFromRuntimeConfig();
+    scxt::engine::Engine engine;
+    scxt::perf::prepareEngine(engine, cfg.engine);
 
     auto load = scxt::perf::applyLoad(engine, cfg.load);
     if (!load.ok)
@@ -156,16 +248,15 @@ int main(int argc, char **argv)
         return 2;
     }
 
-    auto seq = scxt::perf::bake(cfg.sequence, cfg.engine.sampleRate, scxt::blockSize,
-                                cfg.run.tailSilenceS);
+    scxt::perf::applyPostLoadEngineConfig(engine, cfg.engine);
 
     if (cfg.run.mode == scxt::perf::RunConfig::Profile)
     {
-        scxt::perf::runProfile(engine, seq, cfg.run);
-        return 0;
+        scxt::perf::runProfile(engine, seq, cfg.run, cfg.engine.hostBlockSize);
+        return checkRealtimeSafety(0);
     }
 
-    auto run = scxt::perf::runMeasure(engine, seq, cfg.run);
+    auto run = scxt::perf::runMeasure(engine, seq, cfg.run, cfg.engine.hostBlockSize);
 
     scxt::perf::printConsoleSummary(cfg, load, run);
     scxt::perf::writeReport(cfg.run.reportPath, cfg, load, run);
@@ -177,5 +268,5 @@ int main(int argc, char **argv)
         fmt::print("  wav            : {} ({} interleaved floats)\n", *cfg.run.wavOutputPath,
                    run.wavInterleaved.size());
     }
-    return 0;
+    return checkRealtimeSafety(0);
 }
@@ -0,0 +1,269 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "perf_midifile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace scxt::perf
+{
+
+namespace
+{
+struct Reader
+{
+    const std::vector<uint8_t> &buf;
+    size_t pos{0};
+    size_t end{0};
+
+    void need(size_t n) const
+    {
+        if (pos + n > end)
+            throw std::runtime_error("MIDI file truncated at byte " + std::to_string(pos));
+    }
+    uint8_t u8()
+    {
+        need(1);
+        return buf[pos++];
+    }
+    uint16_t u16()
+    {
+        need(2);
+        uint16_t r = (uint16_t)((buf[pos] << 8) | buf[pos + 1]);
+        pos += 2;
+        return r;
+    }
+    uint32_t u32()
+    {
+        need(4);
+        uint32_t r = ((uint32_t)buf[pos] << 24) | ((uint32_t)buf[pos + 1] << 16) |
+                     ((uint32_t)buf[pos + 2] << 8) | (uint32_t)buf[pos + 3];
+        pos += 4;
+        return r;
+    }
+    // SMF variable length quantity; at most 4 bytes by spec
+    uint32_t vlq()
+    {
+        uint32_t r{0};
+        for (int i = 0; i < 4; ++i)
+        {
+            auto b = u8();
+            r = (r << 7) | (b & 0x7f);
+            if (!(b & 0x80))
+                return r;
+        }
+        throw std::runtime_error("MIDI file has an over-long variable length quantity");
+    }
+    bool tag(const char *t)
+    {
+        need(4);
+        bool res = std::equal(t, t + 4, buf.begin() + pos);
+        pos += 4;
+        return res;
+    }
+    void skip(size_t n)
+    {
+        need(n);
+        pos += n;
+    }
+};
+
+struct TickEvent
+{
+    uint64_t tick{0};
+    int track{0};
+    size_t order{0};
+    bool isTempo{false};
+    uint32_t usPerQuarter{500000};
+    uint8_t data[3]{0, 0, 0};
+};
+
+int dataBytesFor(uint8_t status)
+{
+    auto hi = status & 0xf0;
+    return (hi == 0xc0 || hi == 0xd0) ? 1 : 2;
+}
+} // namespace
+
+std::vector<TimedMidi1> readStandardMidiFile(const std::filesystem::path &p)
+{
+    std::ifstream f(p, std::ios::binary);
+    if (!f)
+        throw std::runtime_error("Unable to open MIDI file " + p.u8string());
+    std::vector<uint8_t> buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    Reader r{buf, 0, buf.size()};
+    if (!r.tag("MThd"))
+        throw std::runtime_error("Not a Standard MIDI File (no MThd): " + p.u8string());
+    auto hdrLen = r.u32();
+    if (hdrLen < 6)
+        throw std::runtime_error("MIDI file header too short");
+    auto hdrEnd = r.pos + hdrLen;
+    r.u16(); // format; 0, 1 and 2 all merge the same way for playback
+    auto nTracks = r.u16();
+    auto division = r.u16();
+    r.pos = hdrEnd;
+
+    std::vector<TickEvent> evs;
+    size_t order{0};
+    for (int tr = 0; tr < nTracks && r.pos < buf.size(); ++tr)
+    {
+        auto isTrack = r.tag("MTrk");
+        auto len = r.u32();
+        if (!isTrack)
+        {
+            // Unknown chunks are allowed by the spec and must be skipped
+            r.skip(len);
+            --tr;
+            continue;
+        }
+        r.need(len);
+        Reader t{buf, r.pos, r.pos + len};
+        r.pos += len;
+
+        uint64_t tick{0};
+        uint8_t running{0};
+        while (t.pos < t.end)
+        {
+            tick += t.vlq();
+            auto b = t.u8();
+            if (b == 0xff)
+            {
+                auto type = t.u8();
+                auto mlen = t.vlq();
+                if (type == 0x51 && mlen == 3)
+                {
+                    TickEvent e;
+                    e.tick = tick;
+                    e.track = tr;
+                    e.order = order++;
+                    e.isTempo = true;
+                    e.usPerQuarter = ((uint32_t)t.u8() << 16);
+                    e.usPerQuarter |= ((uint32_t)t.u8() << 8);
+                    e.usPerQuarter |= (uint32_t)t.u8();
+                    evs.push_back(e);
+                }
+                else if (type == 0x2f)
+                {
+                    t.skip(mlen);
+                    break;
+                }
+                else
+                {
+                    t.skip(mlen);
+                }
+                continue;
+            }
+            if (b == 0xf0 || b == 0xf7)
+            {
+                // sysex cancels running status
+                t.skip(t.vlq());
+                running = 0;
+                continue;
+            }
+
+            uint8_t status{b};
+            bool haveFirst{false};
+            uint8_t first{0};
+            if (b & 0x80)
+            {
+                running = b;
+            }
+            else
+            {
+                if (!running)
+                    throw std::runtime_error("MIDI file uses running status with no prior status");
+                status = running;
+                first = b;
+                haveFirst = true;
+            }
+
+            TickEvent e;
+            e.tick = tick;
+            e.track = tr;
+            e.order = order++;
+            e.data[0] = status;
+            e.data[1] = haveFirst ? first : t.u8();
+            if (dataBytesFor(status) == 2)
+                e.data[2] = t.u8();
+            evs.push_back(e);
+        }
+    }
+
+    std::stable_sort(evs.begin(), evs.end(), [](const auto &a, const auto &b) {
+        if (a.tick != b.tick)
+            return a.tick < b.tick;
+        return a.order < b.order;
+    });
+
+    // Walk the merged list accumulating seconds through the tempo map. SMPTE
+    // divisions (top bit set) are fixed-rate and ignore tempo events.
+    double secPerTick{0};
+    bool smpte = division & 0x8000;
+    if (smpte)
+    {
+        auto fps = -(int8_t)(division >> 8);
+        auto tpf = division & 0xff;
+        if (fps <= 0 || tpf == 0)
+            throw std::runtime_error("MIDI file has an invalid SMPTE division");
+        // 29 means 29.97 drop frame
+        secPerTick = 1.0 / ((fps == 29 ? 29.97 : fps) * tpf);
+    }
+    else
+    {
+        if (division == 0)
+            throw std::runtime_error("MIDI file has zero ticks per quarter note");
+        secPerTick = 0.5 / division;
+    }
+
+    std::vector<TimedMidi1> res;
+    res.reserve(evs.size());
+    uint64_t lastTick{0};
+    double sec{0};
+    for (const auto &e : evs)
+    {
+        sec += (e.tick - lastTick) * secPerTick;
+        lastTick = e.tick;
+        if (e.isTempo)
+        {
+            if (!smpte)
+                secPerTick = e.usPerQuarter * 1e-6 / division;
+            continue;
+        }
+        TimedMidi1 m;
+        m.t = sec;
+        std::copy(e.data, e.data + 3, m.data);
+        res.push_back(m);
+    }
+    return res;
+}
+
+} // namespace scxt::perf
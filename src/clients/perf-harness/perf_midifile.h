@@ -0,0 +1,55 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_MIDIFILE_H
+#define SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_MIDIFILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace scxt::perf
+{
+
+// One channel-voice message from a Standard MIDI File, with its tick position
+// already run through the file's tempo map. Running status is expanded, so data[0]
+// is always a status byte; 2-byte messages (program change, channel pressure)
+// leave data[2] at zero so the bytes can go straight to Engine::processMIDI1Event.
+struct TimedMidi1
+{
+    double t{0};
+    uint8_t data[3]{0, 0, 0};
+};
+
+// Reads SMF format 0 and 1 (format 2 is read as if it were 1). All tracks are
+// merged; meta events other than tempo and sysex are skipped. Throws
+// std::runtime_error on a malformed file. Result is sorted by time, with ties kept
+// in track-then-file order so a CC written before a note-on still precedes it.
+std::vector<TimedMidi1> readStandardMidiFile(const std::filesystem::path &);
+
+} // namespace scxt::perf
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "perf_multi.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "configuration.h"
+#include "engine/engine.h"
+
+namespace scxt::perf
+{
+
+namespace
+{
+double medianOf(std::vector<double> v)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+} // namespace
+
+MultiRunResult runMultiInstance(const Config &cfg, const BakedSequence &seq)
+{
+    MultiRunResult r;
+    r.instances = cfg.run.instances;
+    r.threads = std::min(cfg.run.threads, cfg.run.instances);
+    r.scenario.sampleRate = seq.sampleRate;
+    r.scenario.blockSize = scxt::blockSize;
+    r.scenario.hostBlockSize = std::max(cfg.engine.hostBlockSize, 0);
+    r.scenario.totalBlocks = seq.totalBlocks;
+    r.scenario.totalSeconds = seq.totalBlocks * scxt::blockSize / seq.sampleRate;
+
+    // Construct and load serially: the point is to measure rendering contention, and
+    // engine construction touches the same process-wide tables a host would build
+    // once per plugin load.
+    std::vector<std::unique_ptr<scxt::engine::Engine>> engines;
+    for (int i = 0; i < r.instances; ++i)
+    {
+        auto e = std::make_unique<scxt::engine::Engine>();
+        prepareEngine(*e, cfg.engine);
+        auto l = applyLoad(*e, cfg.load);
+        if (!l.ok)
+        {
+            r.error = l.error;
+            return r;
+        }
+        applyPostLoadEngineConfig(*e, cfg.engine);
+        if (i == 0)
+            r.load = l;
+        engines.push_back(std::move(e));
+    }
+    std::cout << "scxt-perf: multi-instance, " << r.instances << " engine(s) on " << r.threads
+              << " thread(s)" << std::endl;
+
+    // Baseline: instance 0 alone, same iteration counts as the contended run
+    {
+        if (cfg.run.audioThreadPriority == RunConfig::RealtimePriority)
+            requestRealtimePriority();
+        std::vector<double> ratios;
+        for (int i = 0; i < cfg.run.warmupIterations + cfg.run.measureIterations; ++i)
+        {
+            SequencePlayer p(*engines[0], seq, cfg.engine.hostBlockSize);
+            auto t0 = std::chrono::steady_clock::now();
+            while (!p.done())
+                p.step();
+            auto t1 = std::chrono::steady_clock::now();
+            drainToQuiescence(*engines[0]);
+            if (i >= cfg.run.warmupIterations)
+                ratios.push_back(r.scenario.totalSeconds /
+                                 std::chrono::duration<double>(t1 - t0).count());
+        }
+        r.baselineRealtimeRatio = medianOf(ratios);
+        std::cout << "  baseline (1 engine, 1 thread): realtime=" << r.baselineRealtimeRatio << "x"
+                  << std::endl;
+    }
+
+    auto runOne = [&](bool capture) {
+        MultiIterationStats st;
+        st.instances.resize(r.instances);
+
+        std::vector<std::unique_ptr<SequencePlayer>> players;
+        std::vector<Fingerprint> fps(capture ? r.instances : 0);
+        for (int i = 0; i < r.instances; ++i)
+        {
+            auto p = std::make_unique<SequencePlayer>(*engines[i], seq, cfg.engine.hostBlockSize);
+            p->blockNs = &st.instances[i].blockNs;
+            if (capture)
+            {
+                fps[i].configure(seq.sampleRate, scxt::blockSize);
+                p->fingerprint = &fps[i];
+            }
+            p->reserveSinks();
+            players.push_back(std::move(p));
+        }
+
+        // Each thread owns engines t, t + threads, ... and advances all of them one
+        // tick at a time, the way a host's worker walks its plugin instances each
+        // buffer. Threads spin on `go` so thread startup isn't in the window.
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::chrono::steady_clock::time_point> finished(r.threads);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < r.threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                if (cfg.run.audioThreadPriority == RunConfig::RealtimePriority)
+                    requestRealtimePriority();
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+
+                bool any{true};
+                while (any)
+                {
+                    any = false;
+                    for (int i = t; i < r.instances; i += r.threads)
+                    {
+                        if (!players[i]->done())
+                        {
+                            players[i]->step();
+                            any = true;
+                        }
+                    }
+                }
+                finished[t] = std::chrono::steady_clock::now();
+            });
+        }
+        while (ready.load() < r.threads)
+            std::this_thread::yield();
+        auto t0 = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto &w : workers)
+            w.join();
+        auto t1 = *std::max_element(finished.begin(), finished.end());
+
+        st.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        st.aggregateRealtimeRatio = r.instances * r.scenario.totalSeconds / (st.wallMs / 1000.0);
+        for (int i = 0; i < r.instances; ++i)
+        {
+            st.instances[i].peakVoices = players[i]->peakVoices;
+            if (capture)
+            {
+                fps[i].finalize();
+                st.instances[i].exactFingerprint = fps[i].exact;
+                if (fps[i].exact != fps[0].exact)
+                    r.fingerprintsMatch = false;
+            }
+        }
+
+        for (auto &e : engines)
+            drainToQuiescence(*e);
+        return st;
+    };
+
+    for (int i = 0; i < cfg.run.warmupIterations; ++i)
+    {
+        auto st = runOne(false);
+        std::cout << "  warmup  " << (i + 1) << "/" << cfg.run.warmupIterations
+                  << ": wall=" << st.wallMs << "ms  aggregate realtime="
+                  << st.aggregateRealtimeRatio << "x" << std::endl;
+        r.warmupIterations.push_back(std::move(st));
+    }
+    for (int i = 0; i < cfg.run.measureIterations; ++i)
+    {
+        auto st = runOne(i == 0);
+        std::cout << "  measure " << (i + 1) << "/" << cfg.run.measureIterations
+                  << ": wall=" << st.wallMs << "ms  aggregate realtime="
+                  << st.aggregateRealtimeRatio << "x" << std::endl;
+        r.measureIterations.push_back(std::move(st));
+    }
+
+    r.ok = true;
+    return r;
+}
+
+} // namespace scxt::perf
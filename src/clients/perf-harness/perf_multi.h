@@ -0,0 +1,81 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_MULTI_H
+#define SCXT_SRC_CLIENTS_PERF_HARNESS_PERF_MULTI_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "perf_config.h"
+#include "perf_generator.h"
+#include "perf_loader.h"
+#include "perf_runner.h"
+
+namespace scxt::perf
+{
+
+struct InstanceStats
+{
+    uint32_t peakVoices{0};
+    std::vector<int64_t> blockNs; // this instance's processAudio calls
+    uint64_t exactFingerprint{0}; // first measure iteration only
+};
+
+struct MultiIterationStats
+{
+    double wallMs{0};                  // first thread released to last thread done
+    double aggregateRealtimeRatio{0};  // instances * scenario seconds / wall seconds
+    std::vector<InstanceStats> instances;
+};
+
+struct MultiRunResult
+{
+    bool ok{false};
+    std::string error;
+    int instances{0};
+    int threads{0}; // effective, after clamping to instances
+    ScenarioStats scenario;
+    LoadResult load; // instance 0's; all instances load the same steps
+
+    // One engine on the calling thread, no other instance running; the reference
+    // scaling efficiency is measured against.
+    double baselineRealtimeRatio{0};
+
+    std::vector<MultiIterationStats> warmupIterations;
+    std::vector<MultiIterationStats> measureIterations;
+
+    // Every instance renders the same scenario, so any divergence is shared state
+    // leaking between engines.
+    bool fingerprintsMatch{true};
+};
+
+MultiRunResult runMultiInstance(const Config &, const BakedSequence &);
+
+} // namespace scxt::perf
+#endif
@@ -28,6 +28,7 @@
 #include "perf_report.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -98,6 +99,16 @@ tao::json::value iterToJson(const IterationStats &s)
     bn["p99"] = percentile(s.blockNs, 0.99);
     bn["max"] = percentile(s.blockNs, 1.0);
     v["block_ns"] = std::move(bn);
+    if (!s.hostBufferNs.empty())
+    {
+        tao::json::value hn(tao::json::empty_object);
+        hn["mean"] = mean(s.hostBufferNs);
+        hn["p50"] = percentile(s.hostBufferNs, 0.50);
+        hn["p95"] = percentile(s.hostBufferNs, 0.95);
+        hn["p99"] = percentile(s.hostBufferNs, 0.99);
+        hn["max"] = percentile(s.hostBufferNs, 1.0);
+        v["host_buffer_ns"] = std::move(hn);
+    }
     return v;
 }
 
@@ -118,18 +129,9 @@ tao::json::value fingerprintToJson(const Fingerprint &fp)
     v["tolerant"] = std::move(tol);
     return v;
 }
-} // namespace
 
-void writeReport(const std::filesystem::path &out, const Config &cfg, const LoadResult &load,
-                 const RunResult &run)
+tao::json::value hostToJson()
 {
-    tao::json::value v(tao::json::empty_object);
-    v["scxt_version"] = sst::plugininfra::VersionInformation::project_version_and_hash;
-#ifdef NDEBUG
-    v["scxt_build_type"] = "Release";
-#else
-    v["scxt_build_type"] = "Debug";
-#endif
     tao::json::value host(tao::json::empty_object);
     host["hardware_concurrency"] = (int)std::thread::hardware_concurrency();
 #if defined(__APPLE__)
@@ -141,11 +143,11 @@ void writeReport(const std::filesystem::path &out, const Config &cfg, const Load
 #else
     host["os"] = "Unknown";
 #endif
-    v["host"] = std::move(host);
-
-    v["config_name"] = cfg.name;
-    v["config_hash"] = fmt::format("{:016x}", hashConfig(cfg));
+    return host;
+}
 
+tao::json::value loadResultToJson(const LoadResult &load)
+{
     tao::json::value loadJ(tao::json::empty_object);
     loadJ["wall_ms"] = load.wallMs;
     loadJ["file_hash"] = fmt::format("{:016x}", load.fileHash);
@@ -154,13 +156,102 @@ void writeReport(const std::filesystem::path &out, const Config &cfg, const Load
     loadJ["num_groups"] = load.numGroups;
     loadJ["num_zones"] = load.numZones;
     loadJ["num_samples"] = load.numSamples;
-    v["load"] = std::move(loadJ);
+    return loadJ;
+}
+
+tao::json::value loadIterToJson(const LoadIterationStats &s)
+{
+    using lt = infrastructure::LoadTimings;
+    tao::json::value v(tao::json::empty_object);
+    v["wall_ms"] = s.load.wallMs;
+    tao::json::value steps(tao::json::empty_array);
+    for (auto ms : s.load.stepMs)
+        steps.push_back(ms);
+    v["step_ms"] = std::move(steps);
+    tao::json::value phases(tao::json::empty_object);
+    for (int i = 0; i < lt::numPhases; ++i)
+        phases[lt::phaseName((lt::Phase)i)] =
+            tao::json::value{{"ms", s.phaseMs[i]}, {"entries", s.phaseEntries[i]}};
+    v["phases"] = std::move(phases);
+    v["allocations"] = s.allocations;
+    v["allocated_bytes"] = s.allocatedBytes;
+    v["rss_before_bytes"] = s.rssBeforeBytes;
+    v["rss_after_bytes"] = s.rssAfterBytes;
+    v["peak_rss_bytes"] = s.peakRSSBytes;
+    v["sample_memory_bytes"] = (int64_t)s.sampleMemoryBytes;
+    v["evicted_files"] = s.evictedFiles;
+    return v;
+}
+
+tao::json::value scenarioToJson(const ScenarioStats &sc)
+{
+    tao::json::value v(tao::json::empty_object);
+    v["sample_rate"] = sc.sampleRate;
+    v["block_size"] = sc.blockSize;
+    v["host_block_size"] = sc.hostBlockSize;
+    v["total_blocks"] = sc.totalBlocks;
+    v["total_seconds"] = sc.totalSeconds;
+    return v;
+}
+
+double scalingEfficiency(const MultiRunResult &m, double aggregateRatio)
+{
+    auto ideal = m.baselineRealtimeRatio * m.threads;
+    return ideal > 0 ? aggregateRatio / ideal : 0;
+}
+
+tao::json::value multiIterToJson(const MultiRunResult &m, const MultiIterationStats &s)
+{
+    tao::json::value v(tao::json::empty_object);
+    v["wall_ms"] = s.wallMs;
+    v["aggregate_realtime_ratio"] = s.aggregateRealtimeRatio;
+    v["scaling_efficiency"] = scalingEfficiency(m, s.aggregateRealtimeRatio);
+    tao::json::value insts(tao::json::empty_array);
+    for (const auto &i : s.instances)
+    {
+        tao::json::value iv(tao::json::empty_object);
+        iv["peak_voices"] = (int64_t)i.peakVoices;
+        tao::json::value bn(tao::json::empty_object);
+        bn["mean"] = mean(i.blockNs);
+        bn["p50"] = percentile(i.blockNs, 0.50);
+        bn["p99"] = percentile(i.blockNs, 0.99);
+        bn["max"] = percentile(i.blockNs, 1.0);
+        iv["block_ns"] = std::move(bn);
+        if (i.exactFingerprint)
+            iv["exact_fnv1a"] = fmt::format("{:016x}", i.exactFingerprint);
+        insts.push_back(std::move(iv));
+    }
+    v["instances"] = std::move(insts);
+    return v;
+}
+
+void writePretty(const std::filesystem::path &out, const tao::json::value &v)
+{
+    std::ofstream f(out);
+    tao::json::events::to_pretty_stream consumer(f, 2);
+    tao::json::events::from_value(consumer, v);
+    f << "\n";
+}
+} // namespace
+
+void writeReport(const std::filesystem::path &out, const Config &cfg, const LoadResult &load,
+                 const RunResult &run)
+{
+    tao::json::value v(tao::json::empty_object);
+    v["scxt_version"] = sst::plugininfra::VersionInformation::project_version_and_hash;
+#ifdef NDEBUG
+    v["scxt_build_type"] = "Release";
+#else
+    v["scxt_build_type"] = "Debug";
+#endif
+    v["host"] = hostToJson();
+
+    v["config_name"] = cfg.name;
+    v["config_hash"] = fmt::format("{:016x}", hashConfig(cfg));
+
+    v["load"] = loadResultToJson(load);
 
-    tao::json::value sc(tao::json::empty_object);
-    sc["sample_rate"] = run.scenario.sampleRate;
-    sc["block_size"] = run.scenario.blockSize;
-    sc["total_blocks"] = run.scenario.totalBlocks;
-    sc["total_seconds"] = run.scenario.totalSeconds;
+    auto sc = scenarioToJson(run.scenario);
     uint32_t peakVoices = 0;
     for (const auto &it : run.measureIterations)
         peakVoices = std::max(peakVoices, it.peakVoices);
@@ -173,12 +264,14 @@ void writeReport(const std::filesystem::path &out, const Config &cfg, const Load
     v["warmup_iterations"] = std::move(warm);
 
     tao::json::value meas(tao::json::empty_array);
-    std::vector<double> wallMsList, p99List;
+    std::vector<double> wallMsList, p99List, hostP99List;
     for (const auto &it : run.measureIterations)
     {
         meas.push_back(iterToJson(it));
         wallMsList.push_back(it.wallMs);
         p99List.push_back(percentile(it.blockNs, 0.99));
+        if (!it.hostBufferNs.empty())
+            hostP99List.push_back(percentile(it.hostBufferNs, 0.99));
     }
     v["measure_iterations"] = std::move(meas);
 
@@ -186,14 +279,74 @@ void writeReport(const std::filesystem::path &out, const Config &cfg, const Load
     agg["wall_ms_median"] = median(wallMsList);
     agg["wall_ms_stddev"] = stddev(wallMsList);
     agg["block_ns_p99_median"] = median(p99List);
+    if (!hostP99List.empty())
+        agg["host_buffer_ns_p99_median"] = median(hostP99List);
     v["aggregate"] = std::move(agg);
 
     v["fingerprint"] = fingerprintToJson(run.fingerprint);
 
-    std::ofstream f(out);
-    tao::json::events::to_pretty_stream consumer(f, 2);
-    tao::json::events::from_value(consumer, v);
-    f << "\n";
+    writePretty(out, v);
+}
+
+void writeLoadReport(const std::filesystem::path &out, const Config &cfg,
+                     const LoadBenchResult &bench)
+{
+    using lt = infrastructure::LoadTimings;
+
+    tao::json::value v(tao::json::empty_object);
+    v["scxt_version"] = sst::plugininfra::VersionInformation::project_version_and_hash;
+#ifdef NDEBUG
+    v["scxt_build_type"] = "Release";
+#else
+    v["scxt_build_type"] = "Debug";
+#endif
+    v["host"] = hostToJson();
+    v["config_name"] = cfg.name;
+    v["config_hash"] = fmt::format("{:016x}", hashConfig(cfg));
+
+    // The structure and file hash are the same every iteration; report the first so
+    // diff_perf.py's file_hash check works on load reports too.
+    const auto &first = !bench.measureIterations.empty() ? bench.measureIterations.front()
+                                                         : bench.warmupIterations.front();
+    v["load"] = loadResultToJson(first.load);
+
+    tao::json::value lb(tao::json::empty_object);
+    lb["file_cache"] = cfg.run.fileCache == RunConfig::ColdCache ? "cold" : "warm";
+
+    tao::json::value warm(tao::json::empty_array);
+    for (const auto &it : bench.warmupIterations)
+        warm.push_back(loadIterToJson(it));
+    lb["warmup_iterations"] = std::move(warm);
+
+    tao::json::value meas(tao::json::empty_array);
+    std::vector<double> wallMsList, allocList;
+    std::array<std::vector<double>, lt::numPhases> phaseLists;
+    int64_t peakRSS{0};
+    for (const auto &it : bench.measureIterations)
+    {
+        meas.push_back(loadIterToJson(it));
+        wallMsList.push_back(it.load.wallMs);
+        allocList.push_back((double)it.allocations);
+        for (int i = 0; i < lt::numPhases; ++i)
+            phaseLists[i].push_back(it.phaseMs[i]);
+        peakRSS = std::max(peakRSS, it.peakRSSBytes);
+    }
+    lb["measure_iterations"] = std::move(meas);
+
+    tao::json::value agg(tao::json::empty_object);
+    agg["wall_ms_median"] = median(wallMsList);
+    agg["wall_ms_stddev"] = stddev(wallMsList);
+    tao::json::value ph(tao::json::empty_object);
+    for (int i = 0; i < lt::numPhases; ++i)
+        ph[lt::phaseName((lt::Phase)i)] = median(phaseLists[i]);
+    agg["phase_ms_median"] = std::move(ph);
+    agg["allocations_median"] = median(allocList);
+    agg["peak_rss_bytes"] = peakRSS;
+    agg["sample_memory_bytes"] = (int64_t)first.sampleMemoryBytes;
+    lb["aggregate"] = std::move(agg);
+    v["load_benchmark"] = std::move(lb);
+
+    writePretty(out, v);
 }
 
 void writeWavFloat32(const std::filesystem::path &out, const std::vector<float> &interleaved,
@@ -239,6 +392,8 @@ void printConsoleSummary(const Config &cfg, const LoadResult &load, const RunRes
                load.wallMs, load.numParts, load.numGroups, load.numZones, load.numSamples);
     fmt::print("  scenario       : sr={}  bs={}  blocks={}  ({:.3f}s)\n", run.scenario.sampleRate,
                run.scenario.blockSize, run.scenario.totalBlocks, run.scenario.totalSeconds);
+    if (run.scenario.hostBlockSize > 0)
+        fmt::print("  host buffer    : {} frames\n", run.scenario.hostBlockSize);
     fmt::print("  warmup iters   : {}\n", run.warmupIterations.size());
     for (const auto &it : run.measureIterations)
     {
@@ -251,4 +406,102 @@ void printConsoleSummary(const Config &cfg, const LoadResult &load, const RunRes
                run.fingerprint.zeroCrossings);
 }
 
+void writeMultiReport(const std::filesystem::path &out, const Config &cfg,
+                      const MultiRunResult &multi)
+{
+    tao::json::value v(tao::json::empty_object);
+    v["scxt_version"] = sst::plugininfra::VersionInformation::project_version_and_hash;
+#ifdef NDEBUG
+    v["scxt_build_type"] = "Release";
+#else
+    v["scxt_build_type"] = "Debug";
+#endif
+    v["host"] = hostToJson();
+    v["config_name"] = cfg.name;
+    v["config_hash"] = fmt::format("{:016x}", hashConfig(cfg));
+    v["load"] = loadResultToJson(multi.load);
+    v["scenario"] = scenarioToJson(multi.scenario);
+
+    tao::json::value mi(tao::json::empty_object);
+    mi["instances"] = multi.instances;
+    mi["threads"] = multi.threads;
+    mi["baseline_realtime_ratio"] = multi.baselineRealtimeRatio;
+    mi["fingerprints_match"] = multi.fingerprintsMatch;
+
+    tao::json::value warm(tao::json::empty_array);
+    for (const auto &it : multi.warmupIterations)
+        warm.push_back(multiIterToJson(multi, it));
+    mi["warmup_iterations"] = std::move(warm);
+
+    tao::json::value meas(tao::json::empty_array);
+    std::vector<double> ratios, wallMsList, worstP99, instP99;
+    for (const auto &it : multi.measureIterations)
+    {
+        meas.push_back(multiIterToJson(multi, it));
+        ratios.push_back(it.aggregateRealtimeRatio);
+        wallMsList.push_back(it.wallMs);
+        double worst{0};
+        for (const auto &i : it.instances)
+        {
+            auto p = percentile(i.blockNs, 0.99);
+            worst = std::max(worst, p);
+            instP99.push_back(p);
+        }
+        worstP99.push_back(worst);
+    }
+    mi["measure_iterations"] = std::move(meas);
+
+    tao::json::value agg(tao::json::empty_object);
+    agg["wall_ms_median"] = median(wallMsList);
+    agg["wall_ms_stddev"] = stddev(wallMsList);
+    agg["aggregate_realtime_ratio_median"] = median(ratios);
+    agg["scaling_efficiency_median"] = scalingEfficiency(multi, median(ratios));
+    agg["instance_block_ns_p99_median"] = median(instP99);
+    agg["worst_instance_block_ns_p99_median"] = median(worstP99);
+    mi["aggregate"] = std::move(agg);
+    v["multi_instance"] = std::move(mi);
+
+    writePretty(out, v);
+}
+
+void printMultiConsoleSummary(const Config &cfg, const MultiRunResult &multi)
+{
+    fmt::print("scxt-perf multi-instance  ({})\n", cfg.name.empty() ? "<unnamed>" : cfg.name);
+    fmt::print("  engines        : {} on {} thread(s)\n", multi.instances, multi.threads);
+    fmt::print("  baseline       : realtime={:5.1f}x (1 engine, 1 thread)\n",
+               multi.baselineRealtimeRatio);
+    for (const auto &it : multi.measureIterations)
+    {
+        double worst{0};
+        for (const auto &i : it.instances)
+            worst = std::max(worst, percentile(i.blockNs, 0.99));
+        fmt::print("  measure iter   : wall={:7.2f}ms  aggregate={:6.1f}x  efficiency={:5.1f}%  "
+                   "worst_p99={:.0f}ns\n",
+                   it.wallMs, it.aggregateRealtimeRatio,
+                   100.0 * scalingEfficiency(multi, it.aggregateRealtimeRatio), worst);
+    }
+    fmt::print("  fingerprints   : {}\n", multi.fingerprintsMatch
+                                               ? "all instances match"
+                                               : "INSTANCES DIFFER — shared state leaking?");
+}
+
+void printLoadConsoleSummary(const Config &cfg, const LoadBenchResult &bench)
+{
+    using lt = infrastructure::LoadTimings;
+    fmt::print("scxt-perf load  ({})\n", cfg.name.empty() ? "<unnamed>" : cfg.name);
+    fmt::print("  file cache     : {}\n",
+               cfg.run.fileCache == RunConfig::ColdCache ? "cold" : "warm");
+    fmt::print("  warmup iters   : {}\n", bench.warmupIterations.size());
+    for (const auto &it : bench.measureIterations)
+    {
+        fmt::print("  measure iter   : wall={:8.2f}ms ", it.load.wallMs);
+        for (int i = 0; i < lt::numPhases; ++i)
+            fmt::print(" {}={:.2f}", lt::phaseName((lt::Phase)i), it.phaseMs[i]);
+        fmt::print("\n");
+        fmt::print("                   allocs={}  sample_mem={:.1f}MB  peak_rss={:.1f}MB\n",
+                   it.allocations, it.sampleMemoryBytes / 1048576.0,
+                   it.peakRSSBytes / 1048576.0);
+    }
+}
+
 } // namespace scxt::perf
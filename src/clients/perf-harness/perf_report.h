@@ -31,7 +31,9 @@
 #include <filesystem>
 
 #include "perf_config.h"
+#include "perf_load_bench.h"
 #include "perf_loader.h"
+#include "perf_multi.h"
 #include "perf_runner.h"
 
 namespace scxt::perf
@@ -45,5 +47,13 @@ void writeWavFloat32(const std::filesystem::path &out, const std::vector<float>
 
 void printConsoleSummary(const Config &cfg, const LoadResult &load, const RunResult &run);
 
+void writeLoadReport(const std::filesystem::path &out, const Config &cfg,
+                     const LoadBenchResult &bench);
+void printLoadConsoleSummary(const Config &cfg, const LoadBenchResult &bench);
+
+void writeMultiReport(const std::filesystem::path &out, const Config &cfg,
+                      const MultiRunResult &multi);
+void printMultiConsoleSummary(const Config &cfg, const MultiRunResult &multi);
+
 } // namespace scxt::perf
 #endif
@@ -27,6 +27,7 @@
 
 #include "perf_runner.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 
@@ -48,6 +49,23 @@ namespace
 constexpr int kDrainExtraBlocks = 50;
 constexpr int kDrainSafetyCap = 1 << 18;
 
+void dispatchEvent(scxt::engine::Engine &engine, const MidiEvent &e, int32_t sampleOffset)
+{
+    switch (e.type)
+    {
+    case MidiEvent::NoteOn:
+        engine.processNoteOnEvent(0, e.channel, e.key, -1, e.velocity, 0.f, sampleOffset);
+        break;
+    case MidiEvent::NoteOff:
+        engine.processNoteOffEvent(0, e.channel, e.key, -1, 0.0);
+        break;
+    case MidiEvent::Midi1:
+        engine.processMIDI1Event(0, e.midi1, sampleOffset);
+        break;
+    }
+}
+} // namespace
+
 // Best-effort: log failures to stderr but never throw — realtime priority is
 // platform-dependent and may require elevated privileges (SCHED_FIFO on Linux
 // typically needs CAP_SYS_NICE or root). Falling back to default priority is
@@ -71,20 +89,6 @@ void requestRealtimePriority()
 #endif
 }
 
-void dispatchEventsAt(scxt::engine::Engine &engine, const BakedSequence &seq, size_t &evIdx,
-                      int64_t blockIdx)
-{
-    while (evIdx < seq.events.size() && seq.events[evIdx].first == blockIdx)
-    {
-        const auto &e = seq.events[evIdx].second;
-        if (e.type == MidiEvent::NoteOn)
-            engine.processNoteOnEvent(0, e.channel, e.key, -1, e.velocity, 0.f);
-        else
-            engine.processNoteOffEvent(0, e.channel, e.key, -1, 0.0);
-        ++evIdx;
-    }
-}
-
 int drainToQuiescence(scxt::engine::Engine &engine)
 {
     int blocks{0};
@@ -101,59 +105,146 @@ int drainToQuiescence(scxt::engine::Engine &engine)
     return blocks;
 }
 
-// runOneIteration is the CLAP-process-shaped loop. The three sinks are
-// optional so the same code path serves warmup, measurement, and profiling
-// without separate copies.
-IterationStats runOneIteration(scxt::engine::Engine &engine, const BakedSequence &seq,
-                               Fingerprint *fp, std::vector<int64_t> *blockNs,
-                               std::vector<float> *wavOut)
+SequencePlayer::SequencePlayer(scxt::engine::Engine &e, const BakedSequence &s, int hbs)
+    : engine(e), seq(s), hostBlockSize(std::max(hbs, 0)),
+      totalSamples(s.totalBlocks * scxt::blockSize)
+{
+    if (hostBlockSize > 0)
+        hostOut.resize(2 * hostBlockSize);
+}
+
+void SequencePlayer::reserveSinks()
 {
-    IterationStats s;
     if (blockNs)
         blockNs->reserve(seq.totalBlocks);
+    if (hostBufferNs && hostBlockSize > 0)
+        hostBufferNs->reserve(totalSamples / hostBlockSize + 1);
     if (wavOut)
         wavOut->reserve(seq.totalBlocks * scxt::blockSize * 2);
+}
 
-    size_t evIdx = 0;
-    uint32_t peak = 0;
+void SequencePlayer::reset()
+{
+    evIdx = 0;
+    pos = 0;
+    blockPos = 0;
+    peakVoices = 0;
+}
 
-    auto t0 = std::chrono::steady_clock::now();
-    for (int64_t b = 0; b < seq.totalBlocks; ++b)
+// Events are placed within the block starting at blockStart as the plugin places them
+void SequencePlayer::dispatchEventsThrough(int64_t lastSample, int64_t blockStart)
+{
+    while (evIdx < seq.events.size() && seq.events[evIdx].first <= lastSample)
+    {
+        using scxt::engine::Engine;
+        const auto &e = seq.events[evIdx].second;
+        auto isNoteOn = e.type == MidiEvent::NoteOn ||
+                        (e.type == MidiEvent::Midi1 && Engine::isMIDI1NoteOn(e.midi1));
+        auto offset = Engine::blockEventOffset(seq.events[evIdx].first, blockStart, isNoteOn);
+        if (!offset.has_value())
+            break;
+        dispatchEvent(engine, e, *offset);
+        ++evIdx;
+    }
+}
+
+void SequencePlayer::renderBlock()
+{
+    const auto &out = engine.getPatch()->busses.mainBus.output;
+
+    auto bt0 = std::chrono::steady_clock::now();
+    engine.processAudio();
+    auto bt1 = std::chrono::steady_clock::now();
+
+    if (fingerprint)
+        fingerprint->absorbBlock<scxt::blockSize>(out);
+    if (wavOut)
+        for (int i = 0; i < scxt::blockSize; ++i)
+        {
+            wavOut->push_back(out[0][i]);
+            wavOut->push_back(out[1][i]);
+        }
+    if (blockNs)
+        blockNs->push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(bt1 - bt0).count());
+
+    auto av = engine.activeVoices.load(std::memory_order_relaxed);
+    if (av > peakVoices)
+        peakVoices = av;
+}
+
+void SequencePlayer::step()
+{
+    if (hostBlockSize == 0)
     {
-        dispatchEventsAt(engine, seq, evIdx, b);
+        dispatchEventsThrough(pos + scxt::blockSize - 1, pos);
+        renderBlock();
+        pos += scxt::blockSize;
+        return;
+    }
 
-        auto bt0 = std::chrono::steady_clock::now();
-        engine.processAudio();
-        auto bt1 = std::chrono::steady_clock::now();
-
-        const auto &out = engine.getPatch()->busses.mainBus.output;
-        if (fp)
-            fp->absorbBlock<scxt::blockSize>(out);
-        if (wavOut)
-            for (int i = 0; i < scxt::blockSize; ++i)
-            {
-                wavOut->push_back(out[0][i]);
-                wavOut->push_back(out[1][i]);
-            }
-        if (blockNs)
-            blockNs->push_back(
-                std::chrono::duration_cast<std::chrono::nanoseconds>(bt1 - bt0).count());
-
-        auto av = engine.activeVoices.load(std::memory_order_relaxed);
-        if (av > peak)
-            peak = av;
+    /*
+     * Mirror SCXTPlugin::process_nonblock: walk each host buffer a frame at a time,
+     * and at every engine block boundary send the events of this buffer which are
+     * due, plus the note ons landing inside the block about to render with their
+     * offset into it. Events early in a buffer whose block began in the previous one
+     * are late and start at the next boundary; anything left is swept once the buffer
+     * is done. The last buffer may
+     * be short so the rendered block count doesn't depend on the host size.
+     */
+    const auto &out = engine.getPatch()->busses.mainBus.output;
+    auto n = std::min<int64_t>(hostBlockSize, totalSamples - pos);
+    auto ht0 = std::chrono::steady_clock::now();
+    for (int64_t f = 0; f < n; ++f)
+    {
+        if (blockPos == 0)
+        {
+            dispatchEventsThrough(std::min(pos + f + scxt::blockSize, pos + n) - 1, pos + f);
+            renderBlock();
+        }
+        hostOut[f] = out[0][blockPos];
+        hostOut[hostBlockSize + f] = out[1][blockPos];
+        blockPos = (blockPos + 1) & (scxt::blockSize - 1);
     }
+    dispatchEventsThrough(pos + n - 1, pos + n);
+    auto ht1 = std::chrono::steady_clock::now();
+    if (hostBufferNs)
+        hostBufferNs->push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(ht1 - ht0).count());
+    pos += n;
+}
+
+namespace
+{
+// runOneIteration is the CLAP-process-shaped loop. The sinks are optional so
+// the same code path serves warmup, measurement, and profiling without separate
+// copies.
+IterationStats runOneIteration(scxt::engine::Engine &engine, const BakedSequence &seq,
+                               int hostBlockSize, Fingerprint *fp, std::vector<int64_t> *blockNs,
+                               std::vector<int64_t> *hostBufferNs, std::vector<float> *wavOut)
+{
+    IterationStats s;
+    SequencePlayer player(engine, seq, hostBlockSize);
+    player.fingerprint = fp;
+    player.blockNs = blockNs;
+    player.hostBufferNs = hostBufferNs;
+    player.wavOut = wavOut;
+    player.reserveSinks();
+
+    auto t0 = std::chrono::steady_clock::now();
+    while (!player.done())
+        player.step();
     auto t1 = std::chrono::steady_clock::now();
 
     s.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
     auto sceneSec = seq.totalBlocks * scxt::blockSize / seq.sampleRate;
     s.realtimeRatio = sceneSec / (s.wallMs / 1000.0);
-    s.peakVoices = peak;
+    s.peakVoices = player.peakVoices;
     return s;
 }
 } // namespace
 
-RunResult runMeasure(scxt::engine::Engine &engine, const BakedSequence &seq, const RunConfig &cfg)
+RunResult runMeasure(scxt::engine::Engine &engine, const BakedSequence &seq, const RunConfig &cfg,
+                     int hostBlockSize)
 {
     if (cfg.audioThreadPriority == RunConfig::RealtimePriority)
         requestRealtimePriority();
@@ -161,6 +252,7 @@ RunResult runMeasure(scxt::engine::Engine &engine, const BakedSequence &seq, con
     RunResult r;
     r.scenario.sampleRate = seq.sampleRate;
     r.scenario.blockSize = scxt::blockSize;
+    r.scenario.hostBlockSize = std::max(hostBlockSize, 0);
     r.scenario.totalBlocks = seq.totalBlocks;
     r.scenario.totalSeconds = seq.totalBlocks * scxt::blockSize / seq.sampleRate;
     r.fingerprint.configure(seq.sampleRate, scxt::blockSize);
@@ -172,9 +264,11 @@ RunResult runMeasure(scxt::engine::Engine &engine, const BakedSequence &seq, con
     auto runOne = [&](bool capture, bool wantTiming) {
         Fingerprint *fpSink = capture ? &r.fingerprint : nullptr;
         std::vector<float> *wavSink = (capture && cfg.wavOutputPath) ? &r.wavInterleaved : nullptr;
-        std::vector<int64_t> blocks;
-        auto s = runOneIteration(engine, seq, fpSink, wantTiming ? &blocks : nullptr, wavSink);
+        std::vector<int64_t> blocks, hostBuffers;
+        auto s = runOneIteration(engine, seq, hostBlockSize, fpSink, wantTiming ? &blocks : nullptr,
+                                 wantTiming ? &hostBuffers : nullptr, wavSink);
         s.blockNs = std::move(blocks);
+        s.hostBufferNs = std::move(hostBuffers);
         s.drainBlocks = drainToQuiescence(engine);
         if (capture)
             r.fingerprint.finalize();
@@ -204,7 +298,8 @@ RunResult runMeasure(scxt::engine::Engine &engine, const BakedSequence &seq, con
     return r;
 }
 
-void runProfile(scxt::engine::Engine &engine, const BakedSequence &seq, const RunConfig &cfg)
+void runProfile(scxt::engine::Engine &engine, const BakedSequence &seq, const RunConfig &cfg,
+                int hostBlockSize)
 {
     if (cfg.audioThreadPriority == RunConfig::RealtimePriority)
         requestRealtimePriority();
@@ -219,7 +314,7 @@ void runProfile(scxt::engine::Engine &engine, const BakedSequence &seq, const Ru
     int it = 0;
     while (cfg.profileIterations == 0 || it < cfg.profileIterations)
     {
-        runOneIteration(engine, seq, nullptr, nullptr, nullptr);
+        runOneIteration(engine, seq, hostBlockSize, nullptr, nullptr, nullptr, nullptr);
         drainToQuiescence(engine);
         ++it;
     }
@@ -52,12 +52,16 @@ struct IterationStats
     // Block-time samples in nanoseconds (one entry per processAudio call within
     // the timed window). We keep them all for percentile computation.
     std::vector<int64_t> blockNs;
+    // Host-buffer mode only: wall time of each emulated process() call, which is
+    // what a host's CPU meter sees. Empty when driving the engine directly.
+    std::vector<int64_t> hostBufferNs;
 };
 
 struct ScenarioStats
 {
     double sampleRate{0};
     int blockSize{0};
+    int hostBlockSize{0}; // 0 = engine driven directly
     int64_t totalBlocks{0};
     double totalSeconds{0};
 };
@@ -72,8 +76,57 @@ struct RunResult
         wavInterleaved; // captured during the same fingerprint iter (if wav requested)
 };
 
-RunResult runMeasure(scxt::engine::Engine &, const BakedSequence &, const RunConfig &);
-void runProfile(scxt::engine::Engine &, const BakedSequence &, const RunConfig &);
+/*
+ * Plays a BakedSequence into one engine a tick at a time: one engine block when
+ * driving directly (hostBlockSize == 0), otherwise one host buffer split into engine
+ * blocks the way SCXTPlugin::process does. Sinks are optional and filled per engine
+ * block (blockNs, fingerprint, wav) or per host buffer (hostBufferNs). Separate
+ * players on separate engines share nothing, so the multi-instance mode runs one
+ * per engine.
+ */
+class SequencePlayer
+{
+  public:
+    SequencePlayer(scxt::engine::Engine &, const BakedSequence &, int hostBlockSize);
+
+    Fingerprint *fingerprint{nullptr};
+    std::vector<int64_t> *blockNs{nullptr};
+    std::vector<int64_t> *hostBufferNs{nullptr};
+    std::vector<float> *wavOut{nullptr};
+    uint32_t peakVoices{0};
+
+    void reserveSinks();
+    void reset();
+    bool done() const { return pos >= totalSamples; }
+    void step();
+
+  private:
+    void dispatchEventsThrough(int64_t lastSample, int64_t blockStart);
+    void renderBlock();
+
+    scxt::engine::Engine &engine;
+    const BakedSequence &seq;
+    int hostBlockSize{0};
+    int64_t totalSamples{0};
+    int64_t pos{0};
+    size_t evIdx{0};
+    int blockPos{0};
+    std::vector<float> hostOut;
+};
+
+// Runs the engine until no voices remain, then a little more so effect tails settle.
+// Returns the number of blocks rendered.
+int drainToQuiescence(scxt::engine::Engine &);
+
+// Best effort; see the implementation for the per-platform mechanics.
+void requestRealtimePriority();
+
+// hostBlockSize as in EngineConfig: 0 calls processAudio directly per block, otherwise
+// the scenario is fed through host buffers of that many frames.
+RunResult runMeasure(scxt::engine::Engine &, const BakedSequence &, const RunConfig &,
+                     int hostBlockSize);
+void runProfile(scxt::engine::Engine &, const BakedSequence &, const RunConfig &,
+                int hostBlockSize);
 
 } // namespace scxt::perf
 #endif
@@ -4,7 +4,9 @@
 #
 # Diff two scxt-perf JSON reports. Surfaces timing deltas, fingerprint match,
 # and warns if config / source file hashes differ ("you compared apples to
-# oranges").
+# oranges"). Reports from load mode (they carry a "load_benchmark" section)
+# get load time, per-phase and memory deltas instead; multi-instance reports
+# ("multi_instance" section) get throughput, scaling and tail deltas.
 
 import json
 import math
@@ -24,6 +26,64 @@ def warn_diff(label, a, b):
         print(f"  ⚠ {label}: {a} != {b}  — comparison may not be meaningful")
 
 
+def flag_2sigma(label, a, b):
+    median_o = a.get("wall_ms_median", 0.0)
+    median_n = b.get("wall_ms_median", 0.0)
+    sd = max(a.get("wall_ms_stddev", 0.0), b.get("wall_ms_stddev", 0.0), 1e-6)
+    delta = abs(median_n - median_o)
+    flag = "  ⚠ outside 2σ" if delta > 2 * sd else "  (within 2σ)"
+    print(f"  {label:24s} {delta:12.3f}{flag}")
+
+
+def diff_load(old, new):
+    la = old["load_benchmark"]
+    lb = new["load_benchmark"]
+    warn_diff("file_cache ", la.get("file_cache"), lb.get("file_cache"))
+    a = la.get("aggregate", {})
+    b = lb.get("aggregate", {})
+    print("Load timing:")
+    for k in ("wall_ms_median", "wall_ms_stddev"):
+        ov = a.get(k, 0.0)
+        nv = b.get(k, 0.0)
+        print(f"  {k:24s} {ov:12.3f}  →  {nv:12.3f}{fmt_pct(ov, nv)}")
+    flag_2sigma("wall_ms delta:", a, b)
+    pa = a.get("phase_ms_median", {})
+    pb = b.get("phase_ms_median", {})
+    for k in sorted(set(pa) | set(pb)):
+        ov = pa.get(k, 0.0)
+        nv = pb.get(k, 0.0)
+        print(f"  phase {k:18s} {ov:12.3f}  →  {nv:12.3f}{fmt_pct(ov, nv)}")
+    print()
+    print("Memory:")
+    for k in ("peak_rss_bytes", "sample_memory_bytes", "allocations_median"):
+        ov = a.get(k, 0)
+        nv = b.get(k, 0)
+        print(f"  {k:24s} {ov:14.0f}  →  {nv:14.0f}{fmt_pct(ov, nv)}")
+
+
+def diff_multi(old, new):
+    ma = old["multi_instance"]
+    mb = new["multi_instance"]
+    warn_diff("instances  ", ma.get("instances"), mb.get("instances"))
+    warn_diff("threads    ", ma.get("threads"), mb.get("threads"))
+    a = ma.get("aggregate", {})
+    b = mb.get("aggregate", {})
+    print("Multi-instance:")
+    ov = ma.get("baseline_realtime_ratio", 0.0)
+    nv = mb.get("baseline_realtime_ratio", 0.0)
+    print(f"  {'baseline_realtime_ratio':34s} {ov:12.3f}  →  {nv:12.3f}{fmt_pct(ov, nv)}")
+    for k in ("wall_ms_median", "wall_ms_stddev", "aggregate_realtime_ratio_median",
+              "scaling_efficiency_median", "instance_block_ns_p99_median",
+              "worst_instance_block_ns_p99_median"):
+        ov = a.get(k, 0.0)
+        nv = b.get(k, 0.0)
+        print(f"  {k:34s} {ov:12.3f}  →  {nv:12.3f}{fmt_pct(ov, nv)}")
+    flag_2sigma("wall_ms delta:", a, b)
+    for label, rep in (("old", ma), ("new", mb)):
+        if not rep.get("fingerprints_match", True):
+            print(f"  ⚠ {label}: instances rendered different audio")
+
+
 def main():
     if len(sys.argv) != 3:
         print("Usage: diff_perf.py <old.json> <new.json>", file=sys.stderr)
@@ -40,21 +100,33 @@ def main():
     warn_diff("scxt_build_type", old.get("scxt_build_type"), new.get("scxt_build_type"))
     print()
 
+    if "load_benchmark" in old or "load_benchmark" in new:
+        if "load_benchmark" not in old or "load_benchmark" not in new:
+            print("  ⚠ only one report is from load mode — nothing to compare")
+            sys.exit(1)
+        diff_load(old, new)
+        return
+
+    if "multi_instance" in old or "multi_instance" in new:
+        if "multi_instance" not in old or "multi_instance" not in new:
+            print("  ⚠ only one report is from multi_instance mode — nothing to compare")
+            sys.exit(1)
+        diff_multi(old, new)
+        return
+
     a = old.get("aggregate", {})
     b = new.get("aggregate", {})
     print("Timing:")
-    for k in ("wall_ms_median", "wall_ms_stddev", "block_ns_p99_median"):
+    for k in ("wall_ms_median", "wall_ms_stddev", "block_ns_p99_median",
+              "host_buffer_ns_p99_median"):
+        if k not in a and k not in b:
+            continue
         ov = a.get(k, 0.0)
         nv = b.get(k, 0.0)
         print(f"  {k:24s} {ov:12.3f}  →  {nv:12.3f}{fmt_pct(ov, nv)}")
 
     # Significance: 2σ on the wall-ms metric
-    median_o = a.get("wall_ms_median", 0.0)
-    median_n = b.get("wall_ms_median", 0.0)
-    sd = max(a.get("wall_ms_stddev", 0.0), b.get("wall_ms_stddev", 0.0), 1e-6)
-    delta = abs(median_n - median_o)
-    flag = "  ⚠ outside 2σ" if delta > 2 * sd else "  (within 2σ)"
-    print(f"  wall_ms delta:           {delta:12.3f}{flag}")
+    flag_2sigma("wall_ms delta:", a, b)
     print()
 
     fpa = old.get("fingerprint", {})
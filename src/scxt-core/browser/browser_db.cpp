@@ -30,6 +30,7 @@
 #include "scanner.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -51,6 +52,7 @@ BrowserDB::BrowserDB(const fs::path &p, messaging::MessageController &m) : mc(m)
     m.threadingChecker.addAsAClientThread(writerWorker->qThread.get_id());
 
     scanner = std::make_unique<Scanner>(*writerWorker, mc);
+    scanner->resumeInterruptedScans();
 }
 
 BrowserDB::~BrowserDB() {}
@@ -95,6 +97,52 @@ std::vector<std::pair<fs::path, bool>> BrowserDB::getBrowserLocations()
     return res;
 }
 
+std::unordered_map<std::string, std::vector<BrowserDB::IndexedFile>>
+BrowserDB::findFilesByMD5(const std::vector<std::string> &md5s)
+{
+    std::unordered_map<std::string, std::vector<IndexedFile>> res;
+    if (md5s.empty())
+        return res;
+
+    auto conn = writerWorker->getReadOnlyConn();
+    if (!conn)
+        return res;
+
+    // One IN query per chunk rather than one query per sample. The chunk stays under the
+    // smallest host parameter limit sqlite has shipped with (999).
+    static constexpr size_t chunkSize{500};
+    try
+    {
+        for (size_t start = 0; start < md5s.size(); start += chunkSize)
+        {
+            auto n = std::min(chunkSize, md5s.size() - start);
+
+            // language=SQL
+            std::string query = "SELECT md5, path, size, mtime FROM SampleInfo WHERE md5 IN (?1";
+            for (size_t i = 1; i < n; ++i)
+                query += ", ?" + std::to_string(i + 1);
+            query += ");";
+
+            auto q = SQL::Statement(conn, query);
+            for (size_t i = 0; i < n; ++i)
+                q.bind((int)(i + 1), md5s[start + i]);
+            while (q.step())
+            {
+                res[q.col_str(0)].push_back({fs::path(fs::u8path(q.col_str(1))),
+                                             (uint64_t)q.col_int64(2),
+                                             (uint64_t)q.col_int64(3)});
+            }
+            q.finalize();
+        }
+    }
+    catch (SQL::Exception &e)
+    {
+        SCLOG_IF(sqlDb, e.what());
+        RAISE_ERROR_CONT(mc, "Database Error", e.what());
+    }
+    return res;
+}
+
 int BrowserDB::numberOfJobsOutstanding() const
 {
     std::lock_guard<std::mutex> guard(writerWorker->qLock);
@@ -29,9 +29,11 @@
 #define SCXT_SRC_SCXT_CORE_BROWSER_BROWSER_DB_H
 
 #include "filesystem/import.h"
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 namespace scxt::messaging
@@ -61,6 +63,21 @@ struct BrowserDB
 
     void scanToUpdateSamples();
 
+    /*
+     * Every indexed file whose content md5 is in the list, keyed by md5, with the size and
+     * mtime the scanner saw. Callers should check those still match, and then the content,
+     * before trusting a hit, since the index can trail the disk. Runs on the calling thread
+     * against the read only connection.
+     */
+    struct IndexedFile
+    {
+        fs::path path;
+        uint64_t size{0};
+        uint64_t mtime{0}; // seconds, as the scanner stored it
+    };
+    std::unordered_map<std::string, std::vector<IndexedFile>>
+    findFilesByMD5(const std::vector<std::string> &md5s);
+
   private:
     messaging::MessageController &mc;
     std::unique_ptr<WriterWorker> writerWorker;
@@ -25,10 +25,10 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
 #include <chrono>
 #include "scanner.h"
 #include "utils.h"
-#include "writer_worker.h"
 #include "browser.h"
 #include "infrastructure/md5support.h"
 #include "writer_worker.h"
@@ -38,20 +38,76 @@
 namespace scxt::browser
 {
 
-static uint64_t writeTimeInMinutes(const fs::path &p)
+static uint64_t writeTimeInSeconds(const fs::file_time_type &t)
 {
-    auto tse = fs::last_write_time(p).time_since_epoch();
-    auto mse = std::chrono::duration_cast<std::chrono::minutes>(tse).count();
-    return mse;
+    auto tse = t.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::seconds>(tse).count();
 }
 
+/*
+ * Each scan thread has its own read only connection so it can ask whether a file is
+ * already indexed unchanged without going through the writer. The writer runs the
+ * database in WAL mode so these reads don't wait on its transactions.
+ */
+struct IndexLookup
+{
+    const std::string &dbname;
+    sqlite3 *h{nullptr};
+    std::unique_ptr<SQL::Statement> q;
+
+    explicit IndexLookup(const std::string &db) : dbname(db) {}
+    ~IndexLookup()
+    {
+        q.reset();
+        if (h)
+            sqlite3_close(h);
+    }
+
+    bool isUnchanged(const fs::path &p, uint64_t size, uint64_t mtime)
+    {
+        try
+        {
+            if (!h)
+            {
+                auto ec = sqlite3_open_v2(dbname.c_str(), &h,
+                                          SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_READONLY, nullptr);
+                if (ec != SQLITE_OK)
+                {
+                    if (h)
+                        sqlite3_close(h);
+                    h = nullptr;
+                    return false;
+                }
+                q = std::make_unique<SQL::Statement>(
+                    h, "SELECT size, mtime FROM SampleInfo WHERE path==?1");
+            }
+            q->reset();
+            q->bind(1, p.u8string());
+            bool res{false};
+            if (q->step())
+                res = (uint64_t)q->col_int64(0) == size && (uint64_t)q->col_int64(1) == mtime;
+            q->reset();
+            return res;
+        }
+        catch (const SQL::Exception &e)
+        {
+            SCLOG_IF(sqlDb, "Index lookup failed: " << e.what());
+            return false;
+        }
+    }
+};
+
 struct ScanWorker
 {
     Scanner &scanner;
     ScanWorker(Scanner &s) : scanner(s)
     {
-        qThread = std::thread([this]() { this->processQueue(); });
-        scanner.mc.threadingChecker.addAsAClientThread(qThread.get_id());
+        auto nt = std::clamp((int)std::thread::hardware_concurrency() - 1, 1, maxScanThreads);
+        for (int i = 0; i < nt; ++i)
+        {
+            qThreads.emplace_back([this]() { this->processQueue(); });
+            scanner.mc.threadingChecker.addAsAClientThread(qThreads.back().get_id());
+        }
     }
 
     ~ScanWorker()
@@ -62,7 +118,8 @@ struct ScanWorker
             keepRunning = false;
         }
         qCV.notify_all();
-        qThread.join();
+        for (auto &t : qThreads)
+            t.join();
         for (auto *q : pathQLow)
             delete q;
         for (auto *q : pathQ)
@@ -71,10 +128,11 @@ struct ScanWorker
 
     void processQueue()
     {
-        int lastCount{0}, nextCount{0};
+        IndexLookup lookup(scanner.writer.dbname);
         while (keepRunning)
         {
             EnQAble *p = nullptr;
+            int nextCount{0};
             {
                 std::unique_lock<std::mutex> g(qLock);
                 qCV.wait(g,
@@ -98,7 +156,7 @@ struct ScanWorker
             {
                 try
                 {
-                    p->go(*this);
+                    p->go(*this, lookup);
                 }
                 catch (const std::exception &e)
                 {
@@ -108,15 +166,14 @@ struct ScanWorker
                 }
                 delete p;
 
-                if (lastCount != nextCount)
+                auto lastCount = reportedCount.load();
+                if (lastCount != nextCount &&
+                    (nextCount == 0 || lastCount == 0 || abs(lastCount - nextCount) > 20) &&
+                    reportedCount.compare_exchange_strong(lastCount, nextCount))
                 {
-                    if (nextCount == 0 || lastCount == 0 || abs(lastCount - nextCount) > 20)
-                    {
-                        auto msg =
-                            scxt::messaging::client::BrowserQueueRefresh({(int32_t)nextCount, -1});
-                        messaging::client::clientSendToSerialization(msg, scanner.mc);
-                        lastCount = nextCount;
-                    }
+                    auto msg =
+                        scxt::messaging::client::BrowserQueueRefresh({(int32_t)nextCount, -1});
+                    messaging::client::clientSendToSerialization(msg, scanner.mc);
                 }
             }
         }
@@ -125,14 +182,40 @@ struct ScanWorker
     struct EnQAble
     {
         virtual ~EnQAble() = default;
-        virtual void go(ScanWorker &w) = 0;
+        virtual void go(ScanWorker &w, IndexLookup &lookup) = 0;
+    };
+
+    /*
+     * A directory stays in ScanProgress until every file found in it has been handed
+     * to the writer. The directory scan holds one count and each file one more; whoever
+     * finishes last clears the record. Work dropped at shutdown never counts down, so
+     * the record survives and the directory is rescanned next time.
+     */
+    struct DirProgress
+    {
+        fs::path path, root;
+        std::atomic<int> outstanding{1};
+        DirProgress(const fs::path &p, const fs::path &r) : path(p), root(r) {}
+
+        void complete(ScanWorker &w)
+        {
+            if (outstanding.fetch_sub(1) == 1)
+                w.scanner.writer.enqueueWorkItem(
+                    new WriterWorker::EnQScanProgress(path, root, false));
+        }
     };
 
     struct ScanFile : ScanWorker::EnQAble
     {
         fs::path path;
-        ScanFile(const fs::path &p) : path(p) {}
-        void go(ScanWorker &w) override
+        uint64_t size, mtime;
+        std::shared_ptr<DirProgress> progress;
+        ScanFile(const fs::path &p, uint64_t sz, uint64_t mt,
+                 const std::shared_ptr<DirProgress> &prog)
+            : path(p), size(sz), mtime(mt), progress(prog)
+        {
+        }
+        void go(ScanWorker &w, IndexLookup &) override
         {
             // a file removed/locked between enqueue and scan throws from
             // the filesystem calls; let it escape and it takes the worker thread
@@ -142,10 +225,8 @@ struct ScanWorker
                 if (fs::exists(path))
                 {
                     auto sc = infrastructure::createMD5SumFromFile(path);
-                    auto sz = fs::file_size(path);
-                    auto mt = writeTimeInMinutes(path);
                     w.scanner.writer.enqueueWorkItem(
-                        new WriterWorker::EnQAddSampleInfo(path, sc, mt, sz));
+                        new WriterWorker::EnQAddSampleInfo(path, sc, mtime, size));
                 }
             }
             catch (const std::exception &e)
@@ -153,22 +234,27 @@ struct ScanWorker
                 SCLOG_IF(warnings,
                          "Skipping unreadable file '" << path.u8string() << "': " << e.what());
             }
+            progress->complete(w);
         }
     };
     struct ScanDir : EnQAble
     {
-        fs::path path;
+        fs::path path, root;
         uint64_t afterMtime;
 
-        ScanDir(const fs::path &p, uint64_t mtime) : path(p), afterMtime(mtime) {}
+        ScanDir(const fs::path &p, const fs::path &r, uint64_t mtime)
+            : path(p), root(r), afterMtime(mtime)
+        {
+        }
 
-        void go(ScanWorker &w) override
+        void go(ScanWorker &w, IndexLookup &lookup) override
         {
             // a permission-denied directory (or one deleted mid-scan)
             // throws from directory_iterator/last_write_time. An unhandled throw
             // out of the worker thread is std::terminate, so contain it here and
             // skip the offending directory.
-            std::vector<fs::path> toScan;
+            auto progress = std::make_shared<DirProgress>(path, root);
+            std::vector<ScanFile *> toScan;
             try
             {
                 auto files = fs::directory_iterator(path);
@@ -178,16 +264,18 @@ struct ScanWorker
                     {
                         if (browser::Browser::isLoadableFile(dirent.path()))
                         {
-                            auto mse = writeTimeInMinutes(dirent.path());
-                            if (mse > afterMtime)
+                            auto mt = writeTimeInSeconds(dirent.last_write_time());
+                            auto sz = (uint64_t)dirent.file_size();
+                            // afterMtime is in minutes, as scanPath has always taken it
+                            if (mt / 60 > afterMtime && !lookup.isUnchanged(dirent.path(), sz, mt))
                             {
-                                toScan.push_back(dirent.path());
+                                toScan.push_back(new ScanFile{dirent.path(), sz, mt, progress});
                             }
                         }
                     }
                     else if (dirent.is_directory())
                     {
-                        w.enqueueWorkItem(new ScanDir{dirent.path(), (uint64_t)afterMtime});
+                        w.enqueueDirectory(dirent.path(), root, afterMtime);
                     }
                 }
             }
@@ -197,18 +285,29 @@ struct ScanWorker
                          "Skipping unreadable directory '" << path.u8string() << "': " << e.what());
             }
 
-            for (const auto &s : toScan)
+            progress->outstanding += (int)toScan.size();
+            for (auto *s : toScan)
             {
-                w.enqueueWorkLowPri(new ScanFile{s});
+                w.enqueueWorkLowPri(s);
             }
+            progress->complete(w);
         }
     };
 
-    std::thread qThread;
+    static constexpr int maxScanThreads{8};
+    std::vector<std::thread> qThreads;
     std::mutex qLock;
     std::condition_variable qCV;
     std::deque<EnQAble *> pathQ, pathQLow;
     std::atomic<bool> keepRunning{true};
+    std::atomic<int> reportedCount{0};
+
+    void enqueueDirectory(const fs::path &p, const fs::path &root, uint64_t afterMtime)
+    {
+        // recorded before it is queued, so the writer always sees the add before the clear
+        scanner.writer.enqueueWorkItem(new WriterWorker::EnQScanProgress(p, root, true));
+        enqueueWorkItem(new ScanDir{p, root, afterMtime});
+    }
 
     void enqueueWorkItem(EnQAble *p)
     {
@@ -217,7 +316,7 @@ struct ScanWorker
 
             pathQ.push_back(p);
         }
-        qCV.notify_all();
+        qCV.notify_one();
     }
 
     void enqueueWorkLowPri(EnQAble *p)
@@ -227,7 +326,7 @@ struct ScanWorker
 
             pathQLow.push_back(p);
         }
-        qCV.notify_all();
+        qCV.notify_one();
     }
 };
 
@@ -240,7 +339,31 @@ Scanner::~Scanner() {}
 
 void Scanner::scanPath(const fs::path &path, uint64_t afterMtime)
 {
-    scanWorker->enqueueWorkItem(new ScanWorker::ScanDir{path, afterMtime});
+    scanWorker->enqueueDirectory(path, path, afterMtime);
+}
+
+void Scanner::resumeInterruptedScans()
+{
+    std::vector<std::pair<fs::path, fs::path>> pending;
+    try
+    {
+        auto q = SQL::Statement(writer.getReadOnlyConn(), "SELECT path, root FROM ScanProgress");
+        while (q.step())
+            pending.emplace_back(fs::path{q.col_str(0)}, fs::path{q.col_str(1)});
+        q.finalize();
+    }
+    catch (const SQL::Exception &e)
+    {
+        SCLOG_IF(sqlDb, e.what());
+    }
+
+    if (!pending.empty())
+        SCLOG_IF(sqlDb, "Resuming interrupted index of " << pending.size() << " directories");
+
+    // Already indexed files are skipped by size and mtime, so rescanning a directory that
+    // was partly done is cheap
+    for (const auto &[p, r] : pending)
+        scanWorker->enqueueWorkItem(new ScanWorker::ScanDir{p, r, 0});
 }
 
 } // namespace scxt::browser
@@ -45,6 +45,12 @@ struct Scanner
 
     void scanPath(const fs::path &path, uint64_t afterMtime);
 
+    /*
+     * Requeue directories an earlier index recorded in ScanProgress but never finished,
+     * for instance because the app was closed mid index.
+     */
+    void resumeInterruptedScans();
+
     WriterWorker &writer;
     messaging::MessageController &mc;
     std::unique_ptr<ScanWorker> scanWorker;
@@ -41,7 +41,7 @@ namespace scxt::browser
 struct WriterWorker
 {
     static constexpr const char *schema_version =
-        "1011"; // I will rebuild if this is not my version
+        "1012"; // I will rebuild if this is not my version
 
     static constexpr const char *setup_sql = R"SQL(
 DROP TABLE IF EXISTS "DebugJunk";
@@ -50,8 +50,10 @@ DROP TABLE IF EXISTS "Version";
 DROP TABLE IF EXISTS "Favorites";
 DROP TABLE IF EXISTS "IndexedDeviceLocations";
 DROP TABLE IF EXISTS "SampleInfo";
+DROP TABLE IF EXISTS "ScanProgress";
 DROP INDEX IF EXISTS "SampleInfoPath";
 DROP INDEX IF EXISTS "SampleInfoMD5";
+DROP INDEX IF EXISTS "ScanProgressPath";
 
 CREATE TABLE "Version" (
     id integer primary key,
@@ -74,9 +76,19 @@ CREATE TABLE SampleInfo (
     mtime integer
 );
 
-CREATE INDEX SampleInfoPath ON SampleInfo (path);
+-- mtime is in seconds. path is unique so an index update is a single INSERT OR REPLACE
+CREATE UNIQUE INDEX SampleInfoPath ON SampleInfo (path);
 CREATE INDEX SampleInfoMD5 ON SampleInfo (md5);
 
+-- Directories an index has queued but not finished, so an interrupted index resumes
+CREATE TABLE ScanProgress (
+    id integer primary key,
+    path varchar(2048),
+    root varchar(2048)
+);
+
+CREATE UNIQUE INDEX ScanProgressPath ON ScanProgress (path);
+
 -- We create these tables only if missing of course since it is user data
 CREATE TABLE IF NOT EXISTS BrowserLocations (
     id integer primary key,
@@ -128,28 +140,68 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
         {
             try
             {
-                auto del = SQL::Statement(w.dbh, "DELETE FROM SampleInfo WHERE path==?1");
-                std::string res = path.u8string();
-                del.bind(1, res);
-                del.step();
-                del.finalize();
-
-                auto there =
-                    SQL::Statement(w.dbh, "INSERT INTO SampleInfo  (\"path\", \"format\", \"md5\", "
-                                          "\"size\", \"mtime\") VALUES (?1, ?2, ?3, ?4, ?5)");
-
-                there.bind(1, res);
+                // One prepared statement per connection, reused for every row in the batch
+                if (!w.upsertSampleInfo)
+                    w.upsertSampleInfo = std::make_unique<SQL::Statement>(
+                        w.dbh, "INSERT OR REPLACE INTO SampleInfo (\"path\", \"format\", "
+                               "\"md5\", \"size\", \"mtime\") VALUES (?1, ?2, ?3, ?4, ?5)");
+                auto &there = *w.upsertSampleInfo;
+                there.bind(1, path.u8string());
                 there.bind(2, path.extension().u8string());
                 there.bind(3, md5);
-                there.bind(4, filesz);
-                there.bind(5, time);
-
+                there.bindi64(4, (int64_t)filesz);
+                there.bindi64(5, (int64_t)time);
                 there.step();
-                there.finalize();
+                there.reset();
+                there.clearBindings();
             }
             catch (SQL::Exception &e)
             {
                 SCLOG_IF(warnings, "Unable to insert into SampleInfo: " << e.what())
+                // sqlite3_reset would hand this row's error to the next one, so drop the
+                // statement and let the next row prepare a fresh one
+                w.upsertSampleInfo.reset();
+            }
+        }
+    };
+
+    /*
+     * The scanner records each directory it queues and clears it once every file in it
+     * has been written, which (since this queue is ordered) lands after those rows.
+     */
+    struct EnQScanProgress : public EnQAble
+    {
+        fs::path path, root;
+        bool add;
+        EnQScanProgress(const fs::path &p, const fs::path &r, bool add)
+            : path(p), root(r), add(add)
+        {
+        }
+        void go(WriterWorker &w) override
+        {
+            try
+            {
+                if (add)
+                {
+                    auto st = SQL::Statement(
+                        w.dbh, "INSERT OR IGNORE INTO ScanProgress (\"path\", \"root\") "
+                               "VALUES (?1, ?2)");
+                    st.bind(1, path.u8string());
+                    st.bind(2, root.u8string());
+                    st.step();
+                    st.finalize();
+                }
+                else
+                {
+                    auto st = SQL::Statement(w.dbh, "DELETE FROM ScanProgress WHERE path==?1");
+                    st.bind(1, path.u8string());
+                    st.step();
+                    st.finalize();
+                }
+            }
+            catch (SQL::Exception &e)
+            {
+                SCLOG_IF(warnings, "Unable to update ScanProgress: " << e.what())
             }
         }
     };
@@ -179,6 +231,17 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
             dbh = nullptr;
             return;
         }
+
+        // WAL lets the scanner's read connections look up files while a batch is being
+        // written, and NORMAL sync is durable enough for an index we can always rebuild
+        try
+        {
+            SQL::Exec(dbh, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
+        }
+        catch (const SQL::Exception &e)
+        {
+            SCLOG_IF(sqlDb, e.what());
+        }
     }
 
     void closeDb()
@@ -186,6 +249,8 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
 #if TRACE_DB
         SCLOG_IF(sqlDb, "<<<< Closing r/w DB");
 #endif
+        // sqlite3_close refuses to close a connection with live statements
+        upsertSampleInfo.reset();
         if (dbh)
             sqlite3_close(dbh);
         dbh = nullptr;
@@ -321,6 +386,7 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
                 delete q;
             pathQ.clear();
             // clean up all the prepared statements
+            upsertSampleInfo.reset();
             if (dbh)
                 sqlite3_close(dbh);
             dbh = nullptr;
@@ -342,7 +408,8 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
     std::atomic<bool> waiting{false};
     void loadQueueFunction()
     {
-        static constexpr auto transChunkSize = 50;
+        // Scans produce rows far faster than single row transactions can commit them
+        static constexpr auto transChunkSize = 2000;
         int lock_retries{0};
         int lastCount{0}, nextCount{0};
         while (keepRunning)
@@ -530,6 +597,12 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
 
                 there.step();
                 there.finalize();
+
+                // and forget any index of it still waiting to resume
+                auto prog = SQL::Statement(dbh, "DELETE FROM ScanProgress WHERE root==?1");
+                prog.bind(1, res);
+                prog.step();
+                prog.finalize();
             }
         }
         catch (const SQL::Exception &e)
@@ -592,6 +665,7 @@ CREATE TABLE IF NOT EXISTS BrowserLocations (
   private:
     sqlite3 *rodbh{nullptr};
     sqlite3 *dbh{nullptr};
+    std::unique_ptr<SQL::Statement> upsertSampleInfo;
 };
 
 } // namespace scxt::browser
@@ -631,6 +631,31 @@ void KernelOp<InterpolationTypes::Sinc, int16_t>::Process(
     }
 }
 
+/*
+ * For sample data without the zero pad (GeneratorIO::zeroPaddedEdges), hand back a window
+ * which is safe to read FIRipol_N wide: the window itself when it sits inside the sample,
+ * else a copy into scratch with zeros where the pad would have been. off is where read starts
+ * in data; the caller knows it, so it is never recovered by subtracting pointers, and windows
+ * which aren't onto data at all - the loop end buffers - never come here.
+ */
+template <typename T>
+inline T *padWindowAtEdges(T *read, int off, const T *data, int waveSize, T *scratch)
+{
+    if (!read)
+        return read;
+    if (off >= 0 && off + (int)FIRipol_N <= waveSize)
+        return read;
+    if (off < -(int)FIRipol_N || off > waveSize)
+        return read;
+
+    for (int k = 0; k < (int)FIRipol_N; ++k)
+    {
+        auto q = off + k;
+        scratch[k] = (q >= 0 && q < waveSize) ? data[q] : T(0);
+    }
+    return scratch;
+}
+
 template <int compoundConfig>
 void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO);
 
@@ -729,6 +754,10 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
     float *__restrict readFadeSampleLF32 = nullptr;
     float *__restrict readFadeSampleRF32 = nullptr;
     float loopEndBufferLF32[resampFIRSize], loopEndBufferRF32[resampFIRSize];
+    // where the read windows start in the sample data, for padWindowAtEdges. The main window
+    // always starts at SamplePos - FIRoffset unless it has been swapped for the loop end buffer
+    bool readFromLoopEndBuffer{false};
+    int fadeReadPos{0};
 
     if (fp)
     {
@@ -742,6 +771,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
             if (fadeActive)
             {
                 auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
+                fadeReadPos = fadeSamplePos - FIRoffset;
                 readFadeSampleLF32 = SampleDataFL + fadeSamplePos - FIRoffset;
                 if (stereo)
                     readFadeSampleRF32 = SampleDataFR + fadeSamplePos - FIRoffset;
@@ -758,6 +788,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                     if (stereo)
                         loopEndBufferRF32[k] = SampleDataFR[q];
                 }
+                readFromLoopEndBuffer = true;
                 readSampleLF32 = loopEndBufferLF32;
                 if (stereo)
                     readSampleRF32 = loopEndBufferRF32;
@@ -775,6 +806,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
             if (fadeActive)
             {
                 auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
+                fadeReadPos = fadeSamplePos - FIRoffset;
                 readFadeSampleL = SampleDataL + fadeSamplePos - FIRoffset;
                 if (stereo)
                     readFadeSampleR = SampleDataR + fadeSamplePos - FIRoffset;
@@ -792,6 +824,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                     if (stereo)
                         loopEndBufferR[k] = SampleDataR[q];
                 }
+                readFromLoopEndBuffer = true;
                 readSampleL = loopEndBufferL;
                 if (stereo)
                     readSampleR = loopEndBufferR;
@@ -801,6 +834,10 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
 
     int NSamples = GD->blockSize;
 
+    const bool zeroPadded = IO->zeroPaddedEdges;
+    using edge_t = typename std::conditional<fp, float, int16_t>::type;
+    edge_t edgeL[FIRipol_N], edgeR[FIRipol_N], edgeFadeL[FIRipol_N], edgeFadeR[FIRipol_N];
+
     int i{0};
     for (i = 0; i < NSamples && !IsFinished; i++)
     {
@@ -833,6 +870,28 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
             readFadeR = readFadeSampleR;
         }
 
+        if (!zeroPadded)
+        {
+            auto readPos = SamplePos - FIRoffset;
+            auto dataL = (const type_from_cond *)IO->sampleDataL;
+            if (!readFromLoopEndBuffer)
+                readL = padWindowAtEdges(readL, readPos, dataL, WaveSize, edgeL);
+            if constexpr (loopActive)
+                if (fadeActive)
+                    readFadeL =
+                        padWindowAtEdges(readFadeL, fadeReadPos, dataL, WaveSize, edgeFadeL);
+            if constexpr (stereo)
+            {
+                auto dataR = (const type_from_cond *)IO->sampleDataR;
+                if (!readFromLoopEndBuffer)
+                    readR = padWindowAtEdges(readR, readPos, dataR, WaveSize, edgeR);
+                if constexpr (loopActive)
+                    if (fadeActive)
+                        readFadeR =
+                            padWindowAtEdges(readFadeR, fadeReadPos, dataR, WaveSize, edgeFadeR);
+            }
+        }
+
         // 2. Resample
         unsigned int m0 = ((SampleSubPos >> 12) & 0xff0);
         if (stereo)
@@ -939,12 +998,14 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
 
             if constexpr (fp)
             {
+                readFromLoopEndBuffer = false;
                 readSampleLF32 = SampleDataFL + SamplePos - FIRoffset;
                 if (stereo)
                     readSampleRF32 = SampleDataFR + SamplePos - FIRoffset;
             }
             else
             {
+                readFromLoopEndBuffer = false;
                 readSampleL = SampleDataL + SamplePos - FIRoffset;
                 if (stereo)
                     readSampleR = SampleDataR + SamplePos - FIRoffset;
@@ -1098,12 +1159,14 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                         if (stereo)
                             loopEndBufferRF32[k] = SampleDataFR[q];
                     }
+                    readFromLoopEndBuffer = true;
                     readSampleLF32 = loopEndBufferLF32;
                     if (stereo)
                         readSampleRF32 = loopEndBufferRF32;
                 }
                 else
                 {
+                    readFromLoopEndBuffer = false;
                     readSampleLF32 = SampleDataFL + SamplePos - FIRoffset;
                     if (stereo)
                         readSampleRF32 = SampleDataFR + SamplePos - FIRoffset;
@@ -1111,6 +1174,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                     if (fadeActive)
                     {
                         auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
+                        fadeReadPos = fadeSamplePos - FIRoffset;
                         readFadeSampleLF32 = SampleDataFL + fadeSamplePos - FIRoffset;
                         if (stereo)
                             readFadeSampleRF32 = SampleDataFR + fadeSamplePos - FIRoffset;
@@ -1132,12 +1196,14 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                         if (stereo)
                             loopEndBufferR[k] = SampleDataR[q];
                     }
+                    readFromLoopEndBuffer = true;
                     readSampleL = loopEndBufferL;
                     if (stereo)
                         readSampleR = loopEndBufferR;
                 }
                 else
                 {
+                    readFromLoopEndBuffer = false;
                     readSampleL = SampleDataL + SamplePos - FIRoffset;
                     if (stereo)
                         readSampleR = SampleDataR + SamplePos - FIRoffset;
@@ -1145,6 +1211,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                     if (fadeActive)
                     {
                         auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
+                        fadeReadPos = fadeSamplePos - FIRoffset;
                         readFadeSampleL = SampleDataL + fadeSamplePos - FIRoffset;
                         if (stereo)
                             readFadeSampleR = SampleDataR + fadeSamplePos - FIRoffset;
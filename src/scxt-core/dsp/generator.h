@@ -108,6 +108,9 @@ struct GeneratorIO
     void *__restrict sampleDataL{nullptr};
     void *__restrict sampleDataR{nullptr};
     int waveSize{0};
+    // false when the data is a view into a mapped file with no FIRoffset pad either side; the
+    // generator then makes up the pad itself for windows which reach past an end
+    bool zeroPaddedEdges{true};
 };
 
 typedef void (*GeneratorFPtr)(GeneratorState *__restrict, GeneratorIO *__restrict);
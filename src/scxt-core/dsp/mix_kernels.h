@@ -0,0 +1,100 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_DSP_MIX_KERNELS_H
+#define SCXT_SRC_SCXT_CORE_DSP_MIX_KERNELS_H
+
+#include <cstddef>
+
+#include "sst/basic-blocks/simd/setup.h"
+#include "sst/basic-blocks/dsp/PanLaws.h"
+
+namespace scxt::dsp
+{
+/*
+ * Scale a stereo pair by level, pan it through an equal power matrix and either write
+ * or sum it onto an output pair, all in one pass. The part mix used to do these as
+ * three separate loops over temporaries, which for many groups is nothing but memory
+ * traffic. Buffers must be 16 byte aligned, which every block buffer in the engine is.
+ */
+template <size_t N, bool accumulate>
+inline void scalePanMix(const float *__restrict inL, const float *__restrict inR, float level,
+                        const sst::basic_blocks::dsp::pan_laws::panmatrix_t &pmat,
+                        float *__restrict outL, float *__restrict outR)
+{
+    static_assert(N % 4 == 0);
+    const auto ll = SIMD_MM(set1_ps)(level * pmat[0]);
+    const auto rl = SIMD_MM(set1_ps)(level * pmat[2]);
+    const auto rr = SIMD_MM(set1_ps)(level * pmat[1]);
+    const auto lr = SIMD_MM(set1_ps)(level * pmat[3]);
+    for (size_t i = 0; i < N; i += 4)
+    {
+        auto l = SIMD_MM(load_ps)(inL + i);
+        auto r = SIMD_MM(load_ps)(inR + i);
+        auto ol = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(ll, l), SIMD_MM(mul_ps)(rl, r));
+        auto orr = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(rr, r), SIMD_MM(mul_ps)(lr, l));
+        if constexpr (accumulate)
+        {
+            ol = SIMD_MM(add_ps)(ol, SIMD_MM(load_ps)(outL + i));
+            orr = SIMD_MM(add_ps)(orr, SIMD_MM(load_ps)(outR + i));
+        }
+        SIMD_MM(store_ps)(outL + i, ol);
+        SIMD_MM(store_ps)(outR + i, orr);
+    }
+}
+
+/*
+ * Write or sum a stereo pair, for summing paths which have a first writer and so can
+ * skip clearing the destination.
+ */
+template <size_t N>
+inline void copyOrAccumulate(bool accumulate, const float *__restrict inL,
+                             const float *__restrict inR, float *__restrict outL,
+                             float *__restrict outR)
+{
+    static_assert(N % 4 == 0);
+    if (accumulate)
+    {
+        for (size_t i = 0; i < N; i += 4)
+        {
+            SIMD_MM(store_ps)
+            (outL + i, SIMD_MM(add_ps)(SIMD_MM(load_ps)(outL + i), SIMD_MM(load_ps)(inL + i)));
+            SIMD_MM(store_ps)
+            (outR + i, SIMD_MM(add_ps)(SIMD_MM(load_ps)(outR + i), SIMD_MM(load_ps)(inR + i)));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < N; i += 4)
+        {
+            SIMD_MM(store_ps)(outL + i, SIMD_MM(load_ps)(inL + i));
+            SIMD_MM(store_ps)(outR + i, SIMD_MM(load_ps)(inR + i));
+        }
+    }
+}
+} // namespace scxt::dsp
+#endif // SCXT_SRC_SCXT_CORE_DSP_MIX_KERNELS_H
@@ -35,100 +35,193 @@
 namespace scxt::dsp::processor
 {
 
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
-inline void
-runSingleProcessor(int i, PitchPtr fpitch, Processor *processors[engine::processorCount],
-                   bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
-                   Endpoints *endpoints, bool &chainIsMono, float input[2][N], float output[2][N])
+/*
+ * The per-slot mix and output level ramps. Rather than fading dry into wet in one pass and
+ * then scaling by the output level in a second pass, both ramps are applied together as the
+ * processor output is written, so each processor touches its output block exactly once.
+ */
+template <int N> struct ProcessorMixLevel
 {
-    if (processors[i]->bypassAnyway)
+    float mix{1.f}, mixTarget{1.f};
+    float level{1.f}, levelTarget{1.f};
+
+    void setTargets(float m, float l)
     {
-        return;
+        mixTarget = m;
+        levelTarget = l;
     }
 
-    namespace mech = sst::basic_blocks::mechanics;
+    void setTargetsInstant(float m, float l)
+    {
+        mix = mixTarget = m;
+        level = levelTarget = l;
+    }
+
+    // out = (dry + (wet - dry) * mix) * level. dry and out may alias; every sample is read
+    // before it is written.
+    void mono(const float *dry, const float *wet, float *out)
+    {
+        const auto dm = (mixTarget - mix) * invN;
+        const auto dl = (levelTarget - level) * invN;
+        for (int k = 0; k < N; ++k)
+        {
+            auto m = mix + dm * (k + 1);
+            auto l = level + dl * (k + 1);
+            auto d = dry[k];
+            out[k] = (d + (wet[k] - d) * m) * l;
+        }
+        mix = mixTarget;
+        level = levelTarget;
+    }
 
-    float tempbuf alignas(16)[2][N];
+    void stereo(const float *dryL, const float *dryR, const float *wetL, const float *wetR,
+                float *outL, float *outR)
+    {
+        const auto dm = (mixTarget - mix) * invN;
+        const auto dl = (levelTarget - level) * invN;
+        for (int k = 0; k < N; ++k)
+        {
+            auto m = mix + dm * (k + 1);
+            auto l = level + dl * (k + 1);
+            auto dL = dryL[k];
+            auto dR = dryR[k];
+            auto vL = (dL + (wetL[k] - dL) * m) * l;
+            auto vR = (dR + (wetR[k] - dR) * m) * l;
+            outL[k] = vL;
+            outR[k] = vR;
+        }
+        mix = mixTarget;
+        level = levelTarget;
+    }
 
+  private:
+    static constexpr float invN{1.f / N};
+};
+
+/*
+ * How a single slot moves signal, resolved from the incoming chain state and the
+ * processor's mono capabilities. Each has its own kernel below so the audio path
+ * has no mono/stereo branching once the routing is known.
+ */
+enum struct SlotRouting : uint8_t
+{
+    monoToMono,
+    monoToStereo,
+    splatToStereo, // mono chain into a stereo-only processor; copy L to R first
+    stereoToStereo
+};
+
+inline SlotRouting resolveSlotRouting(Processor *p, bool consumesMono, bool chainIsMono)
+{
+    if (!chainIsMono)
+        return SlotRouting::stereoToStereo;
+    if (!consumesMono)
+        return SlotRouting::splatToStereo;
+    return p->monoInputCreatesStereoOutput() ? SlotRouting::monoToStereo
+                                             : SlotRouting::monoToMono;
+}
+
+template <typename MixLevel, typename Endpoints>
+inline void updateSlotTargets(int i, Processor *processors[engine::processorCount],
+                              MixLevel &mixLevel, Endpoints *endpoints)
+{
     endpoints->processorTarget[i].snapValues();
 
     auto mixl = *endpoints->processorTarget[i].mixP;
     if (processors[i]->getType() == proct_none)
         mixl = 1.0;
-    mix[i].set_target(mixl);
 
-    float p;
-    if constexpr (std::is_same_v<PitchPtr, float>)
-    {
-        p = fpitch;
-    }
-    else
+    auto ol = *endpoints->processorTarget[i].outputLevelDbP;
+    ol = ol * ol * ol * dsp::processor::ProcessorStorage::maxOutputAmp;
+
+    mixLevel[i].setTargets(mixl, ol);
+}
+
+template <bool OS, SlotRouting R, int N, typename Ramp>
+inline void runSlot(Processor *proc, float pitch, Ramp &ramp, float input[2][N],
+                    float output[2][N])
+{
+    namespace mech = sst::basic_blocks::mechanics;
+
+    float wet alignas(16)[2][N];
+
+    if constexpr (R == SlotRouting::monoToMono)
     {
-        p = fpitch[i];
+        proc->process_monoToMono(input[0], wet[0], pitch);
+        ramp.mono(input[0], wet[0], output[0]);
     }
-
-    if constexpr (forceStereo)
+    else if constexpr (R == SlotRouting::monoToStereo)
     {
-        processors[i]->process_stereo(input[0], input[1], tempbuf[0], tempbuf[1], p);
-        mix[i].fade_blocks(input[0], tempbuf[0], output[0]);
-        mix[i].fade_blocks(input[1], tempbuf[1], output[1]);
-
-        chainIsMono = false;
+        proc->process_monoToStereo(input[0], wet[0], wet[1], pitch);
+        // Input is mono, so both dry sides are input[0]
+        ramp.stereo(input[0], input[0], wet[0], wet[1], output[0], output[1]);
     }
     else
     {
-        if (chainIsMono && processorConsumesMono[i] &&
-            !processors[i]->monoInputCreatesStereoOutput())
-        {
-            // mono to mono
-            processors[i]->process_monoToMono(input[0], tempbuf[0], p);
-            mix[i].fade_blocks(input[0], tempbuf[0], output[0]);
-        }
-        else if (chainIsMono && processorConsumesMono[i])
-        {
-            assert(processors[i]->monoInputCreatesStereoOutput());
-            // mono to stereo. process then toggle
-            processors[i]->process_monoToStereo(input[0], tempbuf[0], tempbuf[1], p);
-
-            // this input[0] is NOT a typo. Input is mono
-            // And this order matters. Have to splat [1] first to keep [0] around
-            mix[i].fade_blocks(input[0], tempbuf[1], output[1]);
-            mix[i].fade_blocks(input[0], tempbuf[0], output[0]);
-
-            chainIsMono = false;
-        }
-        else if (chainIsMono)
+        if constexpr (R == SlotRouting::splatToStereo)
         {
-            assert(!processorConsumesMono[i]);
-            // stereo to stereo. copy L to R then process
             mech::copy_from_to<blockSize << (OS ? 1 : 0)>(input[0], input[1]);
-            chainIsMono = false;
-            processors[i]->process_stereo(input[0], input[1], tempbuf[0], tempbuf[1], p);
-            mix[i].fade_blocks(input[0], tempbuf[0], output[0]);
-            mix[i].fade_blocks(input[1], tempbuf[1], output[1]);
-        }
-        else
-        {
-            // stereo to stereo. process
-            processors[i]->process_stereo(input[0], input[1], tempbuf[0], tempbuf[1], p);
-            mix[i].fade_blocks(input[0], tempbuf[0], output[0]);
-            mix[i].fade_blocks(input[1], tempbuf[1], output[1]);
-            chainIsMono = false;
         }
+        proc->process_stereo(input[0], input[1], wet[0], wet[1], pitch);
+        ramp.stereo(input[0], input[1], wet[0], wet[1], output[0], output[1]);
     }
+}
 
-    auto ol = *endpoints->processorTarget[i].outputLevelDbP;
-    ol = ol * ol * ol * dsp::processor::ProcessorStorage::maxOutputAmp;
-    outLev[i].set_target(ol);
+template <bool OS, int N, typename Ramp>
+inline void dispatchSlot(SlotRouting r, Processor *proc, float pitch, Ramp &ramp,
+                         float input[2][N], float output[2][N])
+{
+    switch (r)
+    {
+    case SlotRouting::monoToMono:
+        runSlot<OS, SlotRouting::monoToMono>(proc, pitch, ramp, input, output);
+        break;
+    case SlotRouting::monoToStereo:
+        runSlot<OS, SlotRouting::monoToStereo>(proc, pitch, ramp, input, output);
+        break;
+    case SlotRouting::splatToStereo:
+        runSlot<OS, SlotRouting::splatToStereo>(proc, pitch, ramp, input, output);
+        break;
+    case SlotRouting::stereoToStereo:
+        runSlot<OS, SlotRouting::stereoToStereo>(proc, pitch, ramp, input, output);
+        break;
+    }
+}
 
-    if (forceStereo || !chainIsMono)
+template <typename PitchPtr> inline float slotPitch(PitchPtr fpitch, int i)
+{
+    if constexpr (std::is_same_v<PitchPtr, float>)
     {
-        outLev[i].multiply_2_blocks(output[0], output[1]);
+        return fpitch;
     }
     else
     {
-        outLev[i].multiply_block(output[0]);
+        return fpitch[i];
+    }
+}
+
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
+inline void
+runSingleProcessor(int i, PitchPtr fpitch, Processor *processors[engine::processorCount],
+                   bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
+                   Endpoints *endpoints, bool &chainIsMono, float input[2][N], float output[2][N])
+{
+    if (processors[i]->bypassAnyway)
+    {
+        return;
+    }
+
+    updateSlotTargets(i, processors, mixLevel, endpoints);
+
+    auto r = SlotRouting::stereoToStereo;
+    if constexpr (!forceStereo)
+    {
+        r = resolveSlotRouting(processors[i], processorConsumesMono[i], chainIsMono);
     }
+    dispatchSlot<OS>(r, processors[i], slotPitch(fpitch, i), mixLevel[i], input, output);
+
+    chainIsMono = (r == SlotRouting::monoToMono);
 
     // TODO: What was the filter_modout? Seems SC2 never finished it
     /*
@@ -153,30 +246,90 @@ inline bool allActive(Processor *processors[engine::processorCount], Indices...
     return (isActive(processors, idxs) && ...);
 }
 
-// -> 1 -> 2 -> 3 -> 4 ->
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
-inline void processSequential(PitchPtr fpitch, Processor *processors[engine::processorCount],
-                              bool processorConsumesMono[engine::processorCount], Mix &mix,
-                              Mix &outLev, Endpoints *endpoints, bool &chainIsMono,
-                              float output[2][N])
+/*
+ * The linear route flattened into the list of live slots, each with its mono/stereo routing
+ * already resolved. The plan is rebuilt only when a slot goes live or quiet or changes its
+ * mono capabilities, or the chain input changes width; otherwise each block just walks it.
+ */
+struct CompiledProcessorChain
 {
-    namespace mech = sst::basic_blocks::mechanics;
+    int count{0};
+    int8_t slot[engine::processorCount]{};
+    SlotRouting routing[engine::processorCount]{};
+    bool endsMono{false};
+
+    // what the plan was built from. -1 is an inactive slot, -2 has never been compiled
+    int8_t key[engine::processorCount]{-2, -2, -2, -2};
+    bool keyStartsMono{false};
+};
+
+inline void compileSequentialChain(CompiledProcessorChain &chain,
+                                   Processor *processors[engine::processorCount],
+                                   bool processorConsumesMono[engine::processorCount],
+                                   bool startsMono)
+{
+    static_assert(engine::processorCount == 4); // for the key init above
 
-    for (auto i = 0; i < engine::processorCount; ++i)
+    int8_t key[engine::processorCount];
+    bool same = (startsMono == chain.keyStartsMono);
+    for (int i = 0; i < engine::processorCount; ++i)
     {
-        if (isActive(processors, i))
+        if (!isActive(processors, i))
+        {
+            key[i] = -1;
+        }
+        else
         {
-            runSingleProcessor<OS, forceStereo>(i, fpitch, processors, processorConsumesMono, mix,
-                                                outLev, endpoints, chainIsMono, output, output);
+            auto cm = processorConsumesMono[i];
+            key[i] = (cm ? 1 : 0) | (cm && processors[i]->monoInputCreatesStereoOutput() ? 2 : 0);
         }
+        same = same && key[i] == chain.key[i];
+    }
+
+    if (same)
+        return;
+
+    auto mono = startsMono;
+    chain.count = 0;
+    for (int i = 0; i < engine::processorCount; ++i)
+    {
+        chain.key[i] = key[i];
+        if (key[i] < 0)
+            continue;
+
+        auto r = resolveSlotRouting(processors[i], processorConsumesMono[i], mono);
+        chain.slot[chain.count] = i;
+        chain.routing[chain.count] = r;
+        chain.count++;
+        mono = (r == SlotRouting::monoToMono);
+    }
+    chain.endsMono = mono;
+    chain.keyStartsMono = startsMono;
+}
+
+// -> 1 -> 2 -> 3 -> 4 ->
+template <bool OS, int N, typename MixLevel, typename Endpoints, typename PitchPtr>
+inline void processCompiledChain(const CompiledProcessorChain &chain, PitchPtr fpitch,
+                                 Processor *processors[engine::processorCount],
+                                 MixLevel &mixLevel, Endpoints *endpoints, bool &chainIsMono,
+                                 float output[2][N])
+{
+    for (int s = 0; s < chain.count; ++s)
+    {
+        auto i = chain.slot[s];
+        updateSlotTargets(i, processors, mixLevel, endpoints);
+        dispatchSlot<OS>(chain.routing[s], processors[i], slotPitch(fpitch, i), mixLevel[i],
+                         output, output);
     }
+    chainIsMono = chain.endsMono;
 }
 
 // -> { A | B } ->
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
 void processParallelPair(int A, int B, PitchPtr fpitch,
                          Processor *processors[engine::processorCount],
-                         bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
+                         bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
                          Endpoints *endpoints, bool &chainIsMono, float output[2][N])
 {
     namespace mech = sst::basic_blocks::mechanics;
@@ -190,15 +343,15 @@ void processParallelPair(int A, int B, PitchPtr fpitch,
     if (isActive(processors, A))
     {
         isMute[0] = false;
-        runSingleProcessor<OS, forceStereo>(A, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, m1, output, tmpbuf[0]);
+        runSingleProcessor<OS, forceStereo>(A, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, m1, output, tmpbuf[0]);
     }
 
     if (isActive(processors, B))
     {
         isMute[1] = false;
-        runSingleProcessor<OS, forceStereo>(B, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, m2, output, tmpbuf[1]);
+        runSingleProcessor<OS, forceStereo>(B, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, m2, output, tmpbuf[1]);
     }
 
     chainIsMono = m1 && m2;
@@ -250,53 +403,56 @@ void processParallelPair(int A, int B, PitchPtr fpitch,
 }
 
 // -> { 1 | 2 } -> { 3 | 4 } ->
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
 void processSer2Pattern(PitchPtr fpitch, Processor *processors[engine::processorCount],
-                        bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
+                        bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
                         Endpoints *endpoints, bool &chainIsMono, float output[2][N])
 {
     if (anyActive(processors, 0, 1))
     {
-        processParallelPair<OS, forceStereo>(0, 1, fpitch, processors, processorConsumesMono, mix,
-                                             outLev, endpoints, chainIsMono, output);
+        processParallelPair<OS, forceStereo>(0, 1, fpitch, processors, processorConsumesMono,
+                                             mixLevel, endpoints, chainIsMono, output);
     }
 
     if (anyActive(processors, 2, 3))
     {
-        processParallelPair<OS, forceStereo>(2, 3, fpitch, processors, processorConsumesMono, mix,
-                                             outLev, endpoints, chainIsMono, output);
+        processParallelPair<OS, forceStereo>(2, 3, fpitch, processors, processorConsumesMono,
+                                             mixLevel, endpoints, chainIsMono, output);
     }
 }
 
 // -> 1 -> { 2 | 3 } -> 4 ->
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
 void processSer3Pattern(PitchPtr fpitch, Processor *processors[engine::processorCount],
-                        bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
+                        bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
                         Endpoints *endpoints, bool &chainIsMono, float output[2][N])
 {
     if (isActive(processors, 0))
     {
-        runSingleProcessor<OS, forceStereo>(0, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, chainIsMono, output, output);
+        runSingleProcessor<OS, forceStereo>(0, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, chainIsMono, output, output);
     }
 
     if (anyActive(processors, 1, 2))
     {
-        processParallelPair<OS, forceStereo>(1, 2, fpitch, processors, processorConsumesMono, mix,
-                                             outLev, endpoints, chainIsMono, output);
+        processParallelPair<OS, forceStereo>(1, 2, fpitch, processors, processorConsumesMono,
+                                             mixLevel, endpoints, chainIsMono, output);
     }
 
     if (isActive(processors, 3))
     {
-        runSingleProcessor<OS, forceStereo>(3, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, chainIsMono, output, output);
+        runSingleProcessor<OS, forceStereo>(3, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, chainIsMono, output, output);
     }
 }
 
 // All in parallel
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
 void processPar1Pattern(PitchPtr fpitch, Processor *processors[engine::processorCount],
-                        bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
+                        bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
                         Endpoints *endpoints, bool &chainIsMono, float output[2][N])
 {
     namespace mech = sst::basic_blocks::mechanics;
@@ -313,8 +469,9 @@ void processPar1Pattern(PitchPtr fpitch, Processor *processors[engine::processor
         if (isActive(processors, i))
         {
             isMute[i] = false;
-            runSingleProcessor<OS, forceStereo>(i, fpitch, processors, processorConsumesMono, mix,
-                                                outLev, endpoints, localMono[i], output, tmpbuf[i]);
+            runSingleProcessor<OS, forceStereo>(i, fpitch, processors, processorConsumesMono,
+                                                mixLevel, endpoints, localMono[i], output,
+                                                tmpbuf[i]);
         }
         else
         {
@@ -364,9 +521,10 @@ void processPar1Pattern(PitchPtr fpitch, Processor *processors[engine::processor
 }
 
 // -> { { 1->2} | { 3->4 } ->
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
 void processPar2Pattern(PitchPtr fpitch, Processor *processors[engine::processorCount],
-                        bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
+                        bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
                         Endpoints *endpoints, bool &chainIsMono, float output[2][N])
 {
     namespace mech = sst::basic_blocks::mechanics;
@@ -394,13 +552,13 @@ void processPar2Pattern(PitchPtr fpitch, Processor *processors[engine::processor
 
     if (isActive(processors, 0))
     {
-        runSingleProcessor<OS, forceStereo>(0, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, mono12, tempbuf12, tempbuf12);
+        runSingleProcessor<OS, forceStereo>(0, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, mono12, tempbuf12, tempbuf12);
     }
     if (isActive(processors, 1))
     {
-        runSingleProcessor<OS, forceStereo>(1, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, mono12, tempbuf12, tempbuf12);
+        runSingleProcessor<OS, forceStereo>(1, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, mono12, tempbuf12, tempbuf12);
     }
 
     if (anyActive(processors, 2, 3))
@@ -418,13 +576,13 @@ void processPar2Pattern(PitchPtr fpitch, Processor *processors[engine::processor
 
     if (isActive(processors, 2))
     {
-        runSingleProcessor<OS, forceStereo>(2, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, mono34, tempbuf34, tempbuf34);
+        runSingleProcessor<OS, forceStereo>(2, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, mono34, tempbuf34, tempbuf34);
     }
     if (isActive(processors, 3))
     {
-        runSingleProcessor<OS, forceStereo>(3, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, mono34, tempbuf34, tempbuf34);
+        runSingleProcessor<OS, forceStereo>(3, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, mono34, tempbuf34, tempbuf34);
     }
 
     if constexpr (!forceStereo)
@@ -490,9 +648,10 @@ void processPar2Pattern(PitchPtr fpitch, Processor *processors[engine::processor
 }
 
 // -> { 1 | 2 | 3 } -> 4
-template <bool OS, bool forceStereo, int N, typename Mix, typename Endpoints, typename PitchPtr>
+template <bool OS, bool forceStereo, int N, typename MixLevel, typename Endpoints,
+          typename PitchPtr>
 void processPar3Pattern(PitchPtr fpitch, Processor *processors[engine::processorCount],
-                        bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
+                        bool processorConsumesMono[engine::processorCount], MixLevel &mixLevel,
                         Endpoints *endpoints, bool &chainIsMono, float output[2][N])
 {
     namespace mech = sst::basic_blocks::mechanics;
@@ -511,22 +670,22 @@ void processPar3Pattern(PitchPtr fpitch, Processor *processors[engine::processor
         if (isActive(processors, 0))
         {
             isMute[0] = false;
-            runSingleProcessor<OS, forceStereo>(0, fpitch, processors, processorConsumesMono, mix,
-                                                outLev, endpoints, m1, output, tmpbuf[0]);
+            runSingleProcessor<OS, forceStereo>(0, fpitch, processors, processorConsumesMono,
+                                                mixLevel, endpoints, m1, output, tmpbuf[0]);
         }
 
         if (isActive(processors, 1))
         {
             isMute[1] = false;
-            runSingleProcessor<OS, forceStereo>(1, fpitch, processors, processorConsumesMono, mix,
-                                                outLev, endpoints, m2, output, tmpbuf[1]);
+            runSingleProcessor<OS, forceStereo>(1, fpitch, processors, processorConsumesMono,
+                                                mixLevel, endpoints, m2, output, tmpbuf[1]);
         }
 
         if (isActive(processors, 2))
         {
             isMute[2] = false;
-            runSingleProcessor<OS, forceStereo>(2, fpitch, processors, processorConsumesMono, mix,
-                                                outLev, endpoints, m3, output, tmpbuf[2]);
+            runSingleProcessor<OS, forceStereo>(2, fpitch, processors, processorConsumesMono,
+                                                mixLevel, endpoints, m3, output, tmpbuf[2]);
         }
 
         chainIsMono = m1 && m2 && m3;
@@ -582,8 +741,8 @@ void processPar3Pattern(PitchPtr fpitch, Processor *processors[engine::processor
 
     if (isActive(processors, 3))
     {
-        runSingleProcessor<OS, forceStereo>(3, fpitch, processors, processorConsumesMono, mix,
-                                            outLev, endpoints, chainIsMono, output, output);
+        runSingleProcessor<OS, forceStereo>(3, fpitch, processors, processorConsumesMono, mixLevel,
+                                            endpoints, chainIsMono, output, output);
     }
 }
 
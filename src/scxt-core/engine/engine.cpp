@@ -37,6 +37,7 @@
 #include "part.h"
 #include "sst/cpputils/iterators.h"
 #include "voice/voice.h"
+#include "modulation/modulators/shared_lfo_pool.h"
 #include "dsp/data_tables.h"
 #include "tuning/equal.h"
 #include "tuning/scl_kbm.h"
@@ -58,6 +59,7 @@
 #include "sample/multisample_support/multisample_import.h"
 #include "infrastructure/user_defaults.h"
 #include "infrastructure/md5support.h"
+#include "infrastructure/realtime_safety.h"
 #include "browser/browser.h"
 #include "browser/browser_db.h"
 
@@ -77,6 +79,7 @@
 #include "missing_resolution.h"
 #include "sst/voicemanager/midi1_to_voicemanager.h"
 #include "voice/preview_voice.h"
+#include "voice/preview_decoder.h"
 #include "clipboard_impl.h"
 
 #include "sst/basic-blocks/dsp/EllipticBlepOscillators.h"
@@ -84,7 +87,9 @@
 namespace scxt::engine
 {
 
-Engine::Engine()
+Engine::Engine() : Engine(std::nullopt) {}
+
+Engine::Engine(const std::optional<fs::path> &storageDirectory)
 {
     SCLOG_IF(always, "Shortcircuit XT : Constructing Engine");
     SCLOG_IF(always,
@@ -98,6 +103,7 @@ Engine::Engine()
     id.id = rng.unifU32() % 1024;
 
     messageController = std::make_unique<messaging::MessageController>(*this);
+    sharedLFOPool = std::make_unique<modulation::modulators::SharedLFOPool>(rng);
     dsp::sincTable.init();
     dsp::dbTable.init();
     dsp::twoToTheXTable.init();
@@ -119,7 +125,11 @@ Engine::Engine()
     patch = std::make_unique<Patch>();
     patch->parentEngine = this;
 
-    auto tdp = setupUserStorageDirectory();
+    auto tdp = storageDirectory;
+    if (tdp.has_value())
+        fs::create_directories(*tdp);
+    else
+        tdp = setupUserStorageDirectory();
     fs::path useTDP;
 
     if (tdp.has_value())
@@ -194,11 +204,33 @@ Engine::Engine()
     voice::modulation::sourcesForScanning();
 
     previewVoice = std::make_unique<voice::PreviewVoice>();
+    previewDecoder = std::make_unique<voice::PreviewDecoder>();
 
     runtimeConfig.defaultOmniFlavor = static_cast<OmniFlavor>(
         defaults->getUserDefaultValue(scxt::infrastructure::DefaultKeys::omniFlavor, 0));
     runtimeConfig.omniFlavor = runtimeConfig.defaultOmniFlavor;
 
+    auto residencyMB = defaults->getUserDefaultValue(
+        scxt::infrastructure::DefaultKeys::sampleResidencyCacheMB,
+        (int)sample::SampleManager::defaultResidencyCacheBudgetMB);
+    sampleManager->setResidencyCacheBudget((uint64_t)std::max(residencyMB, 0) * 1024 * 1024);
+
+    auto decodedCacheMB = defaults->getUserDefaultValue(
+        scxt::infrastructure::DefaultKeys::decodedSampleCacheMB,
+        (int)sample::DecodedSampleCache::defaultBudgetMB);
+    if (decodedCacheMB > 0)
+    {
+        sampleManager->decodedCache.configure(useTDP / "DecodedSampleCache",
+                                              (uint64_t)decodedCacheMB * 1024 * 1024);
+    }
+    sampleManager->mapWavSamplesInPlace =
+        defaults->getUserDefaultValue(scxt::infrastructure::DefaultKeys::mapWavSamplesInPlace,
+                                      false);
+
+    voiceGovernor.budgetPercent = (float)std::max(
+        defaults->getUserDefaultValue(scxt::infrastructure::DefaultKeys::voiceCPUBudgetPercent, 0),
+        0);
+
     onPartConfigurationUpdated();
 }
 
@@ -364,6 +396,8 @@ bool Engine::processAudio()
     auto processingStartTime = std::chrono::high_resolution_clock::now();
 
     namespace mech = sst::basic_blocks::mechanics;
+    namespace rts = infrastructure::realtime;
+    rts::RealtimeScope realtimeScope("Engine::processAudio");
 #if BUILD_IS_DEBUG
     messageController->threadingChecker.registerAsAudioThread();
 #endif
@@ -371,7 +405,12 @@ bool Engine::processAudio()
     messageController->isAudioRunning = true;
     auto av = (uint32_t)activeVoices;
 
-    drainSerialToEngineQueue();
+    {
+        rts::RealtimeStage stage("drainSerialToEngineQueue");
+        drainSerialToEngineQueue();
+    }
+
+    sharedLFOPool->beginBlock();
 
     if (stopEngineRequests > 0)
     {
@@ -380,11 +419,21 @@ bool Engine::processAudio()
         return true;
     }
 
-    // process clears the busses it is about to accumulate onto
-    getPatch()->process(*this);
+    if (voiceGovernor.isEnabled())
+    {
+        rts::RealtimeStage stage("VoiceGovernor::enforce");
+        voiceGovernor.enforce(voices);
+    }
+
+    {
+        // process clears the busses it is about to accumulate onto
+        rts::RealtimeStage stage("Patch::process");
+        getPatch()->process(*this);
+    }
 
     if (previewVoice->isActive)
     {
+        rts::RealtimeStage stage("PreviewVoice::processBlock");
         previewVoice->processBlock();
 
         auto &main = getPatch()->busses.mainBus.output;
@@ -514,6 +563,7 @@ void Engine::drainSerialToEngineQueue()
         {
             // We know this will lock and potentailly allocate so for now don't add rtsan noise
             SST_CPPUTILS_RTSAN_DISABLE;
+            infrastructure::realtime::RealtimeAllowedScope allowLockAndAllocate;
             std::lock_guard<std::mutex> structG(modifyStructureMutex);
             auto cb =
                 static_cast<messaging::MessageController::AudioThreadCallback *>(msgopt->payload.p);
@@ -1690,6 +1740,7 @@ void Engine::setMacro01ValueFromPlugin(int part, int index, float value01)
     assert(part >= 0 && part < scxt::numParts);
     assert(index >= 0 && index < scxt::macrosPerPart);
     getPatch()->getPart(part)->macros[index].setValue01(value01);
+    markPartStreamStateChanged(part);
 
     scxt::messaging::audio::AudioToSerialization a2s;
     a2s.id = messaging::audio::a2s_macro_updated;
@@ -1699,7 +1750,7 @@ void Engine::setMacro01ValueFromPlugin(int part, int index, float value01)
     getMessageController()->sendAudioToSerialization(a2s);
 }
 
-void Engine::processMIDI1Event(uint16_t idx, const uint8_t data[3])
+void Engine::processMIDI1Event(uint16_t idx, const uint8_t data[3], int32_t sampleOffset)
 {
     auto msg = data[0] & 0xf0;
     auto chan = data[0] & 0x0f;
@@ -1719,7 +1770,7 @@ void Engine::processMIDI1Event(uint16_t idx, const uint8_t data[3])
     auto vel = sst::voicemanager::midiToFloatVelocity(data[2]);
     if (msg == 0x90 && data[2] != 0)
     {
-        processNoteOnEvent(idx, chan, data[1], -1, vel, 0.f);
+        processNoteOnEvent(idx, chan, data[1], -1, vel, 0.f, sampleOffset);
         return;
     }
     if (msg == 0x80 || msg == 0x90)
@@ -1747,10 +1798,24 @@ void Engine::processProgramChangeEvent(int16_t port, int16_t channel, int16_t pr
 }
 
 void Engine::processNoteOnEvent(int16_t port, int16_t channel, int16_t key, int32_t note_id,
-                                double velocity, float retune)
+                                double velocity, float retune, int32_t sampleOffset)
 {
     heldNotes.noteOn(channel, key, note_id, (float)velocity);
+
+    // The voice manager has no idea of time within a block, so hand the offset to our
+    // responder around the call the way the release trigger pass does
+    noteOnSampleOffset = std::clamp(sampleOffset, 0, (int32_t)blockSize - 1);
     voiceManager.processNoteOnEvent(port, channel, key, note_id, velocity, retune);
+    noteOnSampleOffset = 0;
+}
+
+std::optional<int32_t> Engine::blockEventOffset(int64_t time, int64_t blockStart, bool isNoteOn)
+{
+    if (time <= blockStart)
+        return 0;
+    if (isNoteOn && time < blockStart + blockSize)
+        return (int32_t)(time - blockStart);
+    return std::nullopt;
 }
 
 void Engine::processNoteOffEvent(int16_t port, int16_t channel, int16_t key, int32_t note_id,
@@ -1793,6 +1858,17 @@ void Engine::fireReleaseTriggers(int16_t port, int16_t channel, int16_t key, int
     inReleaseTriggerPass = false;
 }
 
+void Engine::markPartStreamStateChanged(int part)
+{
+    if (part >= 0 && part < numParts)
+    {
+        getPatch()->getPart(part)->streamGeneration++;
+        return;
+    }
+    for (const auto &p : *getPatch())
+        p->streamGeneration++;
+}
+
 void Engine::onPartConfigurationUpdated()
 {
     auto midiM = (runtimeConfig.omniFlavor == OmniFlavor::MPE)
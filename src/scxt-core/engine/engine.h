@@ -46,6 +46,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <set>
 #include <cassert>
 #include <thread>
@@ -61,6 +62,7 @@
 #include "modulation/group_matrix.h"
 
 #include "undo_manager/undo.h"
+#include "voice_governor.h"
 
 #define DEBUG_VOICE_LIFECYCLE 0
 
@@ -68,6 +70,7 @@ namespace scxt::voice
 {
 struct Voice;
 struct PreviewVoice;
+struct PreviewDecoder;
 } // namespace scxt::voice
 namespace scxt::messaging
 {
@@ -77,6 +80,10 @@ namespace scxt::infrastructure
 {
 struct DefaultsProvider;
 }
+namespace scxt::modulation::modulators
+{
+struct SharedLFOPool;
+}
 namespace scxt::browser
 {
 struct Browser;
@@ -88,6 +95,11 @@ namespace scxt::engine
 struct Engine : MoveableOnly<Engine>, SampleRateSupport
 {
     Engine();
+    /*
+     * Keep the defaults and the browser database in storageDirectory rather than the user's
+     * documents directory. Tests use this so they never write into user storage.
+     */
+    explicit Engine(const std::optional<fs::path> &storageDirectory);
     ~Engine();
 
     EngineID id;
@@ -95,6 +107,7 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     const std::unique_ptr<Patch> &getPatch() const { return patch; }
     const std::unique_ptr<sample::SampleManager> &getSampleManager() const { return sampleManager; }
     const std::unique_ptr<browser::Browser> &getBrowser() const { return browser; }
+    const std::unique_ptr<browser::BrowserDB> &getBrowserDB() const { return browserDb; }
 
     std::unique_ptr<infrastructure::DefaultsProvider> defaults;
 
@@ -120,16 +133,32 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     void onTransportUpdated();
 
     /**
-     * Midi-style events. Each event is assumed to be at the top of the
-     * blockSize sample block
+     * Midi-style events. Each event is handled at the top of the blockSize sample
+     * block. A note on can say where in the upcoming block it really lands with
+     * sampleOffset (0 to blockSize-1); the voices it starts then begin on that sample.
      */
-    void processMIDI1Event(uint16_t midiPort, const uint8_t data[3]);
+    void processMIDI1Event(uint16_t midiPort, const uint8_t data[3], int32_t sampleOffset = 0);
     void processProgramChangeEvent(int16_t port, int16_t channel, int16_t program);
     void processNoteOnEvent(int16_t port, int16_t channel, int16_t key, int32_t note_id,
-                            double velocity, float retune);
+                            double velocity, float retune, int32_t sampleOffset = 0);
     void processNoteOffEvent(int16_t port, int16_t channel, int16_t key, int32_t note_id,
                              double velocity);
 
+    /**
+     * Hosts timestamp events inside their buffers and we run them at block tops. At the top
+     * of the block starting at blockStart, an event runs now with offset 0 if it is due, and a
+     * note on landing inside the block runs now with its offset into it. Anything else inside
+     * the block waits for the next top, so it acts at most blockSize-1 samples late and never
+     * early; nothing is returned then and the caller stops walking so later events, note ons
+     * included, stay behind it.
+     */
+    static std::optional<int32_t> blockEventOffset(int64_t time, int64_t blockStart,
+                                                   bool isNoteOn);
+    static bool isMIDI1NoteOn(const uint8_t data[3])
+    {
+        return (data[0] & 0xf0) == 0x90 && data[2] != 0;
+    }
+
     /*
      * Groups which create voices on release. The press is remembered in heldNotes so the
      * release can play it at the velocity it arrived with; fireReleaseTriggers then runs a
@@ -140,6 +169,9 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
      */
     HeldNotes heldNotes;
     bool inReleaseTriggerPass{false};
+
+    // The sample offset of the note on currently in the voice manager; see Voice::startOffset
+    int32_t noteOnSampleOffset{0};
     void fireReleaseTriggers(int16_t port, int16_t channel, int16_t key, int32_t note_id);
     bool anyGroupCreatesVoicesOnRelease() const;
 
@@ -299,6 +331,14 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
 
     void onPartConfigurationUpdated();
 
+    /*
+     * Bump the stream generation of one part, or of every part with -1. The serialization
+     * thread calls this after each client message which may edit parts, host macro
+     * automation calls it for its part, and unstreaming calls it for what it replaced.
+     * Lock free, so callable from the audio thread.
+     */
+    void markPartStreamStateChanged(int part);
+
     tuning::MidikeyRetuner midikeyRetuner;
 
     enum struct TuningMode
@@ -491,6 +531,7 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     uint64_t nextVoiceCreationId{1};
 
     std::unique_ptr<voice::PreviewVoice> previewVoice;
+    std::unique_ptr<voice::PreviewDecoder> previewDecoder;
 
     const std::unique_ptr<messaging::MessageController> &getMessageController() const
     {
@@ -759,6 +800,14 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
         return memoryPool;
     }
 
+    const std::unique_ptr<modulation::modulators::SharedLFOPool> &getSharedLFOPool() const
+    {
+        return sharedLFOPool;
+    }
+
+    // Audio thread only; see VoiceGovernor. Set up from the user defaults at construction.
+    VoiceGovernor voiceGovernor;
+
     std::atomic<int32_t> stopEngineRequests{0};
 
     /*
@@ -910,6 +959,7 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     std::unique_ptr<uint8_t[]> voiceInPlaceBuffer{nullptr};
     std::unique_ptr<messaging::MessageController> messageController;
     std::unique_ptr<selection::SelectionManager> selectionManager;
+    std::unique_ptr<modulation::modulators::SharedLFOPool> sharedLFOPool;
 
     static constexpr size_t cpuAverageObservation{64};
     size_t cpuWP{0};
@@ -102,6 +102,7 @@ int32_t Engine::VoiceManagerResponder::initializeMultipleVoices(
     // A release trigger's voices are let go by the very note-off which made them, so no
     // envelope on them can wait on the gate - see Voice::createdByReleaseTrigger
     auto byReleaseTrigger = engine.inReleaseTriggerPass;
+    auto startOffset = engine.noteOnSampleOffset;
 
     for (auto idx = 0; idx < nts; ++idx)
     {
@@ -131,6 +132,7 @@ int32_t Engine::VoiceManagerResponder::initializeMultipleVoices(
                 v->originalMidiKey = key;
 
                 v->createdByReleaseTrigger = byReleaseTrigger;
+                v->startOffset = startOffset;
                 v->attack();
                 glideFromPriorVoice(v, idx);
 
@@ -164,6 +166,7 @@ int32_t Engine::VoiceManagerResponder::initializeMultipleVoices(
 
                     v->originalMidiKey = key;
                     v->createdByReleaseTrigger = byReleaseTrigger;
+                    v->startOffset = startOffset;
                     v->attack();
                     glideFromPriorVoice(v, idx);
 
@@ -42,29 +42,63 @@
 #include "engine.h"
 #include "group_and_zone_impl.h"
 #include "dsp/processor/routing.h"
+#include "dsp/mix_kernels.h"
 
 namespace scxt::engine
 {
 
 Group::Group(sst::basic_blocks::dsp::RNG &engineRNG)
     : id(GroupID::next()), name(id.to_string()), endpoints{nullptr},
-      modulation::shared::HasModulators<Group, egsPerGroup>(this, engineRNG), osDownFilter(6, true)
+      modulation::shared::HasModulators<Group, egsPerGroup>(this, engineRNG),
+      osDownFilter(makeDecimator(OSQ_HIGH)), sharedVoiceDownFilter(makeDecimator(OSQ_HIGH))
 {
 }
 
-void Group::rePrepareAndBindGroupMatrix()
+sst::filters::HalfRate::HalfRateFilter Group::makeDecimator(OversampleQuality q)
 {
-    for (int i = 0; i < lfosPerGroup; ++i)
+    switch (q)
     {
-        const auto &ms = modulatorStorage[i];
-        lfoEvaluator[i] = ms.isStep() ? STEP : (ms.isEnv() ? ENV : (ms.isMSEG() ? MSEG : CURVE));
+    case OSQ_LOW:
+        return {2, true};
+    case OSQ_MEDIUM:
+        return {4, true};
+    case OSQ_HIGH:
+        break;
     }
+    return {6, true};
+}
+
+void Group::updateDecimatorQuality()
+{
+    if (lastOversampleQuality == outputInfo.oversampleQuality)
+        return;
+
+    // a fresh filter has reset state, which is what a length change needs anyway
+    lastOversampleQuality = outputInfo.oversampleQuality;
+    osDownFilter = makeDecimator(lastOversampleQuality);
+    sharedVoiceDownFilter = makeDecimator(lastOversampleQuality);
+}
+
+void Group::rePrepareAndBindGroupMatrix()
+{
+    std::array<bool, lfosPerGroup> newlyBuilt{};
+    for (int i = 0; i < lfosPerGroup; ++i)
+        newlyBuilt[i] = setLFOEvaluator(i, evaluatorFor(modulatorStorage[i]));
 
     endpoints.sources.bind(modMatrix, *this);
     modMatrix.prepare(routingTable, getSampleRate(), blockSize);
     endpoints.bindTargetBaseValues(modMatrix, *this);
     modMatrix.process();
 
+    // An LFO whose shape changed category has a fresh evaluator, which needs assigning
+    // before it next runs
+    if (getEngine())
+    {
+        for (int i = 0; i < lfosPerGroup; ++i)
+            if (newlyBuilt[i])
+                assignLFOEvaluator(i);
+    }
+
     std::fill(lfosActive.begin(), lfosActive.end(), false);
     std::fill(envFollowersActive.begin(), envFollowersActive.end(), false);
     egsActive[0] = false; // no AEG here
@@ -149,6 +183,7 @@ template <bool OS> void Group::processWithOS(scxt::engine::Engine &e)
         envelopeFollowers[0].ballistics.setSampleRate(sampleRate * (outputInfo.oversample ? 2 : 1));
         envelopeFollowers[1].ballistics.setSampleRate(sampleRate * (outputInfo.oversample ? 2 : 1));
     }
+    updateDecimatorQuality();
 
     namespace blk = sst::basic_blocks::mechanics;
 
@@ -247,6 +282,7 @@ template <bool OS> void Group::processWithOS(scxt::engine::Engine &e)
 
     auto oAZ = activeZones;
     rescanWeakRefs = 0;
+    bool sharedVoiceOSWritten{false};
     for (int i = 0; i < activeZones; ++i)
     {
         auto z = activeZoneWeakRefs[i];
@@ -272,10 +308,32 @@ template <bool OS> void Group::processWithOS(scxt::engine::Engine &e)
             {
                 blk::accumulate_from_to<blockSize>(z->output[0], lOut);
                 blk::accumulate_from_to<blockSize>(z->output[1], rOut);
+                if (z->hasOSOutput)
+                {
+                    dsp::copyOrAccumulate<blockSize << 1>(sharedVoiceOSWritten, z->outputOS[0],
+                                                          z->outputOS[1], sharedVoiceOS[0],
+                                                          sharedVoiceOS[1]);
+                    sharedVoiceOSWritten = true;
+                }
             }
         }
     }
 
+    if constexpr (!OS)
+    {
+        if (sharedVoiceOSWritten)
+        {
+            // after a gap the filter holds the tail of whatever last went through it
+            if (!previousHadSharedVoiceOS)
+                sharedVoiceDownFilter.reset();
+            sharedVoiceDownFilter.process_block_D2(sharedVoiceOS[0], sharedVoiceOS[1],
+                                                   blockSize << 1);
+            blk::accumulate_from_to<blockSize>(sharedVoiceOS[0], lOut);
+            blk::accumulate_from_to<blockSize>(sharedVoiceOS[1], rOut);
+        }
+        previousHadSharedVoiceOS = sharedVoiceOSWritten;
+    }
+
     /*
      * Legato parking: a voice which ran out of sound in a LEGATO group stays alive so a later
      * legato move can re-attack that same voice (see Voice::isParked). Once nothing in the
@@ -334,13 +392,13 @@ template <bool OS> void Group::processWithOS(scxt::engine::Engine &e)
     if constexpr (OS)                                                                              \
     {                                                                                              \
         scxt::dsp::processor::FNN<OS, true>(groupProcPitches, processors.data(),                   \
-                                            processorConsumesMono, processorMixOS,                 \
-                                            processorLevelOS, &endpoints, chainIsMono, output);    \
+                                            processorConsumesMono, processorMixLevelOS,            \
+                                            &endpoints, chainIsMono, output);                      \
     }                                                                                              \
     else                                                                                           \
     {                                                                                              \
         scxt::dsp::processor::FNN<OS, true>(groupProcPitches, processors.data(),                   \
-                                            processorConsumesMono, processorMix, processorLevel,   \
+                                            processorConsumesMono, processorMixLevel,              \
                                             &endpoints, chainIsMono, output);                      \
     }
 
@@ -348,7 +406,20 @@ template <bool OS> void Group::processWithOS(scxt::engine::Engine &e)
         {
         case engine::HasGroupZoneProcessors<engine::Group>::procRoute_linear:
         {
-            CALL_ROUTE(processSequential);
+            dsp::processor::compileSequentialChain(processorChain, processors.data(),
+                                                   processorConsumesMono, chainIsMono);
+            if constexpr (OS)
+            {
+                dsp::processor::processCompiledChain<OS>(processorChain, groupProcPitches,
+                                                         processors.data(), processorMixLevelOS,
+                                                         &endpoints, chainIsMono, output);
+            }
+            else
+            {
+                dsp::processor::processCompiledChain<OS>(processorChain, groupProcPitches,
+                                                         processors.data(), processorMixLevel,
+                                                         &endpoints, chainIsMono, output);
+            }
         }
         break;
         case engine::HasGroupZoneProcessors<engine::Group>::procRoute_ser2:
@@ -566,11 +637,7 @@ void Group::setupOnUnstream(engine::Engine &e)
 
     for (auto i = 0U; i < engine::lfosPerGroup; ++i)
     {
-        stepLfos[i].setSampleRate(sampleRate, sampleRateInv);
-
-        stepLfos[i].assign(&modulatorStorage[i], endpoints.lfo[i].rateP, &(getEngine()->transport),
-                           getEngine()->rng);
-        curveLfos[i].assign(&modulatorStorage[i], &(getEngine()->transport));
+        assignLFOEvaluator(i);
     }
 
     for (int i = 0U; i < envFollowersPerGroupOrZone; ++i)
@@ -721,11 +788,11 @@ void Group::attack()
                 }
 
                 // Looping envelopes are basically unipolar lfos so follow lfos
-                if (ms.isEnv() && !ms.envLfoStorage.loop)
+                if (lfoEvaluator[i] == ENV && !ms.envLfoStorage.loop)
                 {
-                    envLfos[i].attackFrom(envLfos[i].envelope.outBlock0,
-                                          *endpoints.lfo[i].env.delayP,
-                                          *endpoints.lfo[i].env.attackP);
+                    envLfo(i).attackFrom(envLfo(i).envelope.outBlock0,
+                                         *endpoints.lfo[i].env.delayP,
+                                         *endpoints.lfo[i].env.attackP);
                 }
             }
         }
@@ -739,17 +806,17 @@ void Group::attack()
     for (int i = 0; i < processorsPerZoneAndGroup; ++i)
     {
         const auto &ps = processorStorage[i];
-        processorMix[i].set_target_instant(ps.mix);
-        processorMixOS[i].set_target_instant(ps.mix);
-
         auto ol = ps.outputCubAmp;
         ol = ol * ol * ol * dsp::processor::ProcessorStorage::maxOutputAmp;
-        processorLevel[i].set_target_instant(ol);
-        processorLevelOS[i].set_target_instant(ol);
+        processorMixLevel[i].setTargetsInstant(ps.mix, ol);
+        processorMixLevelOS[i].setTargetsInstant(ps.mix, ol);
     }
 
     resetLFOs();
+    updateDecimatorQuality();
     osDownFilter.reset();
+    sharedVoiceDownFilter.reset();
+    previousHadSharedVoiceOS = false;
     for (int i = 0; i < egsPerGroup; ++i)
     {
         eg[i].attackFrom(0.f);
@@ -850,28 +917,8 @@ void Group::resetLFOs(int whichLFO)
     {
         const auto &ms = modulatorStorage[i];
 
-        lfoEvaluator[i] = ms.isStep() ? STEP : (ms.isEnv() ? ENV : (ms.isMSEG() ? MSEG : CURVE));
-
-        if (lfoEvaluator[i] == STEP)
-        {
-            stepLfos[i].setSampleRate(sampleRate, sampleRateInv);
-
-            stepLfos[i].assign(&modulatorStorage[i], endpoints.lfo[i].rateP,
-                               &(getEngine()->transport), getEngine()->rng);
-            curveLfos[i].assign(&modulatorStorage[i], &(getEngine()->transport));
-        }
-        else if (lfoEvaluator[i] == CURVE)
-        {
-            curveLfos[i].setSampleRate(sampleRate, sampleRateInv);
-        }
-        else if (lfoEvaluator[i] == ENV)
-        {
-            envLfos[i].setSampleRate(sampleRate, sampleRateInv);
-        }
-        else
-        {
-            SCLOG_IF(warnings, "Unimplemented modulator shape " << ms.modulatorShape);
-        }
+        setLFOEvaluator(i, evaluatorFor(ms));
+        assignLFOEvaluator(i);
 
         // RELEASE holds off until the group ungates; everything else starts here.
         if (ms.triggerMode == modulation::ModulatorStorage::RELEASE)
@@ -889,6 +936,29 @@ void Group::resetLFOs(int whichLFO)
     phasorEvaluator.attack(getEngine()->transport, miscSourceStorage, getEngine()->rng);
 }
 
+void Group::assignLFOEvaluator(int i)
+{
+    const auto &ms = modulatorStorage[i];
+    switch (lfoEvaluator[i])
+    {
+    case STEP:
+        stepLfo(i).setSampleRate(sampleRate, sampleRateInv);
+        stepLfo(i).assign(&modulatorStorage[i], endpoints.lfo[i].rateP, &(getEngine()->transport),
+                          getEngine()->rng);
+        break;
+    case CURVE:
+        curveLfo(i).setSampleRate(sampleRate, sampleRateInv);
+        curveLfo(i).assign(&modulatorStorage[i], &(getEngine()->transport));
+        break;
+    case ENV:
+        envLfo(i).setSampleRate(sampleRate, sampleRateInv);
+        break;
+    default:
+        SCLOG_IF(warnings, "Unimplemented modulator shape " << ms.modulatorShape);
+        break;
+    }
+}
+
 bool Group::isActive() const
 {
     auto haz = hasActiveZones();
@@ -1044,5 +1114,30 @@ Group::NotePriority Group::fromStringNotePriority(const std::string &s)
     return p->second;
 }
 
+std::string Group::toStringOversampleQuality(const OversampleQuality &m)
+{
+    switch (m)
+    {
+    case OSQ_LOW:
+        return "lo";
+    case OSQ_MEDIUM:
+        return "med";
+    case OSQ_HIGH:
+        return "hi";
+    }
+    return "hi";
+}
+
+Group::OversampleQuality Group::fromStringOversampleQuality(const std::string &s)
+{
+    static auto inverse =
+        makeEnumInverse<Group::OversampleQuality, Group::toStringOversampleQuality>(
+            Group::OversampleQuality::OSQ_LOW, Group::OversampleQuality::OSQ_HIGH);
+    auto p = inverse.find(s);
+    if (p == inverse.end())
+        return OSQ_HIGH;
+    return p->second;
+}
+
 template struct HasGroupZoneProcessors<Group>;
 } // namespace scxt::engine
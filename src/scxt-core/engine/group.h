@@ -46,6 +46,7 @@
 #include "modulation/group_matrix.h"
 #include "modulation/has_modulators.h"
 #include "group_triggers.h"
+#include "dsp/processor/routing.h"
 
 namespace scxt::engine
 {
@@ -98,11 +99,24 @@ struct Group : MoveableOnly<Group>,
     };
     DECLARE_ENUM_STRING(NotePriority);
 
+    // Filter length for the group's 2x decimators; HIGH is the historical (6, steep) halfband
+    enum OversampleQuality : int32_t
+    {
+        OSQ_LOW = 0,
+        OSQ_MEDIUM,
+        OSQ_HIGH
+    };
+    DECLARE_ENUM_STRING(OversampleQuality);
+
     struct GroupOutputInfo
     {
         float amplitude{1.f}, pan{0.f}, velocitySensitivity{0.6f}, tuning{0.f};
         bool muted{false};
         bool oversample{true};
+        OversampleQuality oversampleQuality{OSQ_HIGH};
+        // With oversample off, voices which pitch up past aliasing hand their 2x block to the
+        // group for one decimation rather than each running their own. See Voice::voiceStarted
+        bool sharedVoiceDecimation{false};
 
         ProcRoutingPath procRouting{procRoute_linear};
         bool procRoutingConsistent{true};
@@ -145,9 +159,12 @@ struct Group : MoveableOnly<Group>,
     void warmup();
     void attack();
     void resetLFOs(int whichLFO = -1);
+    // Point LFO i's evaluator at its storage, transport and sample rate
+    void assignLFOEvaluator(int i);
     void process(Engine &onto);
     template <bool OS> void processWithOS(Engine &onto);
     bool lastOversample{true};
+    OversampleQuality lastOversampleQuality{OSQ_HIGH};
 
     void setupOnUnstream(engine::Engine &e);
     void onGroupMidiChannelSubscriptionChanged();
@@ -265,6 +282,17 @@ struct Group : MoveableOnly<Group>,
     }
 
     sst::filters::HalfRate::HalfRateFilter osDownFilter;
+    static sst::filters::HalfRate::HalfRateFilter makeDecimator(OversampleQuality q);
+    void updateDecimatorQuality();
+
+    /*
+     * The shared voice decimation sum. Zones leave their 2x voices in Zone::outputOS and
+     * we add them here, so the halfband runs once per group per block however many voices
+     * fed it.
+     */
+    float sharedVoiceOS alignas(16)[2][blockSize << 1];
+    sst::filters::HalfRate::HalfRateFilter sharedVoiceDownFilter;
+    bool previousHadSharedVoiceOS{false};
 
     /*
      * One of the core differences between zone and group is, since group is monophonic,
@@ -302,10 +330,9 @@ struct Group : MoveableOnly<Group>,
         16)[engine::processorCount][dsp::processor::processorMemoryBufferSize];
     int32_t processorIntParams alignas(
         16)[engine::processorCount][dsp::processor::maxProcessorIntParams];
-    lipol processorMix[engine::processorCount];
-    lipolOS processorMixOS[engine::processorCount];
-    lipol processorLevel[engine::processorCount];
-    lipolOS processorLevelOS[engine::processorCount];
+    dsp::processor::ProcessorMixLevel<blockSize> processorMixLevel[engine::processorCount];
+    dsp::processor::ProcessorMixLevel<(blockSize << 1)> processorMixLevelOS[engine::processorCount];
+    dsp::processor::CompiledProcessorChain processorChain;
 
     sst::basic_blocks::dsp::UIComponentLagHandler mUILag;
 
@@ -327,9 +354,9 @@ struct Group : MoveableOnly<Group>,
             if (lfosActive[i])
             {
                 const auto &ms = modulatorStorage[i];
-                if (ms.isEnv() && !ms.envLfoStorage.loop)
+                if (lfoEvaluator[i] == ENV && !ms.envLfoStorage.loop)
                 {
-                    res = res || ((int)envLfos[i].envelope.stage <=
+                    res = res || ((int)envLfo(i).envelope.stage <=
                                   (int)modulation::modulators::EnvLFO::env_t::s_release);
                 }
             }
@@ -437,6 +464,17 @@ SC_DESCRIBE(
                               {scxt::engine::Zone::ProcRoutingPath::procRoute_bypass, "BYP"},
                           }));
     SC_FIELD(oversample, pmd().asOnOffBool().withName("Oversample"));
+    SC_FIELD(oversampleQuality,
+             pmd()
+                 .asInt()
+                 .withRange(0, 2)
+                 .withName("Oversample Quality")
+                 .withUnorderedMapFormatting({
+                     {scxt::engine::Group::OversampleQuality::OSQ_LOW, "Low"},
+                     {scxt::engine::Group::OversampleQuality::OSQ_MEDIUM, "Medium"},
+                     {scxt::engine::Group::OversampleQuality::OSQ_HIGH, "High"},
+                 }));
+    SC_FIELD(sharedVoiceDecimation, pmd().asOnOffBool().withName("Shared Voice Decimation"));
     SC_FIELD(velocitySensitivity,
              pmd().asPercent().withName("Velocity Sensitivity").withDefault(0.6f));
     SC_FIELD(glideTime, pmd().as25SecondExpTime().withDefault(0.f).withName("Glide Time"));)
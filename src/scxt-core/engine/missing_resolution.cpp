@@ -27,6 +27,13 @@
 
 #include "missing_resolution.h"
 #include "messaging/messaging.h"
+#include "browser/browser_db.h"
+#include "infrastructure/md5support.h"
+
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <thread>
 
 namespace scxt::engine
 {
@@ -165,4 +172,172 @@ void resolveMultiFileMissingWorkItem(engine::Engine &e, const MissingResolutionW
     }
 }
 
-} // namespace scxt::engine
\ No newline at end of file
+
+namespace
+{
+// Placeholders for legacy, invalid or hand made ids carry no content hash to look up
+bool hasRelinkableMD5(const SampleID &id)
+{
+    if (!id.isValid() || id.md5[0] == '!')
+        return false;
+    auto len = strnlen(id.md5, SampleID::md5len + 1);
+    return len == SampleID::md5len &&
+           std::all_of(id.md5, id.md5 + len, [](auto c) { return std::isxdigit((uint8_t)c); });
+}
+
+// mtime as the scanner writes it to the index
+uint64_t indexedWriteTime(const fs::file_time_type &t)
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+}
+
+// Spread n jobs over a few threads, no more than one per perThread jobs
+template <typename F> void runOnFewThreads(size_t n, size_t perThread, F &&work)
+{
+    std::atomic<size_t> next{0};
+    auto run = [&]() {
+        size_t k;
+        while ((k = next.fetch_add(1)) < n)
+            work(k);
+    };
+    auto nThreads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+    nThreads = std::min(nThreads, (n + perThread - 1) / perThread);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < nThreads; ++t)
+        workers.emplace_back(run);
+    run();
+    for (auto &w : workers)
+        w.join();
+}
+} // namespace
+
+int autoRelinkMissingFromBrowserIndex(engine::Engine &e)
+{
+    const auto &db = e.getBrowserDB();
+    if (!db)
+        return 0;
+
+    auto items = collectMissingResolutionWorkItems(e);
+    if (items.empty())
+        return 0;
+
+    std::vector<std::string> md5s;
+    md5s.reserve(items.size());
+    for (const auto &mwi : items)
+        if (hasRelinkableMD5(mwi.missingID))
+            md5s.emplace_back(mwi.missingID.md5);
+    if (md5s.empty())
+        return 0;
+    std::sort(md5s.begin(), md5s.end());
+    md5s.erase(std::unique(md5s.begin(), md5s.end()), md5s.end());
+
+    auto hits = db->findFilesByMD5(md5s);
+    if (hits.empty())
+        return 0;
+
+    struct Candidate
+    {
+        size_t item;
+        fs::path path;
+        uint64_t size, mtime;
+        bool sameName{false};
+        bool current{false};
+        bool hashed{false}, confirmed{false};
+    };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (!hasRelinkableMD5(items[i].missingID))
+            continue;
+        auto hit = hits.find(std::string(items[i].missingID.md5));
+        if (hit == hits.end())
+            continue;
+        for (const auto &f : hit->second)
+        {
+            auto same = f.path.filename() == items[i].path.filename();
+            candidates.push_back({i, f.path, f.size, f.mtime, same});
+        }
+    }
+
+    /*
+     * A relocated library is thousands of stats, which is what dominates on a network
+     * volume or a cold disk, so check the rows are current on a few threads. The loads
+     * below stay on this thread since the sample manager is serial thread only.
+     */
+    runOnFewThreads(candidates.size(), 64, [&candidates](size_t k) {
+        auto &c = candidates[k];
+        std::error_code ec;
+        auto sz = fs::file_size(c.path, ec);
+        if (ec || sz != c.size)
+            return;
+        auto mt = fs::last_write_time(c.path, ec);
+        c.current = !ec && indexedWriteTime(mt) == c.mtime;
+    });
+
+    // Prefer a hit with the original file name, then whichever the index listed first
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+        if (a.item != b.item)
+            return a.item < b.item;
+        return a.sameName && !b.sameName;
+    });
+
+    /*
+     * A current row only says the index is up to date with the file, not that the file
+     * is the one we lost, so hash each item's best candidate before relinking to it. The
+     * rest are only hashed, on this thread, if the best turns out not to match.
+     */
+    auto confirm = [&items](Candidate &c) {
+        c.hashed = true;
+        c.confirmed = infrastructure::createMD5SumFromFile(c.path) ==
+                      std::string(items[c.item].missingID.md5);
+    };
+    std::vector<size_t> bestPerItem;
+    for (size_t k = 0; k < candidates.size(); ++k)
+    {
+        if (!candidates[k].current)
+            continue;
+        if (bestPerItem.empty() || candidates[bestPerItem.back()].item != candidates[k].item)
+            bestPerItem.push_back(k);
+    }
+    runOnFewThreads(bestPerItem.size(), 1, [&](size_t k) { confirm(candidates[bestPerItem[k]]); });
+
+    auto g = messaging::MessageController::ClientActivityNotificationGuard(
+        "Relinking missing samples", *(e.getMessageController()));
+    int resolved{0};
+    size_t lastItem{items.size()};
+    for (size_t k = 0; k < candidates.size(); ++k)
+    {
+        auto &c = candidates[k];
+        if (!c.current || c.item == lastItem)
+            continue;
+        if (!c.hashed)
+            confirm(c);
+        if (!c.confirmed)
+        {
+            SCLOG_IF(missingResolution, "Auto relink : index hit " << c.path.u8string()
+                                                                   << " no longer matches");
+            continue;
+        }
+        lastItem = c.item;
+
+        const auto &mwi = items[c.item];
+        SCLOG_IF(missingResolution,
+                 "Auto relink : " << mwi.path.u8string() << " -> " << c.path.u8string());
+        if (mwi.isMultiUsed)
+        {
+            resolveMultiFileMissingWorkItem(e, mwi, c.path);
+        }
+        else
+        {
+            resolveSingleFileMissingWorkItem(e, mwi, c.path);
+        }
+        resolved++;
+    }
+
+    if (resolved > 0)
+    {
+        e.getSampleManager()->purgeUnreferencedSamples();
+    }
+    return resolved;
+}
+} // namespace scxt::engine
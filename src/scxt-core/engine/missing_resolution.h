@@ -47,6 +47,16 @@ void resolveSingleFileMissingWorkItem(engine::Engine &e, const MissingResolution
 
 void resolveMultiFileMissingWorkItem(engine::Engine &e, const MissingResolutionWorkItem &mwi,
                                      const fs::path &p);
+
+/*
+ * Every missing sample carries the md5 of its file, and the browser index has the md5
+ * of every file it has scanned, so a moved library can usually be found without asking.
+ * This looks all the missing md5s up in one batched index query, checks each hit is
+ * still on disk at the indexed size, and resolves the items it can exactly as if the
+ * user had picked the file. Whatever is left is for the missing resolution dialog.
+ * Returns the number of work items resolved.
+ */
+int autoRelinkMissingFromBrowserIndex(engine::Engine &e);
 } // namespace scxt::engine
 
 #endif // MISSING_RESOLUTION_H
@@ -39,6 +39,7 @@
 #include "sst/basic-blocks/simd/setup.h"
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/PanLaws.h"
+#include "dsp/mix_kernels.h"
 #include "messaging/messaging.h"
 #include "messaging/client/detail/client_serial_impl.h"
 #include "messaging/client/mixer_messages.h"
@@ -50,7 +51,6 @@ void Part::process(Engine &e)
 {
     namespace blk = sst::basic_blocks::mechanics;
 
-    float lcp alignas(16)[2][blockSize];
     float defOut alignas(16)[2][blockSize];
 
     macroLagHandler.process();
@@ -68,6 +68,24 @@ void Part::process(Engine &e)
     if (pan != 0)
         pl::stereoEqualPower(0.5 * (pan + 1), pmat);
 
+    bool hasPartFX{false};
+    for (size_t idx = 0; idx < partEffects.size(); ++idx)
+        hasPartFX = hasPartFX || (partEffects[idx] && partEffectStorage[idx].isActive);
+
+    // this should be the route to point
+    auto routeBus = configuration.routeTo;
+    if (configuration.routeTo == DEFAULT_BUS)
+        routeBus = (BusAddress)(PART_0 + partNumber);
+    auto &pbus = e.getPatch()->getBusForOutput(routeBus);
+
+    /*
+     * Without part effects nothing needs the part sum on its own, so default routed
+     * groups are scaled, panned and summed straight onto the bus. With effects they
+     * gather in defOut, whose first writer overwrites rather than clearing first.
+     */
+    float *mixL = hasPartFX ? defOut[0] : pbus.output[0];
+    float *mixR = hasPartFX ? defOut[1] : pbus.output[1];
+
     for (const auto &g : groups)
     {
         if (g->isActive())
@@ -78,31 +96,13 @@ void Part::process(Engine &e)
             auto bi = g->outputInfo.routeTo;
             if (bi == DEFAULT_BUS || bi == configuration.routeTo)
             {
-                blk::mul_block<blockSize>(g->output[0], lev, lcp[0]);
-                blk::mul_block<blockSize>(g->output[1], lev, lcp[1]);
-
-                if (pan != 0.0)
-                {
-                    for (int i = 0; i < blockSize; ++i)
-                    {
-                        auto il = lcp[0][i];
-                        auto ir = lcp[1][i];
-                        lcp[0][i] = pmat[0] * il + pmat[2] * ir;
-                        lcp[1][i] = pmat[1] * ir + pmat[3] * il;
-                    }
-                }
-
-                if (defaultAssigned)
-                {
-                    blk::accumulate_from_to<blockSize>(lcp[0], defOut[0]);
-                    blk::accumulate_from_to<blockSize>(lcp[1], defOut[1]);
-                }
+                if (defaultAssigned || !hasPartFX)
+                    dsp::scalePanMix<blockSize, true>(g->output[0], g->output[1], lev, pmat,
+                                                      mixL, mixR);
                 else
-                {
-                    blk::copy_from_to<blockSize>(lcp[0], defOut[0]);
-                    blk::copy_from_to<blockSize>(lcp[1], defOut[1]);
-                    defaultAssigned = true;
-                }
+                    dsp::scalePanMix<blockSize, false>(g->output[0], g->output[1], lev, pmat,
+                                                       mixL, mixR);
+                defaultAssigned = true;
             }
             else
             {
@@ -114,20 +114,26 @@ void Part::process(Engine &e)
         }
     }
 
+    if (!noGroups)
+        silenceTime = 0;
+
+    if (!hasPartFX)
+    {
+        // Nothing rings out past the groups without part effects
+        silenceMax = 0;
+        if (noGroups)
+            silenceTime += blockSize;
+        return;
+    }
+
     // active groups which all route elsewhere leave defOut unwritten, and the silence
     // check below reads it either way
     if (!defaultAssigned)
         memset(defOut, 0, sizeof(defOut));
-    if (!noGroups)
-        silenceTime = 0;
 
     if (defaultAssigned || noGroups)
     {
         silenceMax = 0;
-        // this should be the route to point
-        auto bi = configuration.routeTo;
-        if (configuration.routeTo == DEFAULT_BUS)
-            bi = (BusAddress)(PART_0 + partNumber);
 
         int idx{0};
         for (auto &p : partEffects)
@@ -140,10 +146,8 @@ void Part::process(Engine &e)
             idx++;
         }
 
-        auto &obus = e.getPatch()->getBusForOutput(bi);
-
-        blk::accumulate_from_to<blockSize>(defOut[0], obus.output[0]);
-        blk::accumulate_from_to<blockSize>(defOut[1], obus.output[1]);
+        blk::accumulate_from_to<blockSize>(defOut[0], pbus.output[0]);
+        blk::accumulate_from_to<blockSize>(defOut[1], pbus.output[1]);
     }
     auto lv = blk::blockAbsMax<blockSize>(defOut[0]) + blk::blockAbsMax<blockSize>(defOut[1]);
     if (lv > silenceThresh)
@@ -27,6 +27,7 @@
 #ifndef SCXT_SRC_SCXT_CORE_ENGINE_PART_H
 #define SCXT_SRC_SCXT_CORE_ENGINE_PART_H
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <optional>
@@ -197,6 +198,13 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
     // Last program change seen on a channel we respond to. Runtime state, not streamed.
     int16_t lastProgramChange{0};
 
+    /*
+     * Moves whenever this part's streamed state may have changed, so a DAW state save can
+     * reuse the part's previous encoding while it holds still. See
+     * Engine::markPartStreamStateChanged for what moves it.
+     */
+    std::atomic<uint64_t> streamGeneration{1};
+
     struct MacroUILagHandler : sst::basic_blocks::dsp::UIComponentLagHandlerBase<MacroUILagHandler>
     {
         Part &part;
@@ -0,0 +1,164 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "voice_governor.h"
+
+#include <algorithm>
+
+#include "voice/voice.h"
+#include "zone.h"
+
+namespace scxt::engine
+{
+namespace
+{
+// How quickly a voice's estimate follows its measured blocks. Slow enough that one
+// preempted block doesn't condemn a voice, fast enough to see a filter switched on.
+constexpr float measuredBlockWeight{0.1f};
+constexpr float calibrationWeight{0.01f};
+} // namespace
+
+float VoiceGovernor::featureWeight(const voice::Voice &v)
+{
+    float w{1.f};
+
+    const auto &variants = v.zone->variantData.variants;
+    if (v.sampleIndex >= 0 && v.sampleIndex < (int)variants.size())
+    {
+        switch (variants[v.sampleIndex].interpolationType)
+        {
+        case dsp::InterpolationTypes::Sinc:
+            w += 1.5f;
+            break;
+        case dsp::InterpolationTypes::ZOHAA:
+            w += 0.25f;
+            break;
+        case dsp::InterpolationTypes::ZeroOrderHold:
+            w -= 0.25f;
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (auto a : v.processorIsActive)
+    {
+        if (a)
+            w += 1.f;
+    }
+    for (auto a : v.lfosActive)
+    {
+        if (a)
+            w += 0.1f;
+    }
+
+    w *= std::max<int>(v.numGeneratorsActive, 1);
+    if (v.forceOversample)
+        w *= 2.f;
+    return w;
+}
+
+float VoiceGovernor::initialEstimate(const voice::Voice &v) const
+{
+    return featureWeight(v) * percentPerWeight;
+}
+
+void VoiceGovernor::noteMeasuredBlock(voice::Voice &v, double seconds, double sampleRate)
+{
+    auto pct = (float)(seconds * sampleRate * blockSizeInv * 100.0);
+    if (v.governorCostPercent < 0.f)
+        v.governorCostPercent = pct;
+    else
+        v.governorCostPercent += measuredBlockWeight * (pct - v.governorCostPercent);
+
+    auto w = featureWeight(v);
+    percentPerWeight += calibrationWeight * (pct / w - percentPerWeight);
+}
+
+int VoiceGovernor::enforce(const std::array<voice::Voice *, maxVoices> &voices)
+{
+    if (!isEnabled())
+        return 0;
+
+    auto costOf = [this](const voice::Voice &v) {
+        return v.governorCostPercent < 0.f ? initialEstimate(v) : v.governorCostPercent;
+    };
+    auto isCandidate = [](const voice::Voice *v) {
+        return v && v->isVoiceAssigned && v->isSounding() && v->terminationSequence <= 0 &&
+               v->governorCostPercent >= 0.f;
+    };
+
+    // Voices already fading out are on their way and count as gone
+    float total{0.f};
+    for (const auto *v : voices)
+    {
+        if (v && v->isVoiceAssigned && v->isSounding() && v->terminationSequence <= 0)
+            total += costOf(*v);
+    }
+    stats.estimatedLoadPercent = total;
+
+    int stolen{0};
+    while (total > budgetPercent)
+    {
+        voice::Voice *victim{nullptr};
+        for (auto *v : voices)
+        {
+            if (!isCandidate(v))
+                continue;
+            if (!victim)
+            {
+                victim = v;
+                continue;
+            }
+            if (v->isGated != victim->isGated)
+            {
+                if (!v->isGated)
+                    victim = v;
+                continue;
+            }
+            auto lv = v->aeg.outBlock0, lvic = victim->aeg.outBlock0;
+            if (lv != lvic)
+            {
+                if (lv < lvic)
+                    victim = v;
+                continue;
+            }
+            if (v->voiceCreationId < victim->voiceCreationId)
+                victim = v;
+        }
+        if (!victim)
+            break;
+
+        // its fade is the overshoot the class comment warns of
+        total -= costOf(*victim);
+        victim->beginTerminationSequence();
+        stolen++;
+    }
+    stats.voicesStolen += stolen;
+    return stolen;
+}
+} // namespace scxt::engine
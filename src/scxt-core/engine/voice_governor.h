@@ -0,0 +1,90 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_VOICE_GOVERNOR_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_VOICE_GOVERNOR_H
+
+#include <array>
+#include <cstdint>
+
+#include "configuration.h"
+
+namespace scxt::voice
+{
+struct Voice;
+}
+
+namespace scxt::engine
+{
+/*
+ * An optional CPU budget for voices. maxVoices caps how many voices can exist, but a sinc
+ * interpolated, oversampled voice running four processors costs many times what a zero
+ * order hold one shot does, so on a live rig a voice count is no promise against dropouts.
+ *
+ * With the governor on, every voice carries a cost estimate in percent of the time a block
+ * has to render. A new voice starts from a guess based on its feature set, scaled by what
+ * voices have been measuring per feature unit on this machine; from its first block on it
+ * follows its own measured time. Before each block the engine sums the estimates and,
+ * while the total is over budget, fades out the voice it can best lose: released before
+ * gated, then quietest, then oldest. A voice which hasn't rendered yet is never chosen,
+ * so the note which pushed the total over still sounds.
+ *
+ * A stolen voice keeps costing for its short fade, so the ceiling can be overshot for a
+ * few blocks; the budget should leave room for that and for everything outside the voices.
+ */
+struct VoiceGovernor
+{
+    // 0 turns the governor off
+    float budgetPercent{0.f};
+    bool isEnabled() const { return budgetPercent > 0.f; }
+
+    // Relative cost of v's feature set; 1 is a plain linear interpolated voice
+    static float featureWeight(const voice::Voice &v);
+
+    // A starting estimate for a voice which hasn't rendered a block yet
+    float initialEstimate(const voice::Voice &v) const;
+
+    // Fold one measured block into v's estimate and the per feature unit calibration
+    void noteMeasuredBlock(voice::Voice &v, double seconds, double sampleRate);
+
+    // Fade out voices until the estimated total fits the budget. Returns how many it took.
+    int enforce(const std::array<voice::Voice *, maxVoices> &voices);
+
+    struct Stats
+    {
+        float estimatedLoadPercent{0.f};
+        uint64_t voicesStolen{0};
+    } stats;
+
+  private:
+    // Percent of a block per unit of featureWeight, as measured. The seed is only a guess
+    // and is replaced by measurement within a few blocks of the first voice.
+    float percentPerWeight{0.5f};
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_VOICE_GOVERNOR_H
@@ -26,9 +26,13 @@
  */
 
 #include "zone.h"
+
+#include <chrono>
+
 #include "bus.h"
 #include "group.h"
 #include "modulation/modulators/steplfo.h"
+#include "modulation/modulators/shared_lfo_pool.h"
 #include "part.h"
 #include "engine.h"
 #include "messaging/messaging.h"
@@ -38,6 +42,7 @@
 #include "group_and_zone_impl.h"
 
 #include "dsp/sample_analytics.h"
+#include "dsp/mix_kernels.h"
 
 namespace scxt::engine
 {
@@ -55,16 +60,21 @@ void Zone::process(Engine &e)
 
 template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
 {
+    constexpr size_t osBlock{blockSize << (OS ? 1 : 0)};
+    namespace blk = sst::basic_blocks::mechanics;
+
     if (terminateOnNextProcess)
     {
         terminateOnNextProcess = false;
         terminateAllVoices();
+        memset(output[0], 0, osBlock * sizeof(float));
+        memset(output[1], 0, osBlock * sizeof(float));
+        hasOSOutput = false;
         return;
     }
-    constexpr size_t osBlock{blockSize << (OS ? 1 : 0)};
-    namespace blk = sst::basic_blocks::mechanics;
-    // TODO these memsets are probably gratuitous
-    memset(output, 0, sizeof(output));
+
+    // The first voice to sound overwrites output; it is only cleared if none did
+    bool outputWritten{false}, osOutputWritten{false};
 
     mUILag.process();
 
@@ -78,12 +88,42 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
         auto &v = voiceWeakPointers[i];
         assert(v);
         assert(v->isVoiceAssigned);
-        if (v->process())
+        bool rendered;
+        if (onto.voiceGovernor.isEnabled())
         {
+            auto t0 = std::chrono::steady_clock::now();
+            rendered = v->process();
+            std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+            onto.voiceGovernor.noteMeasuredBlock(*v, dt.count(), onto.sampleRate);
+        }
+        else
+        {
+            rendered = v->process();
+        }
+        if (rendered && !OS && v->forceOversample)
+        {
+            // shared decimation (see Voice::voiceStarted): the block is still at 2x
             if (outputInfo.routeTo == DEFAULT_BUS)
             {
-                blk::accumulate_from_to<osBlock>(v->output[0], output[0]);
-                blk::accumulate_from_to<osBlock>(v->output[1], output[1]);
+                dsp::copyOrAccumulate<blockSize << 1>(osOutputWritten, v->output[0], v->output[1],
+                                                      outputOS[0], outputOS[1]);
+                osOutputWritten = true;
+            }
+            else if (outputInfo.routeTo >= 0)
+            {
+                auto &tb = getEngine()->getPatch()->getBusForOutput(outputInfo.routeTo);
+                blk::accumulate_from_to<blockSize << 1>(v->output[0], tb.outputOS[0]);
+                blk::accumulate_from_to<blockSize << 1>(v->output[1], tb.outputOS[1]);
+                tb.hasOSSignal = true;
+            }
+        }
+        else if (rendered)
+        {
+            if (outputInfo.routeTo == DEFAULT_BUS)
+            {
+                dsp::copyOrAccumulate<osBlock>(outputWritten, v->output[0], v->output[1],
+                                               output[0], output[1]);
+                outputWritten = true;
             }
             else if (outputInfo.routeTo >= 0)
             {
@@ -116,6 +156,13 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
         }
     }
 
+    if (!outputWritten)
+    {
+        memset(output[0], 0, osBlock * sizeof(float));
+        memset(output[1], 0, osBlock * sizeof(float));
+    }
+    hasOSOutput = osOutputWritten;
+
     for (int i = 0; i < cleanupIdx; ++i)
     {
         SCLOG_IF(voiceLifecycle, "Cleanup Voice at " << SCD((int)toCleanUp[i]->key));
@@ -539,6 +586,7 @@ void Zone::onRoutingChanged()
     auto pgeg = gegsActive;
     std::fill(gegsActive.begin(), gegsActive.end(), false);
     std::fill(envFollowersActive.begin(), envFollowersActive.end(), false);
+    std::fill(lfosTargeted.begin(), lfosTargeted.end(), false);
 
     for (int i = 0; i < egsPerZone; ++i)
         egsActive[i] = false;
@@ -609,6 +657,9 @@ void Zone::onRoutingChanged()
 
         if (r.sourceVia.has_value())
             doCheck(*r.sourceVia);
+
+        if (r.target->gid == 'lfo ' && r.target->index < lfosPerZone)
+            lfosTargeted[r.target->index] = true;
     }
 
     if (pglfo != glfosActive || pgeg != gegsActive)
@@ -618,6 +669,11 @@ void Zone::onRoutingChanged()
     }
 }
 
+bool Zone::lfoCanBeShared(int i) const
+{
+    return modulation::modulators::SharedLFOPool::canShare(modulatorStorage[i], lfosTargeted[i]);
+}
+
 int16_t Zone::missingSampleCount() const
 {
     int idx{0};
@@ -286,6 +286,10 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
     static_assert(std::is_standard_layout<ZoneOutputInfo>::value);
 
     float output alignas(16)[2][blockSize << 1];
+    // 2x voices awaiting the group's shared decimation; only ever written when the group isn't
+    // oversampling, and only valid this block if hasOSOutput
+    float outputOS alignas(16)[2][blockSize << 1];
+    bool hasOSOutput{false};
     void process(Engine &onto);
     template <bool OS> void processWithOS(Engine &onto);
 
@@ -409,6 +413,12 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
     std::array<bool, envFollowersPerGroupOrZone> envFollowersActive{};
     bool phasorsActive{};
 
+    // Whether an active route targets LFO i, which keeps it out of the shared LFO pool
+    std::array<bool, lfosPerZone> lfosTargeted{};
+    // Our entry per LFO in the engine's SharedLFOPool. The pool validates it on each use.
+    std::array<int16_t, lfosPerZone> sharedLFOEntry{};
+    bool lfoCanBeShared(int i) const;
+
     // 0 is the AEG, 1 is EG2
     std::array<modulation::modulators::AdsrStorage, egsPerZone> egStorage;
 
@@ -0,0 +1,95 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "infrastructure/load_timing.h"
+
+namespace scxt::infrastructure
+{
+namespace
+{
+std::atomic<LoadTimings *> loadTimingSink{nullptr};
+thread_local ScopedLoadPhase *currentPhase{nullptr};
+} // namespace
+
+const char *LoadTimings::phaseName(Phase p)
+{
+    switch (p)
+    {
+    case READ:
+        return "read";
+    case HASH:
+        return "hash";
+    case DECODE:
+        return "decode";
+    case UNSTREAM:
+        return "unstream";
+    case PURGE:
+        return "purge";
+    case numPhases:
+        break;
+    }
+    return "unknown";
+}
+
+void setLoadTimingSink(LoadTimings *s) { loadTimingSink.store(s, std::memory_order_release); }
+LoadTimings *getLoadTimingSink() { return loadTimingSink.load(std::memory_order_acquire); }
+
+ScopedLoadPhase::ScopedLoadPhase(LoadTimings::Phase p) : phase(p)
+{
+    sink = loadTimingSink.load(std::memory_order_relaxed);
+    if (!sink)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    parent = currentPhase;
+    if (parent)
+        parent->charge(now);
+    currentPhase = this;
+    resumedAt = now;
+    sink->entries[phase].fetch_add(1, std::memory_order_relaxed);
+}
+
+ScopedLoadPhase::~ScopedLoadPhase()
+{
+    if (!sink)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    charge(now);
+    currentPhase = parent;
+    if (parent)
+        parent->resumedAt = now;
+}
+
+void ScopedLoadPhase::charge(std::chrono::steady_clock::time_point now)
+{
+    auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(now - resumedAt).count();
+    sink->ns[phase].fetch_add(d, std::memory_order_relaxed);
+    resumedAt = now;
+}
+
+} // namespace scxt::infrastructure
@@ -0,0 +1,100 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_LOAD_TIMING_H
+#define SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_LOAD_TIMING_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace scxt::infrastructure
+{
+
+/**
+ * Accumulates where load time goes, phase by phase. Nothing in the engine owns
+ * one of these; a benchmark (scxt-perf's load mode, say) installs one with
+ * setLoadTimingSink for the duration of a load and reads it afterwards. With no
+ * sink installed a ScopedLoadPhase costs a relaxed atomic load.
+ *
+ * Timings are exclusive: entering a phase pauses the one enclosing it on the same
+ * thread, so unstreaming a multi which loads samples shows the sample reads and
+ * decodes under READ/DECODE and only the json work under UNSTREAM. Mapped files
+ * are paged in by whoever touches them first, which for most formats is the MD5,
+ * so cold-cache I/O generally lands in HASH.
+ */
+struct LoadTimings
+{
+    enum Phase
+    {
+        READ,     // opening files and containers, pulling chunks into memory
+        HASH,     // md5 over source files
+        DECODE,   // converting sample data into Sample buffers
+        UNSTREAM, // json/msgpack into the engine, excluding the above
+        PURGE,    // purgeUnreferencedSamples
+
+        numPhases
+    };
+
+    std::array<std::atomic<int64_t>, numPhases> ns{};
+    std::array<std::atomic<int64_t>, numPhases> entries{};
+
+    void reset()
+    {
+        for (auto &n : ns)
+            n = 0;
+        for (auto &e : entries)
+            e = 0;
+    }
+
+    static const char *phaseName(Phase p);
+};
+
+void setLoadTimingSink(LoadTimings *);
+LoadTimings *getLoadTimingSink();
+
+struct ScopedLoadPhase
+{
+    explicit ScopedLoadPhase(LoadTimings::Phase p);
+    ~ScopedLoadPhase();
+
+    ScopedLoadPhase(const ScopedLoadPhase &) = delete;
+    ScopedLoadPhase &operator=(const ScopedLoadPhase &) = delete;
+
+  private:
+    LoadTimings *sink{nullptr};
+    LoadTimings::Phase phase;
+    ScopedLoadPhase *parent{nullptr};
+    std::chrono::steady_clock::time_point resumedAt;
+
+    void charge(std::chrono::steady_clock::time_point now);
+};
+
+} // namespace scxt::infrastructure
+
+#endif // SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_LOAD_TIMING_H
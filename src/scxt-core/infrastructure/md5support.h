@@ -31,6 +31,7 @@
 #include <string>
 #include "filesystem_import.h"
 #include "file_map_view.h"
+#include "load_timing.h"
 #include "md5.h"
 
 #if MAC
@@ -55,6 +56,7 @@ inline std::string hexString(unsigned char *digest, int length)
 
 inline std::string createMD5SumFromFile(const fs::path &path)
 {
+    auto lp = ScopedLoadPhase(LoadTimings::HASH);
     auto fmp = infrastructure::FileMapView(path);
     if (!fmp.isMapped())
         return {};
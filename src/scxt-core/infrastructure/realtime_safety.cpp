@@ -0,0 +1,131 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "realtime_safety.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
+namespace scxt::infrastructure::realtime
+{
+namespace
+{
+// Plain ints so the first touch on a thread never needs the allocator
+thread_local int realtimeDepth{0};
+thread_local int allowedDepth{0};
+thread_local int noting{0};
+thread_local int stageDepth{0};
+thread_local const char *stageStack[maxStageDepth];
+
+std::atomic<size_t> totalViolations{0};
+ViolationRecord records[maxRecorded];
+} // namespace
+
+const char *violationName(Violation v)
+{
+    switch (v)
+    {
+    case Violation::ALLOCATION:
+        return "allocation";
+    case Violation::DEALLOCATION:
+        return "deallocation";
+    case Violation::LOCK:
+        return "lock";
+    case Violation::FILE_IO:
+        return "file i/o";
+    }
+    return "unknown";
+}
+
+void enterRealtime(const char *stage)
+{
+    realtimeDepth++;
+    pushStage(stage);
+}
+
+void leaveRealtime()
+{
+    popStage();
+    realtimeDepth--;
+}
+
+void pushStage(const char *stage)
+{
+    if (stageDepth < maxStageDepth)
+        stageStack[stageDepth] = stage;
+    stageDepth++;
+}
+
+void popStage()
+{
+    if (stageDepth > 0)
+        stageDepth--;
+}
+
+void beginAllowed() { allowedDepth++; }
+void endAllowed() { allowedDepth--; }
+bool isRealtime() { return realtimeDepth > 0 && allowedDepth == 0; }
+
+void note(Violation kind, const char *what)
+{
+    if (realtimeDepth == 0 || allowedDepth > 0 || noting > 0)
+        return;
+
+    noting++;
+    auto idx = totalViolations.fetch_add(1, std::memory_order_relaxed);
+    if (idx < maxRecorded)
+    {
+        auto &r = records[idx];
+        r.kind = kind;
+        r.what = what;
+        r.stageDepth = std::min(stageDepth, maxStageDepth);
+        for (int i = 0; i < r.stageDepth; ++i)
+            r.stages[i] = stageStack[i];
+    }
+    noting--;
+}
+
+size_t violationCount() { return totalViolations.load(std::memory_order_acquire); }
+
+std::vector<ViolationRecord> recordedViolations()
+{
+    auto n = std::min(violationCount(), maxRecorded);
+    return std::vector<ViolationRecord>(records, records + n);
+}
+
+void clearViolations() { totalViolations.store(0, std::memory_order_release); }
+
+std::string describe(const ViolationRecord &r)
+{
+    std::ostringstream oss;
+    oss << violationName(r.kind) << " (" << (r.what ? r.what : "?") << ") in ";
+    for (int i = 0; i < r.stageDepth; ++i)
+        oss << (i ? " > " : "") << (r.stages[i] ? r.stages[i] : "?");
+    return oss.str();
+}
+} // namespace scxt::infrastructure::realtime
@@ -0,0 +1,159 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_REALTIME_SAFETY_H
+#define SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_REALTIME_SAFETY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace scxt::infrastructure::realtime
+{
+
+/**
+ * Realtime safety tracking. Configure with SCXT_REALTIME_SAFETY_TRACKING=ON and
+ * Engine::processAudio marks its thread as realtime for the duration of the call.
+ * Hooks installed into the test and perf executables (operator new/delete, and on
+ * linux malloc, mutex lock and file I/O through linker wrapping) report anything
+ * they see happen there, tagged with the stack of RealtimeStage names active at the
+ * time. scxt-test fails the test case, and scxt-perf the run, on any report.
+ *
+ * With tracking off at configure time the scopes below are empty and the hooks are
+ * not linked, so a normal build pays nothing.
+ *
+ * Only calls made from our own objects are seen by the wrapped libc functions; a
+ * malloc inside a shared system library (libstdc++'s iostreams, say) is not, but an
+ * operator new anywhere is.
+ */
+#if SCXT_REALTIME_SAFETY_TRACKING
+static constexpr bool trackingEnabled{true};
+#else
+static constexpr bool trackingEnabled{false};
+#endif
+
+enum struct Violation : uint8_t
+{
+    ALLOCATION,
+    DEALLOCATION,
+    LOCK,
+    FILE_IO
+};
+const char *violationName(Violation v);
+
+static constexpr int maxStageDepth{6};
+struct ViolationRecord
+{
+    Violation kind{Violation::ALLOCATION};
+    const char *what{nullptr}; // a static string naming the call
+    const char *stages[maxStageDepth]{};
+    int stageDepth{0};
+};
+
+/*
+ * The thread state. These never allocate, lock or touch a file, since the hooks
+ * call them from inside malloc and friends.
+ */
+void enterRealtime(const char *stage);
+void leaveRealtime();
+void pushStage(const char *stage);
+void popStage();
+void beginAllowed();
+void endAllowed();
+bool isRealtime();
+
+// Called by the hooks. A no-op unless this thread is inside a realtime scope.
+void note(Violation kind, const char *what);
+
+/*
+ * Reporting. Every violation is counted; the first maxRecorded are kept in full.
+ * Read these off the audio thread, or after it has stopped.
+ */
+static constexpr size_t maxRecorded{256};
+size_t violationCount();
+std::vector<ViolationRecord> recordedViolations();
+void clearViolations();
+std::string describe(const ViolationRecord &r);
+
+struct RealtimeScope
+{
+    explicit RealtimeScope(const char *stage)
+    {
+        if constexpr (trackingEnabled)
+            enterRealtime(stage);
+    }
+    ~RealtimeScope()
+    {
+        if constexpr (trackingEnabled)
+            leaveRealtime();
+    }
+};
+
+struct RealtimeStage
+{
+    explicit RealtimeStage(const char *stage)
+    {
+        if constexpr (trackingEnabled)
+            pushStage(stage);
+    }
+    ~RealtimeStage()
+    {
+        if constexpr (trackingEnabled)
+            popStage();
+    }
+};
+
+/*
+ * For the handful of places which are known and accepted to lock or allocate on the
+ * audio thread - the structure locked callback dispatch, say. Keep these rare.
+ */
+struct RealtimeAllowedScope
+{
+    RealtimeAllowedScope()
+    {
+        if constexpr (trackingEnabled)
+            beginAllowed();
+    }
+    ~RealtimeAllowedScope()
+    {
+        if constexpr (trackingEnabled)
+            endAllowed();
+    }
+};
+
+/*
+ * The allocator underneath the hooks. Where malloc is wrapped these go straight to the
+ * real one so a tracked operator new is not reported a second time as a malloc.
+ * Defined alongside the hooks, so only available in a tracking build.
+ */
+void *rawAlloc(size_t sz);
+void rawFree(void *p);
+
+} // namespace scxt::infrastructure::realtime
+
+#endif // SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_REALTIME_SAFETY_H
@@ -0,0 +1,134 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * The libc side of realtime safety tracking. Only built with
+ * SCXT_REALTIME_SAFETY_TRACKING=ON, and linked into the executables which want
+ * it (scxt-test and scxt-perf) rather than into scxt-core, since on linux it
+ * works by asking the linker to --wrap the symbols below.
+ */
+
+#include "realtime_safety.h"
+
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <cstdarg>
+#include <cstdio>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+namespace rt = scxt::infrastructure::realtime;
+
+extern "C"
+{
+    void *__real_malloc(size_t);
+    void *__real_calloc(size_t, size_t);
+    void *__real_realloc(void *, size_t);
+    void __real_free(void *);
+    int __real_pthread_mutex_lock(pthread_mutex_t *);
+    FILE *__real_fopen(const char *, const char *);
+    int __real_open(const char *, int, ...);
+    ssize_t __real_read(int, void *, size_t);
+    ssize_t __real_write(int, const void *, size_t);
+
+    void *__wrap_malloc(size_t sz)
+    {
+        rt::note(rt::Violation::ALLOCATION, "malloc");
+        return __real_malloc(sz);
+    }
+
+    void *__wrap_calloc(size_t n, size_t sz)
+    {
+        rt::note(rt::Violation::ALLOCATION, "calloc");
+        return __real_calloc(n, sz);
+    }
+
+    void *__wrap_realloc(void *p, size_t sz)
+    {
+        rt::note(rt::Violation::ALLOCATION, "realloc");
+        return __real_realloc(p, sz);
+    }
+
+    void __wrap_free(void *p)
+    {
+        if (p)
+            rt::note(rt::Violation::DEALLOCATION, "free");
+        __real_free(p);
+    }
+
+    int __wrap_pthread_mutex_lock(pthread_mutex_t *m)
+    {
+        rt::note(rt::Violation::LOCK, "pthread_mutex_lock");
+        return __real_pthread_mutex_lock(m);
+    }
+
+    FILE *__wrap_fopen(const char *path, const char *mode)
+    {
+        rt::note(rt::Violation::FILE_IO, "fopen");
+        return __real_fopen(path, mode);
+    }
+
+    int __wrap_open(const char *path, int flags, ...)
+    {
+        rt::note(rt::Violation::FILE_IO, "open");
+        mode_t mode{0};
+        if (flags & O_CREAT)
+        {
+            va_list args;
+            va_start(args, flags);
+            mode = (mode_t)va_arg(args, int);
+            va_end(args);
+        }
+        return __real_open(path, flags, mode);
+    }
+
+    ssize_t __wrap_read(int fd, void *buf, size_t n)
+    {
+        rt::note(rt::Violation::FILE_IO, "read");
+        return __real_read(fd, buf, n);
+    }
+
+    ssize_t __wrap_write(int fd, const void *buf, size_t n)
+    {
+        rt::note(rt::Violation::FILE_IO, "write");
+        return __real_write(fd, buf, n);
+    }
+}
+#endif
+
+namespace scxt::infrastructure::realtime
+{
+#if defined(__linux__)
+void *rawAlloc(size_t sz) { return __real_malloc(sz ? sz : 1); }
+void rawFree(void *p) { __real_free(p); }
+#else
+void *rawAlloc(size_t sz) { return std::malloc(sz ? sz : 1); }
+void rawFree(void *p) { std::free(p); }
+#endif
+} // namespace scxt::infrastructure::realtime
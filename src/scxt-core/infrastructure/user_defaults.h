@@ -49,6 +49,10 @@ enum DefaultKeys
     useSoftwareRenderer,
     showUndoRedo,
     lastSavedPath,
+    sampleResidencyCacheMB,
+    voiceCPUBudgetPercent,
+    decodedSampleCacheMB,
+    mapWavSamplesInPlace,
 
     nKeys // must be last K?
 };
@@ -88,6 +92,14 @@ inline std::string defaultKeyToString(DefaultKeys k)
         return "showUndoRedo";
     case lastSavedPath:
         return "lastSavedPath";
+    case sampleResidencyCacheMB:
+        return "sampleResidencyCacheMB";
+    case voiceCPUBudgetPercent:
+        return "voiceCPUBudgetPercent";
+    case decodedSampleCacheMB:
+        return "decodedSampleCacheMB";
+    case mapWavSamplesInPlace:
+        return "mapWavSamplesInPlace";
     default:
         std::terminate(); // for now
     }
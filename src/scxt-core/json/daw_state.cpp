@@ -0,0 +1,275 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "daw_state.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <miniz.h>
+
+#include <tao/json/contrib/traits.hpp>
+#include <tao/json/msgpack/from_string.hpp>
+#include <tao/json/msgpack/to_string.hpp>
+
+#include "scxt_traits.h"
+#include "engine_traits.h"
+#include "infrastructure/load_timing.h"
+
+namespace scxt::json
+{
+namespace
+{
+static constexpr char magic[4]{'S', 'C', 'X', 'B'};
+static constexpr uint8_t formatVersion{1};
+static constexpr size_t headerSize{12};
+static constexpr const char *payloadTag{"SCXB64:"};
+
+// Big enough to only matter for a corrupt or hostile stream
+static constexpr uint32_t maxChunkSize{1u << 30};
+
+using val_t = tao::json::basic_value<scxt_traits>;
+
+void putU32(std::string &s, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        s.push_back((char)((v >> (8 * i)) & 0xFF));
+}
+
+uint32_t getU32(const std::string &s, size_t at)
+{
+    if (at + 4 > s.size())
+        throw std::runtime_error("Compact DAW state is truncated");
+    uint32_t v{0};
+    for (int i = 0; i < 4; ++i)
+        v |= (uint32_t)(uint8_t)s[at + i] << (8 * i);
+    return v;
+}
+
+std::string makeChunk(const std::string &raw)
+{
+    if (raw.size() > maxChunkSize)
+        throw std::runtime_error("DAW state chunk is too large to store");
+
+    // Level 1: this runs on every host autosave, and most of the win over JSON text is
+    // msgpack's, not deflate's
+    auto bound = mz_compressBound((mz_ulong)raw.size());
+    std::string res;
+    res.resize(8 + bound);
+    auto stored = (mz_ulong)bound;
+    auto rc = mz_compress2((unsigned char *)res.data() + 8, &stored,
+                           (const unsigned char *)raw.data(), (mz_ulong)raw.size(), 1);
+    if (rc != MZ_OK || stored >= raw.size())
+    {
+        res.resize(8);
+        res.append(raw);
+        stored = (mz_ulong)raw.size();
+    }
+    else
+    {
+        res.resize(8 + stored);
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        res[i] = (char)((raw.size() >> (8 * i)) & 0xFF);
+        res[4 + i] = (char)((stored >> (8 * i)) & 0xFF);
+    }
+    return res;
+}
+
+std::string readChunk(const std::string &s, size_t &at)
+{
+    auto rawSize = getU32(s, at);
+    auto storedSize = getU32(s, at + 4);
+    at += 8;
+    if (rawSize > maxChunkSize || storedSize > s.size() - at)
+        throw std::runtime_error("Compact DAW state has a corrupt chunk");
+
+    std::string raw;
+    if (storedSize == rawSize)
+    {
+        raw = s.substr(at, storedSize);
+    }
+    else
+    {
+        raw.resize(rawSize);
+        auto rs = (mz_ulong)rawSize;
+        auto rc = mz_uncompress((unsigned char *)raw.data(), &rs,
+                                (const unsigned char *)s.data() + at, (mz_ulong)storedSize);
+        if (rc != MZ_OK || rs != rawSize)
+            throw std::runtime_error("Compact DAW state chunk failed to inflate");
+    }
+    at += storedSize;
+    return raw;
+}
+
+val_t msgpackToValue(const std::string &raw)
+{
+    tao::json::events::transformer<tao::json::events::to_basic_value<scxt_traits>> consumer;
+    tao::json::msgpack::events::from_string(consumer, raw);
+    return std::move(consumer.value);
+}
+
+static constexpr char b64chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string toBase64(const std::string &in)
+{
+    std::string out;
+    out.reserve(((in.size() + 2) / 3) * 4);
+    size_t i{0};
+    for (; i + 2 < in.size(); i += 3)
+    {
+        uint32_t n = ((uint8_t)in[i] << 16) | ((uint8_t)in[i + 1] << 8) | (uint8_t)in[i + 2];
+        out.push_back(b64chars[(n >> 18) & 63]);
+        out.push_back(b64chars[(n >> 12) & 63]);
+        out.push_back(b64chars[(n >> 6) & 63]);
+        out.push_back(b64chars[n & 63]);
+    }
+    if (i < in.size())
+    {
+        uint32_t n = (uint8_t)in[i] << 16;
+        if (i + 1 < in.size())
+            n |= (uint8_t)in[i + 1] << 8;
+        out.push_back(b64chars[(n >> 18) & 63]);
+        out.push_back(b64chars[(n >> 12) & 63]);
+        out.push_back(i + 1 < in.size() ? b64chars[(n >> 6) & 63] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+std::string fromBase64(const char *in, size_t len)
+{
+    std::array<int8_t, 256> rev;
+    rev.fill(-1);
+    for (int i = 0; i < 64; ++i)
+        rev[(uint8_t)b64chars[i]] = (int8_t)i;
+
+    std::string out;
+    out.reserve(len / 4 * 3);
+    uint32_t acc{0};
+    int bits{0};
+    for (size_t i = 0; i < len; ++i)
+    {
+        auto c = (uint8_t)in[i];
+        if (c == '=')
+            break;
+        if (rev[c] < 0)
+            throw std::runtime_error("Compact DAW state payload is not valid base64");
+        acc = (acc << 6) | rev[c];
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            out.push_back((char)((acc >> bits) & 0xFF));
+        }
+    }
+    return out;
+}
+} // namespace
+
+std::string DawStateEncoder::encode(const engine::Engine &e)
+{
+    std::lock_guard<std::mutex> g(encodeMutex);
+
+    // Mirrors the Engine SC_FROM in engine_traits.h, with the parts left out of the patch
+    val_t ev = {{"streamingVersion", scxt::currentStreamingVersion},
+                {"streamingVersionHumanReadable",
+                 scxt::humanReadableVersion(scxt::currentStreamingVersion)},
+                {"patch", val_t{{"busses", e.getPatch()->busses}}},
+                {"runtimeConfig", e.runtimeConfig},
+                {"selectionManager", e.getSelectionManager()},
+                {"sampleManager", e.getSampleManager()},
+                {"dawExtraState", e.dawExtraState}};
+
+    std::string res(magic, sizeof(magic));
+    res.push_back((char)formatVersion);
+    res.append(3, '\0');
+    putU32(res, 1 + numParts);
+    res.append(makeChunk(tao::json::msgpack::to_string(ev)));
+
+    for (int i = 0; i < numParts; ++i)
+    {
+        const auto &part = e.getPatch()->getPart(i);
+        auto &pc = partChunks[i];
+        // read the generation before encoding, so an edit racing this save is picked up
+        // by the next one rather than lost under a newer generation
+        auto gen = part->streamGeneration.load();
+        if (pc.stored.empty() || pc.partId != part->id || pc.generation != gen)
+        {
+            pc.stored = makeChunk(tao::json::msgpack::to_string(json::scxt_value(*part)));
+            pc.partId = part->id;
+            pc.generation = gen;
+        }
+        res.append(pc.stored);
+    }
+    return res;
+}
+
+bool isCompactDawState(const std::string &data)
+{
+    if (data.rfind(payloadTag, 0) == 0)
+        return true;
+    return data.size() >= headerSize && data.compare(0, sizeof(magic), magic, sizeof(magic)) == 0;
+}
+
+std::string compactDawStateToMessagePayload(const std::string &data)
+{
+    return payloadTag + toBase64(data);
+}
+
+void unstreamCompactDawState(engine::Engine &e, const std::string &data)
+{
+    if (data.rfind(payloadTag, 0) == 0)
+    {
+        auto tl = strlen(payloadTag);
+        unstreamCompactDawState(e, fromBase64(data.data() + tl, data.size() - tl));
+        return;
+    }
+
+    if (data.size() < headerSize || data.compare(0, sizeof(magic), magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a compact DAW state");
+    if ((uint8_t)data[4] > formatVersion)
+        throw std::runtime_error("Compact DAW state is from a newer version of Shortcircuit XT");
+
+    auto chunks = getU32(data, 8);
+    if (chunks < 1)
+        throw std::runtime_error("Compact DAW state has no engine chunk");
+
+    size_t at{headerSize};
+    auto ev = msgpackToValue(readChunk(data, at));
+
+    val_t pv = tao::json::empty_array;
+    for (uint32_t i = 1; i < chunks; ++i)
+        pv.get_array().push_back(msgpackToValue(readChunk(data, at)));
+
+    ev.at("patch").get_object()["parts"] = std::move(pv);
+    ev.to(e);
+}
+} // namespace scxt::json
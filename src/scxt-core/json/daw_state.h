@@ -0,0 +1,84 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_JSON_DAW_STATE_H
+#define SCXT_SRC_SCXT_CORE_JSON_DAW_STATE_H
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "configuration.h"
+#include "engine/engine.h"
+
+/*
+ * The compact DAW state format. A session save is a header, then one chunk holding the
+ * engine minus its parts and one chunk per part. Each chunk is msgpack of exactly what
+ * the JSON stream would carry, deflated on its own, so an unchanged part's chunk can be
+ * kept from the last save and copied through without being rebuilt or recompressed.
+ *
+ *   "SCXB" u8 version u8[3] reserved u32 chunkCount
+ *   per chunk: u32 rawSize u32 storedSize (== rawSize means uncompressed) bytes
+ *
+ * All integers are little endian. The legacy DAW state is JSON text, which can never start
+ * with the magic, so every JSON unstream entry point accepts either.
+ */
+namespace scxt::json
+{
+struct DawStateEncoder
+{
+    /*
+     * Call with an Engine::StreamGuard for FOR_DAW in place. Safe to call from any
+     * non-audio thread, though only one save runs at a time.
+     */
+    std::string encode(const engine::Engine &e);
+
+  private:
+    struct PartChunk
+    {
+        PartID partId{};
+        uint64_t generation{0};
+        std::string stored; // chunk header and body, ready to append
+    };
+    std::array<PartChunk, numParts> partChunks{};
+    std::mutex encodeMutex;
+};
+
+bool isCompactDawState(const std::string &data);
+
+/*
+ * Client messages carry their payloads as strings which must survive a JSON or msgpack
+ * text round trip, so the compact state travels through them as base64 under its own tag.
+ */
+std::string compactDawStateToMessagePayload(const std::string &data);
+
+// Accepts the raw compact form or its message payload form; throws std::runtime_error
+void unstreamCompactDawState(engine::Engine &e, const std::string &data);
+} // namespace scxt::json
+
+#endif // SCXT_SRC_SCXT_CORE_JSON_DAW_STATE_H
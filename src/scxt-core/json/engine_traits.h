@@ -478,6 +478,8 @@ STREAM_ENUM(engine::Group::PlayMode, engine::Group::toStringPlayMode,
             engine::Group::fromStringPlayMode);
 STREAM_ENUM(engine::Group::NotePriority, engine::Group::toStringNotePriority,
             engine::Group::fromStringNotePriority);
+STREAM_ENUM(engine::Group::OversampleQuality, engine::Group::toStringOversampleQuality,
+            engine::Group::fromStringOversampleQuality);
 STREAM_ENUM(scxt::dsp::processor::ProcessorStorage::GroupProcessorPitch,
             scxt::dsp::processor::ProcessorStorage::toStringGroupProcessorPitch,
             scxt::dsp::processor::ProcessorStorage::fromStringGroupProcessorPitch);
@@ -487,6 +489,8 @@ SC_STREAMDEF(scxt::engine::Group::GroupOutputInfo, SC_FROM({
                       {"pan", t.pan},
                       {"tn", t.tuning},
                       {"oversample", t.oversample},
+                      {"osq", t.oversampleQuality},
+                      {"svd", t.sharedVoiceDecimation},
                       {"velocitySensitivity", t.velocitySensitivity},
                       {"muted", t.muted},
                       {"procRouting", t.procRouting},
@@ -512,6 +516,9 @@ SC_STREAMDEF(scxt::engine::Group::GroupOutputInfo, SC_FROM({
                  findIf(v, "procRouting", result.procRouting);
                  findIf(v, "velocitySensitivity", result.velocitySensitivity);
                  findIf(v, "oversample", result.oversample);
+                 findOrSet(v, "osq", engine::Group::OversampleQuality::OSQ_HIGH,
+                           result.oversampleQuality);
+                 findOrSet(v, "svd", false, result.sharedVoiceDecimation);
                  int rt{engine::BusAddress::DEFAULT_BUS};
                  findIf(v, "routeTo", rt);
                  findIf(v, "hip", result.hasIndependentPolyLimit);
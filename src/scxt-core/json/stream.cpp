@@ -34,7 +34,10 @@
 
 #include "scxt_traits.h"
 #include "engine_traits.h"
+#include "daw_state.h"
 #include "messaging/messaging.h"
+#include "infrastructure/load_timing.h"
+#include "engine/missing_resolution.h"
 
 namespace scxt::json
 {
@@ -73,8 +76,13 @@ std::string streamEngineState(const engine::Engine &e, bool pretty)
 
 void unstreamEngineState(engine::Engine &e, const std::string &data, bool msgPack)
 {
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::UNSTREAM);
     e.clearAll(false);
-    if (msgPack)
+    if (!msgPack && isCompactDawState(data))
+    {
+        unstreamCompactDawState(e, data);
+    }
+    else if (msgPack)
     {
         tao::json::events::transformer<tao::json::events::to_basic_value<scxt_traits>> consumer;
         tao::json::msgpack::events::from_string(consumer, data);
@@ -88,6 +96,8 @@ void unstreamEngineState(engine::Engine &e, const std::string &data, bool msgPac
         auto jv = std::move(consumer.value);
         jv.to(e);
     }
+    e.markPartStreamStateChanged(-1);
+    engine::autoRelinkMissingFromBrowserIndex(e);
     e.getSampleManager()->purgeUnreferencedSamples();
     e.sendFullRefreshToClient();
 }
@@ -95,6 +105,7 @@ void unstreamEngineState(engine::Engine &e, const std::string &data, bool msgPac
 void unstreamPartState(engine::Engine &e, int part, const std::string &data, bool msgPack,
                        bool setStreamGuard)
 {
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::UNSTREAM);
     e.getPatch()->getPart(part)->clearGroups();
     {
         std::unique_ptr<engine::Engine::StreamGuard> sg;
@@ -119,6 +130,8 @@ void unstreamPartState(engine::Engine &e, int part, const std::string &data, boo
         }
     }
 
+    e.markPartStreamStateChanged(part);
+    engine::autoRelinkMissingFromBrowserIndex(e);
     e.sendFullRefreshToClient();
 }
 } // namespace scxt::json
\ No newline at end of file
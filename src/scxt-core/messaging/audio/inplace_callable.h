@@ -0,0 +1,150 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MESSAGING_AUDIO_INPLACE_CALLABLE_H
+#define SCXT_SRC_SCXT_CORE_MESSAGING_AUDIO_INPLACE_CALLABLE_H
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace scxt::messaging::audio
+{
+/*
+ * A move-only callable which keeps its target inside the object. Unlike std::function it
+ * never reaches for the heap: a target which will not fit in Capacity bytes is a compile
+ * error rather than a hidden allocation. That makes it safe to hand across to the audio
+ * thread, so long as the object is created and destroyed on the other side - which is the
+ * contract of MessageController::AudioThreadCallback.
+ *
+ * A lambda whose captures are too big for the storage should box them in a unique_ptr made
+ * on the serialization thread; the pointer is what travels and it is freed back there.
+ */
+template <typename Sig, size_t Capacity> class InplaceCallable;
+
+template <typename R, typename... Args, size_t Capacity>
+class InplaceCallable<R(Args...), Capacity>
+{
+  public:
+    static constexpr size_t capacity{Capacity};
+
+    InplaceCallable() = default;
+    InplaceCallable(std::nullptr_t) {}
+
+    template <typename F, typename = std::enable_if_t<
+                              !std::is_same_v<std::decay_t<F>, InplaceCallable> &&
+                              !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+    InplaceCallable(F &&f)
+    {
+        emplace(std::forward<F>(f));
+    }
+
+    InplaceCallable(InplaceCallable &&other) noexcept { takeFrom(other); }
+    InplaceCallable &operator=(InplaceCallable &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceCallable(const InplaceCallable &) = delete;
+    InplaceCallable &operator=(const InplaceCallable &) = delete;
+
+    ~InplaceCallable() { reset(); }
+
+    template <typename F> void emplace(F &&f)
+    {
+        using T = std::decay_t<F>;
+        static_assert(sizeof(T) <= Capacity,
+                      "Callable is too large for in place storage. Box the big captures.");
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "Callable is over-aligned for in place storage");
+        static_assert(std::is_invocable_r_v<R, T &, Args...>,
+                      "Callable does not match the InplaceCallable signature");
+
+        reset();
+        new (storage) T(std::forward<F>(f));
+        ops = &opsFor<T>;
+    }
+
+    void reset()
+    {
+        if (ops)
+        {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    R operator()(Args... args)
+    {
+        assert(ops);
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+
+  private:
+    struct Ops
+    {
+        R (*invoke)(void *, Args &&...);
+        void (*moveTo)(void *dst, void *src);
+        void (*destroy)(void *);
+    };
+
+    template <typename T>
+    static constexpr Ops opsFor{
+        [](void *s, Args &&...args) -> R {
+            return (*static_cast<T *>(s))(std::forward<Args>(args)...);
+        },
+        [](void *d, void *s) {
+            new (d) T(std::move(*static_cast<T *>(s)));
+            static_cast<T *>(s)->~T();
+        },
+        [](void *s) { static_cast<T *>(s)->~T(); }};
+
+    void takeFrom(InplaceCallable &other)
+    {
+        if (other.ops)
+        {
+            other.ops->moveTo(storage, other.storage);
+            ops = other.ops;
+            other.ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops *ops{nullptr};
+};
+} // namespace scxt::messaging::audio
+
+#endif // SCXT_SRC_SCXT_CORE_MESSAGING_AUDIO_INPLACE_CALLABLE_H
@@ -0,0 +1,121 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MESSAGING_AUDIO_MPSC_QUEUE_H
+#define SCXT_SRC_SCXT_CORE_MESSAGING_AUDIO_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace scxt::messaging::audio
+{
+/*
+ * A bounded, lock-free queue with any number of producers and exactly one consumer. Each
+ * cell carries a sequence number which says whose turn it is: producers claim a slot with
+ * one compare-exchange on the enqueue position and publish it by bumping the cell sequence,
+ * and the consumer, which alone owns the dequeue position, waits for that bump. Nothing
+ * allocates after construction and nobody ever waits on anybody else.
+ *
+ * This is what the serialization thread talks to the audio thread through. It has to be
+ * multi producer since Engine::markDirty and friends can be reached from more than one
+ * thread.
+ */
+template <typename T, size_t N> struct MPSCQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MPSCQueue size must be a power of two");
+
+    MPSCQueue()
+    {
+        for (size_t i = 0; i < N; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Any thread. Returns false, dropping the item, if the queue is full.
+    bool push(const T &item)
+    {
+        auto pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto &cell = cells[pos & (N - 1)];
+            auto seq = cell.sequence.load(std::memory_order_acquire);
+            auto dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    std::optional<T> pop()
+    {
+        auto &cell = cells[dequeuePos & (N - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+            return std::nullopt;
+
+        T res = cell.value;
+        cell.sequence.store(dequeuePos + N, std::memory_order_release);
+        dequeuePos++;
+        return res;
+    }
+
+    // Consumer thread only
+    bool empty() const
+    {
+        return cells[dequeuePos & (N - 1)].sequence.load(std::memory_order_acquire) !=
+               dequeuePos + 1;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    Cell cells[N];
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos{0};
+};
+} // namespace scxt::messaging::audio
+
+#endif // SCXT_SRC_SCXT_CORE_MESSAGING_AUDIO_MPSC_QUEUE_H
@@ -37,6 +37,7 @@
 #include "filesystem/import.h"
 #include "browser/browser.h"
 #include "voice/preview_voice.h"
+#include "voice/preview_decoder.h"
 
 namespace scxt::messaging::client
 {
@@ -98,18 +99,38 @@ inline void doPreviewBrowserSample(const previewBrowserSamplePayload_t &p,
 {
     auto [action, amplitude, sampleAddress] = p;
 
+    using smp_t = sample::Sample;
+    auto st = sampleAddress.type;
+    auto singleFile = st == smp_t::WAV_FILE || st == smp_t::FLAC_FILE || st == smp_t::MP3_FILE ||
+                      st == smp_t::OPUS_FILE || st == smp_t::AIFF_FILE;
+
+    // Starting the file the voice is already playing toggles it off. Decide that here rather
+    // than leave it to the voice, since a second start would be a second decode of the file
+    if (action == 1 && singleFile && engine.previewDecoder->isPreviewing(sampleAddress.path))
+        action = 0;
+
     if (action == 1)
     {
-        auto sid = engine.getSampleManager()->loadSampleByFileAddress(sampleAddress, {});
+        std::shared_ptr<voice::PreviewStream> stream;
+        if (singleFile)
+        {
+            // Single files decode in the background and start playing as soon as the
+            // first few blocks are ready, without going near the SampleManager
+            if (fs::exists(sampleAddress.path))
+                stream = engine.previewDecoder->start(sampleAddress.path);
+        }
+        else
+        {
+            auto sid = engine.getSampleManager()->loadSampleByFileAddress(sampleAddress, {});
+            if (sid.has_value())
+                stream = engine.previewDecoder->wrap(engine.getSampleManager()->getSample(*sid));
+        }
 
-        if (sid.has_value())
+        if (stream)
         {
-            auto smp = engine.getSampleManager()->getSample(*sid);
-            cont.scheduleAudioThreadCallback(
-                [smp, amplitude](auto &eng) {
-                    eng.previewVoice->attachAndStartUnlessPlaying(smp, amplitude);
-                },
-                [](const auto &e) { e.getSampleManager()->purgeUnreferencedSamples(); });
+            cont.scheduleAudioThreadCallback([stream, amplitude](auto &eng) {
+                eng.previewVoice->attachAndStartUnlessPlaying(stream, amplitude);
+            });
         }
         else
         {
@@ -122,14 +143,13 @@ inline void doPreviewBrowserSample(const previewBrowserSamplePayload_t &p,
     {
         cont.scheduleAudioThreadCallback(
             [](auto &eng) { eng.previewVoice->detatchAndStop(); },
-            [](const auto &e) { e.getSampleManager()->purgeUnreferencedSamples(); });
+            [](const auto &e) { e.previewDecoder->release(); });
     }
     else if (action == 2)
     {
         cont.scheduleAudioThreadCallback(
             [amplitude](auto &eng) { eng.previewVoice->adjustAmplitude(amplitude); });
     }
-    engine.getSampleManager()->purgeUnreferencedSamples();
 }
 CLIENT_TO_SERIAL(PreviewBrowserSample, c2s_preview_browser_sample, previewBrowserSamplePayload_t,
                  doPreviewBrowserSample(payload, engine, cont));
@@ -28,6 +28,9 @@
 #ifndef SCXT_SRC_SCXT_CORE_MESSAGING_CLIENT_CLIENT_SERIAL_H
 #define SCXT_SRC_SCXT_CORE_MESSAGING_CLIENT_CLIENT_SERIAL_H
 
+#include <cstring>
+#include <string>
+
 #include "messaging/messaging.h"
 
 namespace scxt::messaging::client
@@ -293,6 +296,71 @@ inline bool cacheSerializationMessagesAbsentClient(SerializationToClientMessageI
     return false;
 }
 
+/*
+ * A bundle of server to client messages is these four bytes followed by (uint32 little
+ * endian length, encoded message) frames. A bare message is a msgpack map or a json
+ * object so never starts with the magic. A bundle holding one message is delivered bare.
+ * The magic is deliberately not the DAW state's "SCXB", so neither can be mistaken for
+ * the other.
+ */
+static constexpr char clientBundleMagic[4]{'S', 'C', 'M', 'B'};
+
+/*
+ * Call f(data, size) for each message in what the client received, in the order they
+ * were sent; a bare message is one. A bundle whose frames don't exactly fill it is
+ * rejected whole, with f never called, and this returns false.
+ */
+template <typename F> bool forEachMessageInBundle(const std::string &msg, F &&f)
+{
+    constexpr auto &magic = clientBundleMagic;
+    if (msg.size() < sizeof(magic) || std::memcmp(msg.data(), magic, sizeof(magic)) != 0)
+    {
+        f(msg.data(), msg.size());
+        return true;
+    }
+
+    auto *d = reinterpret_cast<const unsigned char *>(msg.data());
+    auto frameSize = [d](size_t pos) {
+        return (size_t)d[pos] | ((size_t)d[pos + 1] << 8) | ((size_t)d[pos + 2] << 16) |
+               ((size_t)d[pos + 3] << 24);
+    };
+
+    size_t pos{sizeof(magic)};
+    while (pos < msg.size())
+    {
+        if (msg.size() - pos < 4 || msg.size() - pos - 4 < frameSize(pos))
+            return false;
+        pos += 4 + frameSize(pos);
+    }
+
+    pos = sizeof(magic);
+    while (pos < msg.size())
+    {
+        auto sz = frameSize(pos);
+        f(msg.data() + pos + 4, sz);
+        pos += 4 + sz;
+    }
+    return true;
+}
+
+/*
+ * Progress and errors go to the client as they happen, even in the middle of a long
+ * serialization step which is otherwise bundling its messages. Anything already in the
+ * bundle is flushed ahead of them so ordering holds.
+ */
+inline bool sendToClientOutsideBundles(SerializationToClientMessageIds id)
+{
+    switch (id)
+    {
+    case s2c_send_activity_notification:
+    case s2c_report_error:
+        return true;
+    default:
+        break;
+    }
+    return false;
+}
+
 /*
  * How dragging an effect from one slot onto another resolves. Carried as the last field of
  * the swap-fx payloads, which is why it is int16_t sized.
@@ -117,13 +117,13 @@ auto executeOnClientFor(size_t ft, typename tao::json::basic_value<Traits> &o, C
 } // namespace detail
 
 template <typename Client>
-void clientThreadExecuteSerializationMessage(const std::string &msgView, Client *c)
+void clientThreadExecuteOneSerializationMessage(const char *data, size_t size, Client *c)
 {
     using namespace tao::json;
 
     // We need to unpack with the client message traits
     events::transformer<events::to_basic_value<detail::client_message_traits>> consumer;
-    encoder::events::from_string(consumer, msgView);
+    encoder::events::from_string(consumer, data, size);
     auto jv = std::move(consumer.value);
 
     auto o = jv.get_object();
@@ -136,5 +136,20 @@ void clientThreadExecuteSerializationMessage(const std::string &msgView, Client
             size_t)SerializationToClientMessageIds::num_serializationToClientMessages>());
 }
 
+template <typename Client>
+void clientThreadExecuteSerializationMessage(const std::string &msgView, Client *c)
+{
+    // A bundle (see MessageController::ClientMessageBundle) is walked in place, one frame
+    // after another, in the order the serialization thread sent them
+    auto ok = forEachMessageInBundle(msgView, [c](const char *data, size_t size) {
+        clientThreadExecuteOneSerializationMessage(data, size, c);
+    });
+    if (!ok)
+    {
+        SCLOG_IF(warnings, "Dropping a malformed message bundle of " << msgView.size()
+                                                                     << " bytes");
+    }
+}
+
 } // namespace scxt::messaging::client
 #endif // SCXT_SRC_SCXT_CORE_MESSAGING_CLIENT_DETAIL_CLIENT_SERIAL_DISPATCH_H
@@ -142,7 +142,7 @@ inline void serializationSendToClient(SerializationToClientMessageIds id, const
         auto mw = detail::ResponseWrapper<T>(msg, id);
         detail::client_message_value v = mw;
         auto res = encoder::to_string(v);
-        mc.clientCallback(res);
+        mc.deliverToClientLocked(res, sendToClientOutsideBundles(id));
     }
     catch (const std::exception &e)
     {
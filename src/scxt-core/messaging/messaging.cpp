@@ -35,6 +35,134 @@
 
 namespace scxt::messaging::client
 {
+/*
+ * The parts an edit to the selection can reach. Handlers act on the selected zones and
+ * groups, not on the selected part, so take the parts from the addresses themselves.
+ */
+static uint32_t partsReachedBySelection(engine::Engine &e)
+{
+    const auto &sm = e.getSelectionManager();
+    uint32_t mask{0};
+    auto add = [&mask](int32_t part) {
+        if (part >= 0 && part < numParts)
+            mask |= 1u << part;
+    };
+    add(sm->currentlySelectedPart(e));
+    for (const auto &z : sm->currentlySelectedZones())
+        add(z.part);
+    for (const auto &g : sm->currentlySelectedGroups())
+        add(g.part);
+    if (auto lz = sm->currentLeadZone(e))
+        add(lz->part);
+    if (auto lg = sm->currentLeadGroup(e))
+        add(lg->part);
+    return mask;
+}
+
+/*
+ * DAW state saves reuse each part's previous encoding until its stream generation moves,
+ * so after every message we move the generations it could have touched. Anything not
+ * listed is assumed to touch every part; a message misfiled here loses edits from a
+ * saved session, so only list ones whose reach is certain.
+ */
+static void markStreamedStateAfter(ClientToSerializationMessagesIds id, engine::Engine &e,
+                                   MessageController &mc)
+{
+    static constexpr uint32_t allParts{(1u << numParts) - 1};
+    uint32_t mask{allParts};
+
+    switch (id)
+    {
+    // Queries, transport, browser and UI-only traffic leave the parts alone. Selection is
+    // streamed, but outside the parts, and is re-encoded on every save.
+    case c2s_register_client:
+    case c2s_resend_full_state:
+    case c2s_save_multi:
+    case c2s_save_part:
+    case c2s_apply_select_actions:
+    case c2s_select_part:
+    case c2s_begin_edit:
+    case c2s_end_edit:
+    case c2s_request_zone_mapping:
+    case c2s_request_zone_data_refresh:
+    case c2s_request_pgz_structure:
+    case c2s_noteonoff:
+    case c2s_add_browser_device_location:
+    case c2s_reindex_browser_location:
+    case c2s_request_browser_update:
+    case c2s_remove_browser_device_location:
+    case c2s_preview_browser_sample:
+    case c2s_browser_queue_refresh:
+    case c2s_request_debug_action:
+    case c2s_raise_debug_error:
+    case c2s_silence_engine:
+    case c2s_request_host_callback:
+    case c2s_macro_begin_end_edit:
+    case c2s_set_othertab_selection:
+        mask = 0;
+        break;
+
+    // Edits which apply to the selected zones or groups
+    case c2s_update_zone_or_group_eg_float_value:
+    case c2s_update_zone_or_group_eg_bool_value:
+    case c2s_update_zone_or_group_modstorage_float_value:
+    case c2s_update_zone_or_group_modstorage_bool_value:
+    case c2s_update_zone_or_group_modstorage_int16_t_value:
+    case c2s_update_full_adsrstorage_for_groups_or_zones:
+    case c2s_update_full_modstorage_for_groups_or_zones:
+    case c2s_update_miscmod_storage_for_groups_or_zones:
+    case c2s_update_audiomod_storage_for_groups_or_zones:
+    case c2s_update_audiomod_storage_element_for_groups_or_zones:
+    case c2s_update_lead_zone_mapping:
+    case c2s_update_zone_mapping_float:
+    case c2s_update_zone_mapping_int16_t:
+    case c2s_update_variant_field:
+    case c2s_update_zone_variants_int16_t:
+    case c2s_apply_all_zone_delta:
+    case c2s_normalize_variant_amplitude:
+    case c2s_clear_variant_amplitude_normalization:
+    case c2s_delete_variant:
+    case c2s_update_zone_output_float_value:
+    case c2s_update_zone_output_int16_t_value:
+    case c2s_update_zone_output_int16_t_value_then_refresh:
+    case c2s_update_zone_routing_row:
+    case c2s_reorder_mod_row:
+    case c2s_update_group_routing_row:
+    case c2s_update_group_output_float_value:
+    case c2s_update_group_output_int16_t_value:
+    case c2s_update_group_output_bool_value:
+    case c2s_update_group_output_info_polyphony:
+    case c2s_update_group_output_info_midichannel:
+    case c2s_update_group_output_info_exclusive_group:
+    case c2s_update_group_trigger_conditions:
+    case c2s_update_single_processor_float_value:
+    case c2s_update_single_processor_bool_value:
+    case c2s_update_single_processor_int32_t_value:
+    case c2s_set_processor_type:
+    case c2s_copy_processor_lead_to_all:
+    case c2s_swap_zone_processors:
+    case c2s_swap_group_processors:
+    case c2s_send_full_processor_storage:
+        mask = partsReachedBySelection(e);
+        break;
+
+    default:
+        break;
+    }
+
+    if (mask == allParts)
+    {
+        e.markPartStreamStateChanged(-1);
+    }
+    else
+    {
+        for (int p = 0; p < numParts; ++p)
+            if (mask & (1u << p))
+                e.markPartStreamStateChanged(p);
+    }
+    mc.noteStreamedPartsEdited(mask);
+}
+
 // c2s dispatcher — defined here (not inline in impl.h) so the per-message-id helper
 // instantiation tree it pulls in is parsed and instantiated in exactly one TU instead
 // of every TU that touches the messaging headers.
@@ -56,6 +184,7 @@ void serializationThreadExecuteClientMessage(const std::string &msgView, engine:
         (ClientToSerializationMessagesIds)idv, jv, e, mc,
         std::make_index_sequence<(
             size_t)ClientToSerializationMessagesIds::num_clientToSerializationMessages>());
+    markStreamedStateAfter((ClientToSerializationMessagesIds)idv, e, mc);
 }
 } // namespace scxt::messaging::client
 
@@ -167,12 +296,33 @@ void MessageController::returnAudioThreadCallback(AudioThreadCallback *r)
 {
     assert(threadingChecker.isSerialThread());
     r->execCompleteOnSer(engine);
+    // Drop the captures now, here, rather than whenever the slot is next reused
+    r->clear();
     cbStore.push(r);
+
+    audioCallbacksInFlight--;
+    if (streamedPartsAwaitingAudio)
+    {
+        // A save between the message and this callback running encoded the part as it
+        // was, under the new generation. Move it again now the edit has landed.
+        for (int p = 0; p < numParts; ++p)
+            if (streamedPartsAwaitingAudio & (1u << p))
+                engine.markPartStreamStateChanged(p);
+        if (audioCallbacksInFlight == 0)
+            streamedPartsAwaitingAudio = 0;
+    }
+}
+
+void MessageController::noteStreamedPartsEdited(uint32_t partMask)
+{
+    assert(threadingChecker.isSerialThread());
+    if (audioCallbacksInFlight > 0)
+        streamedPartsAwaitingAudio |= partMask;
 }
 
 void MessageController::scheduleAudioThreadFunctionCallback(
-    audio::SerializationToAudioMessageId sid, std::function<void(engine::Engine &)> cb,
-    std::function<void(const engine::Engine &)> sercb)
+    audio::SerializationToAudioMessageId sid, audioThreadFunction_t &&cb,
+    serialCompleteFunction_t sercb)
 {
     assert(threadingChecker.isSerialThread());
 
@@ -191,9 +341,9 @@ void MessageController::scheduleAudioThreadFunctionCallback(
     else
     {
         auto pt = getAudioThreadCallback();
-        pt->setFunction(cb);
+        pt->setFunction(std::move(cb));
         if (sercb)
-            pt->setSerialCompleteFunction(sercb);
+            pt->setSerialCompleteFunction(std::move(sercb));
         else
             pt->nullSerialCompleteFunction();
         auto s2a = audio::SerializationToAudio();
@@ -201,12 +351,28 @@ void MessageController::scheduleAudioThreadFunctionCallback(
         s2a.payload.p = (void *)pt;
         s2a.payloadType = audio::SerializationToAudio::VOID_STAR;
 
-        serializationToAudioQueue.push(s2a);
+        // The audio thread empties the queue every block, so a full one is only behind. Give
+        // it a moment, and if it still has no room take the callback back rather than count
+        // it in flight, since it would never come home.
+        auto pushed = serializationToAudioQueue.push(s2a);
+        for (int i = 0; !pushed && i < audioQueueFullRetries; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            pushed = serializationToAudioQueue.push(s2a);
+        }
+        if (!pushed)
+        {
+            pt->clear();
+            cbStore.push(pt);
+            RAISE_ERROR_CONT(*this, "Audio thread not responding",
+                             "The queue to the audio thread is full, so an edit was dropped");
+            return;
+        }
+        audioCallbacksInFlight++;
     }
 }
 
-void MessageController::stopAudioThreadThenRunOnSerial(
-    std::function<void(const engine::Engine &)> f)
+void MessageController::stopAudioThreadThenRunOnSerial(serialCompleteFunction_t f)
 {
     assert(threadingChecker.isSerialThread());
     scheduleAudioThreadCallbackUnderStructureLock([](engine::Engine &e) { e.stopEngineRequests++; },
@@ -249,6 +415,7 @@ void MessageController::runSerialization()
         }
         if (shouldRun)
         {
+            auto bundle = ClientMessageBundle(*this);
             if (receivedMessageFromClient)
             {
                 std::lock_guard<std::mutex> g(engine.modifyStructureMutex);
@@ -283,6 +450,12 @@ void MessageController::runSerialization()
                     tryToDrain = false;
             }
             serializationThreadPostAudioQueueDrain();
+
+            if (auto dropped = droppedSerializationToAudio.exchange(0))
+            {
+                SCLOG_IF(warnings, "Serialization to audio queue full; dropped "
+                                       << dropped << " messages");
+            }
         }
         else
         {
@@ -354,6 +527,67 @@ void MessageController::registerClient(const std::string &nm, clientCallback_t &
 
     isClientConnected = true;
 }
+MessageController::ClientMessageBundle::ClientMessageBundle(MessageController &m) : mc(m)
+{
+    assert(mc.threadingChecker.isSerialThread());
+    auto lk = mc.acquireClientCallbackMutex();
+    mc.clientBundleDepth++;
+}
+
+MessageController::ClientMessageBundle::~ClientMessageBundle()
+{
+    auto lk = mc.acquireClientCallbackMutex();
+    mc.clientBundleDepth--;
+    if (mc.clientBundleDepth == 0 && mc.clientBundleCount > 0)
+        mc.flushClientBundleLocked();
+}
+
+void MessageController::deliverToClientLocked(const serialToClientMessage_t &msg,
+                                              bool immediate)
+{
+    if (clientBundleDepth == 0 || immediate)
+    {
+        if (clientBundleCount > 0)
+            flushClientBundleLocked();
+        clientCallback(msg);
+        return;
+    }
+
+    if (clientBundleCount == 0)
+    {
+        clientBundleBuffer.clear();
+        clientBundleBuffer.append(client::clientBundleMagic, sizeof(client::clientBundleMagic));
+    }
+    auto sz = (uint32_t)msg.size();
+    char len[4]{(char)(sz & 0xFF), (char)((sz >> 8) & 0xFF), (char)((sz >> 16) & 0xFF),
+                (char)((sz >> 24) & 0xFF)};
+    clientBundleBuffer.append(len, sizeof(len));
+    clientBundleBuffer.append(msg);
+    clientBundleCount++;
+
+    if (clientBundleBuffer.size() >= clientBundleFlushBytes)
+        flushClientBundleLocked();
+}
+
+void MessageController::flushClientBundleLocked()
+{
+    if (clientBundleCount == 0)
+        return;
+
+    // The client may have gone away mid step, in which case the bundle is dropped
+    // just as an unbundled message would have been
+    if (clientCallback)
+    {
+        static constexpr size_t header{sizeof(client::clientBundleMagic) + 4};
+        if (clientBundleCount == 1)
+            clientCallback(clientBundleBuffer.substr(header));
+        else
+            clientCallback(clientBundleBuffer);
+    }
+    clientBundleCount = 0;
+    clientBundleBuffer.clear();
+}
+
 void MessageController::unregisterClient()
 {
     auto lk = acquireClientCallbackMutex();
@@ -362,6 +596,8 @@ void MessageController::unregisterClient()
 
     assert(clientCallback);
     clientCallback = nullptr;
+    clientBundleCount = 0;
+    clientBundleBuffer.clear();
     isClientConnected = false;
 }
 void MessageController::sendRawFromClient(const clientToSerializationMessage_t &s)
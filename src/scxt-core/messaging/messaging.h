@@ -32,6 +32,7 @@
 
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 
 #include <queue>
@@ -40,6 +41,8 @@
 
 #include "client/client_serial.h"
 #include "audio/audio_serial.h"
+#include "audio/inplace_callable.h"
+#include "audio/mpsc_queue.h"
 #include "sst/cpputils/ring_buffer.h"
 
 namespace scxt::messaging
@@ -140,7 +143,9 @@ namespace scxt::messaging
  * MessageController::scheduleAudioThreadCallback(cb) hides most of these
  * mechanics by sending a function to the audio thread with all of the
  * required allocation and deallocation happening on the serialization
- * thread.
+ * thread. The function is held in an audio::InplaceCallable so its captures
+ * live inside a pooled callback object; a capture too large to fit fails to
+ * compile rather than quietly allocating.
  *
  * The other common pattern of the audio thread initiates a message is
  * really just done by explicitly constructing the message on the audio
@@ -157,7 +162,6 @@ struct MessageController : MoveableOnly<MessageController>
   public:
     MessageController(engine::Engine &e) : engine(e)
     {
-        serializationToAudioQueue.subscribe();
         audioToSerializationQueue.subscribe();
 
         for (auto &ma : macroSetValueCompressor)
@@ -205,6 +209,30 @@ struct MessageController : MoveableOnly<MessageController>
     }
     std::vector<std::string> preClientConnectionCache;
 
+    /**
+     * Client message bundling. While a ClientMessageBundle is open on the serialization
+     * thread, messages to the client are framed into one buffer rather than each being
+     * handed to the client callback; the outermost bundle delivers the buffer in a single
+     * callback when it closes. runSerialization opens one around each step, so a full
+     * refresh or a selection burst reaches the client as one queue entry rather than
+     * hundreds.
+     *
+     * The frame layout is described at client::clientBundleMagic.
+     */
+    static constexpr size_t clientBundleFlushBytes{4 * 1024 * 1024};
+    struct ClientMessageBundle
+    {
+        MessageController &mc;
+        explicit ClientMessageBundle(MessageController &m);
+        ~ClientMessageBundle();
+    };
+
+    /**
+     * Hand an encoded message to the client, or to the open bundle. Called by
+     * serializationSendToClient with the client callback mutex held.
+     */
+    void deliverToClientLocked(const serialToClientMessage_t &msg, bool immediate);
+
     /**
      * Register a client. Called from the client thread.
      *
@@ -259,42 +287,72 @@ struct MessageController : MoveableOnly<MessageController>
      * Send a message from the serialization thread to the audio thread.
      * Called from the serialization queue.
      *
+     * Everything sent this way is a notification a later one supersedes, and some of it is
+     * sent from audio thread callbacks, so a full queue drops the message rather than wait.
+     * The serialization thread logs the drops.
+     *
      * @param m
      */
-    void sendSerializationToAudio(const serializationToAudioMessage_t &m)
+    bool sendSerializationToAudio(const serializationToAudioMessage_t &m)
     {
-        serializationToAudioQueue.push(m);
+        if (serializationToAudioQueue.push(m))
+            return true;
+        droppedSerializationToAudio.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
+    std::atomic<uint32_t> droppedSerializationToAudio{0};
+
+    // How many milliseconds scheduleAudioThreadCallback waits for room in a full queue
+    static constexpr int audioQueueFullRetries{100};
+
+    /*
+     * The audio side of a scheduled callback. Its captures are stored in place and are
+     * created and destroyed on the serialization thread, so they may own heap memory; they
+     * just have to fit.
+     */
+    static constexpr size_t audioThreadCallbackCapacity{4096};
+    using audioThreadFunction_t =
+        audio::InplaceCallable<void(engine::Engine &), audioThreadCallbackCapacity>;
+    using serialCompleteFunction_t = std::function<void(const engine::Engine &)>;
 
     /**
      * Schedule a function on the audio thread from the serialization thread.
      * @param f
      */
-    void scheduleAudioThreadCallback(std::function<void(engine::Engine &)> f,
-                                     std::function<void(const engine::Engine &)> cb = nullptr)
+    template <typename F>
+    void scheduleAudioThreadCallback(F &&f, serialCompleteFunction_t cb = nullptr)
     {
-        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer, f, cb);
+        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer,
+                                            audioThreadFunction_t(std::forward<F>(f)),
+                                            std::move(cb));
     }
 
-    void scheduleAudioThreadCallbackUnderStructureLock(
-        std::function<void(engine::Engine &)> f,
-        std::function<void(const engine::Engine &)> cb = nullptr)
+    template <typename F>
+    void scheduleAudioThreadCallbackUnderStructureLock(F &&f,
+                                                       serialCompleteFunction_t cb = nullptr)
     {
-        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer_under_structurelock, f,
-                                            cb);
+        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer_under_structurelock,
+                                            audioThreadFunction_t(std::forward<F>(f)),
+                                            std::move(cb));
     }
 
     void scheduleAudioThreadFunctionCallback(audio::SerializationToAudioMessageId id,
-                                             std::function<void(engine::Engine &)> f,
-                                             std::function<void(const engine::Engine &)> cb);
+                                             audioThreadFunction_t &&f,
+                                             serialCompleteFunction_t cb);
 
-    void stopAudioThreadThenRunOnSerial(std::function<void(const engine::Engine &)> f);
+    void stopAudioThreadThenRunOnSerial(serialCompleteFunction_t f);
     void restartAudioThreadFromSerial();
+
+    /*
+     * A pooled callback. It is filled, and after the audio thread is done with it emptied,
+     * on the serialization thread only, so whatever its captures own is released there. The
+     * audio thread only ever calls exec. In debug builds the pool checks that contract.
+     */
     struct AudioThreadCallback
     {
       public:
-        void setFunction(std::function<void(engine::Engine &)> &to) { f = std::move(to); }
-        void setSerialCompleteFunction(std::function<void(const engine::Engine &)> &q)
+        void setFunction(audioThreadFunction_t &&to) { f = std::move(to); }
+        void setSerialCompleteFunction(serialCompleteFunction_t &&q)
         {
             serialOnComplete = std::move(q);
         }
@@ -302,6 +360,7 @@ struct MessageController : MoveableOnly<MessageController>
         inline void exec(engine::Engine &e)
         {
             assert(e.getMessageController()->threadingChecker.isAudioThread());
+            assert(f);
             f(e);
         }
         inline void execCompleteOnSer(const engine::Engine &e)
@@ -310,10 +369,16 @@ struct MessageController : MoveableOnly<MessageController>
             if (serialOnComplete)
                 serialOnComplete(e);
         }
+        // Release the captures of both halves. Serialization thread only.
+        void clear()
+        {
+            f.reset();
+            serialOnComplete = nullptr;
+        }
 
       private:
-        std::function<void(engine::Engine &)> f{nullptr};
-        std::function<void(const engine::Engine &)> serialOnComplete{nullptr};
+        audioThreadFunction_t f;
+        serialCompleteFunction_t serialOnComplete{nullptr};
     };
 
     // The engine has direct access to the audio queues
@@ -385,6 +450,13 @@ struct MessageController : MoveableOnly<MessageController>
     };
 
   private:
+    // Only the serialization thread opens bundles, but messages from other threads read the
+    // depth as they are delivered, so all three are guarded by clientCallbackMutex
+    int clientBundleDepth{0};
+    uint32_t clientBundleCount{0};
+    std::string clientBundleBuffer;
+    void flushClientBundleLocked();
+
     uint64_t inboundClientMessageCount{0};
     void runSerialization();
     void parseAudioMessageOnSerializationThread(const audio::AudioToSerialization &as);
@@ -397,8 +469,19 @@ struct MessageController : MoveableOnly<MessageController>
     AudioThreadCallback *getAudioThreadCallback();
     void returnAudioThreadCallback(AudioThreadCallback *);
     std::stack<AudioThreadCallback *> cbStore;
+    int32_t audioCallbacksInFlight{0};
+    uint32_t streamedPartsAwaitingAudio{0};
+
+  public:
+    /*
+     * Edits reach the parts through audio thread callbacks, so the parts a message marked
+     * as changed are marked again when those callbacks come back.
+     */
+    void noteStreamedPartsEdited(uint32_t partMask);
+
+  private:
 
-    sst::cpputils::SimpleRingBuffer<serializationToAudioMessage_t, 1024> serializationToAudioQueue;
+    audio::MPSCQueue<serializationToAudioMessage_t, 1024> serializationToAudioQueue;
     sst::cpputils::SimpleRingBuffer<audioToSerializationMessage_t, 1024 * 16>
         audioToSerializationQueue;
 
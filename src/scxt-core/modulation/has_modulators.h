@@ -30,7 +30,10 @@
 
 #include "configuration.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <new>
 
 #include "sst/basic-blocks/modulators/AHDSRShapedSC.h"
 #include "modulation/modulators/steplfo.h"
@@ -74,14 +77,15 @@ template <typename T, size_t egsPerObject> struct HasModulators
         }
     } doubleRate;
 
-    using cLFO_t = scxt::modulation::modulators::CurveLFO;
     using envF_t = scxt::modulation::modulators::EnvFollower;
     HasModulators(T *that, sst::basic_blocks::dsp::RNG &extrng)
         : eg{sst::cpputils::make_array<ahdsrenv_t, egsPerObject>(that)}, doubleRate{that},
           egOS{sst::cpputils::make_array<ahdsrenvOS_t, egsPerObject>(&doubleRate)},
-          randomEvaluator(extrng),
-          curveLfos{sst::cpputils::make_array<cLFO_t, lfosPerObject>(extrng)}
+          lfoRng(extrng), randomEvaluator(extrng)
     {
+        // lfoEvaluator starts as STEP, so the slots do too
+        for (auto &s : lfoSlots)
+            s.hold(STEP, lfoRng);
     }
 
     static constexpr uint16_t lfosPerObject{lfosPerZone};
@@ -94,9 +98,145 @@ template <typename T, size_t egsPerObject> struct HasModulators
         ENV,
         MSEG
     } lfoEvaluator[lfosPerObject]{};
-    std::array<scxt::modulation::modulators::StepLFO, lfosPerObject> stepLfos{};
-    std::array<scxt::modulation::modulators::CurveLFO, lfosPerObject> curveLfos;
-    std::array<scxt::modulation::modulators::EnvLFO, lfosPerObject> envLfos{};
+
+    /*
+     * Only one evaluator per LFO is ever live, so rather than carry a step, a curve and an
+     * env LFO for every slot, each slot is storage for the largest of them with whichever
+     * one lfoEvaluator names built in place. MSEG holds nothing yet. Nothing here allocates,
+     * so the evaluator can change on the audio thread. The evaluators point into themselves
+     * (their envelopes hold the owning LFO as the sample rate provider) so a slot never
+     * moves or copies.
+     */
+    struct LFOSlot
+    {
+        using step_t = scxt::modulation::modulators::StepLFO;
+        using curve_t = scxt::modulation::modulators::CurveLFO;
+        using env_t = scxt::modulation::modulators::EnvLFO;
+
+        static constexpr size_t storageSize{
+            std::max({sizeof(step_t), sizeof(curve_t), sizeof(env_t)})};
+        static constexpr size_t storageAlign{
+            std::max({alignof(step_t), alignof(curve_t), alignof(env_t)})};
+
+        LFOSlot() = default;
+        ~LFOSlot() { clear(); }
+        LFOSlot(const LFOSlot &) = delete;
+        LFOSlot &operator=(const LFOSlot &) = delete;
+
+        template <typename L> L &as()
+        {
+            return *std::launder(reinterpret_cast<L *>(storage));
+        }
+        template <typename L> const L &as() const
+        {
+            return *std::launder(reinterpret_cast<const L *>(storage));
+        }
+
+        // Returns true if the slot had to build a new evaluator
+        bool hold(LFOEvaluator ev, sst::basic_blocks::dsp::RNG &rng)
+        {
+            if (held == (int)ev)
+                return false;
+            clear();
+            switch (ev)
+            {
+            case STEP:
+                new (storage) step_t();
+                break;
+            case CURVE:
+                new (storage) curve_t(rng);
+                break;
+            case ENV:
+                new (storage) env_t();
+                break;
+            default:
+                break;
+            }
+            held = (int)ev;
+            return true;
+        }
+
+        void clear()
+        {
+            switch (held)
+            {
+            case STEP:
+                as<step_t>().~step_t();
+                break;
+            case CURVE:
+                as<curve_t>().~curve_t();
+                break;
+            case ENV:
+                as<env_t>().~env_t();
+                break;
+            default:
+                break;
+            }
+            held = -1;
+        }
+
+        int held{-1};
+        alignas(storageAlign) unsigned char storage[storageSize];
+    };
+    std::array<LFOSlot, lfosPerObject> lfoSlots;
+    sst::basic_blocks::dsp::RNG &lfoRng;
+
+    static LFOEvaluator evaluatorFor(const modulation::ModulatorStorage &ms)
+    {
+        return ms.isStep() ? STEP : (ms.isEnv() ? ENV : (ms.isMSEG() ? MSEG : CURVE));
+    }
+
+    /*
+     * Every change to lfoEvaluator goes through here so the slot always holds what it
+     * names. Returns true if the evaluator was newly built, and so still needs assigning to
+     * its storage and sample rate before it runs.
+     */
+    bool setLFOEvaluator(int i, LFOEvaluator ev)
+    {
+        lfoEvaluator[i] = ev;
+        return lfoSlots[i].hold(ev, lfoRng);
+    }
+
+    scxt::modulation::modulators::StepLFO &stepLfo(int i)
+    {
+        assert(lfoEvaluator[i] == STEP);
+        return lfoSlots[i].template as<typename LFOSlot::step_t>();
+    }
+    scxt::modulation::modulators::CurveLFO &curveLfo(int i)
+    {
+        assert(lfoEvaluator[i] == CURVE);
+        return lfoSlots[i].template as<typename LFOSlot::curve_t>();
+    }
+    scxt::modulation::modulators::EnvLFO &envLfo(int i)
+    {
+        assert(lfoEvaluator[i] == ENV);
+        return lfoSlots[i].template as<typename LFOSlot::env_t>();
+    }
+    const scxt::modulation::modulators::EnvLFO &envLfo(int i) const
+    {
+        assert(lfoEvaluator[i] == ENV);
+        return lfoSlots[i].template as<typename LFOSlot::env_t>();
+    }
+
+    // Hand the matrix a block of LFO i computed elsewhere, as if our evaluator had run it
+    void setLFOOutput(int i, float v)
+    {
+        switch (lfoEvaluator[i])
+        {
+        case STEP:
+            stepLfo(i).output = v;
+            break;
+        case CURVE:
+            curveLfo(i).output = v;
+            break;
+        case ENV:
+            envLfo(i).output = v;
+            break;
+        default:
+            break;
+        }
+    }
+
     scxt::modulation::modulators::RandomEvaluator randomEvaluator;
     scxt::modulation::modulators::PhasorEvaluator phasorEvaluator{};
     std::array<scxt::modulation::modulators::EnvFollower, envFollowersPerGroupOrZone>
@@ -198,13 +338,13 @@ template <typename T, size_t egsPerObject> struct HasModulators
         switch (ms.triggerMode)
         {
         case modulation::ModulatorStorage::SONGPOS:
-            stepLfos[i].setStartPosition(ms.start_phase, transport.timeInSeconds);
+            stepLfo(i).setStartPosition(ms.start_phase, transport.timeInSeconds);
             break;
         case modulation::ModulatorStorage::RANDOM:
-            stepLfos[i].setStartPosition(rng.unif01());
+            stepLfo(i).setStartPosition(rng.unif01());
             break;
         default:
-            stepLfos[i].setStartPosition(ms.start_phase);
+            stepLfo(i).setStartPosition(ms.start_phase);
             break;
         }
     }
@@ -225,11 +365,11 @@ template <typename T, size_t egsPerObject> struct HasModulators
             startStepLFO(i, ms, transport, rng);
             break;
         case CURVE:
-            curveLfos[i].attack(initialLFOPhase(ms, transport, *lp.rateP, rng), *lp.curve.delayP,
+            curveLfo(i).attack(initialLFOPhase(ms, transport, *lp.rateP, rng), *lp.curve.delayP,
                                 ms.modulatorShape);
             break;
         case ENV:
-            envLfos[i].attack(*lp.env.delayP, *lp.env.attackP);
+            envLfo(i).attack(*lp.env.delayP, *lp.env.attackP);
             break;
         default:
             break;
@@ -241,13 +381,13 @@ template <typename T, size_t egsPerObject> struct HasModulators
         switch (lfoEvaluator[i])
         {
         case STEP:
-            stepLfos[i].silence();
+            stepLfo(i).silence();
             break;
         case CURVE:
-            curveLfos[i].silence();
+            curveLfo(i).silence();
             break;
         case ENV:
-            envLfos[i].silence();
+            envLfo(i).silence();
             break;
         default:
             break;
@@ -306,38 +446,38 @@ template <typename T, size_t egsPerObject> struct HasModulators
         {
         case STEP:
             if (rt)
-                stepLfos[i].retrigger();
-            stepLfos[i].process(blockSize);
-            stepLfos[i].output *= amp;
+                stepLfo(i).retrigger();
+            stepLfo(i).process(blockSize);
+            stepLfo(i).output *= amp;
             break;
         case CURVE:
         {
             if (rt)
-                curveLfos[i].attack(0, *lp.curve.delayP, ms.modulatorShape);
+                curveLfo(i).attack(0, *lp.curve.delayP, ms.modulatorShape);
 
             // With the sub-envelope off, a one shot is one cycle of the curve and then
             // silence; with it on, it is the DAR envelope making a single pass instead
             auto useEnv = ms.curveLfoStorage.useenv;
             auto oneCycle = oneShot && !useEnv;
 
-            if (oneCycle && curveLfos[i].cycleComplete())
+            if (oneCycle && curveLfo(i).cycleComplete())
             {
-                curveLfos[i].silence();
+                curveLfo(i).silence();
                 break;
             }
 
             using senv_t = modulation::modulators::CurveLFO::senv_t;
             auto useGate =
-                lfoEnvelopeGate(ms.triggerMode, gate, curveLfos[i].simpleEnv.stage, senv_t::s_hold);
+                lfoEnvelopeGate(ms.triggerMode, gate, curveLfo(i).simpleEnv.stage, senv_t::s_hold);
 
-            curveLfos[i].process(*lp.rateP, *lp.curve.deformP, *lp.curve.angleP, *lp.curve.delayP,
+            curveLfo(i).process(*lp.rateP, *lp.curve.deformP, *lp.curve.angleP, *lp.curve.delayP,
                                  *lp.curve.attackP, *lp.curve.releaseP, useEnv,
                                  ms.curveLfoStorage.unipolar, useGate);
             // Silence the block the cycle ends on rather than show the next one starting
-            if (oneCycle && curveLfos[i].cycleComplete())
-                curveLfos[i].silence();
+            if (oneCycle && curveLfo(i).cycleComplete())
+                curveLfo(i).silence();
             else
-                curveLfos[i].output *= amp;
+                curveLfo(i).output *= amp;
             break;
         }
         case ENV:
@@ -345,28 +485,28 @@ template <typename T, size_t egsPerObject> struct HasModulators
             using env_t = modulation::modulators::EnvLFO::env_t;
             auto eloop = ms.envLfoStorage.loop && !oneShot;
             auto useGate =
-                lfoEnvelopeGate(ms.triggerMode, gate, envLfos[i].envelope.stage, env_t::s_sustain);
+                lfoEnvelopeGate(ms.triggerMode, gate, envLfo(i).envelope.stage, env_t::s_sustain);
 
             if (eloop)
             {
                 // A looping env is a unipolar LFO: gate through DAHD, drop at sustain so it
                 // releases, then re-attack once it completes so it cycles. This drives the
                 // loop for both Voice and Group (the Group path previously lacked it).
-                useGate = envLfos[i].envelope.stage < env_t::s_sustain;
-                if (envLfos[i].envelope.stage > env_t::s_release)
+                useGate = envLfo(i).envelope.stage < env_t::s_sustain;
+                if (envLfo(i).envelope.stage > env_t::s_release)
                     rt = true;
             }
             if (rt)
             {
-                envLfos[i].attackFrom(envLfos[i].output, *lp.env.delayP, *lp.env.attackP);
+                envLfo(i).attackFrom(envLfo(i).output, *lp.env.delayP, *lp.env.attackP);
                 useGate = true;
             }
 
-            envLfos[i].process(*lp.env.delayP, *lp.env.attackP, *lp.env.holdP, *lp.env.decayP,
+            envLfo(i).process(*lp.env.delayP, *lp.env.attackP, *lp.env.holdP, *lp.env.decayP,
                                *lp.env.sustainP, *lp.env.releaseP, *lp.env.aShapeP, *lp.env.dShapeP,
                                *lp.env.rShapeP, *lp.env.rateMulP, useGate, ms.temposync,
                                transport.tempo / 120.f);
-            envLfos[i].output *= amp;
+            envLfo(i).output *= amp;
             break;
         }
         default:
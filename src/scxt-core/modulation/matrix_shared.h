@@ -492,13 +492,13 @@ struct LFOSourceBase
             switch (s.lfoEvaluator[i])
             {
             case S::CURVE:
-                m.bindSourceValue(sources[i], s.curveLfos[i].output);
+                m.bindSourceValue(sources[i], s.curveLfo(i).output);
                 break;
             case S::STEP:
-                m.bindSourceValue(sources[i], s.stepLfos[i].output);
+                m.bindSourceValue(sources[i], s.stepLfo(i).output);
                 break;
             case S::ENV:
-                m.bindSourceValue(sources[i], s.envLfos[i].output);
+                m.bindSourceValue(sources[i], s.envLfo(i).output);
                 break;
             case S::MSEG:
                 m.bindSourceValue(sources[i], zeroSource);
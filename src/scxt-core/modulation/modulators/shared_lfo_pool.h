@@ -0,0 +1,178 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MODULATION_MODULATORS_SHARED_LFO_POOL_H
+#define SCXT_SRC_SCXT_CORE_MODULATION_MODULATORS_SHARED_LFO_POOL_H
+
+#include <array>
+#include <cstdint>
+
+#include "sst/basic-blocks/dsp/RNG.h"
+#include "sst/cpputils/constructors.h"
+
+#include "utils.h"
+#include "modulation/modulator_storage.h"
+#include "modulation/modulators/steplfo.h"
+#include "modulation/modulators/curvelfo.h"
+
+namespace scxt::modulation::modulators
+{
+/*
+ * A song position locked LFO which nothing in the matrix modulates and which draws
+ * nothing random produces exactly the same block in every voice of its zone. Rather
+ * than have each voice run its own copy, the first voice to ask in a block runs the one
+ * entry here for (zone, lfo) and every later voice copies its output.
+ *
+ * The pool is preallocated by the engine so claiming an entry on the audio thread is a
+ * scan, not an allocation. An entry nobody evaluated last block is free for reuse, and
+ * when one is picked up again it re-locks to song position, which is where each voice's
+ * own evaluator would have been. If the pool is full, voices just run their own.
+ */
+struct SharedLFOPool : MoveableOnly<SharedLFOPool>
+{
+    static constexpr int16_t maxEntries{128};
+
+    explicit SharedLFOPool(sst::basic_blocks::dsp::RNG &rng)
+        : entries{sst::cpputils::make_array<Entry, maxEntries>(rng)}
+    {
+    }
+
+    // Only LFOs whose block can't differ voice to voice qualify
+    static bool canShare(const ModulatorStorage &ms, bool targetedByMatrix)
+    {
+        if (targetedByMatrix || ms.triggerMode != ModulatorStorage::SONGPOS)
+            return false;
+        if (ms.isStep())
+            return true;
+        if (!ms.isCurve() || ms.curveLfoStorage.useenv)
+            return false;
+        // the noise shapes draw from the rng, so each voice hears its own noise
+        return ms.modulatorShape != ModulatorStorage::LFO_SMOOTH_NOISE &&
+               ms.modulatorShape != ModulatorStorage::LFO_SH_NOISE;
+    }
+
+    void beginBlock() { currentBlock++; }
+
+    // Off, every voice runs its own evaluator; what the pool hands out has to match that
+    bool enabled{true};
+
+    /*
+     * The amplitude scaled block for LFO i of v's zone, evaluated at most once per block,
+     * or nullptr if the pool has no room and v should run its own evaluator. V is the
+     * Voice; it is a template only to keep the engine headers out of this one.
+     */
+    template <typename V> const float *evaluate(V &v, int i)
+    {
+        if (!enabled)
+            return nullptr;
+
+        auto &z = *v.zone;
+        auto &idx = z.sharedLFOEntry[i];
+        if (idx < 0 || idx >= maxEntries || !(entries[idx].owner == z.id) ||
+            entries[idx].lfo != i || entries[idx].lastBlock < currentBlock - 1)
+        {
+            idx = claim();
+            if (idx < 0)
+                return nullptr;
+            entries[idx].owner = z.id;
+            entries[idx].lfo = i;
+        }
+
+        auto &e = entries[idx];
+        if (e.lastBlock == currentBlock)
+            return &e.value;
+
+        auto &ms = z.modulatorStorage[i];
+        const auto &lp = v.endpoints->lfo[i];
+        auto &transport = v.engine->transport;
+        e.rate = *lp.rateP;
+
+        if (e.lastBlock != currentBlock - 1 || e.isStep != ms.isStep())
+        {
+            e.isStep = ms.isStep();
+            if (e.isStep)
+            {
+                e.step.setSampleRate(v.sampleRate, v.sampleRateInv);
+                e.step.assign(&ms, &e.rate, &transport, v.engine->rng);
+                e.step.setStartPosition(ms.start_phase, transport.timeInSeconds);
+            }
+            else
+            {
+                e.curve.setSampleRate(v.sampleRate, v.sampleRateInv);
+                e.curve.assign(&ms, &transport);
+                e.curve.attack(V::initialLFOPhase(ms, transport, e.rate, v.engine->rng),
+                               *lp.curve.delayP, ms.modulatorShape);
+            }
+        }
+
+        if (e.isStep)
+        {
+            e.step.process(blockSize);
+            e.value = e.step.output * *lp.amplitudeP;
+        }
+        else
+        {
+            e.curve.process(e.rate, *lp.curve.deformP, *lp.curve.angleP, *lp.curve.delayP,
+                            *lp.curve.attackP, *lp.curve.releaseP, false,
+                            ms.curveLfoStorage.unipolar, true);
+            e.value = e.curve.output * *lp.amplitudeP;
+        }
+        e.lastBlock = currentBlock;
+        return &e.value;
+    }
+
+  private:
+    struct Entry
+    {
+        explicit Entry(sst::basic_blocks::dsp::RNG &rng) : curve(rng) {}
+
+        ZoneID owner{};
+        int lfo{-1};
+        int64_t lastBlock{-2};
+        bool isStep{false};
+        float rate{0.f}, value{0.f};
+
+        StepLFO step;
+        CurveLFO curve;
+    };
+
+    int16_t claim() const
+    {
+        for (int16_t i = 0; i < maxEntries; ++i)
+        {
+            if (entries[i].lastBlock < currentBlock - 1)
+                return i;
+        }
+        return -1;
+    }
+
+    int64_t currentBlock{0};
+    std::array<Entry, maxEntries> entries;
+};
+} // namespace scxt::modulation::modulators
+
+#endif // SCXT_SRC_SCXT_CORE_MODULATION_MODULATORS_SHARED_LFO_POOL_H
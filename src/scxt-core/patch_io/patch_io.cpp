@@ -49,6 +49,7 @@
 #include "messaging/messaging.h"
 
 #include "json/engine_traits.h"
+#include "infrastructure/load_timing.h"
 
 #include "cmrc/cmrc.hpp"
 #include "browser/browser.h"
@@ -128,8 +129,22 @@ std::string readSCDataChunk(const std::unique_ptr<RIFF::File> &f)
     return res;
 }
 
+/*
+ * Monolith sample bodies are never held in memory. addMonolithBinaries lays out the
+ * chunks at their final sizes, the RIFF::File::Save then reserves that space on disk,
+ * and streamMonolithBinaries copies each file into its chunk a block at a time.
+ */
+struct PendingMonolithBinary
+{
+    RIFF::Chunk *chunk{nullptr};
+    fs::path path;
+    uint64_t size{0};
+};
+using pendingMonolithBinaries_t = std::vector<PendingMonolithBinary>;
+
 bool addMonolithBinaries(const std::unique_ptr<RIFF::File> &f, const engine::Engine &e,
-                         const sample::SampleManager::sampleMap_t &addThese)
+                         const sample::SampleManager::sampleMap_t &addThese,
+                         pendingMonolithBinaries_t &pending)
 {
     SCLOG_IF(patchIO, "Adding " << addThese.size() << " samples to monolith");
     auto lst = f->AddSubList(sampleChunk);
@@ -171,42 +186,79 @@ bool addMonolithBinaries(const std::unique_ptr<RIFF::File> &f, const engine::Eng
             strncpy((char *)dex, fn.c_str(), fn.size());
             dex[fn.size()] = 0;
 
+            // No LoadChunkData here; Save reserves the space and we stream into it after
             auto c = smplst->AddSubChunk(sampleDatChunk, fsz);
-            auto d = (uint8_t *)c->LoadChunkData();
+            pending.push_back({c, path, fsz});
 
-            std::ifstream file(path, std::ios::binary);
-            if (!file)
-            {
-                return false;
-            }
+            SCLOG_IF(patchIO, "   - " << path.u8string() << " bytes=" << fsz);
+        }
+        catch (const fs::filesystem_error &fse)
+        {
+            return false;
+        }
+    }
 
-            // Check the file size
-            file.seekg(0, std::ios::end);
-            std::size_t fstreamSz = file.tellg();
-            file.seekg(0, std::ios::beg);
+    return true;
+}
 
-            if (fstreamSz != fsz)
-            {
-                SCLOG_IF(patchIO, "Mismatched sizes " << fsz << " " << fstreamSz);
-                return false;
-            };
+bool streamMonolithBinaries(const pendingMonolithBinaries_t &pending)
+{
+    static constexpr size_t copyBlockSize{1 << 20};
+    std::vector<char> buffer(copyBlockSize);
+
+    for (const auto &pb : pending)
+    {
+        std::ifstream file(pb.path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        // Check the file size didn't move under us between layout and copy
+        file.seekg(0, std::ios::end);
+        std::size_t fstreamSz = file.tellg();
+        file.seekg(0, std::ios::beg);
+
+        if (fstreamSz != pb.size)
+        {
+            SCLOG_IF(patchIO, "Mismatched sizes " << pb.size << " " << fstreamSz);
+            return false;
+        };
 
-            file.read((char *)d, fsz);
+        pb.chunk->SetPos(0);
+        uint64_t remaining = pb.size;
+        while (remaining > 0)
+        {
+            auto blk = (size_t)std::min<uint64_t>(remaining, copyBlockSize);
+            file.read(buffer.data(), blk);
             if (!file)
             {
                 return false;
             }
+            if (pb.chunk->Write(buffer.data(), blk, 1) != blk)
+            {
+                SCLOG_IF(patchIO, "Short write streaming " << pb.path.u8string());
+                return false;
+            }
+            remaining -= blk;
+        }
+    }
+    return true;
+}
 
-            SCLOG_IF(patchIO, "   - " << path.u8string() << " bytes=" << fsz);
-            file.close();
+void removeTemporaryFiles(const std::vector<fs::path> &tmpf)
+{
+    for (auto &f : tmpf)
+    {
+        try
+        {
+            fs::remove(f);
         }
-        catch (const fs::filesystem_error &fse)
+        catch (fs::filesystem_error &fse)
         {
-            return false;
+            SCLOG_IF(patchIO, "Unable to remove " << f.u8string() << " " << fse.what());
         }
     }
-
-    return true;
 }
 
 bool hasMonolithBinaries(const std::unique_ptr<RIFF::File> &f)
@@ -559,6 +611,8 @@ bool saveMulti(const fs::path &p, scxt::engine::Engine &e, SaveStyles style)
         }
     }
 
+    std::vector<fs::path> tmpf;
+    pendingMonolithBinaries_t pendingBinaries;
     try
     {
         if (style == SaveStyles::WITH_COLLECTED_SAMPLES)
@@ -573,22 +627,11 @@ bool saveMulti(const fs::path &p, scxt::engine::Engine &e, SaveStyles style)
 
         if (style == SaveStyles::AS_MONOLITH)
         {
-            std::vector<fs::path> tmpf;
             auto smp = getSamplePathsFor(e, -1, tmpf);
-            auto res = addMonolithBinaries(f, e, smp);
-            for (auto &f : tmpf)
-            {
-                try
-                {
-                    fs::remove(f);
-                }
-                catch (fs::filesystem_error &fse)
-                {
-                    SCLOG_IF(patchIO, "Unable to remove " << f.u8string() << " " << fse.what());
-                }
-            }
+            auto res = addMonolithBinaries(f, e, smp, pendingBinaries);
             if (!res)
             {
+                removeTemporaryFiles(tmpf);
                 return false;
             }
         }
@@ -600,15 +643,26 @@ bool saveMulti(const fs::path &p, scxt::engine::Engine &e, SaveStyles style)
 
         f->Save(riffPath.u8string());
 
+        auto streamed = streamMonolithBinaries(pendingBinaries);
+        removeTemporaryFiles(tmpf);
+
         if (style == SaveStyles::WITH_COLLECTED_SAMPLES)
         {
             e.getSampleManager()->clearReparenting();
         }
         e.getSampleManager()->remapIds.clear();
+
+        if (!streamed)
+        {
+            RAISE_ERROR_ENGINE(e, "Unable to write monolith samples",
+                               "Copying samples into " + riffPath.u8string() + " failed");
+            return false;
+        }
     }
     catch (const RIFF::Exception &exc)
     {
         SCLOG_IF(patchIO, exc.Message);
+        removeTemporaryFiles(tmpf);
         RAISE_ERROR_ENGINE(e, "Exception saving Multi",
                            riffPath.u8string() + " threw " + exc.Message);
         // A failed save must report failure and leave the SampleManager out of
@@ -653,6 +707,8 @@ bool savePart(const fs::path &p, scxt::engine::Engine &e, int part, patch_io::Sa
         }
     }
 
+    std::vector<fs::path> tmpf;
+    pendingMonolithBinaries_t pendingBinaries;
     try
     {
         if (style == SaveStyles::WITH_COLLECTED_SAMPLES)
@@ -667,22 +723,11 @@ bool savePart(const fs::path &p, scxt::engine::Engine &e, int part, patch_io::Sa
 
         if (style == SaveStyles::AS_MONOLITH)
         {
-            std::vector<fs::path> tmpf;
             auto smp = getSamplePathsFor(e, part, tmpf);
-            auto res = addMonolithBinaries(f, e, smp);
-            for (auto &f : tmpf)
-            {
-                try
-                {
-                    fs::remove(f);
-                }
-                catch (fs::filesystem_error &fse)
-                {
-                    SCLOG_IF(patchIO, "Unable to remove " << f.u8string() << " " << fse.what());
-                }
-            }
+            auto res = addMonolithBinaries(f, e, smp, pendingBinaries);
             if (!res)
             {
+                removeTemporaryFiles(tmpf);
                 return false;
             }
         }
@@ -732,15 +777,26 @@ bool savePart(const fs::path &p, scxt::engine::Engine &e, int part, patch_io::Sa
 
         f->Save(riffPath.u8string());
 
+        auto streamed = streamMonolithBinaries(pendingBinaries);
+        removeTemporaryFiles(tmpf);
+
         if (style == SaveStyles::WITH_COLLECTED_SAMPLES)
         {
             e.getSampleManager()->clearReparenting();
         }
         e.getSampleManager()->remapIds.clear();
+
+        if (!streamed)
+        {
+            RAISE_ERROR_ENGINE(e, "Unable to write monolith samples",
+                               "Copying samples into " + riffPath.u8string() + " failed");
+            return false;
+        }
     }
     catch (const RIFF::Exception &exc)
     {
         SCLOG_IF(patchIO, exc.Message);
+        removeTemporaryFiles(tmpf);
         RAISE_ERROR_ENGINE(e, "Exception saving Part",
                            riffPath.u8string() + " threw " + exc.Message);
         // A failed save must report failure and leave the SampleManager out of
@@ -825,6 +881,7 @@ bool loadMulti(const fs::path &p, scxt::engine::Engine &engine)
     std::vector<fs::path> monolithBinaryIndex;
     try
     {
+        auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
         auto f = std::make_unique<RIFF::File>(p.u8string());
         auto manifest = readSCManifest(f);
         payload = readSCDataChunk(f);
@@ -894,6 +951,7 @@ bool loadPartInto(const fs::path &p, scxt::engine::Engine &engine, int part)
 
     try
     {
+        auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
         auto f = std::make_unique<RIFF::File>(p.u8string());
         auto manifest = readSCManifest(f);
         payload = readSCDataChunk(f);
@@ -1007,47 +1065,56 @@ size_t SCMonolithSampleReader::getSampleCount()
     return cacheSampleCount;
 }
 
-bool SCMonolithSampleReader::getSampleData(size_t index, SampleData &data)
+RIFF::Chunk *SCMonolithSampleReader::findSampleDataChunk(size_t index, std::string &filename)
 {
     auto lst = file->GetSubList(sampleChunk);
     if (!lst)
     {
-        return false;
+        return nullptr;
     }
     auto slst = lst->GetSubList(sampleListChunk);
     if (!slst)
     {
-        return false;
+        return nullptr;
     }
 
     auto ck = slst->GetFirstSubChunk();
     if (!ck)
-        return false;
+        return nullptr;
     for (int i = 0; i < index * 2; i++)
     {
         if (ck)
             ck = slst->GetNextSubChunk();
         if (!ck)
-            return false;
+            return nullptr;
     }
 
     if (ck->GetChunkID() != sampleFilenameChunk)
     {
         addError("didn't count forward to filename chunk");
-        return false;
+        return nullptr;
     }
 
-    data.filename = std::string((char *)ck->LoadChunkData());
+    filename = std::string((char *)ck->LoadChunkData());
     ck->ReleaseChunkData();
 
     ck = slst->GetNextSubChunk();
     if (!ck)
-        return false;
+        return nullptr;
     if (ck->GetChunkID() != sampleDatChunk)
     {
         addError("didn't get data chunk id");
-        return false;
+        return nullptr;
     }
+    return ck;
+}
+
+bool SCMonolithSampleReader::getSampleData(size_t index, SampleData &data)
+{
+    auto ck = findSampleDataChunk(index, data.filename);
+    if (!ck)
+        return false;
+
     auto sd = ck->LoadChunkData();
     data.data.assign((uint8_t *)sd, (uint8_t *)sd + ck->GetSize());
     ck->ReleaseChunkData();
@@ -1055,4 +1122,15 @@ bool SCMonolithSampleReader::getSampleData(size_t index, SampleData &data)
     return true;
 }
 
+bool SCMonolithSampleReader::getSampleRange(size_t index, SampleRange &range)
+{
+    auto ck = findSampleDataChunk(index, range.filename);
+    if (!ck)
+        return false;
+
+    range.fileOffset = ck->GetFilePos();
+    range.size = ck->GetSize();
+    return true;
+}
+
 } // namespace scxt::patch_io
\ No newline at end of file
@@ -71,11 +71,25 @@ struct SCMonolithSampleReader
     // Lets avoid copying around that data vector; return bool and populate the ref
     bool getSampleData(size_t index, SampleData &data);
 
+    /*
+     * Where a sample's bytes sit in the monolith file, without loading them. Pair
+     * with a FileMapView of the same file to decode straight from the mapping.
+     */
+    struct SampleRange
+    {
+        std::string filename;
+        uint64_t fileOffset{0};
+        size_t size{0};
+    };
+    bool getSampleRange(size_t index, SampleRange &range);
+
     void resetErrorString() { errStack.clear(); }
     void addError(const std::string &msg) { errStack += msg + "\n"; }
     [[nodiscard]] std::string getErrorString() const { return errStack; }
 
   private:
+    RIFF::Chunk *findSampleDataChunk(size_t index, std::string &filename);
+
     RIFF::File *file;
     int version;
     size_t cacheSampleCount{0};
@@ -32,8 +32,8 @@
 #include "sample/import_support/import_filter.h"
 #include "sample/import_support/import_modulation.h"
 #include "sample/import_support/import_numeric.h"
+#include "infrastructure/file_map_view.h"
 #include <cmath>
-#include <fstream>
 #include <map>
 #include <set>
 #include <algorithm>
@@ -531,21 +531,38 @@ bool importAKP(const fs::path &path, engine::Engine &e)
 {
     import_support::ImporterContext ctx(e, "Loading AKP '" + path.filename().u8string() + "'");
 
-    auto f = std::ifstream(path, std::ios::binary);
-    if (!f.is_open())
-        return ctx.fail("AKP Load Error", "Cannot open file");
-
-    f.seekg(0, std::ios::end);
-    auto size = f.tellg();
-    f.seekg(0, std::ios::beg);
-    std::vector<char> buffer(size);
-    f.read(buffer.data(), size);
-
+    // The chunk parsers copy out everything they keep, so they can read straight
+    // from the mapping and it can go once the file is parsed
     AKPFile akp;
-    if (!akp.load(buffer.data(), size))
-        return ctx.fail("AKP Load Error", "Failed to parse AKP file");
+    {
+        auto mapped = infrastructure::FileMapView(path);
+        if (!mapped.isMapped())
+            return ctx.fail("AKP Load Error", "Cannot open file");
+
+        if (!akp.load(static_cast<const char *>(mapped.data()), mapped.dataSize()))
+            return ctx.fail("AKP Load Error", "Failed to parse AKP file");
+    }
 
     auto rootDir = path.parent_path();
+
+    // Gather every mapped zone's sample first so the distinct files decode in
+    // parallel, rather than one at a time as the zones are built
+    std::vector<std::vector<fs::path>> sampleCandidates;
+    std::map<std::string, size_t> sampleSlot;
+    for (const auto &kg : akp.keygroups)
+    {
+        for (const auto &z : kg.zones)
+        {
+            if (!z.mapped || z.sample.empty())
+                continue;
+            if (sampleSlot.emplace(z.sample, sampleCandidates.size()).second)
+                sampleCandidates.push_back({rootDir / z.sample});
+        }
+    }
+    // AKP files reference samples by name without extension; the actual
+    // file on disk is .WAV or .AIF (and case may vary).
+    auto loadedSamples =
+        ctx.loadSamplesFromDisk(sampleCandidates, {".WAV", ".wav", ".AIF", ".aif"});
     std::map<uint16_t, int> akaiGroupToSCGroup;
     std::set<uint16_t> reportedFilterTypes; // dedupe filter-type warnings per import
     std::set<int> reportedAkpModSources;    // dedupe mod-source warnings per import
@@ -564,10 +581,7 @@ bool importAKP(const fs::path &path, engine::Engine &e)
             if (!z.mapped || z.sample.empty())
                 continue;
 
-            // AKP files reference samples by name without extension; the actual
-            // file on disk is .WAV or .AIF (and case may vary).
-            auto lsid =
-                ctx.loadSampleFromDisk({rootDir / z.sample}, {".WAV", ".wav", ".AIF", ".aif"});
+            auto lsid = loadedSamples[sampleSlot[z.sample]];
             if (!lsid)
                 continue;
 
@@ -754,21 +768,17 @@ bool importAKP(const fs::path &path, engine::Engine &e)
 void dumpAkaiToLog(const fs::path &path)
 {
     SCLOG_IF(cliTools, "Dumping " << path.u8string());
-    auto f = std::ifstream(path, std::ios::binary);
-    if (!f.is_open())
+    auto mapped = infrastructure::FileMapView(path);
+    if (!mapped.isMapped())
     {
         SCLOG_IF(cliTools, "Failed to open file");
         return;
     }
-    f.seekg(0, std::ios::end);
-    auto size = f.tellg();
-    f.seekg(0, std::ios::beg);
-    std::vector<char> buffer(size);
-    f.read(buffer.data(), size);
+    auto size = mapped.dataSize();
     SCLOG_IF(cliTools, "File size: " << size);
 
     AKPFile akp;
-    if (!akp.load(buffer.data(), size))
+    if (!akp.load(static_cast<const char *>(mapped.data()), size))
     {
         SCLOG_IF(cliTools, "Failed to load AKP file");
         return;
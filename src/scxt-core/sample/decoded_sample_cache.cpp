@@ -0,0 +1,428 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "decoded_sample_cache.h"
+#include "dsp/resampling.h"
+#include "infrastructure/file_map_view.h"
+
+namespace scxt::sample
+{
+namespace
+{
+constexpr char cacheMagic[4]{'S', 'C', 'X', 'D'};
+constexpr uint32_t cacheLayoutVersion{1};
+// the files never leave this machine, but a shared home directory can
+constexpr uint32_t cacheEndianMark{0x01020304};
+constexpr size_t cacheDataAlignment{64};
+const std::string cacheExtension{".scxd"};
+
+struct CacheFileHeader
+{
+    char magic[4];
+    uint32_t layout, decoder, endian;
+    uint32_t sourceType, channels, bitDepth, sampleRate, lengthPerChannel;
+    // the padding the channels were written with; a change to either is a miss
+    uint32_t firOffset, firIpolN;
+    int32_t instrument, region;
+
+    uint32_t loopStart, loopEnd;
+    float detune;
+    int8_t keyLow, keyHigh, keyRoot, velLow, velHigh;
+    uint8_t playmode, presentFlags, unused;
+
+    uint64_t channelOffset[2];
+    uint64_t channelBytes;
+};
+static_assert(std::is_trivially_copyable_v<CacheFileHeader>);
+
+enum PresentFlags : uint8_t
+{
+    ROOTKEY = 1 << 0,
+    KEY = 1 << 1,
+    VEL = 1 << 2,
+    LOOP = 1 << 3,
+    PLAYMODE = 1 << 4
+};
+
+uint64_t alignUp(uint64_t v) { return (v + cacheDataAlignment - 1) & ~(cacheDataAlignment - 1); }
+
+// what Sample::allocateI16/F32 hand out for one channel
+uint64_t paddedChannelBytes(const Sample &s)
+{
+    return (uint64_t)(s.sampleLengthPerChannel + dsp::FIRipol_N) *
+           Sample::bitDepthByteSize(s.bitDepth);
+}
+
+bool isValidHeader(const CacheFileHeader &h, Sample::SourceType st, size_t fileSize)
+{
+    if (memcmp(h.magic, cacheMagic, 4) != 0 || h.layout != cacheLayoutVersion ||
+        h.decoder != DecodedSampleCache::decoderVersion || h.endian != cacheEndianMark)
+        return false;
+    if (h.sourceType != (uint32_t)st || h.firOffset != dsp::FIRoffset ||
+        h.firIpolN != dsp::FIRipol_N)
+        return false;
+    if (h.channels < 1 || h.channels > 2 ||
+        (h.bitDepth != Sample::BD_I16 && h.bitDepth != Sample::BD_F32))
+        return false;
+
+    auto want = (uint64_t)(h.lengthPerChannel + dsp::FIRipol_N) *
+                Sample::bitDepthByteSize((Sample::BitDepth)h.bitDepth);
+    if (h.channelBytes != want)
+        return false;
+    for (int c = 0; c < h.channels; ++c)
+    {
+        if (h.channelOffset[c] % cacheDataAlignment != 0 ||
+            h.channelOffset[c] < sizeof(CacheFileHeader) ||
+            h.channelOffset[c] + h.channelBytes > fileSize)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+std::string DecodedSampleCache::keyFor(const std::string &md5, Sample::SourceType st)
+{
+    return md5 + "-" + std::to_string((int)st) + "-d" + std::to_string(decoderVersion);
+}
+
+fs::path DecodedSampleCache::pathFor(const std::string &key) const
+{
+    return directory / (key + cacheExtension);
+}
+
+void DecodedSampleCache::configure(const fs::path &dir, uint64_t budgetBytes)
+{
+    std::lock_guard<std::mutex> g(mutex);
+    directory = dir;
+    budget = budgetBytes;
+    lru.clear();
+    byKey.clear();
+    stats.bytesOnDisk = 0;
+    stats.files = 0;
+
+    if (!isEnabled())
+        return;
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec)
+    {
+        SCLOG_IF(warnings, "Unable to create decoded sample cache at '" << directory.u8string()
+                                                                        << "' : " << ec.message());
+        budget = 0;
+        return;
+    }
+    scanDirectory();
+    trim();
+}
+
+void DecodedSampleCache::scanDirectory()
+{
+    struct Found
+    {
+        fs::file_time_type when;
+        std::string key;
+        uint64_t bytes;
+    };
+    std::vector<Found> found;
+    auto current = "-d" + std::to_string(decoderVersion);
+
+    try
+    {
+        for (auto &de : fs::directory_iterator(directory))
+        {
+            const auto &p = de.path();
+            if (!de.is_regular_file() || p.extension().u8string() != cacheExtension)
+                continue;
+
+            auto key = p.stem().u8string();
+            std::error_code ec;
+            if (key.size() < current.size() ||
+                key.compare(key.size() - current.size(), current.size(), current) != 0)
+            {
+                // written by another decoder version, so it can never hit again
+                fs::remove(p, ec);
+                continue;
+            }
+            auto sz = de.file_size(ec);
+            auto t = de.last_write_time(ec);
+            if (!ec)
+                found.push_back({t, key, sz});
+        }
+    }
+    catch (const fs::filesystem_error &e)
+    {
+        SCLOG_IF(warnings, "Unable to scan decoded sample cache : " << e.what());
+    }
+
+    std::sort(found.begin(), found.end(),
+              [](const auto &a, const auto &b) { return a.when > b.when; });
+    for (auto &f : found)
+    {
+        lru.push_back({f.key, f.bytes});
+        byKey[f.key] = std::prev(lru.end());
+        stats.bytesOnDisk += f.bytes;
+        stats.files++;
+    }
+    SCLOG_IF(sampleLoadAndPurge, "Decoded sample cache holds " << stats.files << " files, "
+                                                               << stats.bytesOnDisk << " bytes");
+}
+
+bool DecodedSampleCache::fetch(const std::string &md5, Sample::SourceType st, Sample &s)
+{
+    if (!isEnabled() || md5.empty() || !isCacheableSourceType(st))
+        return false;
+
+    auto key = keyFor(md5, st);
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        auto it = byKey.find(key);
+        if (it == byKey.end())
+        {
+            stats.misses++;
+            return false;
+        }
+        lru.splice(lru.begin(), lru, it->second);
+    }
+
+    auto p = pathFor(key);
+    auto fmv = std::make_unique<infrastructure::FileMapView>(p);
+    CacheFileHeader h;
+    bool ok = fmv->isMapped() && fmv->dataSize() >= sizeof(CacheFileHeader);
+    if (ok)
+    {
+        memcpy(&h, fmv->data(), sizeof(CacheFileHeader));
+        ok = isValidHeader(h, st, fmv->dataSize());
+    }
+    if (!ok)
+    {
+        fmv.reset();
+        SCLOG_IF(sampleLoadAndPurge,
+                 "Dropping unusable decoded sample cache file " << p.u8string());
+        std::lock_guard<std::mutex> g(mutex);
+        forget(key);
+        std::error_code ec;
+        fs::remove(p, ec);
+        stats.misses++;
+        return false;
+    }
+
+    auto base = (uint8_t *)fmv->data();
+    s.channels = h.channels;
+    s.sample_rate = h.sampleRate;
+    s.sampleLengthPerChannel = h.lengthPerChannel;
+    s.instrument = h.instrument;
+    s.region = h.region;
+    s.adoptMappedSampleData(std::move(fmv), (Sample::BitDepth)h.bitDepth,
+                            base + h.channelOffset[0],
+                            h.channels == 2 ? base + h.channelOffset[1] : nullptr);
+
+    s.meta.loop_start = h.loopStart;
+    s.meta.loop_end = h.loopEnd;
+    s.meta.detune = h.detune;
+    s.meta.key_low = h.keyLow;
+    s.meta.key_high = h.keyHigh;
+    s.meta.key_root = h.keyRoot;
+    s.meta.vel_low = h.velLow;
+    s.meta.vel_high = h.velHigh;
+    s.meta.playmode = (Sample::PlayMode)h.playmode;
+    s.meta.rootkey_present = h.presentFlags & ROOTKEY;
+    s.meta.key_present = h.presentFlags & KEY;
+    s.meta.vel_present = h.presentFlags & VEL;
+    s.meta.loop_present = h.presentFlags & LOOP;
+    s.meta.playmode_present = h.presentFlags & PLAYMODE;
+
+    // so the eviction order survives a restart
+    std::error_code ec;
+    fs::last_write_time(p, fs::file_time_type::clock::now(), ec);
+
+    std::lock_guard<std::mutex> g(mutex);
+    stats.hits++;
+    return true;
+}
+
+void DecodedSampleCache::store(const std::string &md5, Sample::SourceType st, const Sample &s)
+{
+    if (!isEnabled() || md5.empty() || !isCacheableSourceType(st))
+        return;
+    if (s.channels < 1 || s.channels > 2 || s.sampleLengthPerChannel == 0)
+        return;
+    for (int c = 0; c < s.channels; ++c)
+        if (!s.sampleData[c])
+            return;
+
+    auto key = keyFor(md5, st);
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        if (byKey.find(key) != byKey.end())
+            return;
+    }
+
+    CacheFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, cacheMagic, 4);
+    h.layout = cacheLayoutVersion;
+    h.decoder = decoderVersion;
+    h.endian = cacheEndianMark;
+    h.sourceType = (uint32_t)st;
+    h.channels = s.channels;
+    h.bitDepth = (uint32_t)s.bitDepth;
+    h.sampleRate = s.sample_rate;
+    h.lengthPerChannel = s.sampleLengthPerChannel;
+    h.firOffset = dsp::FIRoffset;
+    h.firIpolN = dsp::FIRipol_N;
+    h.instrument = s.instrument;
+    h.region = s.region;
+
+    h.loopStart = s.meta.loop_start;
+    h.loopEnd = s.meta.loop_end;
+    h.detune = s.meta.detune;
+    h.keyLow = s.meta.key_low;
+    h.keyHigh = s.meta.key_high;
+    h.keyRoot = s.meta.key_root;
+    h.velLow = s.meta.vel_low;
+    h.velHigh = s.meta.vel_high;
+    h.playmode = (uint8_t)s.meta.playmode;
+    h.presentFlags = (s.meta.rootkey_present ? ROOTKEY : 0) | (s.meta.key_present ? KEY : 0) |
+                     (s.meta.vel_present ? VEL : 0) | (s.meta.loop_present ? LOOP : 0) |
+                     (s.meta.playmode_present ? PLAYMODE : 0);
+
+    h.channelBytes = paddedChannelBytes(s);
+    h.channelOffset[0] = alignUp(sizeof(CacheFileHeader));
+    h.channelOffset[1] = s.channels == 2 ? alignUp(h.channelOffset[0] + h.channelBytes) : 0;
+    uint64_t fileSize = h.channelOffset[s.channels - 1] + h.channelBytes;
+
+    // written aside and renamed in, so no reader - here or in another engine - sees it partial
+    auto tmp = directory /
+               (key + ".tmp" +
+                std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "-" +
+                std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::error_code ec;
+    try
+    {
+        {
+            std::ofstream o(tmp, std::ios::binary);
+            if (!o)
+                return;
+
+            std::vector<char> zeros(cacheDataAlignment, 0);
+            uint64_t at{0};
+            auto padTo = [&](uint64_t pos) {
+                while (at < pos)
+                {
+                    auto n = std::min<uint64_t>(pos - at, zeros.size());
+                    o.write(zeros.data(), n);
+                    at += n;
+                }
+            };
+            o.write((const char *)&h, sizeof(h));
+            at += sizeof(h);
+            for (int c = 0; c < s.channels; ++c)
+            {
+                padTo(h.channelOffset[c]);
+                o.write((const char *)s.sampleData[c], h.channelBytes);
+                at += h.channelBytes;
+            }
+            if (!o)
+            {
+                o.close();
+                fs::remove(tmp, ec);
+                return;
+            }
+        }
+        fs::rename(tmp, pathFor(key));
+    }
+    catch (const fs::filesystem_error &e)
+    {
+        // most likely another engine has the same file mapped on a platform which won't
+        // let it be replaced; theirs is as good as ours
+        SCLOG_IF(sampleLoadAndPurge, "Unable to store decoded sample cache file : " << e.what());
+        fs::remove(tmp, ec);
+        return;
+    }
+
+    std::lock_guard<std::mutex> g(mutex);
+    if (byKey.find(key) != byKey.end())
+        return;
+    lru.push_front({key, fileSize});
+    byKey[key] = lru.begin();
+    stats.bytesOnDisk += fileSize;
+    stats.files++;
+    stats.stores++;
+    trim();
+}
+
+void DecodedSampleCache::forget(const std::string &key)
+{
+    auto it = byKey.find(key);
+    if (it == byKey.end())
+        return;
+    stats.bytesOnDisk -= it->second->bytes;
+    stats.files--;
+    lru.erase(it->second);
+    byKey.erase(it);
+}
+
+void DecodedSampleCache::trim()
+{
+    while (stats.bytesOnDisk > budget && !lru.empty())
+    {
+        auto key = lru.back().key;
+        // a file still mapped can't be removed on windows; it goes at the next scan instead
+        std::error_code ec;
+        fs::remove(pathFor(key), ec);
+        forget(key);
+        stats.evictions++;
+    }
+}
+
+DecodedSampleCache::Stats DecodedSampleCache::getStats() const
+{
+    std::lock_guard<std::mutex> g(mutex);
+    return stats;
+}
+
+void DecodedSampleCache::clear()
+{
+    std::lock_guard<std::mutex> g(mutex);
+    while (!lru.empty())
+    {
+        auto key = lru.back().key;
+        std::error_code ec;
+        fs::remove(pathFor(key), ec);
+        forget(key);
+    }
+}
+} // namespace scxt::sample
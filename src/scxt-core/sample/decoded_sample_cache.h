@@ -0,0 +1,107 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_SAMPLE_DECODED_SAMPLE_CACHE_H
+#define SCXT_SRC_SCXT_CORE_SAMPLE_DECODED_SAMPLE_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "utils.h"
+#include "sample.h"
+#include "infrastructure/filesystem_import.h"
+
+namespace scxt::sample
+{
+/*
+ * An on-disk cache of decoded PCM for the compressed formats (flac, mp3, opus), which
+ * otherwise decode in full on every load. Files are keyed by the source's md5 and the
+ * decoder version, and hold each channel exactly as Sample::allocateI16/F32 lays it out,
+ * FIRoffset padding and all, so a hit maps the file and points sampleData straight at it.
+ *
+ * Off until configured with a non-zero byte budget. Past the budget the least recently
+ * used files are removed; use is recorded in the file time so the order survives a
+ * restart. Several engines may share a directory: files land by rename so a reader never
+ * sees half of one, and a file which vanishes under us is just a miss.
+ *
+ * fetch and store are safe to call from the parallel decode threads.
+ */
+struct DecodedSampleCache : MoveableOnly<DecodedSampleCache>
+{
+    // Bump when anything in the loaders changes what they decode to; old files then miss
+    // and age out.
+    static constexpr uint32_t decoderVersion{1};
+
+    static bool isCacheableSourceType(Sample::SourceType st)
+    {
+        return st == Sample::FLAC_FILE || st == Sample::MP3_FILE || st == Sample::OPUS_FILE;
+    }
+
+    static constexpr uint64_t defaultBudgetMB{0};
+    void configure(const fs::path &directory, uint64_t budgetBytes);
+    bool isEnabled() const { return budget > 0 && !directory.empty(); }
+
+    // On a hit s holds the decoded sample and its metadata; on a miss s is untouched
+    bool fetch(const std::string &md5, Sample::SourceType, Sample &s);
+    void store(const std::string &md5, Sample::SourceType, const Sample &s);
+
+    struct Stats
+    {
+        uint64_t hits{0}, misses{0}, stores{0}, evictions{0};
+        uint64_t bytesOnDisk{0};
+        size_t files{0};
+    };
+    Stats getStats() const;
+    void clear();
+
+  private:
+    fs::path directory{};
+    uint64_t budget{0};
+
+    struct Entry
+    {
+        std::string key;
+        uint64_t bytes{0};
+    };
+    using lru_t = std::list<Entry>;
+    lru_t lru; // most recently used at the front
+    std::unordered_map<std::string, lru_t::iterator> byKey;
+    Stats stats;
+    mutable std::mutex mutex;
+
+    static std::string keyFor(const std::string &md5, Sample::SourceType);
+    fs::path pathFor(const std::string &key) const;
+    void scanDirectory();
+    void forget(const std::string &key); // call with the lock held
+    void trim();                         // call with the lock held
+};
+} // namespace scxt::sample
+
+#endif
@@ -25,13 +25,15 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
-#include <fstream>
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include "utils.h"
 #include "exs_import.h"
 #include "exs_parameters.h"
+#include "infrastructure/file_map_view.h"
 #include "sample/import_support/import_harness.h"
 #include "sample/import_support/import_mapping.h"
 #include "sample/import_support/import_loop.h"
@@ -69,17 +71,40 @@ inline float exsEnvByteToSeconds(int v)
     return frac * frac * frac * frac * 10.f;
 }
 
-uint32_t readU32(std::ifstream &f, bool bigE)
+// A read cursor over the mapped .exs. Reads that would run off the end fail
+// (and leave the cursor at the end) so a truncated file stops the block walk.
+struct EXSMappedReader
 {
-    char c4[4];
-    f.read(c4, 4);
-    uint32_t res{0};
+    const uint8_t *data{nullptr};
+    size_t size{0};
+    size_t position{0};
+
+    bool read(void *into, size_t n)
+    {
+        if (position + n > size)
+        {
+            position = size;
+            return false;
+        }
+        memcpy(into, data + position, n);
+        position += n;
+        return true;
+    }
+    size_t remaining() const { return size - position; }
+};
+
+bool readU32(EXSMappedReader &f, bool bigE, uint32_t &res)
+{
+    uint8_t c4[4];
+    if (!f.read(c4, 4))
+        return false;
+    res = 0;
     if (bigE)
     {
         for (int i = 0; i < 4; ++i)
         {
             res = res << 8;
-            res += (uint8_t)c4[i];
+            res += c4[i];
         }
     }
     else
@@ -87,10 +112,10 @@ uint32_t readU32(std::ifstream &f, bool bigE)
         for (int i = 3; i >= 0; --i)
         {
             res = res << 8;
-            res += (uint8_t)c4[i];
+            res += c4[i];
         }
     }
-    return res;
+    return true;
 }
 
 struct EXSBlock
@@ -116,22 +141,21 @@ struct EXSBlock
     std::string name;
     byteData_t content;
 
-    bool read(std::ifstream &f)
+    bool read(EXSMappedReader &f)
     {
 #define CHECK(...)                                                                                 \
-    __VA_ARGS__;                                                                                   \
-    if (f.eof())                                                                                   \
+    if (!(__VA_ARGS__))                                                                            \
         return false;
 
         uint8_t c;
-        CHECK(f.read((char *)&c, 1));
+        CHECK(f.read(&c, 1));
 
         isBigEndian = (c == 0);
 
         uint8_t v1, v2, tp;
-        CHECK(f.read((char *)&v1, 1));
-        CHECK(f.read((char *)&v2, 1));
-        CHECK(f.read((char *)&tp, 1));
+        CHECK(f.read(&v1, 1));
+        CHECK(f.read(&v2, 1));
+        CHECK(f.read(&tp, 1));
 
         type = tp & 0x0F;
 
@@ -142,20 +166,23 @@ struct EXSBlock
             return false;
         }
 
-        CHECK(size = readU32(f, isBigEndian));
-        CHECK(index = readU32(f, isBigEndian));
-        CHECK(flags = readU32(f, isBigEndian));
+        CHECK(readU32(f, isBigEndian, size));
+        CHECK(readU32(f, isBigEndian, index));
+        CHECK(readU32(f, isBigEndian, flags));
 
         char magic[4];
         CHECK(f.read(magic, 4));
         // TODO: Check
 
-        char namec[64];
+        char namec[65]{};
         CHECK(f.read(namec, 64));
-        name = std::string(namec); // assume null termination
+        name = std::string(namec);
 
-        content.resize(size);
-        f.read((char *)(content.data()), size);
+        // A block claiming more than the file holds keeps what is there; the objects'
+        // own bounds checks then drop it rather than act on the missing tail
+        auto available = std::min<size_t>(size, f.remaining());
+        content.assign(f.data + f.position, f.data + f.position + available);
+        f.position += available;
 #undef CHECK
         return true;
     }
@@ -688,7 +715,14 @@ struct EXSInfo
 EXSInfo parseEXS(const fs::path &p)
 {
     SCLOG_IF(sampleCompoundParsers, "Importing EXS from " << p.u8string());
-    std::ifstream inputFile(p, std::ios_base::binary);
+    auto mapped = infrastructure::FileMapView(p);
+    if (!mapped.isMapped())
+    {
+        SCLOG_IF(sampleCompoundParsers, "Unable to map EXS file " << p.u8string());
+        return {};
+    }
+    auto inputFile = EXSMappedReader{static_cast<const uint8_t *>(mapped.data()),
+                                     mapped.dataSize()};
 
     auto block = EXSBlock();
     std::vector<EXSZone> zones;
@@ -1023,11 +1057,20 @@ bool importEXS(const fs::path &p, engine::Engine &e)
     // Push a SampleID for every EXS sample so downstream zone lookups by
     // index stay in range. Failed loads become an invalid SampleID (and a
     // raised error); zones that reference them will skip with a clear error.
+    // The whole list goes to the sample manager at once so it can decode in
+    // parallel before any zone is built.
+    std::vector<std::vector<fs::path>> candidates;
+    candidates.reserve(info.samples.size());
     for (auto &s : info.samples)
+        candidates.push_back({fs::path{s.filePath} / s.fileName, exsDir / s.fileName});
+    auto loaded = ctx.loadSamplesFromDisk(candidates);
+
+    for (size_t si = 0; si < info.samples.size(); ++si)
     {
-        auto absolutePath = fs::path{s.filePath} / s.fileName;
-        auto siblingPath = exsDir / s.fileName;
-        if (auto lsid = ctx.loadSampleFromDisk({absolutePath, siblingPath}))
+        const auto &s = info.samples[si];
+        const auto &absolutePath = candidates[si][0];
+        const auto &siblingPath = candidates[si][1];
+        if (auto lsid = loaded[si])
         {
             sampleIDByOrder.push_back(*lsid);
         }
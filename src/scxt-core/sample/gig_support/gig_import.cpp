@@ -147,16 +147,15 @@ VelRange computeVelRange(::gig::Region *region, int velDimIdx, int velBitPos, in
 
 void importDimensionRegion(::gig::Region *region, ::gig::DimensionRegion *dr,
                            const VelRange &velRange, int grNum, engine::Engine &e,
-                           const fs::path &p, const std::string &md5, ::gig::File *gig,
-                           const std::map<::gig::Sample *, int> &sampleToIndex,
+                           const std::string &md5,
+                           const std::map<::gig::Sample *, std::optional<SampleID>> &loaded,
                            import_support::ImporterContext &ctx)
 {
-    auto sit = sampleToIndex.find(dr->pSample);
-    if (sit == sampleToIndex.end())
+    auto sit = loaded.find(dr->pSample);
+    if (sit == loaded.end())
         return;
-    auto sidx = sit->second;
 
-    auto sid = e.getSampleManager()->loadSampleFromGIG(p, md5, gig, -1, -1, sidx);
+    auto sid = sit->second;
     if (!sid.has_value())
         return;
     e.getSampleManager()->getSample(*sid)->md5Sum = md5;
@@ -288,6 +287,66 @@ void importDimensionRegion(::gig::Region *region, ::gig::DimensionRegion *dr,
 }
 } // namespace
 
+/*
+ * Calls f(dr, velRange) for each dimension region of region which becomes a zone.
+ * Velocity and layer dimensions are walked; every other dimension collapses to its
+ * first zone, which is reported through ctx when one is given.
+ */
+template <typename F>
+void forEachImportedDimensionRegion(::gig::Region *region, import_support::ImporterContext *ctx,
+                                    F &&f)
+{
+    // Discover velocity and layer dims; their bit positions in the
+    // packed pDimensionRegions index. Warn on every other dim type
+    // so users know what we're collapsing to bit=0.
+    int velDimIdx = -1, layerDimIdx = -1;
+    int velBitPos = 0, layerBitPos = 0;
+    {
+        int bitpos = 0;
+        for (int d = 0; d < (int)region->Dimensions; ++d)
+        {
+            const auto &dd = region->pDimensionDefinitions[d];
+            if (dd.dimension == ::gig::dimension_velocity)
+            {
+                velDimIdx = d;
+                velBitPos = bitpos;
+            }
+            else if (dd.dimension == ::gig::dimension_layer)
+            {
+                layerDimIdx = d;
+                layerBitPos = bitpos;
+            }
+            else if (dd.dimension != ::gig::dimension_none && ctx)
+            {
+                ctx->unsupported("GIG dimension",
+                                 gigDimensionName(dd.dimension) +
+                                     " (collapsed to first zone) — see end-of-file plan");
+            }
+            bitpos += dd.bits;
+        }
+    }
+
+    int velZones = (velDimIdx >= 0) ? region->pDimensionDefinitions[velDimIdx].zones : 1;
+    int layerZones = (layerDimIdx >= 0) ? region->pDimensionDefinitions[layerDimIdx].zones : 1;
+
+    for (int velIdx = 0; velIdx < velZones; ++velIdx)
+    {
+        VelRange velRange{region->VelocityRange.low, region->VelocityRange.high};
+        if (velDimIdx >= 0)
+            velRange = computeVelRange(region, velDimIdx, velBitPos, velZones, velIdx);
+
+        for (int layerIdx = 0; layerIdx < layerZones; ++layerIdx)
+        {
+            int dimIdx = (velIdx << velBitPos) | (layerIdx << layerBitPos);
+            auto *dr = region->pDimensionRegions[dimIdx];
+            if (!dr || !dr->pSample)
+                continue;
+
+            f(dr, velRange);
+        }
+    }
+}
+
 bool importGIG(const fs::path &p, engine::Engine &e, int preset)
 {
     import_support::ImporterContext ctx(e, "Loading GIG '" + p.filename().u8string() + "'");
@@ -320,6 +379,35 @@ bool importGIG(const fs::path &p, engine::Engine &e, int preset)
             }
         }
 
+        // Walk the instruments once to find every sample the zones will use, and load
+        // that whole set (decoding in parallel) before the first zone is made
+        std::map<::gig::Sample *, std::optional<SampleID>> loaded;
+        {
+            std::vector<::gig::Sample *> used;
+            for (int pc = spc; pc < epc; ++pc)
+            {
+                auto *gigPreset = gig->GetInstrument(pc);
+                for (auto *region = gigPreset->GetFirstRegion(); region;
+                     region = gigPreset->GetNextRegion())
+                {
+                    forEachImportedDimensionRegion(
+                        region, nullptr, [&](::gig::DimensionRegion *dr, const VelRange &) {
+                            if (sampleToIndex.count(dr->pSample) &&
+                                loaded.emplace(dr->pSample, std::nullopt).second)
+                                used.push_back(dr->pSample);
+                        });
+                }
+            }
+
+            std::vector<int> regions;
+            regions.reserve(used.size());
+            for (auto *smp : used)
+                regions.push_back(sampleToIndex[smp]);
+            auto sids = e.getSampleManager()->loadSamplesFromGIG(p, md5, gig.get(), regions);
+            for (size_t k = 0; k < used.size(); ++k)
+                loaded[used[k]] = sids[k];
+        }
+
         for (int pc = spc; pc < epc; ++pc)
         {
             auto *gigPreset = gig->GetInstrument(pc);
@@ -335,60 +423,10 @@ bool importGIG(const fs::path &p, engine::Engine &e, int preset)
             auto *region = gigPreset->GetFirstRegion();
             while (region)
             {
-                // Discover velocity and layer dims; their bit positions in the
-                // packed pDimensionRegions index. Warn on every other dim type
-                // so users know what we're collapsing to bit=0.
-                int velDimIdx = -1, layerDimIdx = -1;
-                int velBitPos = 0, layerBitPos = 0;
-                {
-                    int bitpos = 0;
-                    for (int d = 0; d < (int)region->Dimensions; ++d)
-                    {
-                        const auto &dd = region->pDimensionDefinitions[d];
-                        if (dd.dimension == ::gig::dimension_velocity)
-                        {
-                            velDimIdx = d;
-                            velBitPos = bitpos;
-                        }
-                        else if (dd.dimension == ::gig::dimension_layer)
-                        {
-                            layerDimIdx = d;
-                            layerBitPos = bitpos;
-                        }
-                        else if (dd.dimension != ::gig::dimension_none)
-                        {
-                            ctx.unsupported(
-                                "GIG dimension",
-                                gigDimensionName(dd.dimension) +
-                                    " (collapsed to first zone) — see end-of-file plan");
-                        }
-                        bitpos += dd.bits;
-                    }
-                }
-
-                int velZones =
-                    (velDimIdx >= 0) ? region->pDimensionDefinitions[velDimIdx].zones : 1;
-                int layerZones =
-                    (layerDimIdx >= 0) ? region->pDimensionDefinitions[layerDimIdx].zones : 1;
-
-                for (int velIdx = 0; velIdx < velZones; ++velIdx)
-                {
-                    VelRange velRange{region->VelocityRange.low, region->VelocityRange.high};
-                    if (velDimIdx >= 0)
-                        velRange = computeVelRange(region, velDimIdx, velBitPos, velZones, velIdx);
-
-                    for (int layerIdx = 0; layerIdx < layerZones; ++layerIdx)
-                    {
-                        int dimIdx = (velIdx << velBitPos) | (layerIdx << layerBitPos);
-                        auto *dr = region->pDimensionRegions[dimIdx];
-                        if (!dr || !dr->pSample)
-                            continue;
-
-                        importDimensionRegion(region, dr, velRange, grNum, e, p, md5, gig.get(),
-                                              sampleToIndex, ctx);
-                    }
-                }
-
+                forEachImportedDimensionRegion(
+                    region, &ctx, [&](::gig::DimensionRegion *dr, const VelRange &velRange) {
+                        importDimensionRegion(region, dr, velRange, grNum, e, md5, loaded, ctx);
+                    });
                 region = gigPreset->GetNextRegion();
             }
         }
@@ -129,6 +129,66 @@ ImporterContext::loadSampleFromDisk(std::initializer_list<fs::path> candidates,
     return std::nullopt;
 }
 
+std::vector<std::optional<SampleID>>
+ImporterContext::loadSamplesFromDisk(const std::vector<std::vector<fs::path>> &candidateLists,
+                                     std::initializer_list<const char *> extensionFallbacks)
+{
+    // Every existing file per slot, in the order loadSampleFromDisk would try them
+    auto resolve = [&extensionFallbacks](const std::vector<fs::path> &candidates) {
+        std::vector<fs::path> res;
+        for (const auto &candidate : candidates)
+        {
+            if (fs::exists(candidate))
+                res.push_back(candidate);
+            for (auto ext : extensionFallbacks)
+            {
+                auto withExt = fs::path{candidate.u8string() + ext};
+                if (fs::exists(withExt))
+                    res.push_back(withExt);
+            }
+        }
+        return res;
+    };
+
+    std::vector<std::vector<fs::path>> existing;
+    existing.reserve(candidateLists.size());
+    for (const auto &cl : candidateLists)
+        existing.push_back(resolve(cl));
+
+    /*
+     * Load each slot's first existing file as one batch. A slot whose file fails to load
+     * (a corrupt absolutePath with a good siblingPath, say) moves on to its next file in
+     * another batch, until every slot has loaded or run out.
+     */
+    std::vector<std::optional<SampleID>> res(candidateLists.size());
+    std::vector<size_t> next(candidateLists.size(), 0);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < candidateLists.size(); ++i)
+        if (!existing[i].empty())
+            pending.push_back(i);
+
+    while (!pending.empty())
+    {
+        std::vector<fs::path> toLoad;
+        toLoad.reserve(pending.size());
+        for (auto i : pending)
+            toLoad.push_back(existing[i][next[i]++]);
+
+        auto loaded = engineRef.getSampleManager()->loadSamplesByPath(toLoad);
+        std::vector<size_t> retry;
+        for (size_t k = 0; k < pending.size(); ++k)
+        {
+            auto i = pending[k];
+            if (k < loaded.size() && loaded[k].has_value())
+                res[i] = loaded[k];
+            else if (next[i] < existing[i].size())
+                retry.push_back(i);
+        }
+        pending = std::move(retry);
+    }
+    return res;
+}
+
 bool ImporterContext::finish()
 {
     if (!unsupportedItems.empty())
@@ -100,6 +100,15 @@ class ImporterContext
     loadSampleFromDisk(std::initializer_list<fs::path> candidates,
                        std::initializer_list<const char *> extensionFallbacks = {});
 
+    // Batch form of loadSampleFromDisk for importers which gather their whole sample
+    // list first. Each candidate list's first existing file decodes in parallel via
+    // SampleManager::loadSamplesByPath; a list whose file fails to load falls back to its
+    // next existing one, as loadSampleFromDisk does. Results line up with candidateLists;
+    // an entry with nothing loadable is nullopt.
+    std::vector<std::optional<SampleID>>
+    loadSamplesFromDisk(const std::vector<std::vector<fs::path>> &candidateLists,
+                        std::initializer_list<const char *> extensionFallbacks = {});
+
     // Finalize: emits the unsupported-features summary, pushes a selection
     // action for everything added, and returns true iff ≥1 zone was added.
     // If nothing was added, raises a user-visible error and returns false.
@@ -187,45 +187,28 @@ bool Sample::parse_aiff(void *data, size_t filesize)
         return false;
     }
 
-    if (bitdepth == 32)
+    loadData_t loadData{nullptr};
+    switch (bitdepth)
     {
-        if (channels == 2)
-        {
-            load_data_i32BE(0, loaddata, nsamples, 8);
-            load_data_i32BE(1, loaddata + 4, nsamples, 8);
-        }
-        else
-            load_data_i32BE(0, loaddata, nsamples, 4);
-    }
-    else if (bitdepth == 24)
-    {
-        if (channels == 2)
-        {
-            load_data_i24BE(0, loaddata, nsamples, 6);
-            load_data_i24BE(1, loaddata + 3, nsamples, 6);
-        }
-        else
-            load_data_i24BE(0, loaddata, nsamples, 3);
+    case 32:
+        loadData = &Sample::load_data_i32BE;
+        break;
+    case 24:
+        loadData = &Sample::load_data_i24BE;
+        break;
+    case 16:
+        loadData = &Sample::load_data_i16BE;
+        break;
+    case 8:
+        loadData = &Sample::load_data_i8;
+        break;
     }
-    else if (bitdepth == 16)
-    {
-        if (channels == 2)
-        {
-            load_data_i16BE(0, loaddata, nsamples, 4);
-            load_data_i16BE(1, loaddata + 2, nsamples, 4);
-        }
-        else
-            load_data_i16BE(0, loaddata, nsamples, 2);
-    }
-    else if (bitdepth == 8)
+
+    if (loadData && !loadInterleavedInSlices(loadData, loaddata, nsamples, bitdepth / 8))
     {
-        if (channels == 2)
-        {
-            load_data_i8(0, loaddata, nsamples, 2);
-            load_data_i8(1, loaddata + 1, nsamples, 2);
-        }
-        else
-            load_data_i8(0, loaddata, nsamples, 1);
+        addError("AIFF load cancelled");
+        clear_data();
+        return false;
     }
 
     this->sample_loaded = (sampleData[0] != 0);
@@ -62,6 +62,9 @@ template <class T> class SampleFLACDecoderBase : public T
     virtual ::FLAC__StreamDecoderWriteStatus write_callback(const ::FLAC__Frame *frame,
                                                             const FLAC__int32 *const buffer[])
     {
+        if (sample->isDecodeCancelled())
+            return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+
         if (collectSizeOnly)
         {
             collectedSize += frame->header.blocksize;
@@ -86,6 +89,7 @@ template <class T> class SampleFLACDecoderBase : public T
                 }
             }
             streamPos += n;
+            sample->publishDecodedFrames(streamPos);
             return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
         }
         else if (bitDepth == 24 && sample->bitDepth == Sample::BD_F32)
@@ -99,6 +103,7 @@ template <class T> class SampleFLACDecoderBase : public T
                 }
             }
             streamPos += n;
+            sample->publishDecodedFrames(streamPos);
 
             return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
         }
@@ -113,6 +118,7 @@ template <class T> class SampleFLACDecoderBase : public T
                 }
             }
             streamPos += n;
+            sample->publishDecodedFrames(streamPos);
 
             return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
         }
@@ -78,6 +78,13 @@ bool decodeOpus(Sample *sample, OggOpusFile *of)
     int64_t pos{0};
     while (true)
     {
+        if (sample->isDecodeCancelled())
+        {
+            sample->addError("Opus decode cancelled");
+            op_free(of);
+            return false;
+        }
+
         int li{0};
         auto got = op_read_float(of, buffer.data(), (int)buffer.size(), &li);
         if (got == OP_HOLE)
@@ -106,6 +113,7 @@ bool decodeOpus(Sample *sample, OggOpusFile *of)
             }
         }
         pos += got;
+        sample->publishDecodedFrames(std::min(pos, total));
         if (pos >= total)
             break;
     }
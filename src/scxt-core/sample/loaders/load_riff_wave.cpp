@@ -27,6 +27,7 @@
 
 // #include "resampling.h"
 #include "sample/sample.h"
+#include "dsp/resampling.h"
 // #include <windows.h>
 // #include <mmreg.h>
 #include "riff_memfile.h"
@@ -47,7 +48,19 @@
 namespace scxt::sample
 {
 // TODO [prior] parse INAM etc etc metadata
-bool Sample::parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk)
+namespace
+{
+bool hostIsLittleEndian()
+{
+    uint16_t one{1};
+    uint8_t first;
+    memcpy(&first, &one, 1);
+    return first == 1;
+}
+} // namespace
+
+bool Sample::parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk,
+                             std::unique_ptr<infrastructure::FileMapView> *mapping)
 {
     size_t datasize;
     scxt::sample::loaders::RIFFMemFile mf(data, filesize);
@@ -127,97 +140,99 @@ bool Sample::parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk)
         return false;
     }
 
-    if (wh.wFormatTag == WAVE_FORMAT_PCM ||
-        (wh.wFormatTag == WAVE_FORMAT_EXTENSIBLE && SubFormat == KSDATAFORMAT_SUBTYPE_PCM))
+    auto isPCM = wh.wFormatTag == WAVE_FORMAT_PCM ||
+                 (wh.wFormatTag == WAVE_FORMAT_EXTENSIBLE && SubFormat == KSDATAFORMAT_SUBTYPE_PCM);
+    auto isFloat =
+        wh.wFormatTag == WAVE_FORMAT_IEEE_FLOAT ||
+        (wh.wFormatTag == WAVE_FORMAT_EXTENSIBLE && SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT);
+
+    /*
+     * Mono 16 bit and float data is already exactly what a generator reads, so when we are
+     * handed the mapping we can play it where it lies: no copy at load, the pages shared with
+     * anything else mapping the file, and the OS free to drop them under pressure. Stereo is
+     * interleaved and the generators read each channel contiguously, so it still copies.
+     */
+    bool playsInPlace{false};
+    if (mapping && *mapping && (*mapping)->data() == data && channels == 1 &&
+        hostIsLittleEndian())
     {
-        if (wh.wBitsPerSample == 8)
-        {
-            if (channels == 2)
-            {
-                load_data_ui8(0, loaddata, WaveDataSamples, 2);
-                load_data_ui8(1, loaddata + 1, WaveDataSamples, 2);
-            }
-            else
-                load_data_ui8(0, loaddata, WaveDataSamples, 1);
-        }
-        else if (wh.wBitsPerSample == 16)
+        auto isI16 = isPCM && wh.wBitsPerSample == 16;
+        auto isF32 = isFloat && wh.wBitsPerSample == 32;
+        size_t width = isI16 ? sizeof(int16_t) : sizeof(float);
+        auto at = (size_t)(loaddata - (unsigned char *)data);
+
+        // the generators may look FIRoffset before the start, which must at least be mapped
+        if ((isI16 || isF32) && at % width == 0 && at >= scxt::dsp::FIRoffset * width)
         {
-            if (channels == 2)
-            {
-                load_data_i16(0, loaddata, WaveDataSamples, 4);
-                load_data_i16(1, loaddata + 2, WaveDataSamples, 4);
-            }
-            else
-                load_data_i16(0, loaddata, WaveDataSamples, 2);
+            adoptMappedSampleData(std::move(*mapping), isI16 ? BD_I16 : BD_F32,
+                                  loaddata - scxt::dsp::FIRoffset * width, nullptr, false);
+            playsInPlace = true;
         }
-        else if (wh.wBitsPerSample == 24)
+    }
+
+    if (playsInPlace)
+    {
+        // nothing to copy
+    }
+    else
+    {
+        loadData_t loadData{nullptr};
+        if (isPCM)
         {
-            if (channels == 2)
+            switch (wh.wBitsPerSample)
             {
-                load_data_i24(0, loaddata, WaveDataSamples, 6);
-                load_data_i24(1, loaddata + 3, WaveDataSamples, 6);
+            case 8:
+                loadData = &Sample::load_data_ui8;
+                break;
+            case 16:
+                loadData = &Sample::load_data_i16;
+                break;
+            case 24:
+                loadData = &Sample::load_data_i24;
+                break;
+            case 32:
+                loadData = &Sample::load_data_i32;
+                break;
+            default:
+                ADD_ERROR_MESSAGE("Failed to load: " << SCD(wh.wBitsPerSample)
+                                                     << " must be 8, 16, 24 or 32 for PCM");
+                return false;
             }
-            else
-                load_data_i24(0, loaddata, WaveDataSamples, 3);
         }
-        else if (wh.wBitsPerSample == 32)
+        else if (isFloat)
         {
-            if (channels == 2)
+            switch (wh.wBitsPerSample)
             {
-                load_data_i32(0, loaddata, WaveDataSamples, 8);
-                load_data_i32(1, loaddata + 4, WaveDataSamples, 8);
+            case 32:
+                loadData = &Sample::load_data_f32;
+                break;
+            case 64:
+                loadData = &Sample::load_data_f64;
+                break;
+            default:
+                ADD_ERROR_MESSAGE("Failed to load wav: " << SCD(wh.wBitsPerSample)
+                                                         << " must be 32 or 64 for FLOAT wav");
+                return false;
             }
-            else
-                load_data_i32(0, loaddata, WaveDataSamples, 4);
         }
         else
         {
-            ADD_ERROR_MESSAGE("Failed to load: " << SCD(wh.wBitsPerSample)
-                                                 << " must be 8, 16, 24 or 32 for PCM");
+            ADD_ERROR_MESSAGE("Failed to load wav: Format Tag 0x"
+                              << std::hex << std::setw(4) << std::setfill('0') << wh.wFormatTag
+                              << " must be IEEE FLOAT (0x" << std::hex << std::setw(4)
+                              << std::setfill('0') << WAVE_FORMAT_IEEE_FLOAT << ") or PCM (0x"
+                              << std::hex << std::setw(4) << std::setfill('0') << WAVE_FORMAT_PCM
+                              << ")");
             return false;
         }
-    }
-    else if (wh.wFormatTag == WAVE_FORMAT_IEEE_FLOAT ||
-             (wh.wFormatTag == WAVE_FORMAT_EXTENSIBLE &&
-              SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT))
-    {
-        if (wh.wBitsPerSample == 32)
-        {
-            if (channels == 2)
-            {
-                load_data_f32(0, loaddata, WaveDataSamples, 8);
-                load_data_f32(1, loaddata + 4, WaveDataSamples, 8);
-            }
-            else
-                load_data_f32(0, loaddata, WaveDataSamples, 4);
-        }
-        else if (wh.wBitsPerSample == 64)
-        {
-            if (channels == 2)
-            {
-                load_data_f64(0, loaddata, WaveDataSamples, 16);
-                load_data_f64(1, loaddata + 8, WaveDataSamples, 16);
-            }
-            else
-                load_data_f64(0, loaddata, WaveDataSamples, 8);
-        }
-        else
+
+        if (!loadInterleavedInSlices(loadData, loaddata, WaveDataSamples,
+                                     wh.wBitsPerSample / 8))
         {
-            ADD_ERROR_MESSAGE("Failed to load wav: " << SCD(wh.wBitsPerSample)
-                                                     << " must be 32 or 64 for FLOAT wav");
+            ADD_ERROR_MESSAGE("Wav load cancelled");
             return false;
         }
     }
-    else
-    {
-        ADD_ERROR_MESSAGE("Failed to load wav: Format Tag 0x"
-                          << std::hex << std::setw(4) << std::setfill('0') << wh.wFormatTag
-                          << " must be IEEE FLOAT (0x" << std::hex << std::setw(4)
-                          << std::setfill('0') << WAVE_FORMAT_IEEE_FLOAT << ") or PCM (0x"
-                          << std::hex << std::setw(4) << std::setfill('0') << WAVE_FORMAT_PCM
-                          << ")");
-        return false;
-    }
     this->sample_loaded = true;
 
     // read smpl chunk
@@ -25,12 +25,15 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
 #include <sstream>
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 #include "infrastructure/file_map_view.h"
 #include "infrastructure/md5support.h"
+#include "infrastructure/load_timing.h"
 #include "dsp/resampling.h"
 #include "sample.h"
+#include "decoded_sample_cache.h"
 #include "patch_io/patch_io.h"
 
 namespace scxt::sample
@@ -41,15 +44,60 @@ using namespace sst::basic_blocks::mechanics;
 
 Sample::~Sample()
 {
-    if (sampleData[0])
-        free(sampleData[0]);
-    if (sampleData[1])
-        free(sampleData[1]);
+    releaseSampleData();
     delete[] meta.slice_start;
     delete[] meta.slice_end;
 }
 
-bool Sample::load(const fs::path &path)
+void Sample::releaseSampleData()
+{
+    if (mappedSampleData)
+    {
+        // these point into the mapping, which goes with it
+        mappedSampleData.reset();
+        zeroPaddedEdges = true;
+    }
+    else
+    {
+        if (sampleData[0])
+            free(sampleData[0]);
+        if (sampleData[1])
+            free(sampleData[1]);
+    }
+    sampleData[0] = nullptr;
+    sampleData[1] = nullptr;
+}
+
+void Sample::adoptMappedSampleData(std::unique_ptr<infrastructure::FileMapView> view,
+                                   BitDepth bd, void *channel0, void *channel1, bool zeroPadded)
+{
+    releaseSampleData();
+    mappedSampleData = std::move(view);
+    zeroPaddedEdges = zeroPadded;
+    bitDepth = bd;
+    sampleData[0] = channel0;
+    sampleData[1] = channel1;
+}
+
+bool Sample::decodeThroughCache(const fs::path &path, SourceType st, DecodedSampleCache *cache,
+                                bool (Sample::*parse)(const fs::path &))
+{
+    if (cache && cache->fetch(md5Sum, st, *this))
+    {
+        SCLOG_IF(sampleLoadAndPurge, "Decoded sample cache hit for " << path.u8string());
+        mFileName = path;
+        return true;
+    }
+
+    if (!(this->*parse)(path))
+        return false;
+
+    if (cache)
+        cache->store(md5Sum, st, *this);
+    return true;
+}
+
+bool Sample::load(const fs::path &path, DecodedSampleCache *cache, bool mapInPlace)
 {
     resetErrorString();
     if (!fs::exists(path))
@@ -61,6 +109,8 @@ bool Sample::load(const fs::path &path)
     md5Sum = infrastructure::createMD5SumFromFile(path);
     id.setPathHash(path.u8string().c_str());
 
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::DECODE);
+
     // If you add a type here add it in Browser::isLoadableFile also to stay in sync
     if (extensionMatches(path, ".wav"))
     {
@@ -70,7 +120,7 @@ bool Sample::load(const fs::path &path)
 
         clear_data(); // clear to a more predictable state
 
-        bool r = parse_riff_wave(data, datasize);
+        bool r = parse_riff_wave(data, datasize, false, mapInPlace ? &fmv : nullptr);
         if (!r)
         {
             addError("Unable to parse RIFF");
@@ -88,7 +138,7 @@ bool Sample::load(const fs::path &path)
     }
     else if (extensionMatches(path, ".flac"))
     {
-        if (parseFlac(path))
+        if (decodeThroughCache(path, FLAC_FILE, cache, &Sample::parseFlac))
         {
             sample_loaded = true;
             type = FLAC_FILE;
@@ -107,7 +157,7 @@ bool Sample::load(const fs::path &path)
     }
     else if (extensionMatches(path, ".mp3"))
     {
-        if (parseMP3(path))
+        if (decodeThroughCache(path, MP3_FILE, cache, &Sample::parseMP3))
         {
             sample_loaded = true;
             type = MP3_FILE;
@@ -126,7 +176,7 @@ bool Sample::load(const fs::path &path)
     }
     else if (extensionMatches(path, ".opus"))
     {
-        if (parseOpus(path))
+        if (decodeThroughCache(path, OPUS_FILE, cache, &Sample::parseOpus))
         {
             sample_loaded = true;
             type = OPUS_FILE;
@@ -174,6 +224,7 @@ bool Sample::load(const fs::path &path)
 
 bool Sample::loadFromSF2(const fs::path &p, sf2::File *f, int sampleIndex)
 {
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::DECODE);
     mFileName = p;
     preset = -1;
     instrument = -1;
@@ -247,6 +298,7 @@ bool Sample::loadFromSF2(const fs::path &p, sf2::File *f, int sampleIndex)
 
 bool Sample::loadFromGIG(const fs::path &p, gig::File *f, int sampleIndex)
 {
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::DECODE);
     mFileName = p;
     preset = -1;
     instrument = -1;
@@ -304,8 +356,10 @@ bool Sample::loadFromGIG(const fs::path &p, gig::File *f, int sampleIndex)
     return false;
 }
 
-bool Sample::loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampleIndex)
+bool Sample::loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampleIndex,
+                                  infrastructure::FileMapView *mapped)
 {
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::DECODE);
     mFileName = path;
     preset = -1;
     instrument = -1;
@@ -315,36 +369,54 @@ bool Sample::loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampl
     SCLOG_IF(sampleLoadAndPurge, "Load from SCXT: " << SCD(path) << SCD(sampleIndex));
     auto reader = patch_io::SCMonolithSampleReader(f);
 
+    std::string filename;
+    uint8_t *bytes{nullptr};
+    size_t byteSize{0};
+
+    patch_io::SCMonolithSampleReader::SampleRange range;
     patch_io::SCMonolithSampleReader::SampleData dat;
-    if (!reader.getSampleData(sampleIndex, dat))
+    if (mapped && mapped->isMapped() && reader.getSampleRange(sampleIndex, range) &&
+        range.fileOffset + range.size <= mapped->dataSize())
     {
-        addError(reader.getErrorString());
-        addError("Failed to get sample data from reader");
-        return false;
+        filename = range.filename;
+        bytes = (uint8_t *)mapped->data() + range.fileOffset;
+        byteSize = range.size;
+    }
+    else
+    {
+        if (!reader.getSampleData(sampleIndex, dat))
+        {
+            addError(reader.getErrorString());
+            addError("Failed to get sample data from reader");
+            return false;
+        }
+        filename = dat.filename;
+        bytes = dat.data.data();
+        byteSize = dat.data.size();
     }
 
-    displayName = dat.filename;
+    displayName = filename;
     compoundSourceDetails = fmt::format("{} @ {}", path.filename().u8string(), sampleIndex);
 
-    auto fnP = fs::path(fs::u8path(dat.filename));
+    auto fnP = fs::path(fs::u8path(filename));
 
     if (extensionMatches(fnP, ".wav"))
     {
-        auto res = parse_riff_wave(dat.data.data(), dat.data.size());
+        auto res = parse_riff_wave(bytes, byteSize);
         if (!res)
             addError("Unable to parse embedded wav");
         return res;
     }
     else if (extensionMatches(fnP, ".aif") || extensionMatches(fnP, ".aiff"))
     {
-        auto res = parse_aiff(dat.data.data(), dat.data.size());
+        auto res = parse_aiff(bytes, byteSize);
         if (!res)
             addError("Unable to parse embedded aif");
         return res;
     }
     else if (extensionMatches(fnP, ".flac"))
     {
-        auto res = parseFlac(dat.data.data(), dat.data.size());
+        auto res = parseFlac(bytes, byteSize);
         if (!res)
             addError("Unable to parse embedded FLAC");
 
@@ -358,7 +430,7 @@ bool Sample::loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampl
     }
     else if (extensionMatches(fnP, ".mp3"))
     {
-        auto res = parseMP3(dat.data.data(), dat.data.size());
+        auto res = parseMP3(bytes, byteSize);
         if (!res)
             addError("Unable to parse embedded MP3");
 
@@ -372,7 +444,7 @@ bool Sample::loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampl
     }
     else if (extensionMatches(fnP, ".opus"))
     {
-        auto res = parseOpus(dat.data.data(), dat.data.size());
+        auto res = parseOpus(bytes, byteSize);
         if (!res)
             addError("Unable to parse embedded Opus");
 
@@ -417,6 +489,8 @@ bool Sample::allocateI16(int Channel, int Samples)
     // int samplesizewithmargin = Samples + 2*scxt::dsp::FIRipol_N + BLOCK_SIZE +
     // scxt::dsp::FIRoffset;
     int samplesizewithmargin = Samples + scxt::dsp::FIRipol_N;
+    if (mappedSampleData)
+        releaseSampleData();
     if (sampleData[Channel])
         free(sampleData[Channel]);
     sampleData[Channel] = malloc(sizeof(short) * samplesizewithmargin);
@@ -434,6 +508,8 @@ bool Sample::allocateI16(int Channel, int Samples)
 bool Sample::allocateF32(int Channel, int Samples)
 {
     int samplesizewithmargin = Samples + scxt::dsp::FIRipol_N;
+    if (mappedSampleData)
+        releaseSampleData();
     if (sampleData[Channel])
         free(sampleData[Channel]);
     sampleData[Channel] = malloc(sizeof(float) * samplesizewithmargin);
@@ -449,59 +525,74 @@ bool Sample::allocateF32(int Channel, int Samples)
     return true;
 }
 
-bool Sample::load_data_ui8(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_ui8(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                           unsigned int from, unsigned int to)
 {
-    allocateI16(channel, samplesize);
+    if (from == 0)
+        allocateI16(channel, samplesize);
     short *sampledata = GetSamplePtrI16(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         sampledata[i] = (((short)*((unsigned char *)data + i * stride)) - 128) << 8;
     }
     return true;
 }
 
-bool Sample::load_data_i8(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i8(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                          unsigned int from, unsigned int to)
 {
-    allocateI16(channel, samplesize);
+    if (from == 0)
+        allocateI16(channel, samplesize);
     short *sampledata = GetSamplePtrI16(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         sampledata[i] = ((short)*((char *)data + i * stride)) << 8;
     }
     return true;
 }
 
-bool Sample::load_data_i16(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i16(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                           unsigned int from, unsigned int to)
 {
-    allocateI16(channel, samplesize);
+    if (from == 0)
+        allocateI16(channel, samplesize);
     short *sampledata = GetSamplePtrI16(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         sampledata[i] = endian_read_int16LE(*(short *)((char *)data + i * stride));
     }
     return true;
 }
 
-bool Sample::load_data_i16BE(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i16BE(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                             unsigned int from, unsigned int to)
 {
-    allocateI16(channel, samplesize);
+    if (from == 0)
+        allocateI16(channel, samplesize);
     short *sampledata = GetSamplePtrI16(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         sampledata[i] = endian_read_int16BE(*(short *)((char *)data + i * stride));
     }
     return true;
 }
-bool Sample::load_data_i32(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i32(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                           unsigned int from, unsigned int to)
 {
-    allocateF32(channel, samplesize);
+    if (from == 0)
+        allocateF32(channel, samplesize);
     float *sampledata = GetSamplePtrF32(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         int x = endian_read_int32LE(*(int *)((char *)data + i * stride));
         sampledata[i] = (4.6566128730772E-10f) * (float)x;
@@ -509,12 +600,15 @@ bool Sample::load_data_i32(int channel, void *data, unsigned int samplesize, uns
     return true;
 }
 
-bool Sample::load_data_i32BE(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i32BE(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                             unsigned int from, unsigned int to)
 {
-    allocateF32(channel, samplesize);
+    if (from == 0)
+        allocateF32(channel, samplesize);
     float *sampledata = GetSamplePtrF32(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         int x = endian_read_int32BE(*(int *)((char *)data + i * stride));
         sampledata[i] = (4.6566128730772E-10f) * (float)x;
@@ -522,12 +616,15 @@ bool Sample::load_data_i32BE(int channel, void *data, unsigned int samplesize, u
     return true;
 }
 
-bool Sample::load_data_i24(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i24(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                           unsigned int from, unsigned int to)
 {
-    allocateF32(channel, samplesize);
+    if (from == 0)
+        allocateF32(channel, samplesize);
     float *sampledata = GetSamplePtrF32(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         unsigned char *cval = (unsigned char *)data + i * stride;
         int value = (cval[2] << 16) | (cval[1] << 8) | cval[0];
@@ -538,12 +635,15 @@ bool Sample::load_data_i24(int channel, void *data, unsigned int samplesize, uns
     return true;
 }
 
-bool Sample::load_data_i24BE(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_i24BE(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                             unsigned int from, unsigned int to)
 {
-    allocateF32(channel, samplesize);
+    if (from == 0)
+        allocateF32(channel, samplesize);
     float *sampledata = GetSamplePtrF32(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         unsigned char *cval = (unsigned char *)data + i * stride;
         int value = (cval[0] << 16) | (cval[1] << 8) | cval[2];
@@ -554,30 +654,57 @@ bool Sample::load_data_i24BE(int channel, void *data, unsigned int samplesize, u
     return true;
 }
 
-bool Sample::load_data_f32(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_f32(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                           unsigned int from, unsigned int to)
 {
-    allocateF32(channel, samplesize);
+    if (from == 0)
+        allocateF32(channel, samplesize);
     float *sampledata = GetSamplePtrF32(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         sampledata[i] = (*(float *)((char *)data + i * stride));
     }
     return true;
 }
 
-bool Sample::load_data_f64(int channel, void *data, unsigned int samplesize, unsigned int stride)
+bool Sample::load_data_f64(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                           unsigned int from, unsigned int to)
 {
-    allocateF32(channel, samplesize);
+    if (from == 0)
+        allocateF32(channel, samplesize);
     float *sampledata = GetSamplePtrF32(channel);
 
-    for (int i = 0; i < samplesize; i++)
+    to = std::min(to, samplesize);
+    for (auto i = from; i < to; i++)
     {
         sampledata[i] = (float)(*(double *)((char *)data + i * stride));
     }
     return true;
 }
 
+bool Sample::loadInterleavedInSlices(loadData_t f, unsigned char *data, unsigned int frames,
+                                     unsigned int bytesPerSample)
+{
+    // big enough that the per slice overhead vanishes, small enough that a preview of a long
+    // file starts within a few milliseconds
+    static constexpr unsigned int sliceFrames{1 << 16};
+
+    auto stride = bytesPerSample * channels;
+    for (unsigned int from = 0; from < frames; from += sliceFrames)
+    {
+        auto to = std::min(frames, from + sliceFrames);
+        for (int c = 0; c < channels; ++c)
+            (this->*f)(c, data + c * bytesPerSample, frames, stride, from, to);
+        publishDecodedFrames(to);
+
+        if (isDecodeCancelled())
+            return false;
+    }
+    return true;
+}
+
 bool Sample::SetMeta(unsigned int Channels, unsigned int SampleRate, unsigned int SampleLength)
 {
     if (Channels > 2)
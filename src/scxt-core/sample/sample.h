@@ -30,11 +30,16 @@
 #include "utils.h"
 #include "configuration.h"
 #include "infrastructure/filesystem_import.h"
+#include "infrastructure/file_map_view.h"
 #include "SF.h"
 #include "gig.h"
 
+#include <atomic>
+#include <memory>
+
 namespace scxt::sample
 {
+struct DecodedSampleCache;
 
 struct alignas(16) Sample : MoveableOnly<Sample>
 {
@@ -73,10 +78,16 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     std::string compoundSourceDetails{};
     std::string getCompoundSourceDetails() const { return compoundSourceDetails; }
 
-    bool load(const fs::path &path);
+    // With a cache, compressed formats are read from it when they can be and stored after.
+    // mapInPlace lets a WAV whose data is already in generator layout be played straight from
+    // the mapped file; see parse_riff_wave.
+    bool load(const fs::path &path, DecodedSampleCache *cache = nullptr, bool mapInPlace = false);
     bool loadFromSF2(const fs::path &path, sf2::File *f, int sampleIndex);
     bool loadFromGIG(const fs::path &path, gig::File *f, int sampleIndex);
-    bool loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampleIndex);
+    // If mapped is a view of the same monolith, decode straight from it rather than
+    // loading the chunk through the RIFF
+    bool loadFromSCXTMonolith(const fs::path &path, RIFF::File *f, int sampleIndex,
+                              infrastructure::FileMapView *mapped = nullptr);
 
     const fs::path &getPath() const { return mFileName; }
     std::string md5Sum{};
@@ -98,6 +109,25 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     };
 
     bool isMissingPlaceholder{false};
+
+    /*
+     * Size and modification time of the file this sample was read from, taken when it
+     * entered the SampleManager. The residency cache revives a sample only while its file
+     * still matches.
+     */
+    struct SourceFileStamp
+    {
+        fs::file_time_type modified{};
+        uintmax_t size{0};
+        bool valid{false};
+
+        bool operator==(const SourceFileStamp &o) const
+        {
+            return valid && o.valid && modified == o.modified && size == o.size;
+        }
+        bool operator!=(const SourceFileStamp &o) const { return !(*this == o); }
+    };
+    SourceFileStamp sourceFileStamp;
     static std::shared_ptr<Sample> createMissingPlaceholder(const SampleFileAddress &a);
 
     SampleFileAddress getSampleFileAddress() const
@@ -133,7 +163,10 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     void *__restrict sampleData[2]{nullptr, nullptr};
 
     // TODO: Review evertyhing from here down before moving it above this comment
-    bool parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk = false);
+    // If mapping is given and the data can be played where it lies, the sample takes the
+    // mapping over rather than copying out of it
+    bool parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk = false,
+                         std::unique_ptr<infrastructure::FileMapView> *mapping = nullptr);
     bool parse_aiff(void *data, size_t filesize);
     short *GetSamplePtrI16(int Channel);
     float *GetSamplePtrF32(int Channel);
@@ -234,6 +267,13 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     } meta;
 
   private:
+    std::unique_ptr<infrastructure::FileMapView> mappedSampleData;
+    bool zeroPaddedEdges{true};
+    void releaseSampleData();
+
+    bool decodeThroughCache(const fs::path &path, SourceType st, DecodedSampleCache *cache,
+                            bool (Sample::*parse)(const fs::path &));
+
     void clear_data()
     {
         // TODO: Figure Out and Implement clear_data
@@ -244,16 +284,64 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     bool allocateI16(int Channel, int Samples);
     bool allocateF32(int Channel, int Samples);
 
-    bool load_data_ui8(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i8(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i16(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i16BE(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i24(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i24BE(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i32(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_i32BE(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_f32(int channel, void *data, unsigned int samplesize, unsigned int stride);
-    bool load_data_f64(int channel, void *data, unsigned int samplesize, unsigned int stride);
+    /*
+     * Point sampleData into a mapping and keep the mapping for the life of the sample. The
+     * DecodedSampleCache lays its files out as the allocate calls above would, pad and all.
+     * An in place WAV has no pad, so zeroPadded is false and the generators make up the pad
+     * themselves at the edges (see GeneratorIO::zeroPaddedEdges).
+     */
+    void adoptMappedSampleData(std::unique_ptr<infrastructure::FileMapView> view, BitDepth bd,
+                               void *channel0, void *channel1, bool zeroPadded = true);
+    bool isSampleDataMapped() const { return mappedSampleData != nullptr; }
+    bool hasZeroPaddedEdges() const { return zeroPaddedEdges; }
+
+    /*
+     * Progressive decode, for the browser preview which plays a sample while it loads. The
+     * FLAC, Opus, WAV and AIFF loaders write frames in order, so they publish how many are
+     * valid as they go and give up early once decodeCancelled is set. The other loaders
+     * (MP3 among them) leave these alone and the preview waits for the whole file.
+     */
+    std::atomic<size_t> decodedFrames{0};
+    std::atomic<bool> decodeCancelled{false};
+    void publishDecodedFrames(size_t n) { decodedFrames.store(n, std::memory_order_release); }
+    bool isDecodeCancelled() const { return decodeCancelled.load(std::memory_order_relaxed); }
+
+    /*
+     * Convert frames [from, to) of one channel of the file's sample data into ours. The
+     * slice from 0 allocates the channel for all samplesize frames, so a loader can convert
+     * a slice at a time, as loadInterleavedInSlices does.
+     */
+    bool load_data_ui8(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                       unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i8(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                      unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i16(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                       unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i16BE(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                         unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i24(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                       unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i24BE(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                         unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i32(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                       unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_i32BE(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                         unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_f32(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                       unsigned int from = 0, unsigned int to = ~0U);
+    bool load_data_f64(int channel, void *data, unsigned int samplesize, unsigned int stride,
+                       unsigned int from = 0, unsigned int to = ~0U);
+    typedef bool (Sample::*loadData_t)(int, void *, unsigned int, unsigned int, unsigned int,
+                                       unsigned int);
+
+    /*
+     * Run a load_data_ call over every channel of interleaved frames a slice at a time,
+     * publishing each slice as it lands (see decodedFrames) so a preview can start on the
+     * front of a long file. Returns false, with the sample half filled, if the decode was
+     * cancelled.
+     */
+    bool loadInterleavedInSlices(loadData_t f, unsigned char *data, unsigned int frames,
+                                 unsigned int bytesPerSample);
     bool sample_loaded{false};
 
     bool SetMeta(unsigned int channels, unsigned int SampleRate, unsigned int SampleLength);
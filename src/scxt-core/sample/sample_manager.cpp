@@ -25,10 +25,14 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <thread>
 #include "configuration.h"
 #include "sample_manager.h"
 #include "infrastructure/md5support.h"
+#include "infrastructure/load_timing.h"
 #include "sample/exs_support/exs_import.h"
 
 namespace scxt::sample
@@ -95,6 +99,45 @@ std::optional<SampleID>
 SampleManager::loadSampleByFileAddress(const Sample::SampleFileAddress &addr, const SampleID &id)
 {
     std::optional<SampleID> nid;
+
+    // Try the residency cache before opening anything. SF2 addresses given by
+    // preset/instrument need the file to find the sample index, and EXS/SFZ
+    // resolve to a plain file, so those are left to the loaders below.
+    auto keyable = addr.type != Sample::EXS_FILE && addr.type != Sample::SFZ_FILE &&
+                   !(addr.type == Sample::SF2_FILE && addr.preset >= 0 && addr.instrument >= 0);
+    if (keyable)
+    {
+        nid = findLoadedOrResident(addr.type, addr.path, addr.region);
+        if (nid.has_value())
+            return nid;
+    }
+    if (!addr.md5sum.empty())
+    {
+        // Same content at a different path. Only revive if the parked sample's own
+        // file is still there, since that is the path it will stream back out with;
+        // reviveFromResidencyCache drops it if that file has changed since.
+        auto lk = acquireMapLock();
+        bool retry{true};
+        while (retry)
+        {
+            retry = false;
+            auto [mb, me] = residencyByMD5.equal_range(addr.md5sum);
+            for (auto mi = mb; mi != me; ++mi)
+            {
+                auto &smp = *(mi->second);
+                if (smp->type == addr.type && fs::exists(smp->getPath()))
+                {
+                    auto res = reviveFromResidencyCache(mi->second);
+                    if (res.has_value())
+                        return res;
+                    // that one was stale and is gone, which invalidates the range
+                    retry = true;
+                    break;
+                }
+            }
+        }
+    }
+
     switch (addr.type)
     {
     case Sample::WAV_FILE:
@@ -151,20 +194,15 @@ std::optional<SampleID> SampleManager::loadSampleByPath(const fs::path &p)
     SCLOG_IF(sampleLoadAndPurge, "Loading sample by path '" << p.u8string() << "'");
     assert(threadingChecker.isSerialThread());
 
+    if (auto already = findLoadedOrResident(Sample::WAV_FILE, p, -1); already.has_value())
     {
-        auto lk = acquireMapLock();
-        for (const auto &[alreadyId, sm] : samples)
-        {
-            if (sm->getPath() == p)
-            {
-                return alreadyId;
-            }
-        }
+        return already;
     }
 
+    noteResidencyMiss();
     auto sp = std::make_shared<Sample>();
 
-    if (!sp->load(p))
+    if (!sp->load(p, &decodedCache, mapWavSamplesInPlace))
     {
         raiseError("Sample Load Failed",
                    "Unable to load sample file " + p.u8string() + "\n" + sp->getErrorString());
@@ -175,10 +213,102 @@ std::optional<SampleID> SampleManager::loadSampleByPath(const fs::path &p)
     SCLOG_IF(sampleLoadAndPurge, "Loading : " << p.u8string());
     SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
 
-    updateSampleMemory();
     return sp->id;
 }
 
+namespace
+{
+/*
+ * Run work(k, state) for k in [0, n) across a few threads, each with its own default
+ * constructed State for whatever per-thread handle the decode needs. Decoding into a
+ * fresh Sample touches nothing shared; storing it still has to happen on the caller.
+ */
+template <typename State, typename F> void decodeInParallel(size_t n, F &&work)
+{
+    std::atomic<size_t> next{0};
+    auto run = [&]() {
+        State state{};
+        size_t k;
+        while ((k = next.fetch_add(1)) < n)
+            work(k, state);
+    };
+    auto nThreads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+    nThreads = std::min(nThreads, n);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < nThreads; ++t)
+        workers.emplace_back(run);
+    run();
+    for (auto &w : workers)
+        w.join();
+}
+
+struct PendingDecode
+{
+    std::shared_ptr<Sample> sample;
+    bool ok{false};
+};
+} // namespace
+
+std::vector<std::optional<SampleID>>
+SampleManager::loadSamplesByPath(const std::vector<fs::path> &paths)
+{
+    assert(threadingChecker.isSerialThread());
+
+    std::vector<std::optional<SampleID>> res(paths.size());
+    std::vector<PendingDecode> pending;
+    std::vector<fs::path> pendingPaths;
+    std::unordered_map<std::string, size_t> pendingByPath;
+    std::vector<size_t> pendingFor(paths.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (auto already = findLoadedOrResident(Sample::WAV_FILE, paths[i], -1))
+        {
+            res[i] = already;
+            continue;
+        }
+        auto [it, added] = pendingByPath.emplace(paths[i].u8string(), pending.size());
+        if (added)
+        {
+            pending.push_back({std::make_shared<Sample>()});
+            pendingPaths.push_back(paths[i]);
+        }
+        pendingFor[i] = it->second;
+    }
+
+    SCLOG_IF(sampleLoadAndPurge, "Batch loading " << pending.size() << " of " << paths.size()
+                                                  << " samples by path");
+    struct NoState
+    {
+    };
+    decodeInParallel<NoState>(pending.size(), [&](size_t k, NoState &) {
+        pending[k].ok = pending[k].sample->load(pendingPaths[k], &decodedCache,
+                                                  mapWavSamplesInPlace);
+    });
+
+    for (size_t k = 0; k < pending.size(); ++k)
+    {
+        noteResidencyMiss();
+        auto &sp = pending[k].sample;
+        if (!pending[k].ok)
+        {
+            raiseError("Sample Load Failed", "Unable to load sample file " +
+                                                 pendingPaths[k].u8string() + "\n" +
+                                                 sp->getErrorString());
+            continue;
+        }
+        storeSample(sp);
+        SCLOG_IF(sampleLoadAndPurge, "Loading : " << pendingPaths[k].u8string());
+        SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (pendingFor[i] < pending.size() && pending[pendingFor[i]].ok)
+            res[i] = pending[pendingFor[i]].sample->id;
+    }
+    return res;
+}
+
 std::optional<SampleID> SampleManager::loadSampleFromSF2(const fs::path &p, const std::string &omd5,
                                                          sf2::File *f, int preset, int instrument,
                                                          int region)
@@ -191,6 +321,7 @@ std::optional<SampleID> SampleManager::loadSampleFromSF2(const fs::path &p, cons
             {
                 SCLOG_IF(sampleLoadAndPurge, "Opening SF2 : " << p.u8string());
 
+                auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
                 auto riff = std::make_unique<RIFF::File>(p.u8string());
                 auto sf = std::make_unique<sf2::File>(riff.get());
                 sf2FilesByPath[p.u8string()] = {std::move(riff), std::move(sf)};
@@ -222,18 +353,12 @@ std::optional<SampleID> SampleManager::loadSampleFromSF2(const fs::path &p, cons
     {
         return std::nullopt;
     }
+    if (auto already = findLoadedOrResident(Sample::SF2_FILE, p, sidx); already.has_value())
     {
-        auto lk = acquireMapLock();
-        for (const auto &[id, sm] : samples)
-        {
-            if (sm->type == Sample::SF2_FILE)
-            {
-                if (sm->getPath() == p && sm->getCompoundRegion() == sidx)
-                    return id;
-            }
-        }
+        return already;
     }
 
+    noteResidencyMiss();
     auto sp = std::make_shared<Sample>();
 
     if (!sp->loadFromSF2(p, f, sidx))
@@ -249,7 +374,6 @@ std::optional<SampleID> SampleManager::loadSampleFromSF2(const fs::path &p, cons
     SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
 
     storeSample(sp);
-    updateSampleMemory();
     return sp->id;
 }
 
@@ -328,6 +452,7 @@ std::optional<SampleID> SampleManager::loadSampleFromGIG(const fs::path &p, cons
             {
                 SCLOG_IF(sampleLoadAndPurge, "Opening gig : " << p.u8string());
 
+                auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
                 auto riff = std::make_unique<RIFF::File>(p.u8string());
                 auto sf = std::make_unique<gig::File>(riff.get());
                 gigFilesByPath[p.u8string()] = {std::move(riff), std::move(sf)};
@@ -350,18 +475,12 @@ std::optional<SampleID> SampleManager::loadSampleFromGIG(const fs::path &p, cons
     {
         return std::nullopt;
     }
+    if (auto already = findLoadedOrResident(Sample::GIG_FILE, p, sidx); already.has_value())
     {
-        auto lk = acquireMapLock();
-        for (const auto &[id, sm] : samples)
-        {
-            if (sm->type == Sample::GIG_FILE)
-            {
-                if (sm->getPath() == p && sm->getCompoundRegion() == sidx)
-                    return id;
-            }
-        }
+        return already;
     }
 
+    noteResidencyMiss();
     auto sp = std::make_shared<Sample>();
 
     if (!sp->loadFromGIG(p, f, sidx))
@@ -377,10 +496,108 @@ std::optional<SampleID> SampleManager::loadSampleFromGIG(const fs::path &p, cons
     SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
 
     storeSample(sp);
-    updateSampleMemory();
     return sp->id;
 }
 
+std::vector<std::optional<SampleID>>
+SampleManager::loadSamplesFromGIG(const fs::path &p, const std::string &omd5, gig::File *f,
+                                  const std::vector<int> &regions)
+{
+    assert(threadingChecker.isSerialThread());
+    assert(f);
+
+    setOrCalcMD5Cache(gigMD5ByPath, p, omd5, "gig");
+    const auto &md5 = gigMD5ByPath[p.u8string()];
+
+    std::vector<std::optional<SampleID>> res(regions.size());
+    std::vector<PendingDecode> pending;
+    std::vector<int> pendingRegions;
+    std::unordered_map<int, size_t> pendingByRegion;
+    std::vector<size_t> pendingFor(regions.size(), regions.size());
+    // libgig decompresses through one static buffer, so compressed samples can't decode
+    // side by side; those (rare) files take the serial path on the caller's own File
+    bool anyCompressed{false};
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        auto sidx = regions[i];
+        if (sidx < 0 || sidx >= (int)f->CountSamples())
+            continue;
+        if (auto already = findLoadedOrResident(Sample::GIG_FILE, p, sidx))
+        {
+            res[i] = already;
+            continue;
+        }
+        auto [it, added] = pendingByRegion.emplace(sidx, pending.size());
+        if (added)
+        {
+            pending.push_back({std::make_shared<Sample>()});
+            pendingRegions.push_back(sidx);
+            if (auto *gs = f->GetSample(sidx); gs && gs->Compressed)
+                anyCompressed = true;
+        }
+        pendingFor[i] = it->second;
+    }
+
+    SCLOG_IF(sampleLoadAndPurge, "Batch loading " << pending.size() << " gig samples from "
+                                                  << p.u8string()
+                                                  << (anyCompressed ? " serially" : ""));
+    if (anyCompressed)
+    {
+        for (size_t k = 0; k < pending.size(); ++k)
+            pending[k].ok = pending[k].sample->loadFromGIG(p, f, pendingRegions[k]);
+    }
+    else
+    {
+        // A gig::File reads through its RIFF::File's single handle, so each thread opens its own
+        struct OwnFile
+        {
+            std::unique_ptr<RIFF::File> riff;
+            std::unique_ptr<gig::File> gig;
+            bool failed{false};
+        };
+        decodeInParallel<OwnFile>(pending.size(), [&](size_t k, OwnFile &of) {
+            if (!of.gig && !of.failed)
+            {
+                try
+                {
+                    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
+                    of.riff = std::make_unique<RIFF::File>(p.u8string());
+                    of.gig = std::make_unique<gig::File>(of.riff.get());
+                }
+                catch (RIFF::Exception &)
+                {
+                    of.failed = true;
+                }
+            }
+            if (of.gig)
+                pending[k].ok = pending[k].sample->loadFromGIG(p, of.gig.get(), pendingRegions[k]);
+        });
+    }
+
+    for (size_t k = 0; k < pending.size(); ++k)
+    {
+        noteResidencyMiss();
+        if (!pending[k].ok)
+            continue;
+        auto &sp = pending[k].sample;
+        sp->md5Sum = md5;
+        assert(!sp->md5Sum.empty());
+        sp->id.setAsMD5WithAddress(sp->md5Sum, -1, -1, pendingRegions[k]);
+        sp->id.setPathHash(p);
+        SCLOG_IF(sampleLoadAndPurge, "Loading : " << p.u8string());
+        SCLOG_IF(sampleLoadAndPurge, "        : " << sp->displayName);
+        SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
+        storeSample(sp);
+    }
+
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        if (pendingFor[i] < pending.size() && pending[pendingFor[i]].ok)
+            res[i] = pending[pendingFor[i]].sample->id;
+    }
+    return res;
+}
+
 std::optional<SampleID> SampleManager::loadSampleFromSCXTMonolith(const fs::path &p,
                                                                   const std::string &omd5,
                                                                   RIFF::File *f, int preset,
@@ -395,6 +612,7 @@ std::optional<SampleID> SampleManager::loadSampleFromSCXTMonolith(const fs::path
             {
                 SCLOG_IF(monoliths, "Opening monolith RIFF : " << p.u8string());
 
+                auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
                 auto riff = std::make_unique<RIFF::File>(p.u8string());
                 scxtMonolithFilesByPath[p.u8string()] = std::move(riff);
             }
@@ -412,24 +630,26 @@ std::optional<SampleID> SampleManager::loadSampleFromSCXTMonolith(const fs::path
 
     auto sidx = region;
 
+    if (auto already = findLoadedOrResident(Sample::SCXT_FILE, p, sidx); already.has_value())
     {
-        auto lk = acquireMapLock();
-        for (const auto &[id, sm] : samples)
+        SCLOG_IF(monoliths, "Sample already loaded");
+        return already;
+    }
+
+    noteResidencyMiss();
+    auto &mapped = scxtMonolithMapsByPath[p.u8string()];
+    if (!mapped)
+    {
+        mapped = std::make_unique<infrastructure::FileMapView>(p);
+        if (!mapped->isMapped())
         {
-            if (sm->type == Sample::SCXT_FILE)
-            {
-                if (sm->getPath() == p && sm->getCompoundRegion() == sidx)
-                {
-                    SCLOG_IF(monoliths, "Sample already loaded");
-                    return id;
-                }
-            }
+            SCLOG_IF(monoliths, "Unable to map monolith; falling back to chunk reads");
         }
     }
 
     auto sp = std::make_shared<Sample>();
 
-    if (!sp->loadFromSCXTMonolith(p, f, sidx))
+    if (!sp->loadFromSCXTMonolith(p, f, sidx, mapped.get()))
         return {};
 
     sp->md5Sum = scxtMonolithMD5ByPath[p.u8string()];
@@ -442,7 +662,6 @@ std::optional<SampleID> SampleManager::loadSampleFromSCXTMonolith(const fs::path
     SCLOG_IF(monoliths, "        : " << sp->id.to_string());
 
     storeSample(sp);
-    updateSampleMemory();
     return sp->id;
 }
 
@@ -453,6 +672,13 @@ std::optional<SampleID> SampleManager::setupSampleFromMultifile(const fs::path &
     if (!data || dataSize == 0)
         return std::nullopt;
 
+    if (auto already = findLoadedOrResident(Sample::MULTISAMPLE_FILE, p, idx); already.has_value())
+    {
+        return already;
+    }
+
+    noteResidencyMiss();
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::DECODE);
     auto sp = std::make_shared<Sample>();
     sp->id.setAsMD5WithAddress(md5, idx, -1, -1);
     sp->id.setPathHash(p);
@@ -463,7 +689,6 @@ std::optional<SampleID> SampleManager::setupSampleFromMultifile(const fs::path &
     sp->region = idx;
     sp->mFileName = p;
     storeSample(sp);
-    updateSampleMemory();
     return sp->id;
 }
 
@@ -479,12 +704,22 @@ std::optional<SampleID> SampleManager::loadSampleFromMultiSample(const fs::path
     if (!za->isOpen)
         return std::nullopt;
 
+    if (auto already = findLoadedOrResident(Sample::MULTISAMPLE_FILE, p, idx); already.has_value())
+    {
+        return already;
+    }
+
+    noteResidencyMiss();
     auto sp = std::make_shared<Sample>();
     sp->id.setAsMD5WithAddress(md5, idx, -1, -1);
     sp->id.setPathHash(p);
 
     size_t ssize{0};
-    auto data = mz_zip_reader_extract_to_heap(&za->zip_archive, idx, &ssize, 0);
+    void *data{nullptr};
+    {
+        auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::READ);
+        data = mz_zip_reader_extract_to_heap(&za->zip_archive, idx, &ssize, 0);
+    }
     if (!data)
     {
         raiseError("Sample Load Failed", "Unable to extract entry " + std::to_string(idx) +
@@ -492,7 +727,11 @@ std::optional<SampleID> SampleManager::loadSampleFromMultiSample(const fs::path
         return std::nullopt;
     }
 
-    auto parsed = sp->parse_riff_wave(data, ssize);
+    bool parsed{false};
+    {
+        auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::DECODE);
+        parsed = sp->parse_riff_wave(data, ssize);
+    }
     free(data);
     if (!parsed)
     {
@@ -504,7 +743,6 @@ std::optional<SampleID> SampleManager::loadSampleFromMultiSample(const fs::path
     sp->region = idx;
     sp->mFileName = p;
     sp->md5Sum = md5;
-    storeSample(sp);
 
     mz_zip_archive_file_stat file_stat;
     mz_zip_reader_file_stat(&za->zip_archive, idx, &file_stat);
@@ -512,9 +750,7 @@ std::optional<SampleID> SampleManager::loadSampleFromMultiSample(const fs::path
     sp->displayName =
         fmt::format("{} - ({} @ {})", file_stat.m_filename, p.filename().u8string(), idx);
 
-    updateSampleMemory();
-
-    free(data);
+    storeSample(sp);
 
     SCLOG_IF(sampleLoadAndPurge, "Loading : " << p.u8string());
     SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
@@ -525,6 +761,7 @@ std::optional<SampleID> SampleManager::loadSampleFromMultiSample(const fs::path
 void SampleManager::purgeUnreferencedSamples()
 {
     assert(threadingChecker.isSerialThread());
+    auto lp = infrastructure::ScopedLoadPhase(infrastructure::LoadTimings::PURGE);
     auto lk = acquireMapLock();
     auto preSize{samples.size()};
     auto b = samples.begin();
@@ -540,6 +777,8 @@ void SampleManager::purgeUnreferencedSamples()
                 SCLOG_IF(sampleLoadAndPurge, "        : Missing Placeholder");
             }
 
+            unindexSample(b->second);
+            parkInResidencyCache(b->second);
             b = samples.erase(b);
         }
         else
@@ -548,16 +787,308 @@ void SampleManager::purgeUnreferencedSamples()
         }
     }
 
+    trimResidencyCache();
+
     if (samples.size() != preSize)
     {
         SCLOG_IF(sampleLoadAndPurge, "PostPurge : Purged " << (preSize - samples.size())
                                                            << " Remaining " << samples.size());
+        SCLOG_IF(sampleLoadAndPurge, "          : Resident "
+                                         << residencyLRU.size() << " (" << residencyStats.residentBytes
+                                         << " bytes) hits=" << residencyStats.hits
+                                         << " misses=" << residencyStats.misses
+                                         << " evictions=" << residencyStats.evictions);
     }
     lk.unlock();
 
     updateSampleMemory();
 }
 
+void SampleManager::storeSample(const std::shared_ptr<Sample> &sp)
+{
+    auto lk = acquireMapLock();
+    auto &slot = samples[sp->id];
+    if (slot)
+    {
+        unindexSample(slot);
+        sampleMemoryInBytes -= slot->getDataSize();
+    }
+    slot = sp;
+    if (!sp->sourceFileStamp.valid && !sp->isMissingPlaceholder)
+        sp->sourceFileStamp = stampSourceFile(sp->getPath());
+    indexSample(sp);
+    sampleMemoryInBytes += sp->getDataSize();
+}
+
+void SampleManager::addIdAlias(const SampleID &from, const SampleID &to)
+{
+    auto lk = acquireMapLock();
+    auto target = resolveAlias(to);
+    if (target == from)
+    {
+        // from is now the real thing so it can't alias anything
+        idAliases.erase(from);
+        return;
+    }
+
+    auto prior = idAliases.find(from);
+    if (prior != idAliases.end())
+    {
+        auto &src = aliasSources[prior->second];
+        src.erase(std::remove(src.begin(), src.end(), from), src.end());
+    }
+    idAliases[from] = target;
+    aliasSources[target].push_back(from);
+
+    // Anything which pointed at from now points at target, keeping every chain one hop long
+    auto chained = aliasSources.find(from);
+    if (chained != aliasSources.end())
+    {
+        auto moved = std::move(chained->second);
+        aliasSources.erase(chained);
+        auto &dest = aliasSources[target];
+        for (const auto &a : moved)
+        {
+            idAliases[a] = target;
+            dest.push_back(a);
+        }
+    }
+}
+
+std::string SampleManager::addressKeyFor(Sample::SourceType t, const fs::path &p, int region)
+{
+    switch (t)
+    {
+    case Sample::SF2_FILE:
+    case Sample::GIG_FILE:
+    case Sample::SCXT_FILE:
+    case Sample::MULTISAMPLE_FILE:
+        return fmt::format("{}/{}/{}", (int)t, region, p.u8string());
+    default:
+        // plain files dedupe on path alone, as loadSampleByPath always has
+        return "f//" + p.u8string();
+    }
+}
+
+std::string SampleManager::addressKeyFor(const Sample &s)
+{
+    return addressKeyFor(s.type, s.getPath(), s.getCompoundRegion());
+}
+
+void SampleManager::indexSample(const std::shared_ptr<Sample> &sp)
+{
+    // first one in wins, which is what the old linear scans would have found
+    addressIndex.emplace(addressKeyFor(*sp), sp->id);
+    if (isMD5Indexable(*sp))
+    {
+        md5Index.emplace(sp->md5Sum, sp->id);
+    }
+}
+
+bool SampleManager::isMD5Indexable(const Sample &s)
+{
+    // The md5 of a compound sample is that of its container, so only plain files count
+    return !s.isMissingPlaceholder && !s.md5Sum.empty() &&
+           s.id.multiAddress[0] == SampleID::unusedAddress &&
+           s.id.multiAddress[2] == SampleID::unusedAddress;
+}
+
+void SampleManager::unindexSample(const std::shared_ptr<Sample> &sp)
+{
+    auto ai = addressIndex.find(addressKeyFor(*sp));
+    if (ai != addressIndex.end() && ai->second == sp->id)
+        addressIndex.erase(ai);
+
+    auto [mb, me] = md5Index.equal_range(sp->md5Sum);
+    for (auto mi = mb; mi != me; ++mi)
+    {
+        if (mi->second == sp->id)
+        {
+            md5Index.erase(mi);
+            break;
+        }
+    }
+}
+
+std::optional<SampleID> SampleManager::findLoadedSampleByPath(const fs::path &p) const
+{
+    auto lk = acquireMapLock();
+    auto ai = addressIndex.find(addressKeyFor(Sample::WAV_FILE, p, -1));
+    if (ai == addressIndex.end())
+        return std::nullopt;
+    return ai->second;
+}
+
+std::optional<SampleID> SampleManager::findLoadedSampleByAddress(Sample::SourceType t,
+                                                                 const fs::path &p,
+                                                                 int region) const
+{
+    auto lk = acquireMapLock();
+    auto ai = addressIndex.find(addressKeyFor(t, p, region));
+    if (ai == addressIndex.end())
+        return std::nullopt;
+    return ai->second;
+}
+
+std::optional<SampleID> SampleManager::findLoadedSampleByMD5(const std::string &md5) const
+{
+    auto lk = acquireMapLock();
+    auto mi = md5Index.find(md5);
+    if (mi == md5Index.end())
+        return std::nullopt;
+    return mi->second;
+}
+
+std::optional<SampleID> SampleManager::findLoadedOrResident(Sample::SourceType t,
+                                                            const fs::path &p, int region)
+{
+    auto lk = acquireMapLock();
+    auto key = addressKeyFor(t, p, region);
+    auto ai = addressIndex.find(key);
+    if (ai != addressIndex.end())
+        return ai->second;
+
+    auto ri = residencyByAddress.find(key);
+    if (ri != residencyByAddress.end())
+        return reviveFromResidencyCache(ri->second);
+
+    return std::nullopt;
+}
+
+void SampleManager::reset()
+{
+    {
+        auto lk = acquireMapLock();
+        // Everything goes to the residency cache, so a reset followed by a restore
+        // of a related multi picks most of its samples straight back up
+        for (const auto &[id, smp] : samples)
+            parkInResidencyCache(smp);
+        samples.clear();
+        idAliases.clear();
+        aliasSources.clear();
+        addressIndex.clear();
+        md5Index.clear();
+        trimResidencyCache();
+    }
+    sf2FilesByPath.clear();
+    sf2MD5ByPath.clear();
+    gigFilesByPath.clear();
+    gigMD5ByPath.clear();
+    scxtMonolithFilesByPath.clear();
+    scxtMonolithMapsByPath.clear();
+    scxtMonolithMD5ByPath.clear();
+    zipArchives.clear();
+    streamingVersion = 0x2112'01'01;
+    updateSampleMemory();
+}
+
+void SampleManager::setResidencyCacheBudget(uint64_t bytes)
+{
+    auto lk = acquireMapLock();
+    residencyBudget = bytes;
+    trimResidencyCache();
+}
+
+SampleManager::ResidencyCacheStats SampleManager::getResidencyCacheStats() const
+{
+    auto lk = acquireMapLock();
+    auto res = residencyStats;
+    res.residentSamples = residencyLRU.size();
+    return res;
+}
+
+void SampleManager::clearResidencyCache()
+{
+    auto lk = acquireMapLock();
+    residencyByAddress.clear();
+    residencyByMD5.clear();
+    residencyLRU.clear();
+    residencyStats.residentBytes = 0;
+}
+
+void SampleManager::parkInResidencyCache(const std::shared_ptr<Sample> &sp)
+{
+    if (residencyBudget == 0 || sp->isMissingPlaceholder || !sp->sample_loaded)
+        return;
+
+    auto key = addressKeyFor(*sp);
+    auto prior = residencyByAddress.find(key);
+    if (prior != residencyByAddress.end())
+        dropFromResidencyCache(prior->second);
+
+    residencyLRU.push_front(sp);
+    residencyByAddress[key] = residencyLRU.begin();
+    if (isMD5Indexable(*sp))
+        residencyByMD5.emplace(sp->md5Sum, residencyLRU.begin());
+    residencyStats.residentBytes += sp->getDataSize();
+}
+
+void SampleManager::dropFromResidencyCache(residencyList_t::iterator it)
+{
+    const auto &sp = *it;
+    auto ai = residencyByAddress.find(addressKeyFor(*sp));
+    if (ai != residencyByAddress.end() && ai->second == it)
+        residencyByAddress.erase(ai);
+
+    auto [mb, me] = residencyByMD5.equal_range(sp->md5Sum);
+    for (auto mi = mb; mi != me; ++mi)
+    {
+        if (mi->second == it)
+        {
+            residencyByMD5.erase(mi);
+            break;
+        }
+    }
+    residencyStats.residentBytes -= sp->getDataSize();
+    residencyLRU.erase(it);
+}
+
+void SampleManager::trimResidencyCache()
+{
+    while (!residencyLRU.empty() && residencyStats.residentBytes > residencyBudget)
+    {
+        SCLOG_IF(sampleLoadAndPurge, "Evicting : " << residencyLRU.back()->getPath().u8string());
+        dropFromResidencyCache(std::prev(residencyLRU.end()));
+        residencyStats.evictions++;
+    }
+}
+
+Sample::SourceFileStamp SampleManager::stampSourceFile(const fs::path &p)
+{
+    Sample::SourceFileStamp res;
+    std::error_code ec;
+    res.modified = fs::last_write_time(p, ec);
+    if (ec)
+        return res;
+    res.size = fs::file_size(p, ec);
+    res.valid = !ec;
+    return res;
+}
+
+std::optional<SampleID> SampleManager::reviveFromResidencyCache(residencyList_t::iterator it)
+{
+    auto sp = *it;
+    dropFromResidencyCache(it);
+    if (sp->sourceFileStamp != stampSourceFile(sp->getPath()))
+    {
+        // Edited or re-exported since it was read. The caller goes to disk, and counts
+        // the miss, as if it had never been parked.
+        SCLOG_IF(sampleLoadAndPurge, "Dropping stale : " << sp->getPath().u8string());
+        return std::nullopt;
+    }
+    storeSample(sp);
+    residencyStats.hits++;
+    SCLOG_IF(sampleLoadAndPurge, "Reviving : " << sp->getPath().u8string());
+    SCLOG_IF(sampleLoadAndPurge, "        : " << sp->id.to_string());
+    return sp->id;
+}
+
+void SampleManager::noteResidencyMiss()
+{
+    auto lk = acquireMapLock();
+    residencyStats.misses++;
+}
+
 void SampleManager::updateSampleMemory()
 {
     auto lk = acquireMapLock();
@@ -616,7 +1147,7 @@ void SampleManager::addSampleAsMissing(const SampleID &id, const Sample::SampleF
         SCLOG_IF(missingResolution, "Missing : " << f.path.u8string());
         SCLOG_IF(missingResolution, "        : " << ms->id.to_string());
 
-        samples[ms->id] = ms;
+        storeSample(ms);
 
         if (ms->id != id)
         {
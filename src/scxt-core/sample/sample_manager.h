@@ -30,10 +30,13 @@
 
 #include "utils.h"
 #include "sample.h"
+#include "decoded_sample_cache.h"
 
 #include "infrastructure/filesystem_import.h"
+#include "infrastructure/file_map_view.h"
 
 #include <filesystem>
+#include <list>
 #include <unordered_map>
 #include <optional>
 #include <vector>
@@ -93,6 +96,18 @@ struct SampleManager : MoveableOnly<SampleManager>
                                               gig::File *f, // if this is null I will re-open it
                                               int preset, int instrument, int region);
 
+    /*
+     * Batch loads for importers which know their whole sample list up front. Anything
+     * already loaded or resident is reused; the rest decode on a few threads and are then
+     * stored here on the serial thread. Results line up with the request, and a failed
+     * load is nullopt just as with the single loads above.
+     */
+    std::vector<std::optional<SampleID>> loadSamplesByPath(const std::vector<fs::path> &);
+    std::vector<std::optional<SampleID>> loadSamplesFromGIG(const fs::path &,
+                                                            const std::string &omd5,
+                                                            gig::File *f,
+                                                            const std::vector<int> &regions);
+
     std::optional<SampleID>
     loadSampleFromSCXTMonolith(const fs::path &, const std::string &md5,
                                RIFF::File *f, // if this is null I will re-open it
@@ -110,14 +125,28 @@ struct SampleManager : MoveableOnly<SampleManager>
         if (p != samples.end())
             return p->second;
 
+        // aliases are kept collapsed by addIdAlias so one hop is always enough
         auto alias = idAliases.find(id);
         if (alias != idAliases.end())
         {
-            return getSample(alias->second);
+            auto q = samples.find(alias->second);
+            if (q != samples.end())
+                return q->second;
         }
         return {};
     }
 
+    /*
+     * Find an already loaded sample without touching the disk. Plain files
+     * match by path (whatever the source type), compound sources (sf2, gig,
+     * monoliths, multisamples) by type, path and sample index. These are O(1)
+     * so that importing a file with thousands of regions stays linear.
+     */
+    std::optional<SampleID> findLoadedSampleByPath(const fs::path &) const;
+    std::optional<SampleID> findLoadedSampleByAddress(Sample::SourceType, const fs::path &,
+                                                      int region) const;
+    std::optional<SampleID> findLoadedSampleByMD5(const std::string &md5) const;
+
     fs::path reparentPath;
     void reparentSamplesOnStreamToRelative(const fs::path &newParent)
     {
@@ -189,39 +218,54 @@ struct SampleManager : MoveableOnly<SampleManager>
 
     void purgeUnreferencedSamples();
 
-    void reset()
+    void reset();
+
+    /*
+     * Samples dropped by purgeUnreferencedSamples or reset are parked in an LRU
+     * residency cache rather than freed, so that switching between multis which share
+     * most of their samples doesn't re-read, re-hash and re-decode them. The loaders
+     * revive from here before going to disk. Parked samples are evicted, oldest first,
+     * once they exceed the byte budget; a budget of 0, the default, turns the cache off.
+     * A parked sample whose file has changed size or time since it loaded is dropped
+     * rather than revived.
+     */
+    struct ResidencyCacheStats
     {
-        {
-            auto lk = acquireMapLock();
-            samples.clear();
-        }
-        sf2FilesByPath.clear();
-        sf2MD5ByPath.clear();
-        gigFilesByPath.clear();
-        gigMD5ByPath.clear();
-        scxtMonolithFilesByPath.clear();
-        scxtMonolithMD5ByPath.clear();
-        zipArchives.clear();
-        idAliases.clear();
-        streamingVersion = 0x2112'01'01;
-        updateSampleMemory();
-    }
+        uint64_t hits{0}, misses{0}, evictions{0};
+        uint64_t residentBytes{0};
+        size_t residentSamples{0};
+    };
+    static constexpr uint64_t defaultResidencyCacheBudgetMB{0};
+    void setResidencyCacheBudget(uint64_t bytes);
+    uint64_t getResidencyCacheBudget() const { return residencyBudget; }
+    ResidencyCacheStats getResidencyCacheStats() const;
+    void clearResidencyCache();
+
+    // Decoded PCM for compressed formats, kept on disk across sessions. Off unless configured.
+    DecodedSampleCache decodedCache;
+
+    /*
+     * Play mono 16 bit and float WAVs straight from their mapped file rather than copying
+     * them in. Opt in, since a file changed on disk under a mapping can take the process down.
+     */
+    bool mapWavSamplesInPlace{false};
 
     uint64_t streamingVersion{0x2112'01'01}; // see comment in patch.h
 
     std::atomic<uint64_t> sampleMemoryInBytes{0};
 
-    void addIdAlias(const SampleID &from, const SampleID &to) { idAliases[from] = to; }
+    void addIdAlias(const SampleID &from, const SampleID &to);
 
     SampleID resolveAlias(const SampleID &a) const
     {
+        auto lk = acquireMapLock();
         auto ap = idAliases.find(a);
         if (ap == idAliases.end())
         {
             return a;
         }
         assert(ap->second != a);
-        return resolveAlias(ap->second);
+        return ap->second;
     }
 
     using sampleMap_t = std::unordered_map<SampleID, std::shared_ptr<Sample>>;
@@ -235,17 +279,43 @@ struct SampleManager : MoveableOnly<SampleManager>
     {
         return std::unique_lock(mapMutex);
     }
-    void storeSample(const std::shared_ptr<Sample> &sp)
-    {
-        auto lk = acquireMapLock();
-        samples[sp->id] = sp;
-    }
+    void storeSample(const std::shared_ptr<Sample> &sp);
     std::function<void(const std::string &, const std::string &)> raiseError = [](auto, auto) {};
     std::function<void(const std::string &)> informUI = [](auto) {};
 
   private:
     void updateSampleMemory();
+
+    // idAliases always maps straight to the final id; aliasSources is the reverse
+    // so that re-pointing a target can re-point everything which aliased it.
     std::unordered_map<SampleID, SampleID> idAliases;
+    std::unordered_map<SampleID, std::vector<SampleID>> aliasSources;
+
+    // Secondary indices over samples, maintained by storeSample and purge
+    static std::string addressKeyFor(Sample::SourceType, const fs::path &, int region);
+    static std::string addressKeyFor(const Sample &);
+    void indexSample(const std::shared_ptr<Sample> &);
+    void unindexSample(const std::shared_ptr<Sample> &);
+    std::unordered_map<std::string, SampleID> addressIndex;
+    std::unordered_multimap<std::string, SampleID> md5Index;
+    static bool isMD5Indexable(const Sample &);
+
+    // Loaded sample if there is one, else a revival from the residency cache
+    std::optional<SampleID> findLoadedOrResident(Sample::SourceType, const fs::path &,
+                                                 int region);
+
+    using residencyList_t = std::list<std::shared_ptr<Sample>>;
+    residencyList_t residencyLRU; // most recently parked at the front
+    std::unordered_map<std::string, residencyList_t::iterator> residencyByAddress;
+    std::unordered_multimap<std::string, residencyList_t::iterator> residencyByMD5;
+    uint64_t residencyBudget{defaultResidencyCacheBudgetMB * 1024 * 1024};
+    ResidencyCacheStats residencyStats;
+    void parkInResidencyCache(const std::shared_ptr<Sample> &);
+    void dropFromResidencyCache(residencyList_t::iterator);
+    void trimResidencyCache();
+    std::optional<SampleID> reviveFromResidencyCache(residencyList_t::iterator);
+    static Sample::SourceFileStamp stampSourceFile(const fs::path &);
+    void noteResidencyMiss();
 
     // A sign of great design.
     mutable std::recursive_mutex mapMutex;
@@ -264,6 +334,9 @@ struct SampleManager : MoveableOnly<SampleManager>
 
     std::unordered_map<std::string, std::unique_ptr<RIFF::File>>
         scxtMonolithFilesByPath; // last is the md5sum
+    // sample bodies decode straight from these rather than via RIFF chunk loads
+    std::unordered_map<std::string, std::unique_ptr<infrastructure::FileMapView>>
+        scxtMonolithMapsByPath;
     md5cache_t scxtMonolithMD5ByPath;
 
     void setOrCalcMD5Cache(md5cache_t &, const fs::path &, const std::string &m,
@@ -0,0 +1,163 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "preview_decoder.h"
+
+namespace scxt::voice
+{
+bool PreviewStream::sameSourceAs(const PreviewStream &other) const
+{
+    if (managed != other.managed)
+        return false;
+    if (managed)
+        return sample->id == other.sample->id;
+    return path == other.path;
+}
+
+PreviewDecoder::~PreviewDecoder()
+{
+    cancelRunning();
+    for (auto &j : jobs)
+    {
+        if (j.worker.joinable())
+            j.worker.join();
+    }
+}
+
+std::shared_ptr<PreviewStream> PreviewDecoder::start(const fs::path &p)
+{
+    cancelRunning(p);
+
+    // A decode of p which is still going, or done, is as good as a new one and saves a thread
+    std::shared_ptr<PreviewStream> existing;
+    for (const auto &j : jobs)
+    {
+        const auto &st = j.stream;
+        if (!st->managed && st->path == p && !st->sample->isDecodeCancelled() &&
+            st->getState() != PreviewStream::FAILED)
+        {
+            existing = st;
+            break;
+        }
+    }
+    reap();
+    if (existing)
+        return existing;
+
+    auto res = std::make_shared<PreviewStream>();
+    res->path = p;
+    res->sample = std::make_shared<sample::Sample>();
+
+    // The worker only sees the stream; the job keeps it alive past the thread
+    auto worker = std::thread([st = res.get()]() {
+        auto &smp = *(st->sample);
+        if (smp.load(st->path))
+        {
+            // Loaders which don't stream publish everything once they are done
+            smp.publishDecodedFrames(smp.sampleLengthPerChannel);
+            st->state.store(PreviewStream::DECODED, std::memory_order_release);
+        }
+        else
+        {
+            if (!smp.isDecodeCancelled())
+            {
+                SCLOG_IF(sampleLoadAndPurge, "Preview decode failed for "
+                                                 << st->path.u8string() << " "
+                                                 << smp.getErrorString());
+            }
+            st->state.store(PreviewStream::FAILED, std::memory_order_release);
+        }
+    });
+    jobs.push_back({res, std::move(worker)});
+    return res;
+}
+
+std::shared_ptr<PreviewStream> PreviewDecoder::wrap(const std::shared_ptr<sample::Sample> &s)
+{
+    reap();
+
+    auto res = std::make_shared<PreviewStream>();
+    res->path = s->getPath();
+    res->sample = s;
+    res->managed = true;
+    res->state.store(PreviewStream::DECODED);
+    jobs.push_back({res, std::thread()});
+    return res;
+}
+
+bool PreviewDecoder::isPreviewing(const fs::path &p) const
+{
+    for (const auto &j : jobs)
+    {
+        if (!j.stream->managed && j.stream->path == p && j.stream.use_count() > 1)
+            return true;
+    }
+    return false;
+}
+
+void PreviewDecoder::release()
+{
+    cancelRunning();
+    reap();
+}
+
+void PreviewDecoder::cancelRunning(const fs::path &keep)
+{
+    // Restarting the file already decoding keeps that decode; cancelling it would fail the
+    // stream the voice is playing out from under it
+    for (auto &j : jobs)
+    {
+        if (!j.stream->managed && !keep.empty() && j.stream->path == keep)
+            continue;
+        if (j.stream->getState() == PreviewStream::DECODING)
+            j.stream->sample->decodeCancelled.store(true);
+    }
+}
+
+void PreviewDecoder::reap()
+{
+    // A worker which has set its state is on its way out so the join is short. Ones which
+    // are still going (wav, aiff and mp3 decode without looking at the cancel flag) wait
+    // for a later call rather than holding up the serial thread.
+    auto it = jobs.begin();
+    while (it != jobs.end())
+    {
+        if (it->stream->getState() == PreviewStream::DECODING)
+        {
+            ++it;
+            continue;
+        }
+        if (it->worker.joinable())
+            it->worker.join();
+
+        if (it->stream.use_count() == 1)
+            it = jobs.erase(it);
+        else
+            ++it;
+    }
+}
+} // namespace scxt::voice
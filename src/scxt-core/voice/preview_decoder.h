@@ -0,0 +1,113 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_VOICE_PREVIEW_DECODER_H
+#define SCXT_SRC_SCXT_CORE_VOICE_PREVIEW_DECODER_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utils.h"
+#include "sample/sample.h"
+
+namespace scxt::voice
+{
+/*
+ * What the preview voice plays. A file previewed from the browser decodes on a worker
+ * thread while it plays and never enters the SampleManager, so auditioning a folder leaves
+ * nothing behind to purge. Sub samples of monoliths (sf2, gig and so on) still come from
+ * the SampleManager and are wrapped as already decoded, managed streams.
+ *
+ * The sample's loader sizes and allocates it before it publishes any frames, so once
+ * sample->decodedFrames is non zero the audio thread may read everything below it.
+ */
+struct PreviewStream
+{
+    enum State : int32_t
+    {
+        DECODING,
+        DECODED,
+        FAILED
+    };
+
+    fs::path path;
+    std::shared_ptr<sample::Sample> sample;
+    std::atomic<int32_t> state{DECODING};
+    bool managed{false};
+
+    State getState() const { return (State)state.load(std::memory_order_acquire); }
+    bool sameSourceAs(const PreviewStream &other) const;
+};
+
+struct PreviewDecoder : MoveableOnly<PreviewDecoder>
+{
+    PreviewDecoder() = default;
+    ~PreviewDecoder();
+
+    /*
+     * Start decoding p on a worker thread and return the stream it fills, or hand back the
+     * stream of a decode of p we already have. Any decode still running for a different file
+     * is asked to stop.
+     */
+    std::shared_ptr<PreviewStream> start(const fs::path &p);
+
+    /*
+     * Is a stream of p held by the preview voice, or on its way to it? Only we and the voice
+     * (or the callback taking it there) hold a stream, and the voice lets go once it stops,
+     * so starting p again while this is true is the user toggling it off.
+     */
+    bool isPreviewing(const fs::path &p) const;
+
+    /*
+     * Wrap a sample the SampleManager already holds
+     */
+    std::shared_ptr<PreviewStream> wrap(const std::shared_ptr<sample::Sample> &s);
+
+    /*
+     * Cancel running decodes and free the streams the preview voice has let go of. We hold
+     * every stream until then so its sample is never freed on the audio thread.
+     */
+    void release();
+
+    size_t activeStreams() const { return jobs.size(); }
+
+  private:
+    struct Job
+    {
+        std::shared_ptr<PreviewStream> stream;
+        std::thread worker;
+    };
+    std::vector<Job> jobs;
+
+    void cancelRunning(const fs::path &keep = {});
+    void reap();
+};
+} // namespace scxt::voice
+
+#endif // SCXT_SRC_SCXT_CORE_VOICE_PREVIEW_DECODER_H
@@ -28,6 +28,7 @@
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "preview_voice.h"
 #include "dsp/generator.h"
+#include "dsp/resampling.h"
 
 namespace mech = sst::basic_blocks::mechanics;
 
@@ -43,7 +44,26 @@ struct PreviewVoice::Details
 
     PreviewVoice *parent{nullptr};
     Details(PreviewVoice *p) : parent(p) {}
+    std::shared_ptr<PreviewStream> stream;
     std::shared_ptr<sample::Sample> sample;
+    bool started{false}, primed{false};
+
+    /*
+     * Is enough of the sample decoded to render the next blocks from where we are? The
+     * generator reads a FIRipol_N window around each position so count that in too.
+     */
+    bool isDecodedAhead(int blocks) const
+    {
+        if (stream->getState() == PreviewStream::DECODED)
+            return true;
+
+        auto ready = (int64_t)sample->decodedFrames.load(std::memory_order_acquire);
+        if (ready >= (int64_t)sample->sampleLengthPerChannel)
+            return true;
+
+        auto ahead = ((int64_t)GD.ratio * blocks * blockSize) >> 24;
+        return (int64_t)GD.samplePos + ahead + dsp::FIRipol_N + 1 <= ready;
+    }
 
     void initiateGD()
     {
@@ -64,6 +84,7 @@ struct PreviewVoice::Details
             assert(false);
         }
         GDIO.waveSize = sample->sampleLengthPerChannel;
+        GDIO.zeroPaddedEdges = sample->hasZeroPaddedEdges();
 
         GD.samplePos = 0;
         GD.sampleSubPos = 0;
@@ -88,13 +109,13 @@ struct PreviewVoice::Details
 PreviewVoice::PreviewVoice() { details = std::make_unique<Details>(this); }
 PreviewVoice::~PreviewVoice() {}
 
-bool PreviewVoice::attachAndStartUnlessPlaying(const std::shared_ptr<sample::Sample> &s,
+bool PreviewVoice::attachAndStartUnlessPlaying(const std::shared_ptr<PreviewStream> &s,
                                                float amplitude)
 {
     if (isActive)
     {
-        schedulePurge = true;
-        if (s->id == details->sample->id)
+        schedulePurge = details->stream->managed;
+        if (s->sameSourceAs(*details->stream))
         {
             // You are re-starting the same playing one. This means you want
             // it stopped with our UI interaction.
@@ -103,23 +124,60 @@ bool PreviewVoice::attachAndStartUnlessPlaying(const std::shared_ptr<sample::Sam
         }
     }
 
-    details->sample = s;
+    details->stream = s;
+    details->sample = s->sample;
     details->amplitude = amplitude;
-    details->initiateGD();
+    details->started = false;
+    details->primed = false;
     isActive = true;
     return true;
 }
 bool PreviewVoice::detatchAndStop()
 {
+    // Only samples from the SampleManager leave anything to purge
+    schedulePurge = details->stream && details->stream->managed;
+    details->stream = nullptr;
     details->sample = nullptr;
+    details->started = false;
+    details->primed = false;
     // TODO : Fade
     isActive = false;
-    schedulePurge = true;
     return true;
 }
 
 void PreviewVoice::processBlock()
 {
+    auto state = details->stream->getState();
+    if (state == PreviewStream::FAILED)
+    {
+        detatchAndStop();
+        return;
+    }
+
+    if (!details->started)
+    {
+        // Length and rate are set before the first frames are published
+        if (details->sample->decodedFrames.load(std::memory_order_acquire) == 0)
+        {
+            if (state == PreviewStream::DECODED)
+                detatchAndStop();
+            else
+                memset(output, 0, sizeof(output));
+            return;
+        }
+        details->initiateGD();
+        details->started = true;
+    }
+
+    // Wait for a head start, and if playback catches the decoder hold position until
+    // it is ahead again
+    if (!details->isDecodedAhead(details->primed ? 1 : startAheadBlocks))
+    {
+        memset(output, 0, sizeof(output));
+        return;
+    }
+    details->primed = true;
+
     if (details->GD.isFinished)
     {
         detatchAndStop();
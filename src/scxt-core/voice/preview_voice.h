@@ -33,6 +33,7 @@
 #include "utils.h"
 #include "configuration.h"
 #include "sample/sample.h"
+#include "preview_decoder.h"
 
 namespace scxt::voice
 {
@@ -45,10 +46,13 @@ struct alignas(16) PreviewVoice : SampleRateSupport
     ~PreviewVoice();
 
     /***
-     * Given this sample, play it with this voice unless this vice is already playing
-     * exactly this sample, in which case, stop and release the reference
+     * Given this stream, play it with this voice unless this vice is already playing
+     * exactly this source, in which case, stop and release the reference. A stream which
+     * is still decoding starts once startAheadBlocks of it are ready, and if playback
+     * catches the decoder the voice outputs silence until it is ahead again.
      */
-    bool attachAndStartUnlessPlaying(const std::shared_ptr<sample::Sample> &, float amplitude);
+    bool attachAndStartUnlessPlaying(const std::shared_ptr<PreviewStream> &, float amplitude);
+    static constexpr int startAheadBlocks{64};
 
     /***
      * Stop playing the sample and release the reference to the sample
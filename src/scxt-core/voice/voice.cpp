@@ -33,6 +33,7 @@
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/PanLaws.h"
 #include "engine/engine.h"
+#include "modulation/modulators/shared_lfo_pool.h"
 #include "dsp/processor/routing.h"
 
 namespace scxt::voice
@@ -115,6 +116,7 @@ void Voice::voiceStarted()
     }
 
     forceOversample = zone->parentGroup->outputInfo.oversample;
+    std::fill(lfoFromSharedPool.begin(), lfoFromSharedPool.end(), false);
 
     lfosActive = zone->lfosActive;
     egsActive = zone->egsActive;
@@ -123,8 +125,8 @@ void Voice::voiceStarted()
 
     for (auto i = 0U; i < engine::lfosPerZone; ++i)
     {
-        const auto &ms = zone->modulatorStorage[i];
-        lfoEvaluator[i] = ms.isStep() ? STEP : (ms.isEnv() ? ENV : (ms.isMSEG() ? MSEG : CURVE));
+        // a newly built evaluator is assigned along with the rest below
+        setLFOEvaluator(i, evaluatorFor(zone->modulatorStorage[i]));
     }
 
     startBeat = engine->transport.timeInBeats;
@@ -142,6 +144,23 @@ void Voice::voiceStarted()
 
     // These probably need to happen after the modulator is set up
     initializeGenerator();
+
+    /*
+     * A voice pitched up far enough to alias already renders its generators at 2x. In a base
+     * rate group with shared decimation it stays at 2x to the end of the voice and the group
+     * decimates all such voices at once, rather than each running its own halfRate. That is
+     * only a saving if nothing else runs at 2x, so voices with processors keep their own.
+     */
+    if (!forceOversample && useOversampling &&
+        zone->parentGroup->outputInfo.sharedVoiceDecimation)
+    {
+        bool anyProcessor{false};
+        for (int i = 0; i < processorsPerZoneAndGroup; ++i)
+            anyProcessor = anyProcessor || (zone->processorStorage[i].isActive &&
+                                            zone->processorStorage[i].type !=
+                                                dsp::processor::proct_none);
+        forceOversample = !anyProcessor;
+    }
     initializeProcessors();
 
     for (auto i = 0U; i < engine::lfosPerZone; ++i)
@@ -153,19 +172,19 @@ void Voice::voiceStarted()
         const auto &ms = zone->modulatorStorage[i];
         if (lfoEvaluator[i] == STEP)
         {
-            stepLfos[i].setSampleRate(sampleRate, sampleRateInv);
+            stepLfo(i).setSampleRate(sampleRate, sampleRateInv);
 
-            stepLfos[i].assign(&zone->modulatorStorage[i], endpoints->lfo[i].rateP,
-                               &engine->transport, engine->rng);
+            stepLfo(i).assign(&zone->modulatorStorage[i], endpoints->lfo[i].rateP,
+                              &engine->transport, engine->rng);
         }
         else if (lfoEvaluator[i] == CURVE)
         {
-            curveLfos[i].setSampleRate(sampleRate, sampleRateInv);
-            curveLfos[i].assign(&zone->modulatorStorage[i], &engine->transport);
+            curveLfo(i).setSampleRate(sampleRate, sampleRateInv);
+            curveLfo(i).assign(&zone->modulatorStorage[i], &engine->transport);
         }
         else if (lfoEvaluator[i] == ENV)
         {
-            envLfos[i].setSampleRate(sampleRate, sampleRateInv);
+            envLfo(i).setSampleRate(sampleRate, sampleRateInv);
         }
         else
         {
@@ -325,10 +344,27 @@ void Voice::foldGeneratorIntoOutput(int gidx, int variantIndex, float *loutL, fl
 
 bool Voice::process()
 {
-    if (forceOversample)
-        return processWithOS<true>();
-    else
-        return processWithOS<false>();
+    auto res = forceOversample ? processWithOS<true>() : processWithOS<false>();
+    if (startOffset > 0)
+        applyStartOffset();
+    return res;
+}
+
+void Voice::applyStartOffset()
+{
+    // output is at the group rate, so an oversampled voice shifts twice as far
+    const int n = blockSize << (forceOversample ? 1 : 0);
+    const int d = startOffset << (forceOversample ? 1 : 0);
+    assert(d > 0 && d < n);
+
+    float spill alignas(16)[blockSize << 1];
+    for (int c = 0; c < 2; ++c)
+    {
+        memcpy(spill, output[c] + n - d, d * sizeof(float));
+        memmove(output[c] + d, output[c], (n - d) * sizeof(float));
+        memcpy(output[c], startOffsetCarry[c], d * sizeof(float));
+        memcpy(startOffsetCarry[c], spill, d * sizeof(float));
+    }
 }
 
 template <bool OS> bool Voice::processWithOS()
@@ -351,6 +387,22 @@ template <bool OS> bool Voice::processWithOS()
         {
             continue;
         }
+        if (zone->lfoCanBeShared(i))
+        {
+            if (auto *shared = engine->getSharedLFOPool()->evaluate(*this, i))
+            {
+                setLFOOutput(i, *shared);
+                lfoFromSharedPool[i] = true;
+                continue;
+            }
+        }
+        if (lfoFromSharedPool[i])
+        {
+            // our evaluator sat still while the pool ran, so re-lock it before taking over
+            lfoFromSharedPool[i] = false;
+            startLFO(i, zone->modulatorStorage[i], engine->transport, engine->rng,
+                     endpoints->lfo[i]);
+        }
         processLFOBlock(i, zone->modulatorStorage[i], isGated, engine->transport, engine->rng,
                         endpoints->lfo[i]);
     }
@@ -407,7 +459,8 @@ template <bool OS> bool Voice::processWithOS()
     doEGRetrigger[0] = false;
     auto aegGate =
         getEnvSpecificGate(envGate, zone->egStorage[0], aeg.stage, isAnyGeneratorRunning, aegSub);
-    auto aegRM = dsp::twoToTheXTable.twoToThe(*aegp.rateMulP);
+    auto aegRM = aegRateMulConversion(*aegp.rateMulP,
+                                      [](auto f) { return dsp::twoToTheXTable.twoToThe(f); });
     if constexpr (OS)
     {
         if (rtaeg)
@@ -455,7 +508,8 @@ template <bool OS> bool Voice::processWithOS()
                                              isAnyGeneratorRunning, egSub);
             }
 
-            auto egiRM = dsp::twoToTheXTable.twoToThe(*eg2p.rateMulP);
+            auto egiRM = egRateMulConversion[i](
+                *eg2p.rateMulP, [](auto f) { return dsp::twoToTheXTable.twoToThe(f); });
             eg[i].processBlockWithDelayAndRateMul(
                 *eg2p.dlyP, *eg2p.aP, *eg2p.hP, *eg2p.dP, *eg2p.sP, *eg2p.rP, *eg2p.asP, *eg2p.dsP,
                 *eg2p.rsP, egiRM, egiGate, false, zone->egStorage[i].isTemposync,
@@ -656,7 +710,8 @@ template <bool OS> bool Voice::processWithOS()
         mech::mul_block<blockSize << (OS ? 1 : 0)>(output[0], invsqrt2);
     }
 
-    auto pva = dsp::dbTable.dbToLinear(*endpoints->mappingTarget.ampP);
+    auto pva = sampleAmpConversion(*endpoints->mappingTarget.ampP,
+                                   [](auto db) { return dsp::dbTable.dbToLinear(db); });
 
     if constexpr (OS)
     {
@@ -716,13 +771,13 @@ template <bool OS> bool Voice::processWithOS()
         if constexpr (OS)                                                                          \
         {                                                                                          \
             scxt::dsp::processor::FNN<OS, false>(fpitch, processors, processorConsumesMono,        \
-                                                 processorMixOS, processorLevelOS,                 \
-                                                 endpoints.get(), chainIsMono, output);            \
+                                                 processorMixLevelOS, endpoints.get(),             \
+                                                 chainIsMono, output);                             \
         }                                                                                          \
         else                                                                                       \
         {                                                                                          \
             scxt::dsp::processor::FNN<OS, false>(fpitch, processors, processorConsumesMono,        \
-                                                 processorMix, processorLevel, endpoints.get(),    \
+                                                 processorMixLevel, endpoints.get(),               \
                                                  chainIsMono, output);                             \
         }                                                                                          \
     }                                                                                              \
@@ -731,14 +786,14 @@ template <bool OS> bool Voice::processWithOS()
         if constexpr (OS)                                                                          \
         {                                                                                          \
             scxt::dsp::processor::FNN<OS, true>(fpitch, processors, processorConsumesMono,         \
-                                                processorMixOS, processorLevelOS, endpoints.get(), \
+                                                processorMixLevelOS, endpoints.get(),              \
                                                 chainIsMono, output);                              \
         }                                                                                          \
         else                                                                                       \
         {                                                                                          \
             scxt::dsp::processor::FNN<OS, true>(fpitch, processors, processorConsumesMono,         \
-                                                processorMix, processorLevel, endpoints.get(),     \
-                                                chainIsMono, output);                              \
+                                                processorMixLevel, endpoints.get(), chainIsMono,   \
+                                                output);                                           \
         }                                                                                          \
     }
 
@@ -793,7 +848,20 @@ template <bool OS> bool Voice::processWithOS()
         {
         case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_linear:
         {
-            CALL_ROUTE(processSequential);
+            dsp::processor::compileSequentialChain(processorChain, processors,
+                                                   processorConsumesMono, chainIsMono);
+            if constexpr (OS)
+            {
+                dsp::processor::processCompiledChain<OS>(processorChain, fpitch, processors,
+                                                         processorMixLevelOS, endpoints.get(),
+                                                         chainIsMono, output);
+            }
+            else
+            {
+                dsp::processor::processCompiledChain<OS>(processorChain, fpitch, processors,
+                                                         processorMixLevel, endpoints.get(),
+                                                         chainIsMono, output);
+            }
         }
         break;
         case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_ser2:
@@ -1071,6 +1139,7 @@ void Voice::initializeGenerator()
             assert(false);
         }
         GDIO[currGen].waveSize = s->sampleLengthPerChannel;
+        GDIO[currGen].zeroPaddedEdges = s->hasZeroPaddedEdges();
 
         GD[currGen].samplePos = variantData.startSample;
         GD[currGen].sampleSubPos = 0;
@@ -1271,11 +1340,21 @@ void Voice::calculateGeneratorRatio(float pitch, int cSampleIndex, int generator
 
     float ndiff = kd + zone->parentGroup->parentPart->configuration.tuning + var.pitchOffset;
 
-    auto fac = tuning::equalTuning.note_to_pitch(ndiff);
+    auto pbr = *endpoints->mappingTarget.playbackRatioP;
+    auto sr = zone->samplePointers[cSampleIndex]->sample_rate;
+    auto &rk = generatorRatioKey[generatorIndex];
+    if (ndiff != rk.noteDiff || pbr != rk.playbackRatio || sr != rk.sampleRate ||
+        sampleRateInv != rk.sampleRateInv)
+    {
+        auto fac = tuning::equalTuning.note_to_pitch(ndiff);
 
-    GD[generatorIndex].ratio =
-        (int32_t)((1 << 24) * fac * zone->samplePointers[cSampleIndex]->sample_rate *
-                  sampleRateInv * (1.0 + *endpoints->mappingTarget.playbackRatioP));
+        rk.noteDiff = ndiff;
+        rk.playbackRatio = pbr;
+        rk.sampleRate = sr;
+        rk.sampleRateInv = sampleRateInv;
+        rk.ratio = (int32_t)((1 << 24) * fac * sr * sampleRateInv * (1.0 + pbr));
+    }
+    GD[generatorIndex].ratio = rk.ratio;
 }
 
 void Voice::initializeProcessors()
@@ -1292,14 +1371,11 @@ void Voice::initializeProcessors()
     for (auto i = 0; i < engine::processorCount; ++i)
     {
         processorIsActive[i] = zone->processorStorage[i].isActive;
-        processorMix[i].set_target_instant(*endpoints->processorTarget[i].mixP);
-        processorMixOS[i].set_target_instant(*endpoints->processorTarget[i].mixP);
-
         auto ol = *endpoints->processorTarget[i].outputLevelDbP;
         ol = ol * ol * ol * dsp::processor::ProcessorStorage::maxOutputAmp;
 
-        processorLevel[i].set_target_instant(ol);
-        processorLevelOS[i].set_target_instant(ol);
+        processorMixLevel[i].setTargetsInstant(*endpoints->processorTarget[i].mixP, ol);
+        processorMixLevelOS[i].setTargetsInstant(*endpoints->processorTarget[i].mixP, ol);
 
         processorType[i] = zone->processorStorage[i].type;
 
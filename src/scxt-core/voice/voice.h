@@ -33,12 +33,15 @@
 #include "dsp/data_tables.h"
 #include "dsp/generator.h"
 #include "dsp/processor/processor.h"
+#include "dsp/processor/routing.h"
 
 #include "modulation/voice_matrix.h"
 #include "modulation/has_modulators.h"
 
 #include "configuration.h"
 
+#include <limits>
+
 #include "sst/filters/HalfRateFilter.h"
 #include "sst/basic-blocks/dsp/BlockInterpolators.h"
 #include "sst/basic-blocks/dsp/LagCollection.h"
@@ -67,6 +70,42 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     bool forceOversample{true};
 
     std::array<dsp::GeneratorState, maxGeneratorsPerVoice> GD;
+
+    /*
+     * A held note sees the same inputs block after block, so the per block table
+     * conversions and the generator ratios are memoized against their inputs. Each is a
+     * pure function of what it keys on, so there is nothing to invalidate when a voice is
+     * reused; the NaN initial key just forces the first evaluation.
+     */
+    struct LastConversion
+    {
+        float in{std::numeric_limits<float>::quiet_NaN()};
+        float out{0.f};
+
+        template <typename F> inline float operator()(float x, F &&f)
+        {
+            if (x != in)
+            {
+                in = x;
+                out = f(x);
+            }
+            return out;
+        }
+    };
+    LastConversion aegRateMulConversion, sampleAmpConversion, glideRateConversion;
+    std::array<LastConversion, egsPerZone> egRateMulConversion;
+
+    struct GeneratorRatioKey
+    {
+        float noteDiff{std::numeric_limits<float>::quiet_NaN()};
+        float playbackRatio{0.f};
+        uint32_t sampleRate{0};
+        double sampleRateInv{0.0};
+        int32_t ratio{0};
+    };
+    std::array<GeneratorRatioKey, maxGeneratorsPerVoice> generatorRatioKey;
+    // LFOs whose last block came from the engine's SharedLFOPool rather than our evaluator
+    std::array<bool, lfosPerZone> lfoFromSharedPool{};
     std::array<dsp::GeneratorIO, maxGeneratorsPerVoice> GDIO;
     std::array<dsp::GeneratorFPtr, maxGeneratorsPerVoice> Generator;
     std::array<bool, maxGeneratorsPerVoice> monoGenerator{};
@@ -81,6 +120,8 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     uint8_t key{60};
     int32_t noteId{-1};
     uint64_t voiceCreationId{0};
+    // The VoiceGovernor's running estimate of this voice's cost; negative until it renders
+    float governorCostPercent{-1.f};
     uint8_t originalMidiKey{
         60}; // the actual physical key pressed not the one I resolved to after tuning
     float velocity{1.f};
@@ -149,7 +190,9 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
         auto glideTime = zone->parentGroup->outputInfo.glideTime;
         if (glideTime > 0.f)
         {
-            auto rate = dsp::twentyFiveSecondExpTable.lookupRate(glideTime, dsp::twoToTheXTable);
+            auto rate = glideRateConversion(glideTime, [](auto t) {
+                return dsp::twentyFiveSecondExpTable.lookupRate(t, dsp::twoToTheXTable);
+            });
 
             // In constant rate mode, scale rate by interval so larger intervals take longer
             if (zone->parentGroup->outputInfo.glideRateMode == engine::Group::CONSTANT_RATE)
@@ -278,11 +321,9 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
 
     void panOutputsBy(bool inputIsMono, const lipol &pv);
 
-    lipol processorMix[engine::processorCount];
-    lipolOS processorMixOS[engine::processorCount];
-
-    lipol processorLevel[engine::processorCount];
-    lipolOS processorLevelOS[engine::processorCount];
+    dsp::processor::ProcessorMixLevel<blockSize> processorMixLevel[engine::processorCount];
+    dsp::processor::ProcessorMixLevel<(blockSize << 1)> processorMixLevelOS[engine::processorCount];
+    dsp::processor::CompiledProcessorChain processorChain;
 
     /*
      * Voice State on Creation
@@ -354,6 +395,17 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     }
     bool firstSamplePlayback{false};
 
+    /*
+     * Where in the block the note which made this voice actually arrived. The voice renders
+     * whole blocks as always and its output then runs startOffset samples late for its whole
+     * life, so the generators, the envelopes and everything downstream begin on the right
+     * sample for the price of one short shift per block. The carry holds the samples pushed
+     * off the end of one block onto the front of the next.
+     */
+    int16_t startOffset{0};
+    float startOffsetCarry alignas(16)[2][blockSize << 1]{};
+    void applyStartOffset();
+
     void release() { setIsGated(false); }
     void beginTerminationSequence()
     {
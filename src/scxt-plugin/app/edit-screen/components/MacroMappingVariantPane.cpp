@@ -175,8 +175,7 @@ void MacroMappingVariantPane::setEditAllFromModel(bool b)
 
 void MacroMappingVariantPane::editorSelectionChanged()
 {
-    if (editor->currentLeadZoneSelection.has_value())
-        mappingDisplay->setLeadSelection(*(editor->currentLeadZoneSelection));
+    mappingDisplay->editorSelectionChanged();
 
     sampleDisplay->rebuildForSelectedVariation(sampleDisplay->selectedVariation, true);
     repaint();
@@ -416,6 +416,14 @@ void MappingDisplay::setLeadSelection(const selection::SelectionManager::ZoneAdd
     }
 }
 
+void MappingDisplay::editorSelectionChanged()
+{
+    if (editor->currentLeadZoneSelection.has_value())
+        setLeadSelection(*(editor->currentLeadZoneSelection));
+    if (mappingZones)
+        mappingZones->editorSelectionChanged();
+}
+
 int MappingDisplay::voiceCountFor(const selection::SelectionManager::ZoneAddress &z)
 {
     auto p = editor->editScreen->voiceCountByZoneAddress.find(z);
@@ -205,6 +205,7 @@ struct MappingDisplay : juce::Component,
     void setGroupZoneMappingSummary(const engine::Part::zoneMappingSummary_t &d);
 
     void setLeadSelection(const selection::SelectionManager::ZoneAddress &za);
+    void editorSelectionChanged();
 
     int voiceCountFor(const selection::SelectionManager::ZoneAddress &z);
 
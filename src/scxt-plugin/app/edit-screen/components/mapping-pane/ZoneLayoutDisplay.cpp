@@ -65,8 +65,9 @@ void ZoneLayoutDisplay::mouseDown(const juce::MouseEvent &e)
         if (display->editor->currentLeadZoneSelection.has_value())
         {
             auto cla = *display->editor->currentLeadZoneSelection;
-            for (const auto &z : display->summary)
+            for (auto zi : zonesNear(e.position))
             {
+                const auto &z = display->summary[zi];
                 if (!editor->isAnyZoneFromGroupSelected(z.address.group))
                     continue;
 
@@ -96,8 +97,9 @@ void ZoneLayoutDisplay::mouseDown(const juce::MouseEvent &e)
         else
         {
             // You clicked some random blue area. Lead select it and rmb
-            for (const auto &z : display->summary)
+            for (auto zi : zonesNear(e.position))
             {
+                const auto &z = display->summary[zi];
                 if (!editor->isAnyZoneFromGroupSelected(z.address.group))
                     continue;
 
@@ -197,8 +199,9 @@ void ZoneLayoutDisplay::mouseDown(const juce::MouseEvent &e)
     }
 
     std::vector<selection::SelectionManager::ZoneAddress> potentialZones;
-    for (auto &z : display->summary)
+    for (auto zi : zonesNear(e.position))
     {
+        const auto &z = display->summary[zi];
         auto r = rectangleForZone(z);
         if (r.contains(e.position) && display->editor->isAnyZoneFromGroupSelected(z.address.group))
         {
@@ -578,6 +581,7 @@ void ZoneLayoutDisplay::mouseDrag(const juce::MouseEvent &e)
 
         if (res != MappingDisplay::NO_CHANGE)
         {
+            zoneIndexDirty = true;
             updateCacheFromDisplay();
             display->repaint();
         }
@@ -596,6 +600,7 @@ void ZoneLayoutDisplay::mouseDrag(const juce::MouseEvent &e)
 
         if (res != MappingDisplay::NO_CHANGE)
         {
+            zoneIndexDirty = true;
             updateCacheFromDisplay();
             display->repaint();
         }
@@ -614,6 +619,7 @@ void ZoneLayoutDisplay::mouseDrag(const juce::MouseEvent &e)
 
         if (res != MappingDisplay::NO_CHANGE)
         {
+            zoneIndexDirty = true;
             updateCacheFromDisplay();
             display->repaint();
         }
@@ -639,6 +645,7 @@ void ZoneLayoutDisplay::mouseDrag(const juce::MouseEvent &e)
 
         if (res != MappingDisplay::NO_CHANGE)
         {
+            zoneIndexDirty = true;
             updateCacheFromDisplay();
             display->repaint();
         }
@@ -680,12 +687,14 @@ void ZoneLayoutDisplay::mouseUp(const juce::MouseEvent &e)
         std::vector<selection::SelectionManager::SelectActionContents> actions;
 
         auto rz = juce::Rectangle<float>(firstMousePos, e.position);
+        auto candidates = zonesNear(rz);
         bool selectedLead{false};
         if (display->editor->currentLeadZoneSelection.has_value())
         {
             const auto &sel = *(display->editor->currentLeadZoneSelection);
-            for (const auto &z : display->summary)
+            for (auto zi : candidates)
             {
+                const auto &z = display->summary[zi];
                 if (!(z.address == sel))
                     continue;
                 if (rz.intersects(rectangleForZone(z)))
@@ -696,8 +705,9 @@ void ZoneLayoutDisplay::mouseUp(const juce::MouseEvent &e)
         }
         bool firstAsLead = !selectedLead && !e.mods.isShiftDown();
         bool first = true;
-        for (const auto &z : display->summary)
+        for (auto zi : candidates)
         {
+            const auto &z = display->summary[zi];
             if (!editor->isAnyZoneFromGroupSelected(z.address.group))
                 continue;
 
@@ -811,47 +821,96 @@ juce::Rectangle<float> ZoneLayoutDisplay::rectangleForRangeSkipEnd(int kL, int k
     return {(float)x0, (float)y0, (float)(x1 - x0), (float)(y1 - y0)};
 }
 
-void ZoneLayoutDisplay::paint(juce::Graphics &g)
+void ZoneLayoutDisplay::paintBackground(juce::Graphics &g)
 {
-    if (!display)
-        g.fillAll(juce::Colours::red);
+    auto lb = getLocalBounds().toFloat().withTrimmedTop(1.f);
+    auto displayRegion = lb;
 
-    // Draw the background
+    auto dashCol = editor->themeColor(theme::ColorMap::generic_content_low, 0.4f);
+    g.setColour(dashCol);
+    g.drawVerticalLine(lb.getX() + 1, lb.getY(), lb.getY() + lb.getHeight());
+    g.drawVerticalLine(lb.getX() + lb.getWidth() - 1, lb.getY(), lb.getY() + lb.getHeight());
+    g.drawHorizontalLine(lb.getY(), lb.getX(), lb.getX() + lb.getWidth());
+    g.drawHorizontalLine(lb.getY() + lb.getHeight() - 1, lb.getX(), lb.getX() + lb.getWidth());
+
+    dashCol = dashCol.withAlpha(0.2f);
+    g.setColour(dashCol);
+
+    auto dVel = 1.0 / 4.0;
+    if (vZoom >= 2.0)
+        dVel = 1.0 / 8.0;
+    if (vZoom >= 3.0)
+        dVel = 1.0 / 16.0;
+    for (float fv = 0; fv < 1.0; fv += dVel)
     {
-        auto lb = getLocalBounds().toFloat().withTrimmedTop(1.f);
-        auto displayRegion = lb;
+        auto y = (fv - vPct) * vZoom * getHeight();
+        g.drawHorizontalLine(y, lb.getX(), lb.getX() + lb.getWidth());
+    }
 
-        auto dashCol = editor->themeColor(theme::ColorMap::generic_content_low, 0.4f);
-        g.setColour(dashCol);
-        g.drawVerticalLine(lb.getX() + 1, lb.getY(), lb.getY() + lb.getHeight());
-        g.drawVerticalLine(lb.getX() + lb.getWidth() - 1, lb.getY(), lb.getY() + lb.getHeight());
-        g.drawHorizontalLine(lb.getY(), lb.getX(), lb.getX() + lb.getWidth());
-        g.drawHorizontalLine(lb.getY() + lb.getHeight() - 1, lb.getX(), lb.getX() + lb.getWidth());
+    auto hMul = 1.0;
+    if (hZoom >= 2.0)
+        hMul = 0.5;
+    for (float f = 0; f <= 1.0; f += hMul * 12.0 / 128.0)
+    {
+        auto x = (f - hPct) * hZoom * getWidth();
+        g.drawVerticalLine(x, lb.getY(), lb.getY() + lb.getHeight());
+    }
+}
 
-        dashCol = dashCol.withAlpha(0.2f);
-        g.setColour(dashCol);
+juce::Rectangle<float> ZoneLayoutDisplay::paintZone(juce::Graphics &g,
+                                                    const engine::Part::zoneMappingItem_t &z,
+                                                    bool drawSelected)
+{
+    auto borderColor = editor->themeColor(theme::ColorMap::accent_2a);
+    auto fillColor = editor->themeColor(theme::ColorMap::accent_2b).withAlpha(0.32f);
+    auto textColor = editor->themeColor(theme::ColorMap::accent_2a);
 
-        auto dVel = 1.0 / 4.0;
-        if (vZoom >= 2.0)
-            dVel = 1.0 / 8.0;
-        if (vZoom >= 3.0)
-            dVel = 1.0 / 16.0;
-        for (float fv = 0; fv < 1.0; fv += dVel)
-        {
-            auto y = (fv - vPct) * vZoom * getHeight();
-            g.drawHorizontalLine(y, lb.getX(), lb.getX() + lb.getWidth());
-        }
+    if (z.features & engine::GroupZoneFeatures::MISSING_SAMPLE)
+    {
+        borderColor = editor->themeColor(theme::ColorMap::warning_1b);
+        fillColor = editor->themeColor(theme::ColorMap::warning_1b).withAlpha(0.32f);
+        textColor = editor->themeColor(theme::ColorMap::warning_1a);
+    }
+    if (drawSelected)
+    {
+        borderColor = editor->themeColor(theme::ColorMap::accent_1b);
+        fillColor = borderColor.withAlpha(0.32f);
+        textColor = editor->themeColor(theme::ColorMap::accent_1a);
 
-        auto hMul = 1.0;
-        if (hZoom >= 2.0)
-            hMul = 0.5;
-        for (float f = 0; f <= 1.0; f += hMul * 12.0 / 128.0)
+        if (z.features & engine::GroupZoneFeatures::MISSING_SAMPLE)
         {
-            auto x = (f - hPct) * hZoom * getWidth();
-            g.drawVerticalLine(x, lb.getY(), lb.getY() + lb.getHeight());
+            borderColor = editor->themeColor(theme::ColorMap::warning_1b);
+            fillColor = editor->themeColor(theme::ColorMap::warning_1b);
+            textColor = editor->themeColor(theme::ColorMap::warning_1a);
         }
     }
 
+    auto r = drawZone(g, z, fillColor, borderColor);
+    labelZoneRectangle(g, r, z.name, textColor);
+    return r;
+}
+
+void ZoneLayoutDisplay::paintUnselectedZones(juce::Graphics &g)
+{
+    auto lb = getLocalBounds().toFloat();
+    const auto &lead = display->editor->currentLeadZoneSelection;
+    for (const auto &z : display->summary)
+    {
+        if (!display->editor->isAnyZoneFromGroupSelected(z.address.group))
+            continue;
+
+        if (display->editor->isSelected(z.address) || z.address == lead)
+            continue;
+
+        if (!rectangleForZone(z).intersects(lb))
+            continue;
+
+        paintZone(g, z, false);
+    }
+}
+
+void ZoneLayoutDisplay::paintVoiceMarkers(juce::Graphics &g)
+{
     auto drawVoiceMarkers = [&g](const juce::Rectangle<float> &c, int ct) {
         if (ct == 0)
             return;
@@ -883,66 +942,96 @@ void ZoneLayoutDisplay::paint(juce::Graphics &g)
         }
     };
 
-    for (const auto &drawSelected : {false, true})
+    // Only sounding zones carry markers, so walk the voice map rather than the summary
+    ensureZoneIndex();
+    for (const auto &[za, ct] : editor->editScreen->voiceCountByZoneAddress)
     {
-        for (const auto &z : display->summary)
-        {
-            if (!display->editor->isAnyZoneFromGroupSelected(z.address.group))
-                continue;
-
-            if (display->editor->isSelected(z.address) != drawSelected)
-                continue;
+        auto zi = summaryIndexByAddress.find(za);
+        if (zi == summaryIndexByAddress.end())
+            continue;
+        const auto &z = display->summary[zi->second];
+        if (!display->editor->isAnyZoneFromGroupSelected(z.address.group))
+            continue;
+        drawVoiceMarkers(rectangleForZone(z), (int)ct);
+    }
+}
 
-            if (z.address == display->editor->currentLeadZoneSelection)
-                continue;
+void ZoneLayoutDisplay::renderLayer(juce::Image &into, float scale,
+                                    const std::function<void(juce::Graphics &)> &painter)
+{
+    auto w = std::max(1, (int)std::ceil(getWidth() * scale));
+    auto h = std::max(1, (int)std::ceil(getHeight() * scale));
+    if (!into.isValid() || into.getWidth() != w || into.getHeight() != h)
+        into = juce::Image(juce::Image::ARGB, w, h, true);
+    else
+        into.clear(into.getBounds());
 
-            auto r = rectangleForZone(z);
+    juce::Graphics lg(into);
+    lg.addTransform(juce::AffineTransform::scale(scale));
+    painter(lg);
+}
 
-            auto borderColor = editor->themeColor(theme::ColorMap::accent_2a);
-            auto fillColor = editor->themeColor(theme::ColorMap::accent_2b).withAlpha(0.32f);
-            auto textColor = editor->themeColor(theme::ColorMap::accent_2a);
+void ZoneLayoutDisplay::paint(juce::Graphics &g)
+{
+    if (!display)
+    {
+        g.fillAll(juce::Colours::red);
+        return;
+    }
 
-            if (z.features & engine::GroupZoneFeatures::MISSING_SAMPLE)
-            {
-                borderColor = editor->themeColor(theme::ColorMap::warning_1b);
-                fillColor = editor->themeColor(theme::ColorMap::warning_1b).withAlpha(0.32f);
-                textColor = editor->themeColor(theme::ColorMap::warning_1a);
-            }
-            if (drawSelected)
-            {
-                borderColor = editor->themeColor(theme::ColorMap::accent_1b);
-                fillColor = borderColor.withAlpha(0.32f);
-                textColor = editor->themeColor(theme::ColorMap::accent_1a);
+    auto scale = (float)g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto argb = [this](auto c) { return (uint64_t)editor->themeColor(c).getARGB(); };
+    uint64_t themeKey = (argb(theme::ColorMap::accent_2a) << 32) ^
+                        argb(theme::ColorMap::accent_2b) ^
+                        (argb(theme::ColorMap::warning_1b) << 16) ^
+                        argb(theme::ColorMap::generic_content_low);
+    if (scale != layerScale || themeKey != layerThemeKey)
+    {
+        layerScale = scale;
+        layerThemeKey = themeKey;
+        invalidateLayers();
+    }
 
-                if (z.features & engine::GroupZoneFeatures::MISSING_SAMPLE)
-                {
-                    borderColor = editor->themeColor(theme::ColorMap::warning_1b);
-                    fillColor = editor->themeColor(theme::ColorMap::warning_1b);
-                    textColor = editor->themeColor(theme::ColorMap::warning_1a);
-                }
-            }
+    if (!backgroundLayerValid)
+    {
+        renderLayer(backgroundLayer, scale, [this](auto &lg) { paintBackground(lg); });
+        backgroundLayerValid = true;
+    }
+    if (!unselectedZoneLayerValid)
+    {
+        renderLayer(unselectedZoneLayer, scale, [this](auto &lg) { paintUnselectedZones(lg); });
+        unselectedZoneLayerValid = true;
+    }
 
-            r = drawZone(g, z, fillColor, borderColor);
+    auto toLocal = juce::AffineTransform::scale(1.f / scale);
+    g.drawImageTransformed(backgroundLayer, toLocal);
+    g.drawImageTransformed(unselectedZoneLayer, toLocal);
 
-            labelZoneRectangle(g, r, z.name, textColor);
+    auto lb = getLocalBounds().toFloat();
+    for (auto zi : selectedZoneIndices)
+    {
+        if (zi >= display->summary.size())
+            continue;
+        const auto &z = display->summary[zi];
+        if (!display->editor->isAnyZoneFromGroupSelected(z.address.group))
+            continue;
+        if (z.address == display->editor->currentLeadZoneSelection)
+            continue;
+        if (!rectangleForZone(z).intersects(lb))
+            continue;
 
-            auto ct = display->voiceCountFor(z.address);
-            drawVoiceMarkers(r, ct);
-        }
+        paintZone(g, z, true);
     }
 
     if (display->editor->currentLeadZoneSelection.has_value())
     {
+        ensureZoneIndex();
         const auto &sel = *(display->editor->currentLeadZoneSelection);
+        auto li = summaryIndexByAddress.find(sel);
 
-        for (const auto &z : display->summary)
+        if (li != summaryIndexByAddress.end())
         {
-            if (!(z.address == sel))
-                continue;
-
-            const auto &kb = z.kr;
-            const auto &vel = z.vr;
-            const auto &name = z.name;
+            const auto &z = display->summary[li->second];
 
             auto selZoneColor = editor->themeColor(theme::ColorMap::accent_1a);
             auto borderColor = selZoneColor;
@@ -955,12 +1044,11 @@ void ZoneLayoutDisplay::paint(juce::Graphics &g)
             }
             auto r = drawZone(g, z, selZoneColor, borderColor);
             labelZoneRectangle(g, r, z.name, textColor);
-
-            auto ct = display->voiceCountFor(z.address);
-            drawVoiceMarkers(r, ct);
         }
     }
 
+    paintVoiceMarkers(g);
+
     if (display->isUndertakingDrop &&
         (display->currentDragSource.isNone() || display->currentDragSource.isSingleSample()))
     {
@@ -1006,8 +1094,9 @@ void ZoneLayoutDisplay::paint(juce::Graphics &g)
             juce::PathStrokeType stroke(1);       // Stroke of width 5
             juce::Array<float> dashLengths{5, 5}; // Dashes of 5px, spaces of 5px
 
-            for (const auto &z : display->summary)
+            for (auto zi : zonesNear(r))
             {
+                const auto &z = display->summary[zi];
                 if (!editor->isAnyZoneFromGroupSelected(z.address.group))
                     continue;
 
@@ -1064,8 +1153,6 @@ void ZoneLayoutDisplay::paint(juce::Graphics &g)
     }
 }
 
-void ZoneLayoutDisplay::resized() {}
-
 std::vector<ZoneLayoutDisplay::RootAndRange>
 ZoneLayoutDisplay::rootAndRangeForPosition(const juce::Point<int> &p, size_t nEls,
                                            bool isMappedInstrument)
@@ -1318,9 +1405,125 @@ void ZoneLayoutDisplay::mappingWasReset()
     }
     gcEvery++;
 
+    zoneIndexDirty = true;
+    updateSelectionPartition();
     repaint();
 }
 
+void ZoneLayoutDisplay::editorSelectionChanged()
+{
+    // which zones sit in the cached layer depends on the selection
+    unselectedZoneLayerValid = false;
+    updateSelectionPartition();
+    repaint();
+}
+
+void ZoneLayoutDisplay::updateSelectionPartition()
+{
+    /*
+     * Drags and the server echo of them rewrite the summary constantly but only move
+     * selected zones, so only throw the unselected layer away if something in it changed.
+     */
+    selectedZoneIndices.clear();
+    size_t sig{display->summary.size()};
+    auto mix = [&sig](size_t v) { sig ^= v + 0x9e3779b97f4a7c15ULL + (sig << 6) + (sig >> 2); };
+    const auto &lead = display->editor->currentLeadZoneSelection;
+    for (uint32_t i = 0; i < display->summary.size(); ++i)
+    {
+        const auto &z = display->summary[i];
+        if (display->editor->isSelected(z.address) || z.address == lead)
+        {
+            selectedZoneIndices.push_back(i);
+            continue;
+        }
+        if (!display->editor->isAnyZoneFromGroupSelected(z.address.group))
+            continue;
+
+        mix(((size_t)z.address.part << 48) ^ ((size_t)z.address.group << 24) ^
+            (size_t)z.address.zone);
+        mix(((size_t)z.kr.keyStart << 48) ^ ((size_t)z.kr.keyEnd << 32) ^
+            ((size_t)z.kr.fadeStart << 16) ^ (size_t)z.kr.fadeEnd);
+        mix(((size_t)z.vr.velStart << 48) ^ ((size_t)z.vr.velEnd << 32) ^
+            ((size_t)z.vr.fadeStart << 16) ^ (size_t)z.vr.fadeEnd);
+        mix((size_t)z.features);
+        mix(std::hash<std::string>()(z.name));
+    }
+    if (sig != unselectedZoneSignature)
+    {
+        unselectedZoneSignature = sig;
+        unselectedZoneLayerValid = false;
+    }
+}
+
+void ZoneLayoutDisplay::ZoneSpatialIndex::rebuild(const engine::Part::zoneMappingSummary_t &sum)
+{
+    for (auto &c : cells)
+        c.clear();
+
+    auto cellOf = [](int v) { return std::clamp(v, 0, 127) / cellSpan; };
+    for (uint32_t i = 0; i < sum.size(); ++i)
+    {
+        const auto &z = sum[i];
+        auto k0 = cellOf(std::min(z.kr.keyStart, z.kr.keyEnd));
+        auto k1 = cellOf(std::max(z.kr.keyStart, z.kr.keyEnd));
+        auto v0 = cellOf(std::min(z.vr.velStart, z.vr.velEnd));
+        auto v1 = cellOf(std::max(z.vr.velStart, z.vr.velEnd));
+        for (int k = k0; k <= k1; ++k)
+            for (int v = v0; v <= v1; ++v)
+                cells[k * cellsPerSide + v].push_back(i);
+    }
+}
+
+void ZoneLayoutDisplay::ZoneSpatialIndex::query(int kLo, int kHi, int vLo, int vHi,
+                                                std::vector<uint32_t> &into) const
+{
+    auto cellOf = [](int v) { return std::clamp(v, 0, 127) / cellSpan; };
+    for (int k = cellOf(kLo); k <= cellOf(kHi); ++k)
+        for (int v = cellOf(vLo); v <= cellOf(vHi); ++v)
+        {
+            const auto &c = cells[k * cellsPerSide + v];
+            into.insert(into.end(), c.begin(), c.end());
+        }
+    std::sort(into.begin(), into.end());
+    into.erase(std::unique(into.begin(), into.end()), into.end());
+}
+
+void ZoneLayoutDisplay::ensureZoneIndex()
+{
+    if (!zoneIndexDirty)
+        return;
+    zoneIndex.rebuild(display->summary);
+    summaryIndexByAddress.clear();
+    for (uint32_t i = 0; i < display->summary.size(); ++i)
+        summaryIndexByAddress.emplace(display->summary[i].address, i);
+    zoneIndexDirty = false;
+}
+
+std::vector<uint32_t> ZoneLayoutDisplay::zonesNear(const juce::Rectangle<float> &r)
+{
+    ensureZoneIndex();
+
+    // Invert rectangleForRangeSkipEnd, padded a note / velocity step either side since the
+    // exact test is done by the caller in pixel space
+    auto lb = getLocalBounds().toFloat().withTrimmedTop(2.f);
+    auto keySpan = (float)(ZoneLayoutKeyboard::lastMidiNote - ZoneLayoutKeyboard::firstMidiNote);
+    auto keyAt = [&](float x) {
+        return (x / (hZoom * std::max(lb.getWidth(), 1.f)) + hPct) * keySpan;
+    };
+    auto velAt = [&](float y) {
+        return (1.f - (y / (vZoom * std::max(lb.getHeight(), 1.f)) + vPct)) * 128.f;
+    };
+
+    auto kLo = (int)std::floor(keyAt(r.getX())) - 1;
+    auto kHi = (int)std::ceil(keyAt(r.getRight())) + 1;
+    auto vLo = (int)std::floor(velAt(r.getBottom())) - 1;
+    auto vHi = (int)std::ceil(velAt(r.getY())) + 1;
+
+    std::vector<uint32_t> res;
+    zoneIndex.query(kLo, kHi, vLo, vHi, res);
+    return res;
+}
+
 void ZoneLayoutDisplay::updateCacheFromDisplay()
 {
     if (cacheLastZone.has_value())
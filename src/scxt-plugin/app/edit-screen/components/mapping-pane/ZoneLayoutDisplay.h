@@ -40,7 +40,7 @@ struct ZoneLayoutDisplay : juce::Component, HasEditor
     MappingDisplay *display{nullptr};
     ZoneLayoutDisplay(MappingDisplay *d);
     void paint(juce::Graphics &g) override;
-    void resized() override;
+    void resized() override { invalidateLayers(); }
 
     struct RootAndRange
     {
@@ -173,6 +173,7 @@ struct ZoneLayoutDisplay : juce::Component, HasEditor
     {
         hPct = pctStart;
         hZoom = zoomFactor;
+        invalidateLayers();
         resetLeadZoneBounds();
         repaint();
     }
@@ -180,6 +181,7 @@ struct ZoneLayoutDisplay : juce::Component, HasEditor
     {
         vPct = pctStart;
         vZoom = zoomFactor;
+        invalidateLayers();
         resetLeadZoneBounds();
         repaint();
     }
@@ -189,6 +191,56 @@ struct ZoneLayoutDisplay : juce::Component, HasEditor
     juce::Rectangle<float> drawZone(juce::Graphics &g, const engine::Part::zoneMappingItem_t &z,
                                     const juce::Colour &fillColour,
                                     const juce::Colour &borderColor);
+    juce::Rectangle<float> paintZone(juce::Graphics &g, const engine::Part::zoneMappingItem_t &z,
+                                     bool selected);
+    void paintVoiceMarkers(juce::Graphics &g);
+
+    /*
+     * A coarse key/velocity bucket grid over display->summary. Hit tests ask it for
+     * the few summary indices near a point or rectangle and only do the exact pixel
+     * test on those, so a full 128x128 map doesn't walk every zone per mouse event.
+     * Indices come back ascending, so "last match wins" loops behave as before.
+     */
+    struct ZoneSpatialIndex
+    {
+        static constexpr int cellSpan{8};
+        static constexpr int cellsPerSide{128 / cellSpan};
+        std::array<std::vector<uint32_t>, cellsPerSide * cellsPerSide> cells;
+
+        void rebuild(const engine::Part::zoneMappingSummary_t &);
+        void query(int kLo, int kHi, int vLo, int vHi, std::vector<uint32_t> &into) const;
+    } zoneIndex;
+    bool zoneIndexDirty{true};
+    std::map<selection::SelectionManager::ZoneAddress, uint32_t> summaryIndexByAddress;
+    void ensureZoneIndex();
+    std::vector<uint32_t> zonesNear(const juce::Rectangle<float> &);
+    std::vector<uint32_t> zonesNear(const juce::Point<float> &p)
+    {
+        return zonesNear(juce::Rectangle<float>(p, p));
+    }
+
+    /*
+     * The grid and the unselected zones only change on zoom, resize, theme, selection
+     * or a change to an unselected zone, so they are rendered into offscreen layers.
+     * paint composites those and draws only the selected zones, lead and overlays.
+     */
+    juce::Image backgroundLayer, unselectedZoneLayer;
+    bool backgroundLayerValid{false}, unselectedZoneLayerValid{false};
+    float layerScale{0.f};
+    uint64_t layerThemeKey{0};
+    size_t unselectedZoneSignature{0};
+    std::vector<uint32_t> selectedZoneIndices;
+    void invalidateLayers()
+    {
+        backgroundLayerValid = false;
+        unselectedZoneLayerValid = false;
+    }
+    void editorSelectionChanged();
+    void updateSelectionPartition();
+    void paintBackground(juce::Graphics &g);
+    void paintUnselectedZones(juce::Graphics &g);
+    void renderLayer(juce::Image &into, float scale,
+                     const std::function<void(juce::Graphics &)> &painter);
 };
 
 } // namespace scxt::ui::app::edit_screen
@@ -138,10 +138,10 @@ bool SCXTPlugin::stateSave(const clap_ostream *ostream) noexcept
     try
     {
         auto sg = scxt::engine::Engine::StreamGuard(engine::Engine::FOR_DAW);
-        auto xml = scxt::json::streamEngineState(*engine);
+        auto state = dawStateEncoder.encode(*engine);
 
-        auto c = xml.c_str();
-        auto s = xml.length() + 1; // write the null terminator
+        auto c = state.data();
+        auto s = state.size();
         while (s > 0)
         {
             auto r = ostream->write(ostream, c, s);
@@ -187,7 +187,12 @@ bool SCXTPlugin::stateLoad(const clap_istream *istream) noexcept
         return false;
     }
 
-    auto data = std::string(buffer.data());
+    // Sessions saved before the compact format are null terminated JSON text
+    auto data = std::string(buffer.data(), totalRd);
+    if (scxt::json::isCompactDawState(data))
+        data = scxt::json::compactDawStateToMessagePayload(data);
+    else
+        data = std::string(buffer.data());
 
     engine->getMessageController()->threadingChecker.bypassThreadChecks++;
     SCLOG_IF(plugin, "State has size " << buffer.size());
@@ -313,10 +318,18 @@ SCXTPlugin::process_nonblock(const clap_process *process) SST_CPPUTILS_NONBLOCKI
             // do this before any voice creation
             engine->drainSerialToEngineQueue();
 
-            // Only realy need to run events when we do the block process
-            while (nextEvent && nextEvent->time <= s)
+            /*
+             * Only realy need to run events when we do the block process. Note ons landing
+             * inside the block about to render run now and are told how far in they are, so
+             * their voices start on the right sample; everything else waits until it is due.
+             */
+            while (nextEvent)
             {
-                handleEvent(nextEvent);
+                auto offset = engine::Engine::blockEventOffset(nextEvent->time, s,
+                                                               isNoteOnEvent(nextEvent));
+                if (!offset.has_value())
+                    break;
+                handleEvent(nextEvent, *offset);
                 nextEventIndex++;
                 if (nextEventIndex < sz)
                     nextEvent = ev->get(ev, nextEventIndex);
@@ -425,7 +438,7 @@ SCXTPlugin::process_nonblock(const clap_process *process) SST_CPPUTILS_NONBLOCKI
     // per sample if
     while (nextEvent)
     {
-        handleEvent(nextEvent);
+        handleEvent(nextEvent, 0);
         nextEventIndex++;
         if (nextEventIndex < sz)
             nextEvent = ev->get(ev, nextEventIndex);
@@ -438,7 +451,18 @@ SCXTPlugin::process_nonblock(const clap_process *process) SST_CPPUTILS_NONBLOCKI
     return CLAP_PROCESS_CONTINUE;
 }
 
-bool SCXTPlugin::handleEvent(const clap_event_header_t *nextEvent)
+bool SCXTPlugin::isNoteOnEvent(const clap_event_header_t *e)
+{
+    if (e->space_id != CLAP_CORE_EVENT_SPACE_ID)
+        return false;
+    if (e->type == CLAP_EVENT_NOTE_ON)
+        return true;
+    if (e->type == CLAP_EVENT_MIDI)
+        return engine::Engine::isMIDI1NoteOn(reinterpret_cast<const clap_event_midi *>(e)->data);
+    return false;
+}
+
+bool SCXTPlugin::handleEvent(const clap_event_header_t *nextEvent, uint32_t sampleOffset)
 {
     /*
      * This body is a hack until we do the voice manager
@@ -450,7 +474,7 @@ bool SCXTPlugin::handleEvent(const clap_event_header_t *nextEvent)
         case CLAP_EVENT_MIDI:
         {
             auto mevt = reinterpret_cast<const clap_event_midi *>(nextEvent);
-            engine->processMIDI1Event(mevt->port_index, mevt->data);
+            engine->processMIDI1Event(mevt->port_index, mevt->data, sampleOffset);
         }
         break;
 
@@ -458,7 +482,7 @@ bool SCXTPlugin::handleEvent(const clap_event_header_t *nextEvent)
         {
             auto nevt = reinterpret_cast<const clap_event_note *>(nextEvent);
             engine->processNoteOnEvent(nevt->port_index, nevt->channel, nevt->key, nevt->note_id,
-                                       nevt->velocity, 0.f);
+                                       nevt->velocity, 0.f, sampleOffset);
         }
         break;
 
@@ -45,6 +45,7 @@
 #include "sst/clap_juce_shim/clap_juce_shim.h"
 
 #include "engine/engine.h"
+#include "json/daw_state.h"
 #include "voice/voice.h"
 
 #include "clap-helpers-config.h"
@@ -73,6 +74,9 @@ struct SCXTPlugin : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     std::unique_ptr<scxt::engine::Engine> engine;
     size_t blockPos{0};
 
+    // Keeps each part's last saved encoding so host autosaves only rebuild what changed
+    scxt::json::DawStateEncoder dawStateEncoder;
+
   protected:
     bool activate(double sampleRate, uint32_t minFrameCount,
                   uint32_t maxFrameCount) noexcept override;
@@ -100,7 +104,8 @@ struct SCXTPlugin : public plugHelper_t, sst::clap_juce_shim::EditorProvider
 
     clap_process_status process(const clap_process *process) noexcept override;
     clap_process_status process_nonblock(const clap_process *process) SST_CPPUTILS_NONBLOCKING;
-    bool handleEvent(const clap_event_header_t *);
+    bool handleEvent(const clap_event_header_t *, uint32_t sampleOffset);
+    static bool isNoteOnEvent(const clap_event_header_t *);
 
     bool implementsState() const noexcept override { return true; }
     bool stateSave(const clap_ostream *stream) noexcept override;
@@ -0,0 +1,127 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "messaging/audio/inplace_callable.h"
+#include "messaging/audio/mpsc_queue.h"
+
+namespace scxta = scxt::messaging::audio;
+
+TEST_CASE("Inplace callable holds move only captures")
+{
+    using fn_t = scxta::InplaceCallable<int(int), 64>;
+
+    auto box = std::make_unique<int>(7);
+    auto watch = std::weak_ptr<int>();
+    auto shared = std::make_shared<int>(3);
+    watch = shared;
+
+    fn_t f = [b = std::move(box), s = std::move(shared)](int x) { return x * *b + *s; };
+    REQUIRE(f);
+    REQUIRE(f(2) == 17);
+    REQUIRE(!watch.expired());
+
+    SECTION("Moving carries the target and empties the source")
+    {
+        fn_t g = std::move(f);
+        REQUIRE(!f);
+        REQUIRE(g);
+        REQUIRE(g(1) == 10);
+        REQUIRE(!watch.expired());
+        g.reset();
+        REQUIRE(watch.expired());
+    }
+
+    SECTION("Reassigning destroys the previous captures")
+    {
+        f = [](int x) { return -x; };
+        REQUIRE(watch.expired());
+        REQUIRE(f(4) == -4);
+    }
+}
+
+TEST_CASE("MPSC queue delivers every push exactly once")
+{
+    static constexpr int producers{4};
+    static constexpr int perProducer{5000};
+
+    auto q = std::make_unique<scxta::MPSCQueue<int, 1024>>();
+    REQUIRE(q->empty());
+    REQUIRE(!q->pop().has_value());
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&q, p]() {
+            for (int i = 0; i < perProducer; ++i)
+            {
+                while (!q->push(p * perProducer + i))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    std::set<int> seen;
+    std::vector<int> lastFrom(producers, -1);
+    while ((int)seen.size() < producers * perProducer)
+    {
+        auto v = q->pop();
+        if (!v.has_value())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        // each producer's items arrive in the order it pushed them
+        auto from = *v / perProducer;
+        REQUIRE(*v > lastFrom[from]);
+        lastFrom[from] = *v;
+        REQUIRE(seen.insert(*v).second);
+    }
+
+    for (auto &t : threads)
+        t.join();
+    REQUIRE(q->empty());
+}
+
+TEST_CASE("MPSC queue refuses pushes when full")
+{
+    scxta::MPSCQueue<int, 4> q;
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(q.push(i));
+    REQUIRE(!q.push(99));
+    REQUIRE(*q.pop() == 0);
+    REQUIRE(q.push(4));
+    for (int i = 1; i <= 4; ++i)
+        REQUIRE(*q.pop() == i);
+    REQUIRE(q.empty());
+}
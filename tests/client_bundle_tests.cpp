@@ -0,0 +1,179 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/engine.h"
+#include "messaging/messaging.h"
+
+#include "test_utils.h"
+
+namespace cmsg = scxt::messaging::client;
+using mc_t = scxt::messaging::MessageController;
+
+namespace
+{
+std::vector<std::string> unbundle(const std::vector<std::string> &delivered)
+{
+    std::vector<std::string> res;
+    for (const auto &d : delivered)
+    {
+        auto ok = cmsg::forEachMessageInBundle(
+            d, [&res](const char *data, size_t size) { res.emplace_back(data, size); });
+        REQUIRE(ok);
+    }
+    return res;
+}
+} // namespace
+
+TEST_CASE("Client bundles deliver every message in order", "[messaging]")
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+
+    // A controller of our own, never started, so this thread plays the serialization
+    // thread and nothing else talks to the client
+    auto mc = std::make_unique<mc_t>(*eng);
+    auto bypass = mc->threadingChecker.bypassChecksInScope();
+    std::vector<std::string> delivered;
+    mc->registerClient("bundle test", [&delivered](const auto &s) { delivered.push_back(s); });
+
+    auto send = [&mc](const std::string &m, bool immediate = false) {
+        auto lk = mc->acquireClientCallbackMutex();
+        mc->deliverToClientLocked(m, immediate);
+    };
+
+    SECTION("Several messages arrive as one bundle")
+    {
+        std::vector<std::string> sent{"{\"id\":1}", "", std::string(300, 'q'), "{\"id\":4}"};
+        {
+            auto bundle = mc_t::ClientMessageBundle(*mc);
+            for (const auto &m : sent)
+                send(m);
+            REQUIRE(delivered.empty());
+        }
+        REQUIRE(delivered.size() == 1);
+        REQUIRE(unbundle(delivered) == sent);
+    }
+
+    SECTION("One message arrives bare")
+    {
+        {
+            auto bundle = mc_t::ClientMessageBundle(*mc);
+            send("{\"id\":7}");
+        }
+        REQUIRE(delivered.size() == 1);
+        REQUIRE(delivered[0] == "{\"id\":7}");
+    }
+
+    SECTION("A bundle past the flush size goes early and the rest follows")
+    {
+        std::vector<std::string> sent{"{\"id\":1}", "{\"id\":2}",
+                                      std::string(mc_t::clientBundleFlushBytes, 'x'),
+                                      "{\"id\":4}", "{\"id\":5}"};
+        {
+            auto bundle = mc_t::ClientMessageBundle(*mc);
+            for (int i = 0; i < 3; ++i)
+                send(sent[i]);
+            REQUIRE(delivered.size() == 1);
+            send(sent[3]);
+            send(sent[4]);
+            REQUIRE(delivered.size() == 1);
+        }
+        REQUIRE(delivered.size() == 2);
+        REQUIRE(unbundle(delivered) == sent);
+    }
+
+    SECTION("An immediate message flushes what is ahead of it")
+    {
+        std::vector<std::string> sent{"{\"id\":1}", "{\"id\":2}", "{\"id\":3}", "{\"id\":4}"};
+        {
+            auto bundle = mc_t::ClientMessageBundle(*mc);
+            send(sent[0]);
+            send(sent[1]);
+            send(sent[2], true);
+            send(sent[3]);
+        }
+        REQUIRE(delivered.size() == 3);
+        REQUIRE(unbundle(delivered) == sent);
+    }
+
+    mc->unregisterClient();
+}
+
+TEST_CASE("Malformed client bundles are rejected", "[messaging]")
+{
+    std::string bundle(cmsg::clientBundleMagic, sizeof(cmsg::clientBundleMagic));
+    auto frame = [&bundle](const std::string &m) {
+        auto sz = (uint32_t)m.size();
+        for (int i = 0; i < 4; ++i)
+            bundle.push_back((char)((sz >> (8 * i)) & 0xFF));
+        bundle += m;
+    };
+    frame("{\"id\":1}");
+    frame("{\"id\":2}");
+
+    int calls{0};
+    auto count = [&calls](const char *, size_t) { calls++; };
+    REQUIRE(cmsg::forEachMessageInBundle(bundle, count));
+    REQUIRE(calls == 2);
+
+    SECTION("A frame cut short")
+    {
+        calls = 0;
+        REQUIRE(!cmsg::forEachMessageInBundle(bundle.substr(0, bundle.size() - 1), count));
+        REQUIRE(calls == 0);
+    }
+
+    SECTION("A length header cut short")
+    {
+        calls = 0;
+        frame("");
+        REQUIRE(!cmsg::forEachMessageInBundle(bundle.substr(0, bundle.size() - 2), count));
+        REQUIRE(calls == 0);
+    }
+
+    SECTION("A length past the end")
+    {
+        calls = 0;
+        bundle += std::string("\xff\xff\xff\x7f", 4);
+        REQUIRE(!cmsg::forEachMessageInBundle(bundle, count));
+        REQUIRE(calls == 0);
+    }
+
+    SECTION("A DAW state header is not a bundle")
+    {
+        // see json/daw_state.h; a DAW state handed over by mistake must not be walked
+        std::string daw("SCXB\x01\x00\x00\x00", 8);
+        calls = 0;
+        REQUIRE(cmsg::forEachMessageInBundle(daw, count));
+        REQUIRE(calls == 1);
+    }
+}
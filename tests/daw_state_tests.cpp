@@ -0,0 +1,208 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include <cstring>
+
+#include "catch2/catch2.hpp"
+
+#include "console_harness.h"
+#include "engine/engine.h"
+#include "engine/patch.h"
+#include "engine/zone.h"
+#include "selection/selection_manager.h"
+#include "json/stream.h"
+#include "json/daw_state.h"
+#include "test_utils.h"
+
+namespace
+{
+std::unique_ptr<scxt::engine::Engine> engineWithTwoZones()
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+    auto &part = *eng->getPatch()->getPart(0);
+    part.addGroup();
+    addBlankZoneToGroup(part, 0, 36, 47);
+    addBlankZoneToGroup(part, 0, 48, 59);
+    return eng;
+}
+
+std::string encodeForDaw(scxt::json::DawStateEncoder &enc, const scxt::engine::Engine &e)
+{
+    auto sg = scxt::engine::Engine::StreamGuard(scxt::engine::Engine::FOR_DAW);
+    return enc.encode(e);
+}
+
+void unstreamOnTestThread(scxt::engine::Engine &e, const std::string &data)
+{
+    auto bg = e.getMessageController()->threadingChecker.bypassChecksInScope();
+    scxt::json::unstreamEngineState(e, data);
+}
+} // namespace
+
+TEST_CASE("Compact DAW state round trips", "[daw-state]")
+{
+    auto eng = engineWithTwoZones();
+    strncpy(eng->getPatch()->getPart(0)->configuration.name, "Round Trip",
+            sizeof(eng->getPatch()->getPart(0)->configuration.name));
+
+    scxt::json::DawStateEncoder enc;
+    auto state = encodeForDaw(enc, *eng);
+    REQUIRE(scxt::json::isCompactDawState(state));
+
+    SECTION("As written to the host")
+    {
+        std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine());
+        unstreamOnTestThread(*reloaded, state);
+
+        auto &rpart = *reloaded->getPatch()->getPart(0);
+        REQUIRE(rpart.getGroups().size() == 1);
+        REQUIRE(rpart.getGroup(0)->getZones().size() == 2);
+        REQUIRE(rpart.getGroup(0)->getZone(1)->mapping.keyboardRange.keyStart == 48);
+        REQUIRE(std::string(rpart.configuration.name) == "Round Trip");
+    }
+
+    SECTION("As carried by the unstream message")
+    {
+        auto payload = scxt::json::compactDawStateToMessagePayload(state);
+        REQUIRE(scxt::json::isCompactDawState(payload));
+
+        std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine());
+        unstreamOnTestThread(*reloaded, payload);
+        REQUIRE(reloaded->getPatch()->getPart(0)->getGroup(0)->getZones().size() == 2);
+    }
+
+    SECTION("Legacy JSON still loads")
+    {
+        std::string json;
+        {
+            auto sg = scxt::engine::Engine::StreamGuard(scxt::engine::Engine::FOR_DAW);
+            json = scxt::json::streamEngineState(*eng);
+        }
+        REQUIRE(!scxt::json::isCompactDawState(json));
+
+        std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine());
+        unstreamOnTestThread(*reloaded, json);
+        REQUIRE(reloaded->getPatch()->getPart(0)->getGroup(0)->getZones().size() == 2);
+    }
+
+    SECTION("A truncated state is an error, not a crash")
+    {
+        std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine());
+        REQUIRE_THROWS(unstreamOnTestThread(*reloaded, state.substr(0, state.size() / 2)));
+    }
+}
+
+TEST_CASE("Compact DAW state reuses unchanged parts", "[daw-state]")
+{
+    auto eng = engineWithTwoZones();
+    auto &part = *eng->getPatch()->getPart(0);
+
+    scxt::json::DawStateEncoder enc;
+    auto first = encodeForDaw(enc, *eng);
+    REQUIRE(encodeForDaw(enc, *eng) == first);
+
+    // An edit which nothing reported is, by design, not seen; this is what the
+    // generation bump after each message is for
+    part.getGroup(0)->getZone(0)->mapping.keyboardRange.keyStart = 30;
+    REQUIRE(encodeForDaw(enc, *eng) == first);
+
+    SECTION("Another part moving leaves this one alone")
+    {
+        eng->markPartStreamStateChanged(3);
+        REQUIRE(encodeForDaw(enc, *eng) == first);
+    }
+
+    SECTION("Its own generation moving re-encodes it")
+    {
+        eng->markPartStreamStateChanged(0);
+        auto second = encodeForDaw(enc, *eng);
+        REQUIRE(second != first);
+
+        std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine());
+        unstreamOnTestThread(*reloaded, second);
+        REQUIRE(reloaded->getPatch()->getPart(0)->getGroup(0)->getZone(0)->mapping.keyboardRange
+                    .keyStart == 30);
+    }
+}
+
+TEST_CASE("Compact DAW state keeps edits made through messages", "[daw-state]")
+{
+    namespace cmsg = scxt::messaging::client;
+    using ZMD = scxt::engine::Zone::ZoneMappingData;
+
+    scxt::clients::console_ui::ConsoleHarness th;
+    th.start();
+    th.stepUI();
+
+    auto send = [&th](const auto &msg) {
+        th.sendToSerialization(msg);
+        th.stepUI(30);
+    };
+
+    // a new zone becomes the lead selection, which has to be in the selected part
+    send(cmsg::AddBlankZone({0, 0, 48, 59, 0, 127}));
+    send(cmsg::SelectPart(1));
+    send(cmsg::AddBlankZone({1, 0, 60, 71, 0, 127}));
+    auto &eng = *th.engine;
+    REQUIRE(eng.getPatch()->getPart(0)->getGroup(0)->getZones().size() == 1);
+    REQUIRE(eng.getPatch()->getPart(1)->getGroup(0)->getZones().size() == 1);
+
+    scxt::json::DawStateEncoder enc;
+    auto panAfterReload = [&](int part) {
+        auto state = encodeForDaw(enc, eng);
+        std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine());
+        unstreamOnTestThread(*reloaded, state);
+        return reloaded->getPatch()->getPart(part)->getGroup(0)->getZone(0)->mapping.pan;
+    };
+
+    SECTION("A zone in the selected part")
+    {
+        send(cmsg::SelectPart(0));
+        send(cmsg::ApplySelectActions({{0, 0, 0, true, true, true}}));
+        REQUIRE(panAfterReload(0) == 0.f);
+
+        send(cmsg::UpdateZoneMappingFloatValue({offsetof(ZMD, pan), 0.35f}));
+        REQUIRE(eng.getPatch()->getPart(0)->getGroup(0)->getZone(0)->mapping.pan == 0.35f);
+        REQUIRE(panAfterReload(0) == 0.35f);
+    }
+
+    SECTION("A selected zone outside the selected part")
+    {
+        // lead in part 0, with part 1's zone added to the selection alongside it
+        send(cmsg::SelectPart(0));
+        send(cmsg::ApplySelectActions({{0, 0, 0, true, true, true}}));
+        send(cmsg::ApplySelectActions({{1, 0, 0, true, false, false}}));
+        const auto &sm = eng.getSelectionManager();
+        REQUIRE(sm->currentlySelectedPart(eng) == 0);
+        REQUIRE(sm->currentlySelectedZones().count({1, 0, 0}) == 1);
+        REQUIRE(panAfterReload(1) == 0.f);
+
+        send(cmsg::UpdateZoneMappingFloatValue({offsetof(ZMD, pan), -0.6f}));
+        REQUIRE(eng.getPatch()->getPart(1)->getGroup(0)->getZone(0)->mapping.pan == -0.6f);
+        REQUIRE(panAfterReload(1) == -0.6f);
+    }
+}
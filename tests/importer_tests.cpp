@@ -473,3 +473,60 @@ TEST_CASE("loadMulti on a non-SCXT RIFF errors instead of crashing", "[importer]
     std::error_code ec;
     fs::remove(tmp, ec);
 }
+
+TEST_CASE("Monolith multi round trips its embedded samples", "[importer][patch_io]")
+{
+    // The monolith writer streams sample files into chunks after the RIFF is saved,
+    // and the reader decodes them straight from a mapping of the saved file.
+    auto p = fixturePath("WavStereo48k.wav");
+    REQUIRE(fs::exists(p));
+    auto tmp = fs::temp_directory_path() / "scxt_monolith_roundtrip.scm";
+
+    size_t origLength{0};
+    std::vector<float> origHead;
+    {
+        ImporterFixture f;
+        f.loadSample(p);
+        REQUIRE(f.part0().getGroups().size() == 1);
+        auto &z = f.part0().getGroups()[0]->getZones()[0];
+        auto smp = z->samplePointers[0];
+        REQUIRE(smp);
+        origLength = smp->getSampleLength();
+        auto *d = smp->GetSamplePtrF32(0);
+        REQUIRE(d);
+        origHead.assign(d, d + std::min<size_t>(origLength, 256));
+
+        auto bypass = f.engine().getMessageController()->threadingChecker.bypassChecksInScope();
+        REQUIRE(scxt::patch_io::saveMulti(tmp, f.engine(), scxt::patch_io::AS_MONOLITH));
+    }
+
+    // the whole source file is in there, byte for byte
+    auto slurp = [](const fs::path &q) {
+        std::ifstream i(q, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(i), std::istreambuf_iterator<char>());
+    };
+    auto wav = slurp(p);
+    auto mono = slurp(tmp);
+    CHECK(mono.find(wav) != std::string::npos);
+
+    {
+        ImporterFixture f;
+        auto bypass = f.engine().getMessageController()->threadingChecker.bypassChecksInScope();
+        REQUIRE(scxt::patch_io::loadMulti(tmp, f.engine()));
+        f.th.stepUI(50);
+
+        REQUIRE(f.part0().getGroups().size() == 1);
+        auto &z = f.part0().getGroups()[0]->getZones()[0];
+        auto smp = z->samplePointers[0];
+        REQUIRE(smp);
+        CHECK(smp->type == scxt::sample::Sample::SCXT_FILE);
+        REQUIRE(smp->getSampleLength() == origLength);
+        auto *d = smp->GetSamplePtrF32(0);
+        REQUIRE(d);
+        for (size_t i = 0; i < origHead.size(); ++i)
+            CHECK(d[i] == origHead[i]);
+    }
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
@@ -0,0 +1,160 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "engine/engine.h"
+#include "engine/zone.h"
+#include "browser/browser_db.h"
+#include "infrastructure/md5support.h"
+#include "json/stream.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// A patch with one zone playing the file at p, as a saved session string
+std::string sessionPlaying(const fs::path &p, const fs::path &storage)
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine(storage));
+    auto &part = *eng->getPatch()->getPart(0);
+    part.addGroup();
+    auto z = std::make_unique<scxt::engine::Zone>();
+    z->mapping.keyboardRange = {0, 127};
+    z->mapping.velocityRange = {0, 127};
+    z->initialize();
+    part.getGroup(0)->addZone(z);
+    auto *zone = part.getGroup(0)->getZone(0).get();
+
+    auto bypass = eng->getMessageController()->threadingChecker.bypassChecksInScope();
+    auto sid = eng->getSampleManager()->loadSampleByPath(p);
+    REQUIRE(sid.has_value());
+    zone->variantData.variants[0].sampleID = *sid;
+    zone->variantData.variants[0].active = true;
+    return scxt::json::streamEngineState(*eng);
+}
+
+/*
+ * The scanner writes rows from its own threads, so wait until the one we want shows up.
+ * The database is the test's own but the mtime check keeps this honest if one is reused.
+ */
+bool waitForIndexRow(scxt::engine::Engine &e, const std::string &md5, const fs::path &p)
+{
+    auto mtime = std::chrono::duration_cast<std::chrono::seconds>(
+                     fs::last_write_time(p).time_since_epoch())
+                     .count();
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto hits = e.getBrowserDB()->findFilesByMD5({md5});
+        for (const auto &f : hits[md5])
+            if (f.path == p && f.mtime == (uint64_t)mtime)
+                return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+std::shared_ptr<scxt::sample::Sample> sampleOfFirstZone(scxt::engine::Engine &e)
+{
+    auto &part = *e.getPatch()->getPart(0);
+    REQUIRE(part.getGroups().size() == 1);
+    REQUIRE(part.getGroup(0)->getZones().size() == 1);
+    auto &sid = part.getGroup(0)->getZone(0)->variantData.variants[0].sampleID;
+    return e.getSampleManager()->getSample(sid);
+}
+} // namespace
+
+TEST_CASE("Missing samples relink from the browser index", "[sample][missing]")
+{
+    auto root = fs::temp_directory_path() / "scxt_relink_from_index_test";
+    auto was = root / "was", moved = root / "moved";
+    // the engines keep their browser database here, not in the user's documents
+    auto storage = root / "storage";
+    fs::remove_all(root);
+    fs::create_directories(was);
+    fs::create_directories(moved);
+
+    auto src = samplePath("WavStereo48k.wav");
+    REQUIRE(fs::exists(src));
+    auto md5 = scxt::infrastructure::createMD5SumFromFile(src);
+
+    fs::copy_file(src, was / "relink.wav");
+    auto saved = sessionPlaying(was / "relink.wav", storage);
+
+    // the library moved and the browser indexed its new home
+    fs::rename(was / "relink.wav", moved / "relink.wav");
+
+    std::unique_ptr<scxt::engine::Engine> reloaded(makeEngine(storage));
+    reloaded->getBrowserDB()->reindexLocation(moved);
+    REQUIRE(waitForIndexRow(*reloaded, md5, moved / "relink.wav"));
+
+    SECTION("A current row relinks")
+    {
+        {
+            auto bg = reloaded->getMessageController()->threadingChecker.bypassChecksInScope();
+            scxt::json::unstreamEngineState(*reloaded, saved);
+        }
+        auto smp = sampleOfFirstZone(*reloaded);
+        REQUIRE(smp);
+        CHECK(!smp->isMissingPlaceholder);
+        CHECK(smp->getPath() == moved / "relink.wav");
+        CHECK(smp->md5Sum == md5);
+    }
+
+    SECTION("A row the file no longer matches stays missing")
+    {
+        // different audio of the same size and mtime, so only the content can tell
+        auto p = moved / "relink.wav";
+        auto mtime = fs::last_write_time(p);
+        auto size = fs::file_size(p);
+        {
+            std::fstream f(p, std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp(size - 64);
+            std::vector<char> noise(64, 0x5a);
+            f.write(noise.data(), noise.size());
+        }
+        fs::last_write_time(p, mtime);
+        REQUIRE(fs::file_size(p) == size);
+        REQUIRE(scxt::infrastructure::createMD5SumFromFile(p) != md5);
+
+        {
+            auto bg = reloaded->getMessageController()->threadingChecker.bypassChecksInScope();
+            scxt::json::unstreamEngineState(*reloaded, saved);
+        }
+        auto smp = sampleOfFirstZone(*reloaded);
+        REQUIRE(smp);
+        CHECK(smp->getPath() != p);
+    }
+
+    reloaded.reset();
+    fs::remove_all(root);
+}
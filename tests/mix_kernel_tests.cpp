@@ -0,0 +1,275 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * The part mix and the zone voice sum write their first contributor rather than clearing and
+ * accumulating. These hold the fused kernels to the separate scale, pan and sum loops they
+ * replaced, and the zone to a plain sum of its voices, including the block where nothing
+ * sounds and the output still has to come back cleared.
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "dsp/mix_kernels.h"
+#include "engine/engine.h"
+#include "engine/group.h"
+#include "engine/part.h"
+#include "engine/zone.h"
+#include "voice/voice.h"
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+namespace pl = sst::basic_blocks::dsp::pan_laws;
+
+namespace
+{
+constexpr size_t mixN{scxt::blockSize};
+
+struct Pair
+{
+    float d alignas(16)[2][mixN];
+};
+
+Pair noise(std::mt19937 &gen, bool mono)
+{
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    Pair res;
+    for (size_t i = 0; i < mixN; ++i)
+    {
+        res.d[0][i] = dist(gen);
+        res.d[1][i] = mono ? res.d[0][i] : dist(gen);
+    }
+    return res;
+}
+
+// Part::process before the fused kernel: scale into a temporary, pan it, then copy or sum
+void referenceMix(const std::vector<Pair> &in, float lev, float pan, Pair &out)
+{
+    pl::panmatrix_t pmat{1, 1, 0, 0};
+    if (pan != 0)
+        pl::stereoEqualPower(0.5 * (pan + 1), pmat);
+
+    memset(out.d, 0, sizeof(out.d));
+    for (const auto &p : in)
+    {
+        float lcp[2][mixN];
+        for (size_t i = 0; i < mixN; ++i)
+        {
+            lcp[0][i] = p.d[0][i] * lev;
+            lcp[1][i] = p.d[1][i] * lev;
+        }
+        if (pan != 0)
+        {
+            for (size_t i = 0; i < mixN; ++i)
+            {
+                auto il = lcp[0][i];
+                auto ir = lcp[1][i];
+                lcp[0][i] = pmat[0] * il + pmat[2] * ir;
+                lcp[1][i] = pmat[1] * ir + pmat[3] * il;
+            }
+        }
+        for (size_t i = 0; i < mixN; ++i)
+        {
+            out.d[0][i] += lcp[0][i];
+            out.d[1][i] += lcp[1][i];
+        }
+    }
+}
+
+void fusedMix(const std::vector<Pair> &in, float lev, float pan, Pair &out)
+{
+    pl::panmatrix_t pmat{1, 1, 0, 0};
+    if (pan != 0)
+        pl::stereoEqualPower(0.5 * (pan + 1), pmat);
+
+    // start from garbage; the first writer must overwrite it
+    for (size_t i = 0; i < mixN; ++i)
+        out.d[0][i] = out.d[1][i] = 1234.f;
+
+    bool assigned{false};
+    for (const auto &p : in)
+    {
+        if (assigned)
+            scxt::dsp::scalePanMix<mixN, true>(p.d[0], p.d[1], lev, pmat, out.d[0], out.d[1]);
+        else
+            scxt::dsp::scalePanMix<mixN, false>(p.d[0], p.d[1], lev, pmat, out.d[0], out.d[1]);
+        assigned = true;
+    }
+    if (!assigned)
+        memset(out.d, 0, sizeof(out.d));
+}
+} // namespace
+
+TEST_CASE("Fused scale pan mix matches the separate loops", "[dsp][mix]")
+{
+    std::mt19937 gen(8675309);
+
+    for (auto mono : {true, false})
+    {
+        for (int voices : {0, 1, 2, 7})
+        {
+            for (auto pan : {0.f, -0.6f, 0.35f, 1.f})
+            {
+                DYNAMIC_SECTION("mono=" << mono << " voices=" << voices << " pan=" << pan)
+                {
+                    std::vector<Pair> in;
+                    for (int v = 0; v < voices; ++v)
+                        in.push_back(noise(gen, mono));
+
+                    auto lev = 0.8f * 0.8f * 0.8f;
+                    Pair ref, fused;
+                    referenceMix(in, lev, pan, ref);
+                    fusedMix(in, lev, pan, fused);
+
+                    for (int c = 0; c < 2; ++c)
+                    {
+                        for (size_t i = 0; i < mixN; ++i)
+                        {
+                            INFO("channel " << c << " sample " << i);
+                            // the fused pass folds level into the matrix so rounds once less
+                            REQUIRE(fused.d[c][i] ==
+                                    Approx(ref.d[c][i]).margin(1e-6).epsilon(1e-5));
+                        }
+                    }
+                    if (mono && pan == 0.f)
+                    {
+                        for (size_t i = 0; i < mixN; ++i)
+                            REQUIRE(fused.d[0][i] == fused.d[1][i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Copy or accumulate writes then sums", "[dsp][mix]")
+{
+    std::mt19937 gen(2112);
+    for (auto mono : {true, false})
+    {
+        auto a = noise(gen, mono);
+        auto b = noise(gen, mono);
+
+        Pair out;
+        for (size_t i = 0; i < mixN; ++i)
+            out.d[0][i] = out.d[1][i] = -99.f;
+
+        scxt::dsp::copyOrAccumulate<mixN>(false, a.d[0], a.d[1], out.d[0], out.d[1]);
+        for (int c = 0; c < 2; ++c)
+            for (size_t i = 0; i < mixN; ++i)
+                REQUIRE(out.d[c][i] == a.d[c][i]);
+
+        scxt::dsp::copyOrAccumulate<mixN>(true, b.d[0], b.d[1], out.d[0], out.d[1]);
+        for (int c = 0; c < 2; ++c)
+            for (size_t i = 0; i < mixN; ++i)
+                REQUIRE(out.d[c][i] == a.d[c][i] + b.d[c][i]);
+    }
+}
+
+TEST_CASE("Zone output is the sum of its voices", "[dsp][mix]")
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+
+    auto &part = *eng->getPatch()->getPart(0);
+    part.addGroup();
+    auto *group = part.getGroup(0).get();
+
+    auto z = std::make_unique<scxt::engine::Zone>();
+    z->mapping.keyboardRange = {0, 127};
+    z->mapping.velocityRange = {0, 127};
+    z->mapping.rootKey = 60;
+    z->initialize();
+    group->addZone(z);
+    auto *zone = group->getZone(0).get();
+
+    auto p = samplePath("WavStereo48k.wav");
+    REQUIRE(fs::exists(p));
+    {
+        auto bypass = eng->getMessageController()->threadingChecker.bypassChecksInScope();
+        auto sid = eng->getSampleManager()->loadSampleByPath(p);
+        REQUIRE(sid.has_value());
+        zone->variantData.variants[0].sampleID = *sid;
+        zone->variantData.variants[0].active = true;
+        REQUIRE(zone->attachToSample(*eng->getSampleManager(), 0,
+                                     scxt::engine::Zone::SampleInformationRead::ENDPOINTS));
+    }
+
+    auto checkSum = [&](int expectedVoices) {
+        REQUIRE((int)zone->activeVoices == expectedVoices);
+        for (int c = 0; c < 2; ++c)
+        {
+            for (int i = 0; i < scxt::blockSize; ++i)
+            {
+                float sum{0.f};
+                for (int v = 0; v < (int)zone->activeVoices; ++v)
+                    sum += zone->voiceWeakPointers[v]->output[c][i];
+                INFO("channel " << c << " sample " << i);
+                REQUIRE(zone->output[c][i] == sum);
+            }
+        }
+    };
+
+    SECTION("No voices clears what was there")
+    {
+        for (int c = 0; c < 2; ++c)
+            for (auto &f : zone->output[c])
+                f = 17.f;
+        zone->process(*eng);
+        for (int c = 0; c < 2; ++c)
+            for (auto &f : zone->output[c])
+                REQUIRE(f == 0.f);
+    }
+
+    SECTION("One voice")
+    {
+        eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f);
+        for (int b = 0; b < 8; ++b)
+        {
+            eng->processAudio();
+            checkSum(1);
+        }
+    }
+
+    SECTION("Several voices")
+    {
+        for (auto k : {55, 60, 64, 67})
+            eng->processNoteOnEvent(0, 0, k, -1, 1.f, 0.f);
+        for (int b = 0; b < 8; ++b)
+        {
+            eng->processAudio();
+            checkSum(4);
+        }
+    }
+}
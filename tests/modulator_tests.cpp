@@ -30,6 +30,14 @@
 #include "engine/zone.h"
 #include "modulation/modulator_storage.h"
 #include "modulation/has_modulators.h"
+#include "modulation/modulators/shared_lfo_pool.h"
+#include "voice/voice.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "test_utils.h"
 
 // Use the Zone instantiation of HasModulators to access evaluateGate and the Stage type.
 // evaluateGate is static so no Zone object is needed.
@@ -331,7 +339,7 @@ int countEnvPeaks(scxt::engine::Engine *e, scxt::engine::Group *g, int maxBlocks
     {
         g->processLFOBlock(0, g->modulatorStorage[0], /*gate=*/true, e->transport, e->rng,
                            g->endpoints.lfo[0]);
-        auto o = g->envLfos[0].output;
+        auto o = g->envLfo(0).output;
         if (armed && o > 0.9f)
         {
             peaks++;
@@ -453,7 +461,7 @@ TEST_CASE("ONESHOT curve LFO without an envelope runs one cycle then silence")
     auto e = std::make_unique<scxt::engine::Engine>();
     auto *g = setupCurveLFOGroup(e.get(), MS::ONESHOT, /*useEnv=*/false);
 
-    auto out = runLFOBlocks(e.get(), g, g->curveLfos[0].output, 3 * blocksPerSecond);
+    auto out = runLFOBlocks(e.get(), g, g->curveLfo(0).output, 3 * blocksPerSecond);
 
     // The cycle itself runs full scale...
     REQUIRE(maxAbsOver(out, 0, blocksPerSecond - 10) > 0.9f);
@@ -466,7 +474,7 @@ TEST_CASE("ONESHOT curve LFO with an envelope keeps cycling under its envelope")
     auto e = std::make_unique<scxt::engine::Engine>();
     auto *g = setupCurveLFOGroup(e.get(), MS::ONESHOT, /*useEnv=*/true);
 
-    auto out = runLFOBlocks(e.get(), g, g->curveLfos[0].output, 3 * blocksPerSecond);
+    auto out = runLFOBlocks(e.get(), g, g->curveLfo(0).output, 3 * blocksPerSecond);
 
     // The 25 second release is nowhere near done, so the LFO is still going well past
     // the one cycle mark the envelope-free one shot stops at
@@ -478,7 +486,7 @@ TEST_CASE("Non-ONESHOT curve LFO free runs past its first cycle")
     auto e = std::make_unique<scxt::engine::Engine>();
     auto *g = setupCurveLFOGroup(e.get(), MS::KEYTRIGGER, /*useEnv=*/false);
 
-    auto out = runLFOBlocks(e.get(), g, g->curveLfos[0].output, 3 * blocksPerSecond);
+    auto out = runLFOBlocks(e.get(), g, g->curveLfo(0).output, 3 * blocksPerSecond);
 
     REQUIRE(maxAbsOver(out, 2 * blocksPerSecond, 3 * blocksPerSecond) > 0.9f);
 }
@@ -488,7 +496,7 @@ TEST_CASE("ONESHOT step LFO plays every step once then holds the last one")
     auto e = std::make_unique<scxt::engine::Engine>();
     auto *g = setupStepLFOGroup(e.get(), MS::ONESHOT);
 
-    auto out = runLFOBlocks(e.get(), g, g->stepLfos[0].output, 3 * blocksPerSecond);
+    auto out = runLFOBlocks(e.get(), g, g->stepLfo(0).output, 3 * blocksPerSecond);
 
     // All four steps play, including the last one
     auto blocksPerStep = blocksPerSecond / 4;
@@ -508,7 +516,242 @@ TEST_CASE("Non-ONESHOT step LFO loops the sequence")
     auto e = std::make_unique<scxt::engine::Engine>();
     auto *g = setupStepLFOGroup(e.get(), MS::KEYTRIGGER);
 
-    auto out = runLFOBlocks(e.get(), g, g->stepLfos[0].output, 3 * blocksPerSecond);
+    auto out = runLFOBlocks(e.get(), g, g->stepLfo(0).output, 3 * blocksPerSecond);
 
     REQUIRE(maxAbsOver(out, 2 * blocksPerSecond, 3 * blocksPerSecond) > 0.9f);
 }
+
+TEST_CASE("An LFO slot holds only the evaluator its shape asks for")
+{
+    using G = scxt::engine::Group;
+    using Slot = G::LFOSlot;
+    static_assert(sizeof(Slot) < sizeof(Slot::step_t) + sizeof(Slot::curve_t) +
+                                     sizeof(Slot::env_t));
+
+    auto e = std::make_unique<scxt::engine::Engine>();
+    auto *g = makeLFOGroup(e.get());
+    auto &ms = g->modulatorStorage[0];
+
+    ms.modulatorShape = MS::STEP;
+    g->rePrepareAndBindGroupMatrix();
+    REQUIRE(g->lfoEvaluator[0] == G::STEP);
+    REQUIRE(g->lfoSlots[0].held == G::STEP);
+
+    // Asking for what is already there keeps it, and its state, as it is
+    REQUIRE_FALSE(g->setLFOEvaluator(0, G::STEP));
+
+    ms.modulatorShape = MS::LFO_ENV;
+    g->rePrepareAndBindGroupMatrix();
+    REQUIRE(g->lfoSlots[0].held == G::ENV);
+    REQUIRE(g->envLfo(0).output == 0.f);
+
+    ms.modulatorShape = MS::LFO_SINE;
+    g->rePrepareAndBindGroupMatrix();
+    REQUIRE(g->lfoSlots[0].held == G::CURVE);
+}
+
+TEST_CASE("Only untargeted, non random song position LFOs share an evaluator")
+{
+    using SP = scxt::modulation::modulators::SharedLFOPool;
+    scxt::modulation::ModulatorStorage ms;
+    ms.triggerMode = MS::SONGPOS;
+
+    ms.modulatorShape = MS::STEP;
+    REQUIRE(SP::canShare(ms, false));
+    REQUIRE_FALSE(SP::canShare(ms, true));
+
+    ms.modulatorShape = MS::LFO_SINE;
+    REQUIRE(SP::canShare(ms, false));
+    ms.curveLfoStorage.useenv = true;
+    REQUIRE_FALSE(SP::canShare(ms, false));
+    ms.curveLfoStorage.useenv = false;
+
+    ms.modulatorShape = MS::LFO_SH_NOISE;
+    REQUIRE_FALSE(SP::canShare(ms, false));
+    ms.modulatorShape = MS::LFO_ENV;
+    REQUIRE_FALSE(SP::canShare(ms, false));
+
+    ms.modulatorShape = MS::STEP;
+    ms.triggerMode = MS::KEYTRIGGER;
+    REQUIRE_FALSE(SP::canShare(ms, false));
+}
+
+namespace
+{
+using Endpoints = scxt::voice::modulation::MatrixEndpoints;
+using TI = scxt::modulation::shared::TargetIdentifier;
+
+// Every zone LFO routed somewhere, since only LFOs the matrix reads run at all
+void routeZoneLFOsToPan(scxt::engine::Zone &z)
+{
+    auto &routes = z.routingTable.routes;
+    for (int i = 0; i < scxt::lfosPerZone; ++i)
+    {
+        routes[i].active = true;
+        routes[i].source = Endpoints::Sources::lfoSource(i);
+        routes[i].target = Endpoints::MappingTarget::panA;
+        routes[i].depth = 0.1f;
+    }
+}
+
+float voiceLFOOutput(scxt::voice::Voice &v, int i)
+{
+    using V = scxt::voice::Voice;
+    switch (v.lfoEvaluator[i])
+    {
+    case V::STEP:
+        return v.stepLfo(i).output;
+    case V::CURVE:
+        return v.curveLfo(i).output;
+    case V::ENV:
+        return v.envLfo(i).output;
+    default:
+        return 0.f;
+    }
+}
+
+struct LFOBlock
+{
+    int block, key, lfo;
+    float value;
+    bool fromPool;
+};
+
+/*
+ * Three overlapping notes started blocks apart and released at different times on a zone
+ * set up by setup, with every voice's LFO outputs recorded block by block
+ */
+std::vector<LFOBlock> playOverlappingNotes(const std::function<void(scxt::engine::Zone &)> &setup,
+                                           bool usePool)
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+    eng->getSharedLFOPool()->enabled = usePool;
+    eng->rng.reseed(8675309);
+
+    auto &part = *eng->getPatch()->getPart(0);
+    part.addGroup();
+    addBlankZoneToGroup(part, 0, 0, 127);
+    auto &zone = *part.getGroup(0)->getZone(0);
+    routeZoneLFOsToPan(zone);
+    setup(zone);
+    zone.onRoutingChanged();
+
+    // somewhere into the song, and moving the way a host moves it
+    eng->transport.timeInSeconds = 1.3;
+    std::vector<LFOBlock> res;
+    for (int b = 0; b < 300; ++b)
+    {
+        if (b == 0)
+            eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f);
+        if (b == 37)
+            eng->processNoteOnEvent(0, 0, 64, -1, 1.f, 0.f);
+        if (b == 90)
+            eng->processNoteOnEvent(0, 0, 71, -1, 1.f, 0.f);
+        if (b == 150)
+            eng->processNoteOffEvent(0, 0, 60, -1, 0.f);
+        if (b == 200)
+            eng->processNoteOffEvent(0, 0, 64, -1, 0.f);
+
+        eng->processAudio();
+        eng->transport.timeInSeconds += scxt::blockSize * eng->getSampleRateInv();
+
+        for (int v = 0; v < (int)zone.activeVoices; ++v)
+        {
+            auto *voice = zone.voiceWeakPointers[v];
+            for (int i = 0; i < scxt::lfosPerZone; ++i)
+                res.push_back({b, voice->key, i, voiceLFOOutput(*voice, i),
+                               voice->lfoFromSharedPool[i]});
+        }
+    }
+    return res;
+}
+
+void requireSameLFOBlocks(const std::vector<LFOBlock> &pooled,
+                          const std::vector<LFOBlock> &unpooled)
+{
+    REQUIRE(pooled.size() == unpooled.size());
+    REQUIRE(!pooled.empty());
+    for (size_t k = 0; k < pooled.size(); ++k)
+    {
+        const auto &p = pooled[k];
+        const auto &u = unpooled[k];
+        INFO("block " << p.block << " key " << p.key << " lfo " << p.lfo);
+        REQUIRE(p.block == u.block);
+        REQUIRE(p.key == u.key);
+        REQUIRE(p.lfo == u.lfo);
+        REQUIRE_FALSE(u.fromPool);
+        // the pool runs on from the first voice while a later voice's own evaluator
+        // re-locks to song position, so they agree to phase accumulation only
+        REQUIRE(p.value == Approx(u.value).margin(1e-4));
+    }
+}
+
+bool anyFromPool(const std::vector<LFOBlock> &r, int lfo)
+{
+    return std::any_of(r.begin(), r.end(),
+                       [lfo](const auto &b) { return b.lfo == lfo && b.fromPool; });
+}
+} // namespace
+
+TEST_CASE("Voices sharing a pooled LFO see what their own evaluator would have")
+{
+    SECTION("Shareable song position LFOs")
+    {
+        auto setup = [](scxt::engine::Zone &z) {
+            for (int i = 0; i < scxt::lfosPerZone; ++i)
+            {
+                auto &ms = z.modulatorStorage[i];
+                ms.triggerMode = MS::SONGPOS;
+                ms.rate = -1.f + 0.7f * i;
+                ms.start_phase = 0.15f * i;
+            }
+            z.modulatorStorage[0].modulatorShape = MS::LFO_SINE;
+            z.modulatorStorage[1].modulatorShape = MS::LFO_TRI;
+            z.modulatorStorage[2].modulatorShape = MS::LFO_RAMP;
+            z.modulatorStorage[2].temposync = true;
+
+            auto &step = z.modulatorStorage[3];
+            step.modulatorShape = MS::STEP;
+            step.stepLfoStorage.repeat = 4;
+            step.stepLfoStorage.smooth = 0.5f;
+            for (int s = 0; s < 4; ++s)
+                step.stepLfoStorage.data[s] = 0.25f * s - 0.4f;
+        };
+
+        auto pooled = playOverlappingNotes(setup, true);
+        auto unpooled = playOverlappingNotes(setup, false);
+        requireSameLFOBlocks(pooled, unpooled);
+        for (int i = 0; i < scxt::lfosPerZone; ++i)
+            REQUIRE(anyFromPool(pooled, i));
+    }
+
+    SECTION("LFOs that differ voice to voice stay on their own evaluator")
+    {
+        auto setup = [](scxt::engine::Zone &z) {
+            for (int i = 0; i < scxt::lfosPerZone; ++i)
+            {
+                auto &ms = z.modulatorStorage[i];
+                ms.modulatorShape = MS::LFO_SINE;
+                ms.triggerMode = MS::SONGPOS;
+                ms.rate = 0.5f;
+            }
+
+            // key tracked rate, through the matrix
+            auto &kt = z.routingTable.routes[scxt::lfosPerZone];
+            kt.active = true;
+            kt.source = Endpoints::Sources::KeyAndPitchSources::keyTrackA;
+            kt.target = TI{'lfo ', 'rate', 1};
+            kt.depth = 1.f;
+
+            z.modulatorStorage[2].triggerMode = MS::RANDOM;
+            z.modulatorStorage[3].triggerMode = MS::RELEASE;
+        };
+
+        auto pooled = playOverlappingNotes(setup, true);
+        auto unpooled = playOverlappingNotes(setup, false);
+        requireSameLFOBlocks(pooled, unpooled);
+        REQUIRE(anyFromPool(pooled, 0));
+        for (int i = 1; i < scxt::lfosPerZone; ++i)
+            REQUIRE_FALSE(anyFromPool(pooled, i));
+    }
+}
@@ -0,0 +1,226 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * A note on can land anywhere inside the engine block. The voice it starts renders whole
+ * blocks regardless and then runs its output late by the offset, so these press the same key
+ * at the block top and a few samples in and expect the second render to be the first one,
+ * shifted, with silence in front. Nothing else gets an offset, so everything else inside the
+ * block must wait for the next block top rather than act early.
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "engine/engine.h"
+#include "engine/group.h"
+#include "engine/part.h"
+#include "engine/zone.h"
+#include "voice/voice.h"
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+using Zone = scxt::engine::Zone;
+
+namespace
+{
+constexpr int renderedBlocks{8};
+
+struct OffsetFixture
+{
+    std::unique_ptr<scxt::engine::Engine> eng;
+    Zone *zone{nullptr};
+    int blockLen{scxt::blockSize};
+
+    explicit OffsetFixture(bool oversample)
+    {
+        eng.reset(makeEngine());
+
+        auto &part = *eng->getPatch()->getPart(0);
+        part.addGroup();
+        auto *group = part.getGroup(0).get();
+        group->outputInfo.oversample = oversample;
+        blockLen = scxt::blockSize << (oversample ? 1 : 0);
+
+        auto z = std::make_unique<Zone>();
+        z->mapping.keyboardRange = {0, 127};
+        z->mapping.velocityRange = {0, 127};
+        z->mapping.rootKey = 60;
+        z->initialize();
+        group->addZone(z);
+        zone = group->getZone(0).get();
+
+        auto p = samplePath("WavStereo48k.wav");
+        REQUIRE(fs::exists(p));
+
+        // loadSampleByPath asserts it is on the serial thread; we are the only thread.
+        auto bypass = eng->getMessageController()->threadingChecker.bypassChecksInScope();
+        auto sid = eng->getSampleManager()->loadSampleByPath(p);
+        REQUIRE(sid.has_value());
+
+        zone->variantData.variants[0].sampleID = *sid;
+        zone->variantData.variants[0].active = true;
+        REQUIRE(zone->attachToSample(*eng->getSampleManager(), 0,
+                                     Zone::SampleInformationRead::ENDPOINTS));
+    }
+
+    scxt::voice::Voice *onlyVoice() const
+    {
+        for (int i = 0; i < (int)scxt::maxVoices; ++i)
+        {
+            auto *v = zone->voiceWeakPointers[i];
+            if (v && v->isVoiceAssigned)
+                return v;
+        }
+        return nullptr;
+    }
+
+    std::vector<float> render(int32_t sampleOffset)
+    {
+        std::vector<float> out;
+        eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f, sampleOffset);
+        for (int b = 0; b < renderedBlocks; ++b)
+        {
+            eng->processAudio();
+            auto *v = onlyVoice();
+            REQUIRE(v);
+            REQUIRE(v->startOffset == sampleOffset);
+            for (int i = 0; i < blockLen; ++i)
+                out.push_back(v->output[0][i]);
+        }
+        eng->processNoteOffEvent(0, 0, 60, -1, 0.f);
+        return out;
+    }
+};
+} // namespace
+
+TEST_CASE("Note on sample offset delays the voice by that many samples")
+{
+    for (auto oversample : {false, true})
+    {
+        DYNAMIC_SECTION("Group oversample " << oversample)
+        {
+            constexpr int32_t offset{5};
+
+            auto atTop = OffsetFixture(oversample).render(0);
+            OffsetFixture f(oversample);
+            auto late = f.render(offset);
+            REQUIRE(atTop.size() == late.size());
+
+            auto d = offset << (oversample ? 1 : 0);
+            for (int i = 0; i < d; ++i)
+                REQUIRE(late[i] == 0.f);
+
+            bool anySound{false};
+            for (size_t i = d; i < late.size(); ++i)
+            {
+                REQUIRE(late[i] == Approx(atTop[i - d]).margin(1e-6));
+                anySound = anySound || late[i] != 0.f;
+            }
+            REQUIRE(anySound);
+        }
+    }
+}
+
+TEST_CASE("Note on sample offset is clamped inside the block")
+{
+    OffsetFixture f(false);
+    f.eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f, scxt::blockSize + 7);
+    f.eng->processAudio();
+    auto *v = f.onlyVoice();
+    REQUIRE(v);
+    REQUIRE(v->startOffset == scxt::blockSize - 1);
+    REQUIRE(f.eng->noteOnSampleOffset == 0);
+}
+
+TEST_CASE("Only note ons run ahead of their time within the block")
+{
+    using scxt::engine::Engine;
+    constexpr int64_t top{4 * scxt::blockSize};
+
+    CHECK(Engine::blockEventOffset(top - 3, top, false) == 0);
+    CHECK(Engine::blockEventOffset(top, top, false) == 0);
+    CHECK(Engine::blockEventOffset(top + 14, top, true) == 14);
+    CHECK(!Engine::blockEventOffset(top + 14, top, false).has_value());
+    CHECK(!Engine::blockEventOffset(top + scxt::blockSize, top, true).has_value());
+
+    uint8_t on[3]{0x93, 60, 100}, onAsOff[3]{0x93, 60, 0}, off[3]{0x83, 60, 0};
+    CHECK(Engine::isMIDI1NoteOn(on));
+    CHECK(!Engine::isMIDI1NoteOn(onAsOff));
+    CHECK(!Engine::isMIDI1NoteOn(off));
+
+    SECTION("A note off inside a block releases at the next block top")
+    {
+        // Walk the events as the plugin does, at each block top
+        OffsetFixture f(false);
+        std::vector<std::pair<int64_t, bool>> events{{3, true}, {top + 14, false}};
+        size_t next{0};
+        std::vector<bool> gatedAfterBlock;
+        for (int b = 0; b < 7; ++b)
+        {
+            int64_t blockStart = b * scxt::blockSize;
+            while (next < events.size())
+            {
+                auto [time, isOn] = events[next];
+                auto offset = Engine::blockEventOffset(time, blockStart, isOn);
+                if (!offset.has_value())
+                    break;
+                if (isOn)
+                    f.eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f, *offset);
+                else
+                    f.eng->processNoteOffEvent(0, 0, 60, -1, 0.f);
+                ++next;
+            }
+            f.eng->processAudio();
+
+            // once released the voice may finish, which is as good as ungated here
+            auto *v = f.onlyVoice();
+            if (b == 0)
+            {
+                REQUIRE(v);
+                REQUIRE(v->startOffset == 3);
+            }
+            gatedAfterBlock.push_back(v && v->isGated);
+        }
+
+        // the block holding the note off still plays gated to its end
+        for (int b = 0; b <= 4; ++b)
+        {
+            INFO("block " << b);
+            CHECK(gatedAfterBlock[b]);
+        }
+        CHECK(!gatedAfterBlock[5]);
+        CHECK(!gatedAfterBlock[6]);
+    }
+}
@@ -27,6 +27,7 @@
 
 #include "catch2/catch2.hpp"
 #include "dsp/processor/processor.h"
+#include "dsp/processor/routing.h"
 #include "engine/memory_pool.h"
 #include "engine/engine.h"
 
@@ -155,4 +156,76 @@ TEST_CASE("Dump Processor Silence Lengths")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Processor Mix and Level Apply In One Pass")
+{
+    namespace pdsp = scxt::dsp::processor;
+    static constexpr int N{scxt::blockSize};
+
+    float dry alignas(16)[2][N], wet alignas(16)[2][N], out alignas(16)[2][N];
+    for (int k = 0; k < N; ++k)
+    {
+        dry[0][k] = 0.5f + 0.01f * k;
+        dry[1][k] = -0.25f;
+        wet[0][k] = 1.f - 0.02f * k;
+        wet[1][k] = 0.75f;
+    }
+
+    SECTION("Instant targets are a plain crossfade then gain")
+    {
+        pdsp::ProcessorMixLevel<N> ml;
+        ml.setTargetsInstant(0.25f, 2.f);
+        ml.stereo(dry[0], dry[1], wet[0], wet[1], out[0], out[1]);
+        for (int k = 0; k < N; ++k)
+        {
+            REQUIRE(out[0][k] == Approx((0.75f * dry[0][k] + 0.25f * wet[0][k]) * 2.f));
+            REQUIRE(out[1][k] == Approx((0.75f * dry[1][k] + 0.25f * wet[1][k]) * 2.f));
+        }
+    }
+
+    SECTION("Ramps land on their targets by the end of the block")
+    {
+        pdsp::ProcessorMixLevel<N> ml;
+        ml.setTargetsInstant(0.f, 1.f);
+        ml.setTargets(1.f, 0.5f);
+        ml.mono(dry[0], wet[0], out[0]);
+        REQUIRE(out[0][N - 1] == Approx(wet[0][N - 1] * 0.5f));
+        REQUIRE(ml.mix == 1.f);
+        REQUIRE(ml.level == 0.5f);
+    }
+
+    SECTION("Mono to stereo may write over its own input")
+    {
+        pdsp::ProcessorMixLevel<N> ml;
+        ml.setTargetsInstant(0.5f, 1.f);
+        float expectL[N], expectR[N];
+        for (int k = 0; k < N; ++k)
+        {
+            expectL[k] = 0.5f * (dry[0][k] + wet[0][k]);
+            expectR[k] = 0.5f * (dry[0][k] + wet[1][k]);
+        }
+        ml.stereo(dry[0], dry[0], wet[0], wet[1], dry[0], dry[1]);
+        for (int k = 0; k < N; ++k)
+        {
+            REQUIRE(dry[0][k] == Approx(expectL[k]));
+            REQUIRE(dry[1][k] == Approx(expectR[k]));
+        }
+    }
+}
+
+TEST_CASE("Compiled Processor Chain Skips Empty Slots")
+{
+    namespace pdsp = scxt::dsp::processor;
+    pdsp::Processor *procs[scxt::engine::processorCount]{nullptr, nullptr, nullptr, nullptr};
+    bool consumesMono[scxt::engine::processorCount]{false, false, false, false};
+
+    pdsp::CompiledProcessorChain chain;
+    pdsp::compileSequentialChain(chain, procs, consumesMono, true);
+    REQUIRE(chain.count == 0);
+    REQUIRE(chain.endsMono);
+
+    pdsp::compileSequentialChain(chain, procs, consumesMono, false);
+    REQUIRE(chain.count == 0);
+    REQUIRE(!chain.endsMono);
+}
@@ -27,11 +27,26 @@
 
 #include "catch2/catch2.hpp"
 #include "sample/sample.h"
+#include "sample/sample_manager.h"
+#include "sample/decoded_sample_cache.h"
+#include "dsp/resampling.h"
+#include "dsp/generator.h"
+#include "voice/preview_voice.h"
+#include "voice/preview_decoder.h"
+#include "engine/engine.h"
+#include "messaging/messaging.h"
+#include "messaging/client/client_messages.h"
+#include "sample/import_support/import_harness.h"
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <optional>
+#include <type_traits>
 
 #include "test_utils.h"
 
@@ -116,3 +131,739 @@ TEST_CASE("Load extensible wav sample", "[sample][wav]")
         peak = std::max(peak, std::fabs(d0[i]));
     CHECK(peak > 0.01f);
 }
+
+TEST_CASE("Sample manager dedupes by address", "[sample][manager]")
+{
+    scxt::ThreadingChecker tc;
+    auto bypass = tc.bypassChecksInScope();
+    scxt::sample::SampleManager sm(tc);
+
+    SECTION("Plain files by path")
+    {
+        auto p = samplePath("WavStereo48k.wav");
+        REQUIRE(fs::exists(p));
+
+        auto a = sm.loadSampleByPath(p);
+        REQUIRE(a.has_value());
+        auto b = sm.loadSampleByPath(p);
+        REQUIRE(b.has_value());
+        CHECK(*a == *b);
+
+        auto smp = sm.getSample(*a);
+        REQUIRE(smp);
+        CHECK(sm.sampleMemoryInBytes == smp->getDataSize());
+        auto byMD5 = sm.findLoadedSampleByMD5(smp->md5Sum);
+        REQUIRE(byMD5.has_value());
+        CHECK(*byMD5 == *a);
+
+        smp.reset();
+        sm.purgeUnreferencedSamples();
+        CHECK(sm.sampleMemoryInBytes == 0);
+        CHECK_FALSE(sm.findLoadedSampleByPath(p).has_value());
+        CHECK_FALSE(sm.findLoadedSampleByMD5(byMD5->md5).has_value());
+    }
+
+    SECTION("SF2 regions by path and index")
+    {
+        auto p = samplePath("harpsi.sf2");
+        REQUIRE(fs::exists(p));
+
+        auto r0 = sm.loadSampleFromSF2(p, "", nullptr, -1, -1, 0);
+        auto r1 = sm.loadSampleFromSF2(p, "", nullptr, -1, -1, 1);
+        auto r0again = sm.loadSampleFromSF2(p, "", nullptr, -1, -1, 0);
+        REQUIRE(r0.has_value());
+        REQUIRE(r1.has_value());
+        REQUIRE(r0again.has_value());
+        CHECK(*r0 != *r1);
+        CHECK(*r0 == *r0again);
+
+        auto f0 = sm.findLoadedSampleByAddress(scxt::sample::Sample::SF2_FILE, p, 0);
+        REQUIRE(f0.has_value());
+        CHECK(*f0 == *r0);
+        CHECK_FALSE(sm.findLoadedSampleByAddress(scxt::sample::Sample::GIG_FILE, p, 0));
+        // an sf2 region isn't a plain file at that path
+        CHECK_FALSE(sm.findLoadedSampleByPath(p).has_value());
+    }
+
+    SECTION("Alias chains resolve in one step")
+    {
+        auto p = samplePath("WavStereo48k.wav");
+        auto real = sm.loadSampleByPath(p);
+        REQUIRE(real.has_value());
+
+        scxt::SampleID a, b;
+        a.setAsLegacy(1);
+        b.setAsLegacy(2);
+
+        // b -> a first, then a -> real; b must follow through to real
+        sm.addIdAlias(b, a);
+        sm.addIdAlias(a, *real);
+        CHECK(sm.resolveAlias(a) == *real);
+        CHECK(sm.resolveAlias(b) == *real);
+        CHECK(sm.getSample(b) == sm.getSample(*real));
+    }
+}
+
+TEST_CASE("Sample manager batch loads line up with their paths", "[sample][manager]")
+{
+    scxt::ThreadingChecker tc;
+    auto bypass = tc.bypassChecksInScope();
+    scxt::sample::SampleManager sm(tc);
+
+    auto a = samplePath("WavStereo48k.wav");
+    auto b = samplePath("WavExtensibleFloat.wav");
+    auto missing = samplePath("NotASample.wav");
+    REQUIRE(fs::exists(a));
+    REQUIRE(fs::exists(b));
+
+    auto single = sm.loadSampleByPath(b);
+    REQUIRE(single.has_value());
+
+    auto res = sm.loadSamplesByPath({a, b, missing, a});
+    REQUIRE(res.size() == 4);
+    REQUIRE(res[0].has_value());
+    REQUIRE(res[1].has_value());
+    CHECK_FALSE(res[2].has_value());
+    REQUIRE(res[3].has_value());
+
+    // Repeats decode once, and what was already loaded is reused
+    CHECK(*res[0] == *res[3]);
+    CHECK(*res[1] == *single);
+    CHECK(sm.getResidencyCacheStats().misses == 3);
+
+    auto smp = sm.getSample(*res[0]);
+    REQUIRE(smp);
+    CHECK(smp->getSampleLength() > 0);
+}
+
+TEST_CASE("Importer batch loads fall back past a file that won't load", "[sample][import]")
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+    auto bypass = eng->getMessageController()->threadingChecker.bypassChecksInScope();
+
+    // an EXS absolutePath that exists but isn't audio, with the real file as its sibling
+    auto corrupt = fs::temp_directory_path() / "scxt_import_fallback_corrupt.wav";
+    {
+        std::ofstream f(corrupt, std::ios::binary);
+        f << "RIFF not really a wave file at all";
+    }
+    auto good = samplePath("WavStereo48k.wav");
+    auto other = samplePath("WavExtensibleFloat.wav");
+    auto missing = samplePath("NotASample.wav");
+    REQUIRE(fs::exists(good));
+    REQUIRE(fs::exists(other));
+    REQUIRE_FALSE(eng->getSampleManager()->loadSampleByPath(corrupt).has_value());
+
+    std::vector<std::optional<scxt::SampleID>> res;
+    {
+        scxt::import_support::ImporterContext ctx(*eng, "Import fallback test");
+        res = ctx.loadSamplesFromDisk(
+            {{corrupt, good}, {other}, {missing, corrupt}, {missing, corrupt, other}});
+    }
+    REQUIRE(res.size() == 4);
+
+    auto pathOf = [&eng](const std::optional<scxt::SampleID> &sid) {
+        REQUIRE(sid.has_value());
+        auto smp = eng->getSampleManager()->getSample(*sid);
+        REQUIRE(smp);
+        return smp->getPath();
+    };
+    CHECK(pathOf(res[0]) == good);
+    CHECK(pathOf(res[1]) == other);
+    CHECK_FALSE(res[2].has_value());
+    CHECK(pathOf(res[3]) == other);
+
+    fs::remove(corrupt);
+}
+
+TEST_CASE("Sample manager residency cache", "[sample][manager]")
+{
+    scxt::ThreadingChecker tc;
+    auto bypass = tc.bypassChecksInScope();
+    scxt::sample::SampleManager sm(tc);
+
+    // off unless asked for
+    CHECK(sm.getResidencyCacheBudget() == 0);
+    sm.setResidencyCacheBudget(64 * 1024 * 1024);
+
+    auto p = samplePath("WavStereo48k.wav");
+    REQUIRE(fs::exists(p));
+
+    auto first = sm.loadSampleByPath(p);
+    REQUIRE(first.has_value());
+    CHECK(sm.getResidencyCacheStats().misses == 1);
+
+    SECTION("Purged samples are revived by address")
+    {
+        sm.purgeUnreferencedSamples();
+        CHECK(sm.getSample(*first) == nullptr);
+        CHECK(sm.getResidencyCacheStats().residentSamples == 1);
+
+        scxt::sample::Sample::SampleFileAddress addr;
+        addr.type = scxt::sample::Sample::WAV_FILE;
+        addr.path = p;
+        auto again = sm.loadSampleByFileAddress(addr, *first);
+        REQUIRE(again.has_value());
+        CHECK(*again == *first);
+        CHECK(sm.getSample(*first) != nullptr);
+
+        auto st = sm.getResidencyCacheStats();
+        CHECK(st.hits == 1);
+        CHECK(st.misses == 1);
+        CHECK(st.residentSamples == 0);
+        CHECK(st.residentBytes == 0);
+    }
+
+    SECTION("Reset parks everything")
+    {
+        sm.reset();
+        CHECK(sm.sampleMemoryInBytes == 0);
+        CHECK(sm.getResidencyCacheStats().residentSamples == 1);
+        auto again = sm.loadSampleByPath(p);
+        REQUIRE(again.has_value());
+        CHECK(*again == *first);
+        CHECK(sm.getResidencyCacheStats().hits == 1);
+    }
+
+    SECTION("Budget evicts")
+    {
+        sm.purgeUnreferencedSamples();
+        CHECK(sm.getResidencyCacheStats().residentSamples == 1);
+        sm.setResidencyCacheBudget(1);
+        auto st = sm.getResidencyCacheStats();
+        CHECK(st.residentSamples == 0);
+        CHECK(st.evictions == 1);
+
+        auto again = sm.loadSampleByPath(p);
+        REQUIRE(again.has_value());
+        CHECK(sm.getResidencyCacheStats().misses == 2);
+    }
+
+    SECTION("Zero budget frees on purge")
+    {
+        sm.setResidencyCacheBudget(0);
+        sm.purgeUnreferencedSamples();
+        CHECK(sm.getResidencyCacheStats().residentSamples == 0);
+        CHECK(sm.getResidencyCacheStats().evictions == 0);
+    }
+
+    SECTION("A file edited while parked is read again")
+    {
+        auto edited = fs::temp_directory_path() / "scxt_residency_edit_test.wav";
+        fs::copy_file(p, edited, fs::copy_options::overwrite_existing);
+
+        auto before = sm.loadSampleByPath(edited);
+        REQUIRE(before.has_value());
+        auto oldLength = sm.getSample(*before)->getSampleLength();
+        sm.purgeUnreferencedSamples();
+        auto parked = sm.getResidencyCacheStats();
+        REQUIRE(parked.residentSamples == 2);
+
+        // re-export different audio over the same path
+        auto replacement = samplePath("WavExtensibleFloat.wav");
+        fs::copy_file(replacement, edited, fs::copy_options::overwrite_existing);
+        scxt::sample::Sample fresh;
+        REQUIRE(fresh.load(replacement));
+        REQUIRE(fresh.getSampleLength() != oldLength);
+
+        scxt::sample::Sample::SampleFileAddress addr;
+        addr.type = scxt::sample::Sample::WAV_FILE;
+        addr.path = edited;
+        auto after = sm.loadSampleByFileAddress(addr, *before);
+        REQUIRE(after.has_value());
+        auto smp = sm.getSample(*after);
+        REQUIRE(smp);
+        CHECK(smp->getSampleLength() == fresh.getSampleLength());
+        CHECK(smp->md5Sum == fresh.md5Sum);
+
+        auto st = sm.getResidencyCacheStats();
+        CHECK(st.hits == parked.hits);
+        CHECK(st.misses == parked.misses + 1);
+        // the stale one went, the untouched original is still parked
+        CHECK(st.residentSamples == 1);
+
+        smp.reset();
+        sm.purgeUnreferencedSamples();
+        fs::remove(edited);
+    }
+}
+
+TEST_CASE("Decoded sample cache", "[sample][cache]")
+{
+    auto p = samplePath("\xE8\x81\xB2\xE9\x9F\xB3\xE4\xB8\x8D\xE5\xA5\xBD.opus");
+    REQUIRE(fs::exists(p));
+
+    auto dir = fs::temp_directory_path() / "scxt_decoded_sample_cache_test";
+    fs::remove_all(dir);
+
+    scxt::sample::DecodedSampleCache cache;
+    cache.configure(dir, 256 * 1024 * 1024);
+    REQUIRE(cache.isEnabled());
+
+    scxt::sample::Sample decoded;
+    REQUIRE(decoded.load(p, &cache));
+    CHECK(!decoded.isSampleDataMapped());
+    CHECK(cache.getStats().misses == 1);
+    CHECK(cache.getStats().stores == 1);
+    CHECK(cache.getStats().files == 1);
+
+    SECTION("A second load maps what the first decoded")
+    {
+        scxt::sample::Sample cached;
+        REQUIRE(cached.load(p, &cache));
+        CHECK(cached.isSampleDataMapped());
+        CHECK(cache.getStats().hits == 1);
+
+        CHECK(cached.type == decoded.type);
+        CHECK(cached.sample_rate == decoded.sample_rate);
+        CHECK(cached.channels == decoded.channels);
+        CHECK(cached.bitDepth == decoded.bitDepth);
+        REQUIRE(cached.getSampleLength() == decoded.getSampleLength());
+
+        // the padding either side is part of what is cached, so compare through it
+        auto n = decoded.getSampleLength();
+        for (int c = 0; c < decoded.channels; ++c)
+        {
+            auto a = decoded.GetSamplePtrF32(c) - scxt::dsp::FIRoffset;
+            auto b = cached.GetSamplePtrF32(c) - scxt::dsp::FIRoffset;
+            REQUIRE(memcmp(a, b, (n + scxt::dsp::FIRipol_N) * sizeof(float)) == 0);
+        }
+    }
+
+    SECTION("A new cache on the same directory finds the file")
+    {
+        scxt::sample::DecodedSampleCache again;
+        again.configure(dir, 256 * 1024 * 1024);
+        CHECK(again.getStats().files == 1);
+
+        scxt::sample::Sample cached;
+        REQUIRE(cached.load(p, &again));
+        CHECK(cached.isSampleDataMapped());
+    }
+
+    SECTION("Over budget evicts")
+    {
+        auto bytes = cache.getStats().bytesOnDisk;
+        REQUIRE(bytes > 0);
+        cache.configure(dir, bytes - 1);
+        CHECK(cache.getStats().files == 0);
+        CHECK(cache.getStats().evictions == 1);
+
+        scxt::sample::Sample fresh;
+        REQUIRE(fresh.load(p, &cache));
+        CHECK(!fresh.isSampleDataMapped());
+    }
+
+    fs::remove_all(dir);
+}
+
+namespace
+{
+// A mono WAV with nothing but fmt and data, written fresh so the layout is known
+template <typename T> void writeMonoWav(const fs::path &p, const std::vector<T> &d)
+{
+    static_assert(std::is_same_v<T, int16_t> || std::is_same_v<T, float>);
+    auto put32 = [](std::ofstream &o, uint32_t v) { o.write((const char *)&v, 4); };
+    auto put16 = [](std::ofstream &o, uint16_t v) { o.write((const char *)&v, 2); };
+    uint32_t dataBytes = d.size() * sizeof(T);
+
+    std::ofstream o(p, std::ios::binary);
+    o.write("RIFF", 4);
+    put32(o, 36 + dataBytes);
+    o.write("WAVE", 4);
+    o.write("fmt ", 4);
+    put32(o, 16);
+    put16(o, std::is_same_v<T, float> ? 3 : 1); // IEEE float or PCM
+    put16(o, 1);
+    put32(o, 48000);
+    put32(o, 48000 * sizeof(T));
+    put16(o, sizeof(T));
+    put16(o, sizeof(T) * 8);
+    o.write("data", 4);
+    put32(o, dataBytes);
+    o.write((const char *)d.data(), dataBytes);
+}
+
+// A loop never finishes, so looped renders run a fixed number of blocks
+struct GeneratorLoop
+{
+    int32_t lower{0}, upper{0}, fade{0};
+    int blocks{0};
+};
+
+std::vector<float> renderThroughGenerator(scxt::sample::Sample &s,
+                                          std::optional<GeneratorLoop> loop = std::nullopt)
+{
+    auto isFloat = s.bitDepth == scxt::sample::Sample::BD_F32;
+
+    scxt::dsp::GeneratorState gd;
+    gd.direction = 1;
+    gd.directionAtOutset = 1;
+    gd.ratio = 1 << 23; // half speed, so every read interpolates
+    gd.playbackUpperBound = s.getSampleLength() - 1;
+    gd.loopUpperBound = gd.playbackUpperBound;
+    gd.sampleStop = s.getSampleLength();
+    gd.isFinished = false;
+    if (loop)
+    {
+        gd.loopLowerBound = loop->lower;
+        gd.loopUpperBound = loop->upper;
+        gd.loopFade = loop->fade;
+        gd.loopInvertedBounds = 1.f / std::max(1, loop->upper - loop->lower);
+    }
+
+    float out alignas(16)[2][scxt::blockSize];
+    scxt::dsp::GeneratorIO io;
+    io.outputL = out[0];
+    io.outputR = out[1];
+    if (isFloat)
+        io.sampleDataL = s.GetSamplePtrF32(0);
+    else
+        io.sampleDataL = s.GetSamplePtrI16(0);
+    io.waveSize = s.getSampleLength();
+    io.zeroPaddedEdges = s.hasZeroPaddedEdges();
+
+    auto gen = scxt::dsp::GetFPtrGeneratorSample(false, isFloat, loop.has_value(), true, false);
+    std::vector<float> res;
+    for (int b = 0; loop ? b < loop->blocks : !gd.isFinished; ++b)
+    {
+        memset(out, 0, sizeof(out));
+        gen(&gd, &io);
+        res.insert(res.end(), out[0], out[0] + scxt::blockSize);
+    }
+    return res;
+}
+
+void requireSameRender(const std::vector<float> &a, const std::vector<float> &b)
+{
+    REQUIRE(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        INFO("sample " << i);
+        REQUIRE(a[i] == b[i]);
+    }
+}
+} // namespace
+
+TEST_CASE("Mono WAVs mapped in place play as they would copied", "[sample][wav]")
+{
+    std::vector<int16_t> d(1000);
+    for (size_t i = 0; i < d.size(); ++i)
+        d[i] = (int16_t)(20000 * std::sin(i * 0.05));
+
+    // the loop starts and ends within a FIR window of the file's ends, so the fade reads past
+    // the start and the loop end buffer is what the end reads; at half speed this runs it a
+    // couple of times round
+    auto loop = GeneratorLoop{3, (int32_t)d.size() - 2, 3, (int)(5 * d.size() / scxt::blockSize)};
+
+    auto p = fs::temp_directory_path() / "scxt_mapped_in_place_test.wav";
+
+    SECTION("16 bit")
+    {
+        writeMonoWav(p, d);
+        {
+            scxt::sample::Sample copied, mapped;
+            REQUIRE(copied.load(p));
+            REQUIRE(mapped.load(p, nullptr, true));
+
+            CHECK(!copied.isSampleDataMapped());
+            REQUIRE(mapped.isSampleDataMapped());
+            CHECK(!mapped.hasZeroPaddedEdges());
+            REQUIRE(mapped.getSampleLength() == d.size());
+            REQUIRE(memcmp(mapped.GetSamplePtrI16(0), d.data(), d.size() * sizeof(int16_t)) == 0);
+
+            // both ends are within a FIR window of the start and the finish, so this covers the
+            // pad the generator makes up against the one the copy carries
+            requireSameRender(renderThroughGenerator(copied), renderThroughGenerator(mapped));
+            requireSameRender(renderThroughGenerator(copied, loop),
+                              renderThroughGenerator(mapped, loop));
+        }
+        fs::remove(p);
+    }
+
+    SECTION("Float")
+    {
+        std::vector<float> f(d.size());
+        for (size_t i = 0; i < d.size(); ++i)
+            f[i] = d[i] / 32768.f;
+
+        writeMonoWav(p, f);
+        {
+            scxt::sample::Sample copied, mapped;
+            REQUIRE(copied.load(p));
+            REQUIRE(mapped.load(p, nullptr, true));
+
+            CHECK(!copied.isSampleDataMapped());
+            REQUIRE(mapped.isSampleDataMapped());
+            CHECK(!mapped.hasZeroPaddedEdges());
+            REQUIRE(mapped.bitDepth == scxt::sample::Sample::BD_F32);
+            REQUIRE(mapped.getSampleLength() == f.size());
+            REQUIRE(memcmp(mapped.GetSamplePtrF32(0), f.data(), f.size() * sizeof(float)) == 0);
+
+            requireSameRender(renderThroughGenerator(copied), renderThroughGenerator(mapped));
+            requireSameRender(renderThroughGenerator(copied, loop),
+                              renderThroughGenerator(mapped, loop));
+        }
+        fs::remove(p);
+    }
+
+    SECTION("Interleaved stereo still copies")
+    {
+        scxt::sample::Sample s;
+        REQUIRE(s.load(samplePath("WavStereo48k.wav"), nullptr, true));
+        CHECK(!s.isSampleDataMapped());
+        CHECK(s.hasZeroPaddedEdges());
+    }
+}
+
+TEST_CASE("WAV loads publish their frames as they convert them", "[sample][wav]")
+{
+    // long enough for several slices
+    std::vector<int16_t> d(200000);
+    for (size_t i = 0; i < d.size(); ++i)
+        d[i] = (int16_t)(20000 * std::sin(i * 0.01));
+
+    auto p = fs::temp_directory_path() / "scxt_wav_publish_test.wav";
+    writeMonoWav(p, d);
+
+    SECTION("A whole load publishes everything")
+    {
+        scxt::sample::Sample s;
+        REQUIRE(s.load(p));
+        CHECK(s.decodedFrames.load() == d.size());
+        REQUIRE(memcmp(s.GetSamplePtrI16(0), d.data(), d.size() * sizeof(int16_t)) == 0);
+    }
+
+    SECTION("A cancelled load stops after the slice it is on")
+    {
+        scxt::sample::Sample s;
+        s.decodeCancelled = true;
+        REQUIRE(!s.load(p));
+        auto published = s.decodedFrames.load();
+        CHECK(published > 0);
+        CHECK(published < d.size());
+
+        // and what it did publish is good
+        REQUIRE(memcmp(s.GetSamplePtrI16(0), d.data(), published * sizeof(int16_t)) == 0);
+    }
+    fs::remove(p);
+}
+
+TEST_CASE("Browser preview decodes in the background", "[sample][preview]")
+{
+    using scxt::voice::PreviewStream;
+
+    auto p = samplePath("\xE8\x81\xB2\xE9\x9F\xB3\xE4\xB8\x8D\xE5\xA5\xBD.opus");
+    REQUIRE(fs::exists(p));
+
+    scxt::voice::PreviewDecoder decoder;
+    scxt::voice::PreviewVoice voice;
+    voice.setSampleRate(48000);
+
+    auto stream = decoder.start(p);
+    REQUIRE(stream);
+    CHECK(!stream->managed);
+
+    voice.attachAndStartUnlessPlaying(stream, 1.f);
+    REQUIRE(voice.isActive);
+
+    // Whatever the decoder has got to, the voice only ever renders silence or sound
+    // and keeps going until the stream has played out
+    float peak{0.f};
+    int blocks{0};
+    while (voice.isActive && blocks < 1000000)
+    {
+        voice.processBlock();
+        for (int i = 0; i < scxt::blockSize; ++i)
+            peak = std::max(peak, std::fabs(voice.output[0][i]));
+        if (stream->getState() == PreviewStream::DECODING)
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        blocks++;
+    }
+    CHECK(!voice.isActive);
+    CHECK(!voice.schedulePurge);
+    CHECK(peak > 0.01f);
+
+    REQUIRE(stream->getState() == PreviewStream::DECODED);
+    CHECK(stream->sample->decodedFrames.load() == stream->sample->getSampleLength());
+
+    SECTION("Starting the same file again stops it")
+    {
+        auto again = decoder.start(p);
+        voice.attachAndStartUnlessPlaying(again, 1.f);
+        REQUIRE(voice.isActive);
+        voice.attachAndStartUnlessPlaying(decoder.start(p), 1.f);
+        CHECK(!voice.isActive);
+    }
+
+    SECTION("Starting a file again reuses its decode")
+    {
+        CHECK(decoder.start(p) == stream);
+        CHECK(decoder.activeStreams() == 1);
+
+        // however far a fresh decode has got, a second start shares it
+        scxt::voice::PreviewDecoder fresh;
+        auto a = fresh.start(p);
+        CHECK(fresh.start(p) == a);
+        CHECK(fresh.activeStreams() == 1);
+
+        // unless it has been asked to stop
+        a->sample->decodeCancelled = true;
+        CHECK(fresh.start(p) != a);
+    }
+
+    SECTION("Released streams are freed once the voice lets go")
+    {
+        stream.reset();
+        decoder.release();
+        CHECK(decoder.activeStreams() == 0);
+    }
+}
+
+TEST_CASE("Browser preview plays a stream as it is published", "[sample][preview]")
+{
+    using scxt::voice::PreviewStream;
+
+    std::vector<int16_t> d(20000);
+    for (size_t i = 0; i < d.size(); ++i)
+        d[i] = (int16_t)(20000 * std::sin(i * 0.01));
+    auto p = fs::temp_directory_path() / "scxt_preview_publish_test.wav";
+    writeMonoWav(p, d);
+
+    // Every sample decodes in full up front; the stream only reveals what we publish by hand
+    auto streamOf = [&p](PreviewStream::State st) {
+        auto res = std::make_shared<PreviewStream>();
+        res->path = p;
+        res->sample = std::make_shared<scxt::sample::Sample>();
+        REQUIRE(res->sample->load(p));
+        res->state = st;
+        return res;
+    };
+
+    scxt::voice::PreviewVoice voice;
+    voice.setSampleRate(48000);
+    auto silent = [&voice]() {
+        for (int i = 0; i < scxt::blockSize; ++i)
+            if (voice.output[0][i] != 0.f)
+                return false;
+        return true;
+    };
+    auto block = [&voice]() {
+        return std::vector<float>(voice.output[0], voice.output[0] + scxt::blockSize);
+    };
+
+    // What the whole file sounds like, block by block
+    std::vector<std::vector<float>> whole;
+    voice.attachAndStartUnlessPlaying(streamOf(PreviewStream::DECODED), 1.f);
+    while (voice.isActive && whole.size() < 100000)
+    {
+        voice.processBlock();
+        if (voice.isActive)
+            whole.push_back(block());
+    }
+    REQUIRE(!voice.isActive);
+    REQUIRE(whole.size() > 1000);
+
+    auto stream = streamOf(PreviewStream::DECODING);
+    auto &smp = *stream->sample;
+    smp.publishDecodedFrames(0);
+    voice.attachAndStartUnlessPlaying(stream, 1.f);
+    REQUIRE(voice.isActive);
+
+    std::vector<std::vector<float>> played;
+    auto run = [&](int blocks) {
+        int quiet{0};
+        for (int b = 0; b < blocks && voice.isActive; ++b)
+        {
+            voice.processBlock();
+            if (!voice.isActive)
+                break;
+            if (silent())
+                quiet++;
+            else
+                played.push_back(block());
+        }
+        return quiet;
+    };
+
+    // nothing published, then less than the head start: silence while it waits
+    CHECK(run(8) == 8);
+    smp.publishDecodedFrames(scxt::voice::PreviewVoice::startAheadBlocks * scxt::blockSize / 2);
+    CHECK(run(8) == 8);
+    CHECK(played.empty());
+
+    // enough to start; playback runs into what is published and holds there in silence
+    smp.publishDecodedFrames(4000);
+    auto quiet = run(400);
+    CHECK(!played.empty());
+    CHECK(quiet > 0);
+    CHECK(played.size() < 4000 / scxt::blockSize);
+    CHECK(voice.isActive);
+
+    // and picks up where it held once there is more
+    auto beforeHold = played.size();
+    smp.publishDecodedFrames(d.size());
+    stream->state = PreviewStream::DECODED;
+    run(100000);
+    CHECK(!voice.isActive);
+    CHECK(played.size() > beforeHold);
+
+    // the held render is the whole render with the silences taken out
+    REQUIRE(played.size() == whole.size());
+    for (size_t b = 0; b < whole.size(); ++b)
+    {
+        INFO("block " << b);
+        REQUIRE(played[b] == whole[b]);
+    }
+
+    fs::remove(p);
+}
+
+TEST_CASE("Toggling a browser preview while it decodes stops it", "[sample][preview]")
+{
+    namespace cmsg = scxt::messaging::client;
+    using smp_t = scxt::sample::Sample;
+
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+    auto &mc = *eng->getMessageController();
+    auto bypass = mc.threadingChecker.bypassChecksInScope();
+
+    // Each preview message is handled here as the serialization thread would, then one
+    // block of audio picks up what it scheduled
+    auto preview = [&](const smp_t::SampleFileAddress &a) {
+        cmsg::doPreviewBrowserSample({1, 1.f, a}, *eng, mc);
+        eng->processAudio();
+    };
+
+    auto opus = smp_t::SampleFileAddress{smp_t::OPUS_FILE,
+                                         samplePath("\xE8\x81\xB2\xE9\x9F\xB3\xE4\xB8\x8D"
+                                                    "\xE5\xA5\xBD.opus")};
+    preview(opus);
+    REQUIRE(eng->previewVoice->isActive);
+    REQUIRE(eng->previewDecoder->isPreviewing(opus.path));
+    REQUIRE(eng->previewDecoder->activeStreams() == 1);
+
+    SECTION("The same file again stops it, and starts no second decode")
+    {
+        // Straight after the start, so most likely mid decode. Cancelling that decode used
+        // to fail the playing stream, and the start which followed it played it again
+        preview(opus);
+        CHECK(!eng->previewVoice->isActive);
+        CHECK(eng->previewDecoder->activeStreams() == 1);
+
+        for (int i = 0; i < 1000; ++i)
+            eng->processAudio();
+        CHECK(!eng->previewVoice->isActive);
+    }
+
+    SECTION("A different file takes over")
+    {
+        auto flac = smp_t::SampleFileAddress{smp_t::FLAC_FILE,
+                                             samplePath("\xE8\x81\xB2\xE9\x9F\xB3\xE4\xB8\x8D"
+                                                        "\xE5\xA5\xBD.flac")};
+        preview(flac);
+        CHECK(eng->previewVoice->isActive);
+        CHECK(eng->previewDecoder->isPreviewing(flac.path));
+        CHECK(eng->previewDecoder->activeStreams() == 2);
+    }
+}
@@ -26,12 +26,90 @@
  */
 
 #define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
 #include "catch2/catch2.hpp"
 
+#include <iostream>
+#include <new>
+#include "infrastructure/realtime_safety.h"
+
+namespace rt = scxt::infrastructure::realtime;
+
+#if SCXT_REALTIME_SAFETY_TRACKING
+/*
+ * In a realtime safety tracking build every test case starts with a clean slate and
+ * fails the run if anything it drove through Engine::processAudio allocated, locked
+ * or touched a file.
+ */
+static int testsWithRealtimeViolations{0};
+
+struct RealtimeSafetyListener : Catch::TestEventListenerBase
+{
+    using TestEventListenerBase::TestEventListenerBase;
+
+    void testCaseStarting(const Catch::TestCaseInfo &) override { rt::clearViolations(); }
+
+    void testCaseEnded(const Catch::TestCaseStats &stats) override
+    {
+        auto n = rt::violationCount();
+        if (n == 0)
+            return;
+        testsWithRealtimeViolations++;
+        std::cerr << "REALTIME SAFETY: " << n << " violation(s) in '" << stats.testInfo.name
+                  << "'" << std::endl;
+        for (const auto &r : rt::recordedViolations())
+            std::cerr << "    " << rt::describe(r) << std::endl;
+        rt::clearViolations();
+    }
+};
+CATCH_REGISTER_LISTENER(RealtimeSafetyListener)
+
+// The aligned forms are left to the runtime; they pair among themselves.
+void *operator new(std::size_t sz)
+{
+    rt::note(rt::Violation::ALLOCATION, "operator new");
+    if (auto *p = rt::rawAlloc(sz))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t sz) { return operator new(sz); }
+void *operator new(std::size_t sz, const std::nothrow_t &) noexcept
+{
+    rt::note(rt::Violation::ALLOCATION, "operator new");
+    return rt::rawAlloc(sz);
+}
+void *operator new[](std::size_t sz, const std::nothrow_t &t) noexcept
+{
+    return operator new(sz, t);
+}
+void operator delete(void *p) noexcept
+{
+    if (p)
+        rt::note(rt::Violation::DEALLOCATION, "operator delete");
+    rt::rawFree(p);
+}
+void operator delete[](void *p) noexcept { operator delete(p); }
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void *p, std::size_t) noexcept { operator delete(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { operator delete(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { operator delete(p); }
+#endif
+
 int main(int argc, char *argv[])
 {
     int result = Catch::Session().run(argc, argv);
 
+#if SCXT_REALTIME_SAFETY_TRACKING
+    if (testsWithRealtimeViolations > 0)
+    {
+        std::cerr << "REALTIME SAFETY: " << testsWithRealtimeViolations
+                  << " test case(s) touched the allocator, a lock or a file on the audio thread"
+                  << std::endl;
+        if (result == 0)
+            result = 1;
+    }
+#endif
+
     return result;
 }
 
@@ -41,3 +119,34 @@ TEST_CASE("Tests Exist", "[basics]")
 {
     SECTION("Asset True") { REQUIRE(1); }
 }
+
+TEST_CASE("Realtime Safety Tracking", "[basics]")
+{
+    if constexpr (!rt::trackingEnabled)
+        return;
+
+    SECTION("Outside a realtime scope nothing is noted")
+    {
+        rt::note(rt::Violation::ALLOCATION, "test");
+        REQUIRE(rt::violationCount() == 0);
+    }
+
+    SECTION("Inside one the stage stack is recorded")
+    {
+        {
+            rt::RealtimeScope scope("test");
+            rt::RealtimeStage stage("inner");
+            rt::note(rt::Violation::LOCK, "test lock");
+            {
+                rt::RealtimeAllowedScope allowed;
+                rt::note(rt::Violation::LOCK, "allowed lock");
+            }
+        }
+        REQUIRE(rt::violationCount() == 1);
+        auto v = rt::recordedViolations();
+        REQUIRE(v[0].kind == rt::Violation::LOCK);
+        REQUIRE(v[0].stageDepth == 2);
+        REQUIRE(std::string(v[0].stages[1]) == "inner");
+        rt::clearViolations();
+    }
+}
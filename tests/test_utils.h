@@ -37,6 +37,7 @@
 #include <filesystem>
 #include <string>
 #include <memory>
+#include <optional>
 
 #include "engine/engine.h"
 #include "engine/part.h"
@@ -56,11 +57,15 @@ inline std::filesystem::path samplePath(const std::string &relative)
 
 /*
  * An engine driven directly on the test thread - no ConsoleHarness, no background audio
- * thread - which is enough to exercise real voice creation.
+ * thread - which is enough to exercise real voice creation. Its defaults and browser database
+ * live in a scratch directory, never the user's documents; tests which put rows in the
+ * database hand in a directory of their own and remove it when they are done.
  */
-inline scxt::engine::Engine *makeEngine()
+inline scxt::engine::Engine *
+makeEngine(const std::optional<std::filesystem::path> &storageDirectory = std::nullopt)
 {
-    auto *e = new scxt::engine::Engine();
+    auto *e = new scxt::engine::Engine(storageDirectory.value_or(
+        std::filesystem::temp_directory_path() / "scxt_test_engine_storage"));
     e->prepareToPlay(TEST_SAMPLE_RATE);
     // Pin tuning to 12-TET so any MTS-ESP master running on the dev box
     // doesn't remap test keys out of the zone ranges.
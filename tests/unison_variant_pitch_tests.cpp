@@ -43,6 +43,7 @@
 
 #include <cmath>
 #include <filesystem>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -285,3 +286,67 @@ TEST_CASE("Forward round robin still walks the variants in order under unison de
         REQUIRE(seen[i] == (seen[i - 1] + 1) % 3);
     }
 }
+
+/*
+ * The rates (and the per block table conversions) are memoized against their inputs. A bend
+ * which glides and then rests exercises both the misses and the hits, and a render whose
+ * caches are emptied before every block has to come out bit for bit the same.
+ */
+TEST_CASE("Memoized generator ratios render exactly what fresh ones do", "[variants]")
+{
+    auto render = [](bool forceMiss) {
+        VariantPitchFixture f(Zone::UNISON, {0.f, 7.f});
+        f.eng->rng.reseed(8675309); // the two renders may differ only in their caches
+        const auto &out = f.eng->getPatch()->busses.mainBus.output;
+
+        auto forget = [&f]() {
+            constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+            for (int i = 0; i < (int)scxt::maxVoices; ++i)
+            {
+                auto *v = f.zone->voiceWeakPointers[i];
+                if (!v || !v->isVoiceAssigned)
+                    continue;
+                for (auto &k : v->generatorRatioKey)
+                    k.noteDiff = nan;
+                v->aegRateMulConversion.in = nan;
+                v->sampleAmpConversion.in = nan;
+                v->glideRateConversion.in = nan;
+                for (auto &c : v->egRateMulConversion)
+                    c.in = nan;
+            }
+        };
+
+        std::vector<float> res;
+        f.noteOn(60);
+        for (int b = 0; b < 400; ++b)
+        {
+            // a new bend every 50 blocks; the part glides to it and then holds
+            if (b % 50 == 0)
+            {
+                auto bend = (int)(8191 * std::sin(b * 0.37)) + 8192;
+                uint8_t pb[3]{0xE0, (uint8_t)(bend & 0x7F), (uint8_t)((bend >> 7) & 0x7F)};
+                f.eng->processMIDI1Event(0, pb);
+            }
+            if (forceMiss)
+                forget();
+            f.runBlocks(1);
+            for (int c = 0; c < 2; ++c)
+                res.insert(res.end(), out[c], out[c] + scxt::blockSize);
+        }
+        f.noteOff(60);
+        return res;
+    };
+
+    auto cached = render(false);
+    auto fresh = render(true);
+    REQUIRE(cached.size() == fresh.size());
+
+    bool anySound{false};
+    for (size_t i = 0; i < cached.size(); ++i)
+    {
+        INFO("sample " << i);
+        REQUIRE(cached[i] == fresh[i]);
+        anySound = anySound || cached[i] != 0.f;
+    }
+    REQUIRE(anySound);
+}
@@ -0,0 +1,172 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "engine/engine.h"
+#include "engine/zone.h"
+#include "engine/voice_governor.h"
+#include "voice/voice.h"
+
+#include "test_utils.h"
+
+/*
+ * The governor's choice of voice is what matters here, so these set each voice's cost
+ * estimate by hand and call enforce directly rather than time real blocks.
+ */
+static std::array<scxt::voice::Voice *, scxt::maxVoices> voicesOf(const scxt::engine::Zone &z)
+{
+    std::array<scxt::voice::Voice *, scxt::maxVoices> res{};
+    for (int i = 0; i < z.activeVoices; ++i)
+        res[i] = z.voiceWeakPointers[i];
+    return res;
+}
+
+static scxt::voice::Voice *voiceForKey(const scxt::engine::Zone &z, int key)
+{
+    for (int i = 0; i < z.activeVoices; ++i)
+        if (z.voiceWeakPointers[i]->key == key)
+            return z.voiceWeakPointers[i];
+    return nullptr;
+}
+
+TEST_CASE("Voice governor steals released, then quiet, then old voices", "[voice_governor]")
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+    auto &part = *eng->getPatch()->getPart(0);
+    part.addGroup();
+    addBlankZoneToGroup(part, 0, 36, 96);
+    auto &zone = *part.getGroup(0)->getZone(0);
+
+    for (auto k : {40, 50, 60})
+        eng->processNoteOnEvent(0, 0, k, -1, 1.f, 0.f);
+    eng->processNoteOffEvent(0, 0, 50, -1, 0.f);
+    REQUIRE(zone.activeVoices == 3);
+
+    auto *v40 = voiceForKey(zone, 40);
+    auto *v50 = voiceForKey(zone, 50);
+    auto *v60 = voiceForKey(zone, 60);
+    REQUIRE(v40);
+    REQUIRE(v50);
+    REQUIRE(v60);
+    REQUIRE_FALSE(v50->isGated);
+    for (auto *v : {v40, v50, v60})
+        v->governorCostPercent = 10.f;
+
+    scxt::engine::VoiceGovernor gov;
+    REQUIRE(gov.enforce(voicesOf(zone)) == 0);
+
+    SECTION("Within budget nothing goes")
+    {
+        gov.budgetPercent = 30.f;
+        REQUIRE(gov.enforce(voicesOf(zone)) == 0);
+        REQUIRE(gov.stats.estimatedLoadPercent == Approx(30.f));
+    }
+
+    SECTION("The released voice goes first")
+    {
+        gov.budgetPercent = 25.f;
+        REQUIRE(gov.enforce(voicesOf(zone)) == 1);
+        REQUIRE(v50->terminationSequence > 0);
+        REQUIRE(v40->terminationSequence < 0);
+        REQUIRE(v60->terminationSequence < 0);
+
+        // A fading voice counts as gone, so the next block takes nothing more
+        REQUIRE(gov.enforce(voicesOf(zone)) == 0);
+    }
+
+    SECTION("Then the quietest, then the oldest")
+    {
+        eng->processNoteOnEvent(0, 0, 70, -1, 1.f, 0.f);
+        auto *v70 = voiceForKey(zone, 70);
+        REQUIRE(v70);
+
+        // What everything costs, the unrendered voice's guess included; each budget below
+        // then leaves room for all but one or two of the 10% voices
+        gov.budgetPercent = 1000.f;
+        REQUIRE(gov.enforce(voicesOf(zone)) == 0);
+        auto total = gov.stats.estimatedLoadPercent;
+        auto budgetLosing = [total](int n) { return total - 10.f * n + 0.5f; };
+
+        SECTION("Quiet beats old")
+        {
+            // the released voice is loudest and still goes first
+            v50->aeg.outBlock0 = 0.9f;
+            v40->aeg.outBlock0 = 0.8f;
+            v60->aeg.outBlock0 = 0.3f;
+
+            gov.budgetPercent = budgetLosing(1);
+            REQUIRE(gov.enforce(voicesOf(zone)) == 1);
+            REQUIRE(v50->terminationSequence > 0);
+            REQUIRE(v40->terminationSequence < 0);
+            REQUIRE(v60->terminationSequence < 0);
+
+            gov.budgetPercent = budgetLosing(2);
+            REQUIRE(gov.enforce(voicesOf(zone)) == 1);
+            REQUIRE(v60->terminationSequence > 0);
+            REQUIRE(v40->terminationSequence < 0);
+        }
+
+        SECTION("Equally loud, the oldest goes")
+        {
+            v40->aeg.outBlock0 = 0.5f;
+            v50->aeg.outBlock0 = 0.5f;
+            v60->aeg.outBlock0 = 0.5f;
+
+            gov.budgetPercent = budgetLosing(2);
+            REQUIRE(gov.enforce(voicesOf(zone)) == 2);
+            REQUIRE(v50->terminationSequence > 0);
+            REQUIRE(v40->terminationSequence > 0);
+            REQUIRE(v60->terminationSequence < 0);
+        }
+
+        // it hasn't rendered yet, so it is never the one chosen
+        REQUIRE(v70->terminationSequence < 0);
+        REQUIRE(gov.stats.voicesStolen == 2);
+    }
+}
+
+TEST_CASE("Voice governor weighs voice features", "[voice_governor]")
+{
+    std::unique_ptr<scxt::engine::Engine> eng(makeEngine());
+    auto &part = *eng->getPatch()->getPart(0);
+    part.addGroup();
+    addBlankZoneToGroup(part, 0, 36, 96);
+    auto &zone = *part.getGroup(0)->getZone(0);
+
+    eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f);
+    auto *v = voiceForKey(zone, 60);
+    REQUIRE(v);
+
+    v->forceOversample = false;
+    auto plain = scxt::engine::VoiceGovernor::featureWeight(*v);
+    v->forceOversample = true;
+    REQUIRE(scxt::engine::VoiceGovernor::featureWeight(*v) == Approx(plain * 2));
+
+    v->forceOversample = false;
+    v->processorIsActive[0] = true;
+    REQUIRE(scxt::engine::VoiceGovernor::featureWeight(*v) > plain);
+}
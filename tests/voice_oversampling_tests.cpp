@@ -47,6 +47,7 @@
 
 #include <cmath>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -57,6 +58,7 @@
 #include "engine/part.h"
 #include "engine/zone.h"
 #include "messaging/messaging.h"
+#include "json/stream.h"
 #include "voice/voice.h"
 
 #include "test_utils.h"
@@ -447,3 +449,271 @@ TEST_CASE("A voice an octave up reaches for oversampling on its own", "[oversamp
     REQUIRE(v->useOversampling);
     REQUIRE(v->GD[0].blockSize == scxt::blockSize * 2);
 }
+
+namespace
+{
+// the group's base rate output, which is where shared decimation lands
+Render renderGroup(OversampleFixture &f, const std::vector<int> &keys, int nBlocks,
+                   const std::function<void(int)> &beforeBlock = nullptr)
+{
+    Render out;
+    for (auto key : keys)
+        f.eng->processNoteOnEvent(0, 0, key, -1, 1.f, 0.f);
+    for (int b = 0; b < nBlocks; ++b)
+    {
+        if (beforeBlock)
+            beforeBlock(b);
+        f.eng->processAudio();
+        for (int i = 0; i < scxt::blockSize; ++i)
+        {
+            out.l.push_back(f.group->output[0][i]);
+            out.r.push_back(f.group->output[1][i]);
+        }
+    }
+    for (auto key : keys)
+        f.eng->processNoteOffEvent(0, 0, key, -1, 0.f);
+    return out;
+}
+Render renderGroup(OversampleFixture &f, int key, int nBlocks)
+{
+    return renderGroup(f, std::vector<int>{key}, nBlocks);
+}
+
+// skip the attack, where the 2x and 1x envelopes take different steps to the same place
+void dropAttack(Render &r)
+{
+    constexpr size_t settled{16 * scxt::blockSize};
+    r.l.erase(r.l.begin(), r.l.begin() + settled);
+    r.r.erase(r.r.begin(), r.r.begin() + settled);
+}
+
+int countLiveVoices(const OversampleFixture &f)
+{
+    int n{0};
+    for (int i = 0; i < (int)scxt::maxVoices; ++i)
+    {
+        auto *v = f.zone->voiceWeakPointers[i];
+        if (v && v->isVoiceAssigned)
+            n++;
+    }
+    return n;
+}
+} // namespace
+
+TEST_CASE("Shared voice decimation leaves a pitched up voice at 2x for the group", "[oversample]")
+{
+    SECTION("a voice with no processors hands its 2x block to the zone")
+    {
+        OversampleFixture f(false, 1);
+        f.group->outputInfo.sharedVoiceDecimation = true;
+        f.eng->processNoteOnEvent(0, 0, 72, -1, 1.f, 0.f);
+        f.eng->processAudio();
+
+        auto *v = f.onlyVoice();
+        REQUIRE(v);
+        REQUIRE(v->forceOversample);
+        REQUIRE(f.zone->hasOSOutput);
+    }
+
+    SECTION("a voice at the root key has nothing to share")
+    {
+        OversampleFixture f(false, 1);
+        f.group->outputInfo.sharedVoiceDecimation = true;
+        f.eng->processNoteOnEvent(0, 0, 60, -1, 1.f, 0.f);
+        f.eng->processAudio();
+
+        auto *v = f.onlyVoice();
+        REQUIRE(v);
+        REQUIRE(!v->forceOversample);
+        REQUIRE(!f.zone->hasOSOutput);
+    }
+
+    SECTION("a voice with a processor keeps its own decimation")
+    {
+        OversampleFixture f(false, 1);
+        f.group->outputInfo.sharedVoiceDecimation = true;
+        f.zone->setProcessorType(0, scxt::dsp::processor::proct_osc_sineplus);
+        f.eng->processNoteOnEvent(0, 0, 72, -1, 1.f, 0.f);
+        f.eng->processAudio();
+
+        auto *v = f.onlyVoice();
+        REQUIRE(v);
+        REQUIRE(!v->forceOversample);
+        REQUIRE(v->useOversampling);
+    }
+}
+
+TEST_CASE("Shared voice decimation sounds like per voice decimation", "[oversample]")
+{
+    // same halfband either side, and everything between it and the generator is a gain
+    OversampleFixture own(false, 1);
+    auto perVoice = renderGroup(own, 72, renderedBlocks);
+
+    OversampleFixture shared(false, 1);
+    shared.group->outputInfo.sharedVoiceDecimation = true;
+    auto perGroup = renderGroup(shared, 72, renderedBlocks);
+
+    dropAttack(perVoice);
+    dropAttack(perGroup);
+    requireAudible(perVoice);
+
+    auto d = divergenceFrom(perGroup, perVoice, 1.f, 1e-3f);
+    INFO(d.what);
+    REQUIRE(d.index == -1);
+}
+
+TEST_CASE("Shared voice decimation sums several voices at once", "[oversample]")
+{
+    // two pitched up notes at once, so the group filter sees a sum rather than one voice
+    const std::vector<int> chord{72, 79};
+
+    OversampleFixture own(false, 1);
+    auto perVoice = renderGroup(own, chord, renderedBlocks);
+
+    OversampleFixture shared(false, 1);
+    shared.group->outputInfo.sharedVoiceDecimation = true;
+    auto perGroup = renderGroup(shared, chord, renderedBlocks, [&shared](int b) {
+        if (b == 1)
+        {
+            REQUIRE(countLiveVoices(shared) == 2);
+            for (int i = 0; i < (int)scxt::maxVoices; ++i)
+            {
+                auto *v = shared.zone->voiceWeakPointers[i];
+                if (v && v->isVoiceAssigned)
+                    REQUIRE(v->forceOversample);
+            }
+            REQUIRE(shared.zone->hasOSOutput);
+        }
+    });
+
+    dropAttack(perVoice);
+    dropAttack(perGroup);
+    requireAudible(perVoice);
+
+    auto d = divergenceFrom(perGroup, perVoice, 1.f, 1e-3f);
+    INFO(d.what);
+    REQUIRE(d.index == -1);
+}
+
+TEST_CASE("Oversample quality picks the group decimator", "[oversample]")
+{
+    using G = scxt::engine::Group;
+    const std::vector<G::OversampleQuality> qualities{G::OSQ_LOW, G::OSQ_MEDIUM, G::OSQ_HIGH};
+
+    SECTION("Every length passes DC and each filters differently")
+    {
+        std::vector<std::vector<float>> impulses;
+        for (auto q : qualities)
+        {
+            auto f = G::makeDecimator(q);
+            float l alignas(16)[scxt::blockSize << 1]{}, r alignas(16)[scxt::blockSize << 1]{};
+            l[0] = r[0] = 1.f;
+            f.process_block_D2(l, r, scxt::blockSize << 1);
+            impulses.emplace_back(l, l + scxt::blockSize);
+
+            // and a held level comes out at that level once the filter fills
+            for (int b = 0; b < 8; ++b)
+            {
+                std::fill(l, l + (scxt::blockSize << 1), 0.5f);
+                std::fill(r, r + (scxt::blockSize << 1), 0.5f);
+                f.process_block_D2(l, r, scxt::blockSize << 1);
+            }
+            INFO("quality " << G::toStringOversampleQuality(q));
+            REQUIRE(l[scxt::blockSize - 1] == Approx(0.5f).margin(1e-3));
+            REQUIRE(r[scxt::blockSize - 1] == Approx(0.5f).margin(1e-3));
+        }
+        REQUIRE(impulses[0] != impulses[1]);
+        REQUIRE(impulses[1] != impulses[2]);
+        REQUIRE(impulses[0] != impulses[2]);
+    }
+
+    SECTION("A group picks up a new quality on the next block")
+    {
+        OversampleFixture high(true, 1);
+        auto ref = renderGroup(high, 72, renderedBlocks);
+        REQUIRE(high.group->lastOversampleQuality == G::OSQ_HIGH);
+
+        OversampleFixture low(true, 1);
+        low.group->outputInfo.oversampleQuality = G::OSQ_LOW;
+        auto lowR = renderGroup(low, 72, renderedBlocks);
+        REQUIRE(low.group->lastOversampleQuality == G::OSQ_LOW);
+
+        // switched part way through a note, the way a user turning the knob would
+        OversampleFixture switched(true, 1);
+        auto swR = renderGroup(switched, 72, renderedBlocks, [&switched](int b) {
+            if (b == renderedBlocks / 2)
+                switched.group->outputInfo.oversampleQuality = G::OSQ_MEDIUM;
+        });
+        REQUIRE(switched.group->lastOversampleQuality == G::OSQ_MEDIUM);
+
+        dropAttack(ref);
+        dropAttack(lowR);
+        dropAttack(swR);
+        requireAudible(ref);
+        requireAudible(lowR);
+        requireAudible(swR);
+
+        // a shorter halfband is a different filter, with its own phase, but the same sound
+        auto rms = [](const std::vector<float> &ch) {
+            double sum{0.0};
+            for (auto v : ch)
+                sum += (double)v * v;
+            return std::sqrt(sum / ch.size());
+        };
+        REQUIRE(lowR.l != ref.l);
+        REQUIRE(rms(lowR.l) == Approx(rms(ref.l)).epsilon(0.1));
+        REQUIRE(rms(lowR.r) == Approx(rms(ref.r)).epsilon(0.1));
+
+        // until the switch it is the default filter, sample for sample
+        auto switchAt = (size_t)(renderedBlocks / 2 - 16) * scxt::blockSize;
+        for (size_t i = 0; i < switchAt; ++i)
+            REQUIRE(swR.l[i] == Approx(ref.l[i]).margin(1e-6));
+        for (auto v : swR.l)
+            REQUIRE(std::isfinite(v));
+    }
+}
+
+TEST_CASE("Oversample quality and shared decimation stream", "[oversample][streaming]")
+{
+    using G = scxt::engine::Group;
+
+    OversampleFixture f(false, 1);
+    f.group->outputInfo.oversampleQuality = G::OSQ_LOW;
+    f.group->outputInfo.sharedVoiceDecimation = true;
+    auto saved = scxt::json::streamEngineState(*f.eng);
+
+    auto reload = [](const std::string &json) {
+        std::unique_ptr<scxt::engine::Engine> other(makeEngine());
+        {
+            auto bg = other->getMessageController()->threadingChecker.bypassChecksInScope();
+            scxt::json::unstreamEngineState(*other, json);
+        }
+        auto &part = *other->getPatch()->getPart(0);
+        REQUIRE(part.getGroups().size() == 1);
+        return part.getGroup(0)->outputInfo;
+    };
+
+    SECTION("Set values come back")
+    {
+        auto oi = reload(saved);
+        REQUIRE(oi.oversampleQuality == G::OSQ_LOW);
+        REQUIRE(oi.sharedVoiceDecimation);
+    }
+
+    SECTION("A patch from before the fields loads with the defaults")
+    {
+        // hide the two keys, which is how a patch saved before them reads
+        auto old = saved;
+        for (const std::string key : {"\"osq\"", "\"svd\""})
+        {
+            auto pos = old.find(key);
+            REQUIRE(pos != std::string::npos);
+            old.replace(pos, key.size(), "\"xx" + key.substr(1));
+            REQUIRE(old.find(key) == std::string::npos);
+        }
+
+        auto oi = reload(old);
+        REQUIRE(oi.oversampleQuality == G::OSQ_HIGH);
+        REQUIRE_FALSE(oi.sharedVoiceDecimation);
+    }
+}